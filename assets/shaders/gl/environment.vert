@@ -5,12 +5,26 @@ layout (location = 1) in vec3 vNormal;
 layout (location = 2) in vec2 vTexCoords;
 
 out VsOut {
-  vec2 tex_coords;
+  vec3 direction;
 } Out;
 
+layout (std140) uniform EnvironmentBuffer {
+  mat4 uInverseProjViewMatrix;
+  vec4 uCameraPos;
+  float uBrightness;
+  float uGamma;
+  bool uGammaCorrectionEnabled;
+};
+
 void main()
 {
   gl_Position = vec4(vPosition, 1);
 
-  Out.tex_coords = vTexCoords;
+  // Calculate the world-space position of this corner on the far plane
+  vec4 ws_corner_pos = uInverseProjViewMatrix * vec4(vPosition.xy, 1.0, 1.0);
+  ws_corner_pos *= (1.0 / ws_corner_pos.w);
+
+  // The direction is linear in screen space, so it can be interpolated without
+  // normalization, cubemap lookups don't require normalized directions
+  Out.direction = ws_corner_pos.xyz - uCameraPos.xyz;
 }
@@ -1,7 +1,7 @@
 #version 410 core
 
 layout (location = 0) in vec3 vPosition;
-layout (location = 1) in vec3 vNormal;
+layout (location = 1) in vec3 vNormal;  // Only XY is used by octahedral normals
 layout (location = 2) in vec2 vTexCoords;
 
 out VsOutput {
@@ -16,14 +16,29 @@ layout (std140) uniform MatrixBuffer {
   mat4 uModelViewMatrix;
   mat4 uMVP;
   mat4 uNormalMatrix;
+  vec4 uPositionOffset;
+  vec4 uPositionScale;
+  bool uOctahedralNormals;
 };
 
+vec3 decode_octahedral(vec2 encoded)
+{
+  vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+  float fold = max(-normal.z, 0.0);
+  normal.x += (normal.x >= 0.0) ? -fold : fold;
+  normal.y += (normal.y >= 0.0) ? -fold : fold;
+  return normalize(normal);
+}
+
 void main()
 {
-  gl_Position = uMVP * vec4(vPosition, 1);
+  vec3 position = uPositionOffset.xyz + vPosition * uPositionScale.xyz;
+  vec3 normal = uOctahedralNormals ? decode_octahedral(vNormal.xy) : vNormal;
+
+  gl_Position = uMVP * vec4(position, 1);
 
-  Out.ws_position = vec3(uModelMatrix * vec4(vPosition, 1));
-  Out.vs_position = vec3(uModelViewMatrix * vec4(vPosition, 1));
-  Out.vs_normal = vec3(uNormalMatrix * vec4(vNormal, 0));
+  Out.ws_position = vec3(uModelMatrix * vec4(position, 1));
+  Out.vs_position = vec3(uModelViewMatrix * vec4(position, 1));
+  Out.vs_normal = vec3(uNormalMatrix * vec4(normal, 0));
   Out.tex_coords = vTexCoords;
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#version 410 core
+
+// Must match kMaxInstancesPerDraw in shader_buffers.hpp
+#define MAX_INSTANCES 128
+
+layout (location = 0) in vec3 vPosition;
+layout (location = 1) in vec3 vNormal;  // Only XY is used by octahedral normals
+layout (location = 2) in vec2 vTexCoords;
+layout (location = 3) in uint vInstanceIndex;  // Includes the base instance of draws
+
+out VsOutput {
+  vec3 ws_position;
+  vec3 vs_position;
+  vec3 vs_normal;
+  vec2 tex_coords;
+} Out;
+
+struct Instance {
+  mat4 model_matrix;   // Also decodes the vertex positions
+  mat4 normal_matrix;  // World space normal matrix
+};
+
+layout (std140) uniform InstancedMatrixBuffer {
+  mat4 uViewMatrix;
+  mat4 uProjViewMatrix;
+  bool uOctahedralNormals;
+};
+
+layout (std140) uniform InstanceBuffer {
+  Instance uInstances[MAX_INSTANCES];
+};
+
+vec3 decode_octahedral(vec2 encoded)
+{
+  vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+  float fold = max(-normal.z, 0.0);
+  normal.x += (normal.x >= 0.0) ? -fold : fold;
+  normal.y += (normal.y >= 0.0) ? -fold : fold;
+  return normalize(normal);
+}
+
+void main()
+{
+  Instance instance = uInstances[vInstanceIndex];
+
+  vec3 normal = uOctahedralNormals ? decode_octahedral(vNormal.xy) : vNormal;
+
+  vec4 ws_position = instance.model_matrix * vec4(vPosition, 1);
+  vec4 vs_position = uViewMatrix * ws_position;
+
+  gl_Position = uProjViewMatrix * ws_position;
+
+  Out.ws_position = ws_position.xyz;
+  Out.vs_position = vs_position.xyz;
+  Out.vs_normal = mat3(uViewMatrix) * vec3(instance.normal_matrix * vec4(normal, 0));
+  Out.tex_coords = vTexCoords;
+}
\ No newline at end of file
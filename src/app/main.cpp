@@ -8,6 +8,7 @@
 #include "engine/backend.hpp"
 #include "engine/engine.hpp"
 #include "io/command_line_parser.hpp"
+#include "util/thread_pool.hpp"
 
 auto main(const int argc, char* argv[]) -> int
 {
@@ -25,6 +26,10 @@ auto main(const int argc, char* argv[]) -> int
     const auto log_level = command_line_args->log_level;
     spdlog::set_level(log_level);
 
+    if (command_line_args->thread_count) {
+      glow::set_thread_pool_size(*command_line_args->thread_count);
+    }
+
     const auto api = command_line_args->api;
     spdlog::info("[Main] Using {}", get_short_name(api));
 
@@ -32,14 +37,19 @@ auto main(const int argc, char* argv[]) -> int
     engine.set_backend(glow::create_backend(engine.get_window(), api));
     engine.init();
 
+    if (command_line_args->texture_budget) {
+      engine.set_texture_budget(*command_line_args->texture_budget);
+    }
+
     if (command_line_args->env_path) {
       spdlog::debug("[Main] Specified environment texture '{}'",
                     command_line_args->env_path->string());
-      engine.set_environment_texture(*command_line_args->env_path);
+      engine.set_environment_texture(*command_line_args->env_path,
+                                     command_line_args->env_quality);
     }
 
     for (const auto& model_path : command_line_args->model_paths) {
-      engine.load_model(model_path);
+      engine.load_model(model_path, command_line_args->import_options);
     }
 
     engine.start();
@@ -0,0 +1,113 @@
+#include "hash.hpp"
+
+#include <bit>      // rotl
+#include <cstring>  // memcpy
+
+namespace glow {
+namespace {
+
+inline constexpr uint64 kPrime1 = 0x9E3779B185EBCA87ULL;
+inline constexpr uint64 kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+inline constexpr uint64 kPrime3 = 0x165667B19E3779F9ULL;
+inline constexpr uint64 kPrime4 = 0x85EBCA77C2B2AE63ULL;
+inline constexpr uint64 kPrime5 = 0x27D4EB2F165667C5ULL;
+
+[[nodiscard]] auto _read_u64(const uchar* bytes) noexcept -> uint64
+{
+  uint64 value;
+  std::memcpy(&value, bytes, sizeof value);
+  return value;
+}
+
+[[nodiscard]] auto _read_u32(const uchar* bytes) noexcept -> uint32
+{
+  uint32 value;
+  std::memcpy(&value, bytes, sizeof value);
+  return value;
+}
+
+[[nodiscard]] auto _round(uint64 acc, const uint64 input) noexcept -> uint64
+{
+  acc += input * kPrime2;
+  acc = std::rotl(acc, 31);
+  acc *= kPrime1;
+  return acc;
+}
+
+[[nodiscard]] auto _merge_round(uint64 acc, const uint64 value) noexcept -> uint64
+{
+  acc ^= _round(0, value);
+  acc = acc * kPrime1 + kPrime4;
+  return acc;
+}
+
+}  // namespace
+
+auto hash_bytes(const void* data, const usize size, const uint64 seed) noexcept -> uint64
+{
+  const auto* bytes = static_cast<const uchar*>(data);
+  const auto* const end = bytes + size;
+
+  uint64 hash;
+
+  if (size >= 32) {
+    uint64 v1 = seed + kPrime1 + kPrime2;
+    uint64 v2 = seed + kPrime2;
+    uint64 v3 = seed;
+    uint64 v4 = seed - kPrime1;
+
+    const auto* const limit = end - 32;
+    do {
+      v1 = _round(v1, _read_u64(bytes));
+      v2 = _round(v2, _read_u64(bytes + 8));
+      v3 = _round(v3, _read_u64(bytes + 16));
+      v4 = _round(v4, _read_u64(bytes + 24));
+      bytes += 32;
+    } while (bytes <= limit);
+
+    hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+    hash = _merge_round(hash, v1);
+    hash = _merge_round(hash, v2);
+    hash = _merge_round(hash, v3);
+    hash = _merge_round(hash, v4);
+  }
+  else {
+    hash = seed + kPrime5;
+  }
+
+  hash += static_cast<uint64>(size);
+
+  while (bytes + 8 <= end) {
+    hash ^= _round(0, _read_u64(bytes));
+    hash = std::rotl(hash, 27) * kPrime1 + kPrime4;
+    bytes += 8;
+  }
+
+  if (bytes + 4 <= end) {
+    hash ^= static_cast<uint64>(_read_u32(bytes)) * kPrime1;
+    hash = std::rotl(hash, 23) * kPrime2 + kPrime3;
+    bytes += 4;
+  }
+
+  while (bytes < end) {
+    hash ^= static_cast<uint64>(*bytes) * kPrime5;
+    hash = std::rotl(hash, 11) * kPrime1;
+    ++bytes;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+
+  return hash;
+}
+
+auto hash_content(const void* data, const usize size, const uint64 seed) noexcept
+    -> ContentHash
+{
+  return ContentHash {hash_bytes(data, size, seed), static_cast<uint64>(size)};
+}
+
+}  // namespace glow
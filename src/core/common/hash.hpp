@@ -20,4 +20,33 @@ void hash_combine(usize& seed, const T& val)
   return seed;
 }
 
-}  // namespace glow
\ No newline at end of file
+/// Computes a 64-bit hash of an arbitrary sequence of bytes.
+///
+/// \details
+/// This is an implementation of the XXH64 algorithm, which is fast enough to be used
+/// for hashing entire asset files. The resulting hashes are stable across runs and
+/// platforms, so they may be persisted.
+///
+/// \param data pointer to the first byte to hash.
+/// \param size the number of bytes to hash.
+/// \param seed an optional seed value.
+[[nodiscard]] auto hash_bytes(const void* data, usize size, uint64 seed = 0) noexcept
+    -> uint64;
+
+/// Identifies a sequence of bytes by its content, e.g. the contents of an asset file.
+///
+/// \details
+/// The size is stored along with the hash, so that a collision would require both a
+/// matching 64-bit hash and a matching size.
+struct ContentHash final {
+  uint64 hash {};  ///< The hash of the bytes, see `hash_bytes`.
+  uint64 size {};  ///< The number of hashed bytes.
+
+  [[nodiscard]] auto operator<=>(const ContentHash&) const = default;
+};
+
+/// Computes the content hash of an arbitrary sequence of bytes.
+[[nodiscard]] auto hash_content(const void* data, usize size, uint64 seed = 0) noexcept
+    -> ContentHash;
+
+}  // namespace glow
@@ -6,14 +6,19 @@
 #include "common/primitives.hpp"
 #include "common/result.hpp"
 #include "common/type/dispatcher.hpp"
+#include "common/type/ecs.hpp"
 #include "common/type/math.hpp"
 #include "common/type/memory.hpp"
 #include "common/type/path.hpp"
 #include "graphics/graphics_api.hpp"
+#include "io/hdr_texture.hpp"
+#include "io/import_options.hpp"
+#include "util/task.hpp"
 
 namespace glow {
 
 GLOW_FORWARD_DECLARE_C(Scene);
+GLOW_FORWARD_DECLARE_C(FrameScheduler);
 
 class Backend {
  public:
@@ -26,6 +31,9 @@ class Backend {
 
   virtual void on_event(const SDL_Event& event) = 0;
 
+  /// Updates the resident mip levels of streamed textures, see TextureStreamer.
+  virtual void update_textures([[maybe_unused]] Scene& scene) {}
+
   virtual auto begin_frame(const Scene& scene) -> Result = 0;
 
   virtual void end_frame() = 0;
@@ -33,9 +41,31 @@ class Backend {
   virtual void render_scene(const Scene& scene,
                             Dispatcher& dispatcher) = 0;
 
-  virtual void set_environment_texture(Scene& scene, const Path& path) = 0;
-
-  virtual void load_model(Scene& scene, const Path& path) = 0;
+  virtual void set_environment_texture(Scene& scene,
+                                       const Path& path,
+                                       EnvironmentQuality quality) = 0;
+
+  /// Loads a model and assigns it to a new node in the scene.
+  ///
+  /// \details
+  /// The file import and texture decoding is done on worker threads, whilst the GPU
+  /// resources are created on the main thread using the scheduler.
+  virtual auto load_model(Scene& scene,
+                          FrameScheduler& scheduler,
+                          Path path,
+                          ImportOptions options) -> Task<> = 0;
+
+  /// Reloads the model of an entity from its file, see `ModelSource`.
+  ///
+  /// \details
+  /// The model is updated in place, and meshes with unchanged contents are not uploaded
+  /// again.
+  virtual auto reload_model(Scene& scene, FrameScheduler& scheduler, Entity entity)
+      -> Task<> = 0;
+
+  /// Reloads a texture file and updates the materials that use it.
+  virtual auto reload_texture(Scene& scene, FrameScheduler& scheduler, Path path)
+      -> Task<> = 0;
 
   [[nodiscard]] virtual auto should_quit() const -> bool = 0;
 };
@@ -1,5 +1,9 @@
 #include "opengl_backend.hpp"
 
+#include <span>           // span
+#include <unordered_map>  // erase_if
+#include <utility>        // move
+
 #include <fmt/format.h>
 #include <glad/glad.h>
 #include <imgui_impl_sdl2.h>
@@ -8,14 +12,20 @@
 #include <ImGuizmo.h>
 
 #include "common/debug/assert.hpp"
+#include "common/hash.hpp"
 #include "common/predef.hpp"
 #include "graphics/camera.hpp"
+#include "graphics/culling.hpp"
 #include "graphics/environment.hpp"
+#include "graphics/lod.hpp"
+#include "graphics/opengl/mesh_cache.hpp"
 #include "graphics/opengl/model.hpp"
 #include "graphics/opengl/texture_cache.hpp"
 #include "graphics/opengl/util.hpp"
+#include "graphics/render_stats.hpp"
 #include "graphics/renderer_info.hpp"
 #include "graphics/rendering_options.hpp"
+#include "graphics/texture_streaming.hpp"
 #include "init/window.hpp"
 #include "io/texture_loader.hpp"
 #include "scene/scene.hpp"
@@ -26,6 +36,88 @@
 #include "util/bits.hpp"
 
 namespace glow {
+namespace {
+
+void _update_matrix_buffer(gl::MatrixBuffer& matrix_buffer,
+                           const gl::Mesh& mesh,
+                           const Mat4& model_matrix,
+                           const Mat4& projection,
+                           const Mat4& view)
+{
+  matrix_buffer.m = model_matrix;
+  matrix_buffer.mv = view * matrix_buffer.m;
+  matrix_buffer.mvp = projection * matrix_buffer.mv;
+  matrix_buffer.normal = glm::inverse(glm::transpose(matrix_buffer.mv));
+  matrix_buffer.position_offset = Vec4 {mesh.position_offset, 0};
+  matrix_buffer.position_scale = Vec4 {mesh.position_scale, 0};
+  matrix_buffer.octahedral_normals = mesh.octahedral_normals;
+}
+
+void _update_material_buffer(gl::MaterialBuffer& material_buffer,
+                             const gl::Material& material)
+{
+  material_buffer.ambient = Vec4 {material.ambient, 0};
+  material_buffer.diffuse = Vec4 {material.diffuse, 0};
+  material_buffer.specular = Vec4 {material.specular, 0};
+  material_buffer.emission = Vec4 {material.emission, 0};
+  material_buffer.has_diffuse_tex = material.diffuse_tex.has_value();
+  material_buffer.has_specular_tex = material.specular_tex.has_value();
+}
+
+/// Returns a matrix that maps the stored vertex positions of a mesh to mesh space.
+[[nodiscard]] auto _get_position_decode_matrix(const gl::Mesh& mesh) -> Mat4
+{
+  Mat4 decode {1.0f};
+  decode[0][0] = mesh.position_scale.x;
+  decode[1][1] = mesh.position_scale.y;
+  decode[2][2] = mesh.position_scale.z;
+  decode[3] = Vec4 {mesh.position_offset, 1};
+  return decode;
+}
+
+/// Returns the next unused item of a list that is reused across frames.
+template <typename T>
+[[nodiscard]] auto _reuse_next(Vector<T>& items, usize& used_count) -> T&
+{
+  if (used_count == items.size()) {
+    items.emplace_back();
+  }
+
+  return items[used_count++];
+}
+
+}  // namespace
+
+auto OpenGLBackend::MaterialBatchKey::operator==(const MaterialBatchKey& other) const
+    -> bool
+{
+  return pool == other.pool && diffuse_tex == other.diffuse_tex &&
+         specular_tex == other.specular_tex && ambient == other.ambient &&
+         diffuse == other.diffuse && specular == other.specular &&
+         emission == other.emission;
+}
+
+auto OpenGLBackend::MaterialBatchKey::Hasher::operator()(
+    const MaterialBatchKey& key) const -> usize
+{
+  // The material colors are left out, since they rarely differ for the same textures
+  return hash_combine(key.pool,
+                      key.diffuse_tex.value_or(0),
+                      key.specular_tex.value_or(0));
+}
+
+auto OpenGLBackend::InstanceBatchKey::operator==(const InstanceBatchKey& other) const
+    -> bool
+{
+  return material_batch == other.material_batch && buffers == other.buffers &&
+         range.offset == other.range.offset && range.count == other.range.count;
+}
+
+auto OpenGLBackend::InstanceBatchKey::Hasher::operator()(
+    const InstanceBatchKey& key) const -> usize
+{
+  return hash_combine(key.material_batch, key.buffers, key.range.offset, key.range.count);
+}
 
 OpenGLBackend::OpenGLBackend(SDL_Window* window)
     : mRenderer {window}
@@ -40,6 +132,7 @@ void OpenGLBackend::stop()
 void OpenGLBackend::on_init(Scene& scene)
 {
   scene.add<gl::TextureCache>();
+  scene.add<gl::MeshCache>();
 
   auto& rendering_options = scene.get<RenderingOptions>();
   rendering_options.options = {
@@ -48,6 +141,9 @@ void OpenGLBackend::on_init(Scene& scene)
       {RenderingOption::FaceCulling, true},
       {RenderingOption::Wireframe, false},
       {RenderingOption::Blending, false},
+      {RenderingOption::MeshletCulling, true},
+      {RenderingOption::LevelOfDetail, true},
+      {RenderingOption::LodHysteresis, true},
   };
 
   auto& renderer_info = scene.get<RendererInfo>();
@@ -72,6 +168,14 @@ void OpenGLBackend::on_event(const SDL_Event& event)
   }
 }
 
+void OpenGLBackend::update_textures(Scene& scene)
+{
+  const auto changes = scene.get<TextureStreamer>().update(mTextureRequests);
+  gl::apply_residency_changes(scene, changes);
+
+  mTextureRequests.clear();
+}
+
 auto OpenGLBackend::begin_frame(const Scene& scene) -> Result
 {
   mRenderer.begin_frame();
@@ -169,29 +273,98 @@ void OpenGLBackend::render_models(const Scene& scene,
   mRenderer.bind_shading_program();
 
   const auto& gizmos_options = scene.get<GizmosOptions>();
+  const auto& rendering_options = scene.get<RenderingOptions>();
+
+  const auto meshlet_culling = rendering_options.test(RenderingOption::MeshletCulling);
+  const auto face_culling = rendering_options.test(RenderingOption::FaceCulling);
+  const auto level_of_detail = rendering_options.test(RenderingOption::LevelOfDetail);
+  const auto camera_position = Vec3 {glm::inverse(view)[3]};
+
+  const auto lod_selector =
+      make_lod_selector(projection,
+                        camera_position,
+                        static_cast<float>(mOffscreenFB.get_size().y),
+                        rendering_options.test(RenderingOption::LodHysteresis));
+
+  RenderStats stats;
+  usize model_count = 0;
 
   for (auto [entity, transform, model] : scene.each<Transform, gl::Model>()) {
     const auto model_transform = transform.to_model_matrix();
 
-    for (const auto& mesh : model.meshes) {
+    auto& selected_lods = mSelectedLods[entity];
+    selected_lods.resize(model.meshes.size());
+    ++model_count;
+
+    for (usize mesh_idx = 0; mesh_idx < model.meshes.size(); ++mesh_idx) {
+      const auto& mesh = model.meshes[mesh_idx];
       const auto& material = scene.get<gl::Material>(mesh.material);
       const auto model_matrix = model_transform * mesh.transform;
 
-      auto& matrix_buffer = mRenderer.get_matrix_buffer();
-      matrix_buffer.m = model_matrix;
-      matrix_buffer.mv = view * matrix_buffer.m;
-      matrix_buffer.mvp = projection * matrix_buffer.mv;
-      matrix_buffer.normal = glm::inverse(glm::transpose(matrix_buffer.mv));
-
-      auto& material_buffer = mRenderer.get_material_buffer();
-      material_buffer.ambient = Vec4 {material.ambient, 0};
-      material_buffer.diffuse = Vec4 {material.diffuse, 0};
-      material_buffer.specular = Vec4 {material.specular, 0};
-      material_buffer.emission = Vec4 {material.emission, 0};
-      material_buffer.has_diffuse_tex = material.diffuse_tex.has_value();
-      material_buffer.has_specular_tex = material.specular_tex.has_value();
-
-      mRenderer.render_shaded_mesh(mesh, material);
+      auto& lod = selected_lods[mesh_idx];
+      lod = level_of_detail ? select_lod(lod_selector,
+                                         mesh.lods,
+                                         model_matrix,
+                                         mesh.bounds_center,
+                                         mesh.bounds_radius,
+                                         lod)
+                            : 0;
+
+      // Meshlets only cover the full detail level
+      if (lod != 0) {
+        const auto& mesh_lod = mesh.lods[lod];
+        mRanges.assign(1, IndexRange {mesh_lod.index_offset, mesh_lod.index_count});
+        stats.triangle_count += mesh.index_count / 3;
+        stats.submitted_triangle_count += mesh_lod.index_count / 3;
+        ++stats.lod_mesh_count;
+      }
+      else if (meshlet_culling && !mesh.meshlets.empty()) {
+        const auto local_camera_position =
+            Vec3 {glm::inverse(model_matrix) * Vec4 {camera_position, 1}};
+        cull_meshlets(mesh.meshlets,
+                      projection * view * model_matrix,
+                      local_camera_position,
+                      face_culling && has_uniform_scale(model_matrix),
+                      mRanges,
+                      stats);
+      }
+      else {
+        mRanges.assign(1, IndexRange {0, mesh.index_count});
+        stats.triangle_count += mesh.index_count / 3;
+        stats.submitted_triangle_count += mesh.index_count / 3;
+      }
+
+      if (mRanges.empty()) {
+        continue;
+      }
+
+      // Single ranges are deferred, so that copies of the mesh can be drawn together
+      if (mRanges.size() == 1) {
+        add_mesh_instance(mesh, material, mRanges.front(), model_matrix);
+      }
+      else {
+        _update_matrix_buffer(mRenderer.get_matrix_buffer(),
+                              mesh,
+                              model_matrix,
+                              projection,
+                              view);
+        _update_material_buffer(mRenderer.get_material_buffer(), material);
+
+        mRenderer.render_shaded_mesh(mesh, material, mRanges);
+        ++stats.draw_count;
+      }
+
+      const auto pixels_per_uv = get_pixels_per_unit(lod_selector,
+                                                     model_matrix,
+                                                     mesh.bounds_center,
+                                                     mesh.bounds_radius) /
+                                 mesh.uv_density;
+
+      for (const auto& stream : {material.diffuse_stream, material.specular_stream}) {
+        if (stream.has_value()) {
+          mTextureRequests.push_back(TextureRequest {*stream, pixels_per_uv});
+        }
+      }
     }
 
     ImGuizmo::SetID(static_cast<int>(entity));
@@ -203,25 +376,190 @@ void OpenGLBackend::render_models(const Scene& scene,
                              dispatcher);
   }
 
+  // Destroyed models leave their entries behind, which is detected by the entry count.
+  // Entity versions ensure that recycled entities never match the stale entries.
+  if (mSelectedLods.size() > model_count) {
+    const auto& registry = scene.get_registry();
+    std::erase_if(mSelectedLods, [&](const auto& entry) {
+      return !registry.valid(entry.first) ||
+             !registry.all_of<Transform, gl::Model>(entry.first);
+    });
+  }
+
+  render_instance_batches(projection, view, stats);
+
   GLOW_GL_CHECK_ERRORS();
 
   mRenderer.unbind_shading_program();
+
+  // The state changes are only known for the previous frame, which includes the UI
+  const auto& state_cache_stats = mRenderer.get_state_cache_stats();
+  stats.state_change_count = state_cache_stats.state_change_count;
+  stats.skipped_change_count = state_cache_stats.redundant_state_change_count;
+
+  dispatcher.enqueue<UpdateRenderStatsEvent>(stats);
+}
+
+void OpenGLBackend::add_mesh_instance(const gl::Mesh& mesh,
+                                      const gl::Material& material,
+                                      const IndexRange range,
+                                      const Mat4& model_matrix)
+{
+  const MaterialBatchKey material_key {
+      .pool = mesh.buffers->pool.get(),
+      .diffuse_tex = material.diffuse_tex,
+      .specular_tex = material.specular_tex,
+      .ambient = material.ambient,
+      .diffuse = material.diffuse,
+      .specular = material.specular,
+      .emission = material.emission,
+  };
+
+  const auto [material_iter, new_material] =
+      mMaterialBatchIndices.try_emplace(material_key, mMaterialBatchCount);
+
+  if (new_material) {
+    auto& material_batch = _reuse_next(mMaterialBatches, mMaterialBatchCount);
+    material_batch.material = &material;
+    material_batch.instance_batches.clear();
+  }
+
+  const InstanceBatchKey instance_key {
+      .material_batch = material_iter->second,
+      .buffers = mesh.buffers.get(),
+      .range = range,
+  };
+
+  const auto [instance_iter, new_instance] =
+      mInstanceBatchIndices.try_emplace(instance_key, mInstanceBatchCount);
+
+  if (new_instance) {
+    mMaterialBatches[material_iter->second].instance_batches.push_back(
+        mInstanceBatchCount);
+
+    auto& instance_batch = _reuse_next(mInstanceBatches, mInstanceBatchCount);
+    instance_batch.mesh = &mesh;
+    instance_batch.model_matrix = model_matrix;
+    instance_batch.range = range;
+    instance_batch.instances.clear();
+  }
+
+  mInstanceBatches[instance_iter->second].instances.push_back(gl::InstanceData {
+      .model = model_matrix * _get_position_decode_matrix(mesh),
+      .normal = glm::inverse(glm::transpose(model_matrix)),
+  });
+}
+
+void OpenGLBackend::render_instance_batches(const Mat4& projection,
+                                            const Mat4& view,
+                                            RenderStats& stats)
+{
+  const auto material_batches =
+      std::span {mMaterialBatches.data(), mMaterialBatchCount};
+
+  // Indirect draws combine all meshes of a material batch, regardless of their number
+  // of copies. Otherwise, meshes without copies are drawn with the regular program.
+  const auto multi_draw_indirect = mRenderer.has_multi_draw_indirect();
+  const auto uses_instancing = [&](const InstanceBatch& batch) {
+    return multi_draw_indirect || batch.instances.size() != 1;
+  };
+
+  for (const auto& material_batch : material_batches) {
+    for (const auto batch_index : material_batch.instance_batches) {
+      const auto& batch = mInstanceBatches[batch_index];
+
+      if (uses_instancing(batch)) {
+        continue;
+      }
+
+      _update_matrix_buffer(mRenderer.get_matrix_buffer(),
+                            *batch.mesh,
+                            batch.model_matrix,
+                            projection,
+                            view);
+      _update_material_buffer(mRenderer.get_material_buffer(), *material_batch.material);
+
+      mRanges.assign(1, batch.range);
+      mRenderer.render_shaded_mesh(*batch.mesh, *material_batch.material, mRanges);
+      ++stats.draw_count;
+    }
+  }
+
+  mRenderer.bind_instanced_shading_program();
+
+  auto& matrix_buffer = mRenderer.get_instanced_matrix_buffer();
+  matrix_buffer.view = view;
+  matrix_buffer.proj_view = projection * view;
+
+  for (const auto& material_batch : material_batches) {
+    mInstancedDraws.clear();
+
+    for (const auto batch_index : material_batch.instance_batches) {
+      const auto& batch = mInstanceBatches[batch_index];
+
+      if (uses_instancing(batch)) {
+        mInstancedDraws.push_back(gl::InstancedDraw {
+            .mesh = batch.mesh,
+            .range = batch.range,
+            .instances = batch.instances,
+        });
+        stats.instanced_mesh_count += batch.instances.size();
+      }
+    }
+
+    if (mInstancedDraws.empty()) {
+      continue;
+    }
+
+    // All meshes of the batch share the pool, and thereby the vertex format
+    matrix_buffer.octahedral_normals = mInstancedDraws.front().mesh->octahedral_normals;
+    _update_material_buffer(mRenderer.get_material_buffer(), *material_batch.material);
+
+    stats.draw_count +=
+        mRenderer.render_instanced_meshes(*material_batch.material, mInstancedDraws);
+  }
+
+  mMaterialBatchIndices.clear();
+  mInstanceBatchIndices.clear();
+  mMaterialBatchCount = 0;
+  mInstanceBatchCount = 0;
 }
 
 void OpenGLBackend::set_environment_texture([[maybe_unused]] Scene& scene,
-                                            const Path& path)
+                                            const Path& path,
+                                            const EnvironmentQuality quality)
 {
-  mEnvTexture = gl::Texture2D::load_rgb_f32(path);
+  mEnvTexture = gl::TextureCube::load_hdr(path, quality);
 }
 
-void OpenGLBackend::load_model(Scene& scene, const Path& path)
+auto OpenGLBackend::load_model(Scene& scene,
+                               FrameScheduler& scheduler,
+                               Path path,
+                               const ImportOptions options) -> Task<>
 {
   static int index = 0;
 
   const auto model_entity = scene.make_node(fmt::format("Model {}", index));
-  gl::assign_model(scene, model_entity, path);
-
   ++index;
+
+  return gl::assign_model(scene, scheduler, model_entity, std::move(path), options);
+}
+
+auto OpenGLBackend::reload_model(Scene& scene,
+                                 FrameScheduler& scheduler,
+                                 const Entity entity) -> Task<>
+{
+  co_await gl::reload_model(scene, scheduler, entity);
+
+  // The selected levels refer to the previous meshes
+  mSelectedLods.erase(entity);
+}
+
+auto OpenGLBackend::reload_texture(Scene& scene,
+                                   FrameScheduler& scheduler,
+                                   Path path) -> Task<>
+{
+  return gl::reload_texture(scene, scheduler, std::move(path));
 }
 
 }  // namespace glow
\ No newline at end of file
@@ -1,24 +1,38 @@
 #pragma once
 
+#include <unordered_map>  // unordered_map
+
 #include <SDL2/SDL.h>
 
 #include "common/predef.hpp"
 #include "common/primitives.hpp"
 #include "common/type/chrono.hpp"
 #include "common/type/ecs.hpp"
+#include "common/type/map.hpp"
 #include "common/type/math.hpp"
 #include "common/type/maybe.hpp"
 #include "common/type/path.hpp"
+#include "common/type/vector.hpp"
 #include "engine/backend.hpp"
+#include "graphics/culling.hpp"
 #include "graphics/opengl/framebuffer.hpp"
 #include "graphics/opengl/program.hpp"
 #include "graphics/opengl/renderer.hpp"
-#include "graphics/opengl/texture_2d.hpp"
+#include "graphics/opengl/shader_buffers.hpp"
+#include "graphics/opengl/texture_cube.hpp"
 #include "graphics/opengl/uniform_buffer.hpp"
+#include "graphics/texture_streaming.hpp"
 #include "ui/gizmos.hpp"
 
+namespace glow::gl {
+GLOW_FORWARD_DECLARE_S(MeshBuffers);
+GLOW_FORWARD_DECLARE_C(GeometryPool);
+}  // namespace glow::gl
+
 namespace glow {
 
+GLOW_FORWARD_DECLARE_S(RenderStats);
+
 /// Implements an OpenGL 4.1.0 renderer backend.
 class OpenGLBackend final : public Backend {
  public:
@@ -30,22 +44,94 @@ class OpenGLBackend final : public Backend {
 
   void on_event(const SDL_Event& event) override;
 
+  void update_textures(Scene& scene) override;
+
   auto begin_frame(const Scene& scene) -> Result override;
 
   void end_frame() override;
 
   void render_scene(const Scene& scene, Dispatcher& dispatcher) override;
 
-  void set_environment_texture(Scene& scene, const Path& path) override;
+  void set_environment_texture(Scene& scene,
+                               const Path& path,
+                               EnvironmentQuality quality) override;
+
+  auto load_model(Scene& scene,
+                  FrameScheduler& scheduler,
+                  Path path,
+                  ImportOptions options) -> Task<> override;
 
-  void load_model(Scene& scene, const Path& path) override;
+  auto reload_model(Scene& scene, FrameScheduler& scheduler, Entity entity)
+      -> Task<> override;
+
+  auto reload_texture(Scene& scene, FrameScheduler& scheduler, Path path)
+      -> Task<> override;
 
   [[nodiscard]] auto should_quit() const -> bool override { return mQuit; }
 
  private:
+  /// Identifies meshes that are drawn with the same VAO and material.
+  struct MaterialBatchKey final {
+    const gl::GeometryPool* pool {};  ///< The geometry pool of the meshes.
+    Maybe<uint> diffuse_tex;          ///< The diffuse texture of the material.
+    Maybe<uint> specular_tex;         ///< The specular texture of the material.
+    Vec3 ambient {};
+    Vec3 diffuse {};
+    Vec3 specular {};
+    Vec3 emission {};
+
+    [[nodiscard]] auto operator==(const MaterialBatchKey& other) const -> bool;
+
+    struct Hasher final {
+      [[nodiscard]] auto operator()(const MaterialBatchKey& key) const -> usize;
+    };
+  };
+
+  /// Identifies meshes that can be drawn together with a single instanced draw call.
+  struct InstanceBatchKey final {
+    usize material_batch {};            ///< The index of the material batch.
+    const gl::MeshBuffers* buffers {};  ///< The shared mesh buffers.
+    IndexRange range {};                ///< The drawn index range.
+
+    [[nodiscard]] auto operator==(const InstanceBatchKey& other) const -> bool;
+
+    struct Hasher final {
+      [[nodiscard]] auto operator()(const InstanceBatchKey& key) const -> usize;
+    };
+  };
+
+  /// A group of instance batches that share a VAO and material.
+  struct MaterialBatch final {
+    const gl::Material* material {};  ///< The material of the first mesh.
+    Vector<usize> instance_batches;   ///< The indices of the instance batches.
+  };
+
+  /// A group of mesh instances that share mesh buffers, index range, and material.
+  struct InstanceBatch final {
+    const gl::Mesh* mesh {};  ///< The first mesh of the batch.
+    Mat4 model_matrix {};     ///< The model matrix of the first mesh.
+    IndexRange range {};
+    Vector<gl::InstanceData> instances;
+  };
+
+  using MaterialBatchMap =
+      std::unordered_map<MaterialBatchKey, usize, MaterialBatchKey::Hasher>;
+  using InstanceBatchMap =
+      std::unordered_map<InstanceBatchKey, usize, InstanceBatchKey::Hasher>;
+
   gl::Renderer mRenderer;
-  Maybe<gl::Texture2D> mEnvTexture;
+  Maybe<gl::TextureCube> mEnvTexture;
   gl::Framebuffer mOffscreenFB;
+  Vector<IndexRange> mRanges;
+  HashMap<Entity, Vector<usize>> mSelectedLods;  ///< Current LOD of each model mesh.
+  Vector<TextureRequest> mTextureRequests;        ///< Textures drawn during the frame.
+  MaterialBatchMap mMaterialBatchIndices;         ///< Batch index of each batch key.
+  InstanceBatchMap mInstanceBatchIndices;         ///< Batch index of each batch key.
+  Vector<MaterialBatch> mMaterialBatches;         ///< Reused across frames.
+  Vector<InstanceBatch> mInstanceBatches;         ///< Reused across frames.
+  usize mMaterialBatchCount {};                   ///< Batches used in the current frame.
+  usize mInstanceBatchCount {};                   ///< Batches used in the current frame.
+  Vector<gl::InstancedDraw> mInstancedDraws;      ///< Draws of a material batch.
   bool mQuit {false};
 
   void render_environment(const Scene& scene,
@@ -57,6 +143,15 @@ class OpenGLBackend final : public Backend {
                      const Mat4& projection,
                      const Mat4&,
                      Dispatcher& dispatcher);
+
+  void add_mesh_instance(const gl::Mesh& mesh,
+                         const gl::Material& material,
+                         IndexRange range,
+                         const Mat4& model_matrix);
+
+  void render_instance_batches(const Mat4& projection,
+                               const Mat4& view,
+                               RenderStats& stats);
 };
 
 }  // namespace glow
@@ -1,6 +1,7 @@
 #include "vulkan_backend.hpp"
 
-#include <cstddef>  // offsetof
+#include <unordered_map>  // erase_if
+#include <utility>        // move
 
 #include <fmt/format.h>
 #include <imgui.h>
@@ -13,10 +14,13 @@
 
 #include "common/debug/assert.hpp"
 #include "graphics/renderer_info.hpp"
-#include "graphics/vertex.hpp"
+#include "graphics/rendering_options.hpp"
+#include "graphics/texture_streaming.hpp"
+#include "graphics/vertex_layout.hpp"
 #include "graphics/vulkan/command_buffer.hpp"
 #include "graphics/vulkan/context.hpp"
 #include "graphics/vulkan/image/image_cache.hpp"
+#include "graphics/vulkan/mesh_cache.hpp"
 #include "graphics/vulkan/physical_device.hpp"
 #include "graphics/vulkan/pipeline/descriptor.hpp"
 #include "graphics/vulkan/queue.hpp"
@@ -135,20 +139,34 @@ void VulkanBackend::create_shading_pipeline()
       .push_constant(VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4));
   mShadingPipelineLayout = pipeline_layout.build();
 
-  vk::PipelineBuilder pipeline {mPipelineCache.get()};
-  pipeline  //
-      .render_pass(mRenderPassInfo.pass.get())
-      .layout(mShadingPipelineLayout.get())
-      .shaders("assets/shaders/vk/shading.vert.spv", "assets/shaders/vk/shading.frag.spv")
-      .vertex_input_binding(0, sizeof(Vertex))
-      .vertex_attribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position))
-      .vertex_attribute(0, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, normal))
-      .vertex_attribute(0, 2, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, tex_coords))
-      .rasterization(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT)
-      .multisample(VK_SAMPLE_COUNT_1_BIT)
-      .input_assembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
-      .blending(false);
-  mShadingPipeline = pipeline.build();
+  // Meshes with separate position streams need a pipeline with two vertex bindings
+  const auto build_pipeline = [this](const bool split_positions) {
+    vk::PipelineBuilder pipeline {mPipelineCache.get()};
+    pipeline  //
+        .render_pass(mRenderPassInfo.pass.get())
+        .layout(mShadingPipelineLayout.get())
+        .shaders("assets/shaders/vk/shading.vert.spv",  //
+                 "assets/shaders/vk/shading.frag.spv")
+        .rasterization(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT)
+        .multisample(VK_SAMPLE_COUNT_1_BIT)
+        .input_assembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+        .blending(false);
+
+    if (split_positions) {
+      const auto split_layout = split_vertex_layout(kVertexLayout<Vertex>);
+      pipeline  //
+          .vertex_layout(0, split_layout.positions)
+          .vertex_layout(1, split_layout.attributes);
+    }
+    else {
+      pipeline.vertex_layout(0, kVertexLayout<Vertex>);
+    }
+
+    return pipeline.build();
+  };
+
+  mShadingPipeline = build_pipeline(false);
+  mSplitShadingPipeline = build_pipeline(true);
 }
 
 void VulkanBackend::create_frame_data()
@@ -169,6 +187,7 @@ void VulkanBackend::on_init(Scene& scene)
   vk::init_imgui(mImGuiData, mRenderPassInfo.pass.get(), mSwapchain.get_image_count());
 
   scene.add<vk::ImageCache>();
+  scene.add<vk::MeshCache>();
 
   VkPhysicalDeviceProperties2 gpu_properties {};
   gpu_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
@@ -180,6 +199,11 @@ void VulkanBackend::on_init(Scene& scene)
   renderer_info.vendor = "N/A";
   renderer_info.version = vk::get_driver_version(mGPU);
 
+  auto& rendering_options = scene.get<RenderingOptions>();
+  rendering_options.options[RenderingOption::MeshletCulling] = true;
+  rendering_options.options[RenderingOption::LevelOfDetail] = true;
+  rendering_options.options[RenderingOption::LodHysteresis] = true;
+
   const auto camera_entity =
       make_camera(scene, "Camera", Vec3 {0, 2, -5}, Vec3 {0, 0, 1});
 
@@ -207,6 +231,15 @@ void VulkanBackend::on_event(const SDL_Event& event)
   }
 }
 
+void VulkanBackend::update_textures(Scene& scene)
+{
+  // Streamed images are replaced whilst no frame is being recorded
+  const auto changes = scene.get<TextureStreamer>().update(mTextureRequests);
+  vk::apply_residency_changes(scene, changes);
+
+  mTextureRequests.clear();
+}
+
 auto VulkanBackend::begin_frame(const Scene& scene) -> Result
 {
   if (!scene.has_active_camera()) {
@@ -286,18 +319,49 @@ void VulkanBackend::render_scene(const Scene& scene, Dispatcher& dispatcher)
   vkCmdBindPipeline(frame.command_buffer,
                     VK_PIPELINE_BIND_POINT_GRAPHICS,
                     mShadingPipeline.get());
+  mBoundPipeline = mShadingPipeline.get();
 
   update_static_matrix_buffer(camera, camera_transform);
   push_static_matrix_descriptor();
 
+  const auto& rendering_options = scene.get<RenderingOptions>();
+  mMeshletCulling = rendering_options.test(RenderingOption::MeshletCulling);
+  mLevelOfDetail = rendering_options.test(RenderingOption::LevelOfDetail);
+  mLodSelector =
+      make_lod_selector(mStaticMatrices.proj,
+                        camera_transform.position,
+                        viewport.height,
+                        rendering_options.test(RenderingOption::LodHysteresis));
+  mRenderStats = RenderStats {};
+
+  usize model_count = 0;
+
   for (auto [entity, transform, model] : scene.each<Transform, vk::Model>()) {
-    render_model(scene, transform, model);
+    auto& selected_lods = mSelectedLods[entity];
+    selected_lods.resize(model.meshes.size());
+    ++model_count;
+
+    render_model(scene, transform, model, camera_transform.position, selected_lods);
   }
+
+  // Destroyed models leave their entries behind, which is detected by the entry count.
+  // Entity versions ensure that recycled entities never match the stale entries.
+  if (mSelectedLods.size() > model_count) {
+    const auto& registry = scene.get_registry();
+    std::erase_if(mSelectedLods, [&](const auto& entry) {
+      return !registry.valid(entry.first) ||
+             !registry.all_of<Transform, vk::Model>(entry.first);
+    });
+  }
+
+  dispatcher.enqueue<UpdateRenderStatsEvent>(mRenderStats);
 }
 
 void VulkanBackend::render_model(const Scene& scene,
                                  const Transform& transform,
-                                 const vk::Model& model)
+                                 const vk::Model& model,
+                                 const Vec3& camera_position,
+                                 Vector<usize>& selected_lods)
 {
   auto& frame = mFrames.at(mFrameIndex);
 
@@ -306,12 +370,61 @@ void VulkanBackend::render_model(const Scene& scene,
 
   const auto model_transform = transform.to_model_matrix();
 
-  for (const auto& mesh : model.meshes) {
+  for (usize mesh_idx = 0; mesh_idx < model.meshes.size(); ++mesh_idx) {
+    const auto& mesh = model.meshes[mesh_idx];
     write_buffer.clear();
 
     const auto& material = scene.get<vk::Material>(mesh.material);
     const auto model_matrix = model_transform * mesh.transform;
 
+    const auto& buffers = *mesh.buffers;
+
+    const auto pipeline = buffers.position_buffer.has_value()
+                              ? mSplitShadingPipeline.get()
+                              : mShadingPipeline.get();
+    if (pipeline != mBoundPipeline) {
+      vkCmdBindPipeline(frame.command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+      mBoundPipeline = pipeline;
+    }
+
+    auto& lod = selected_lods[mesh_idx];
+    lod = mLevelOfDetail ? select_lod(mLodSelector,
+                                      mesh.lods,
+                                      model_matrix,
+                                      mesh.bounds_center,
+                                      mesh.bounds_radius,
+                                      lod)
+                         : 0;
+
+    // Meshlets only cover the full detail level
+    if (lod != 0) {
+      const auto& mesh_lod = mesh.lods[lod];
+      mRanges.assign(1, IndexRange {mesh_lod.index_offset, mesh_lod.index_count});
+      mRenderStats.triangle_count += mesh.index_count / 3;
+      mRenderStats.submitted_triangle_count += mesh_lod.index_count / 3;
+      ++mRenderStats.lod_mesh_count;
+    }
+    else if (mMeshletCulling && !mesh.meshlets.empty()) {
+      // The shading pipeline always culls back faces
+      const auto local_camera_position =
+          Vec3 {glm::inverse(model_matrix) * Vec4 {camera_position, 1}};
+      cull_meshlets(mesh.meshlets,
+                    mStaticMatrices.view_proj * model_matrix,
+                    local_camera_position,
+                    has_uniform_scale(model_matrix),
+                    mRanges,
+                    mRenderStats);
+    }
+    else {
+      mRanges.assign(1, IndexRange {0, mesh.index_count});
+      mRenderStats.triangle_count += mesh.index_count / 3;
+      mRenderStats.submitted_triangle_count += mesh.index_count / 3;
+    }
+
+    if (mRanges.empty()) {
+      continue;
+    }
+
     vkCmdPushConstants(frame.command_buffer,
                        mShadingPipelineLayout.get(),
                        VK_SHADER_STAGE_VERTEX_BIT,
@@ -353,10 +466,33 @@ void VulkanBackend::render_model(const Scene& scene,
                              vk::u32_size(write_buffer),
                              write_buffer.data());
 
-    mesh.vertex_buffer->bind_as_vertex_buffer(frame.command_buffer);
-    mesh.index_buffer->bind_as_index_buffer(frame.command_buffer, VK_INDEX_TYPE_UINT32);
+    if (buffers.position_buffer.has_value()) {
+      buffers.position_buffer->bind_as_vertex_buffer(frame.command_buffer, 0);
+      buffers.vertex_buffer->bind_as_vertex_buffer(frame.command_buffer, 1);
+    }
+    else {
+      buffers.vertex_buffer->bind_as_vertex_buffer(frame.command_buffer);
+    }
+
+    buffers.index_buffer->bind_as_index_buffer(frame.command_buffer, mesh.index_type);
+
+    for (const auto& range : mRanges) {
+      vkCmdDrawIndexed(frame.command_buffer, range.count, 1, range.offset, 0, 0);
+    }
+
+    mRenderStats.draw_count += mRanges.size();
+
+    const auto pixels_per_uv = get_pixels_per_unit(mLodSelector,
+                                                   model_matrix,
+                                                   mesh.bounds_center,
+                                                   mesh.bounds_radius) /
+                               mesh.uv_density;
 
-    vkCmdDrawIndexed(frame.command_buffer, mesh.index_count, 1, 0, 0, 0);
+    for (const auto& stream : {material.diffuse_stream, material.specular_stream}) {
+      if (stream.has_value()) {
+        mTextureRequests.push_back(TextureRequest {*stream, pixels_per_uv});
+      }
+    }
   }
 }
 
@@ -450,20 +586,42 @@ void VulkanBackend::push_static_matrix_descriptor()
                            writes);
 }
 
-void VulkanBackend::set_environment_texture([[maybe_unused]] Scene& scene,
-                                            [[maybe_unused]] const Path& path)
+void VulkanBackend::set_environment_texture(
+    [[maybe_unused]] Scene& scene,
+    [[maybe_unused]] const Path& path,
+    [[maybe_unused]] const EnvironmentQuality quality)
 {
   // TODO
 }
 
-void VulkanBackend::load_model(Scene& scene, const Path& path)
+auto VulkanBackend::load_model(Scene& scene,
+                               FrameScheduler& scheduler,
+                               Path path,
+                               const ImportOptions options) -> Task<>
 {
   static int index = 0;
 
   const auto model_entity = scene.make_node(fmt::format("Model {}", index));
-  vk::assign_model(scene, model_entity, path);
-
   ++index;
+
+  return vk::assign_model(scene, scheduler, model_entity, std::move(path), options);
+}
+
+auto VulkanBackend::reload_model(Scene& scene,
+                                 FrameScheduler& scheduler,
+                                 const Entity entity) -> Task<>
+{
+  co_await vk::reload_model(scene, scheduler, entity);
+
+  // The selected levels refer to the previous meshes
+  mSelectedLods.erase(entity);
+}
+
+auto VulkanBackend::reload_texture(Scene& scene,
+                                   FrameScheduler& scheduler,
+                                   Path path) -> Task<>
+{
+  return vk::reload_texture(scene, scheduler, std::move(path));
 }
 
 }  // namespace glow
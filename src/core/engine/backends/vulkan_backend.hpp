@@ -5,9 +5,15 @@
 
 #include "common/predef.hpp"
 #include "common/primitives.hpp"
+#include "common/type/ecs.hpp"
+#include "common/type/map.hpp"
 #include "common/type/vector.hpp"
 #include "engine/backend.hpp"
 #include "graphics/camera.hpp"
+#include "graphics/culling.hpp"
+#include "graphics/lod.hpp"
+#include "graphics/render_stats.hpp"
+#include "graphics/texture_streaming.hpp"
 #include "graphics/vulkan/allocator.hpp"
 #include "graphics/vulkan/buffer.hpp"
 #include "graphics/vulkan/command_pool.hpp"
@@ -52,15 +58,28 @@ class VulkanBackend final : public Backend {
 
   void on_event(const SDL_Event& event) override;
 
+  void update_textures(Scene& scene) override;
+
   auto begin_frame(const Scene& scene) -> Result override;
 
   void end_frame() override;
 
   void render_scene(const Scene& scene, Dispatcher& dispatcher) override;
 
-  void set_environment_texture(Scene& scene, const Path& path) override;
+  void set_environment_texture(Scene& scene,
+                               const Path& path,
+                               EnvironmentQuality quality) override;
+
+  auto load_model(Scene& scene,
+                  FrameScheduler& scheduler,
+                  Path path,
+                  ImportOptions options) -> Task<> override;
+
+  auto reload_model(Scene& scene, FrameScheduler& scheduler, Entity entity)
+      -> Task<> override;
 
-  void load_model(Scene& scene, const Path& path) override;
+  auto reload_texture(Scene& scene, FrameScheduler& scheduler, Path path)
+      -> Task<> override;
 
   [[nodiscard]] auto should_quit() const -> bool override { return mQuit; }
 
@@ -80,10 +99,19 @@ class VulkanBackend final : public Backend {
   vk::DescriptorSetLayoutPtr mShadingDescriptorSetLayout;
   vk::PipelineLayoutPtr mShadingPipelineLayout;
   vk::PipelinePtr mShadingPipeline;
+  vk::PipelinePtr mSplitShadingPipeline;
+  VkPipeline mBoundPipeline {VK_NULL_HANDLE};
   Vector<vk::FrameData> mFrames;
   usize mFrameIndex {0};
   vk::MaterialBuffer mMaterialBuffer;
   vk::StaticMatrices mStaticMatrices;
+  Vector<IndexRange> mRanges;
+  HashMap<Entity, Vector<usize>> mSelectedLods;  ///< Current LOD of each model mesh.
+  Vector<TextureRequest> mTextureRequests;        ///< Textures drawn during the frame.
+  LodSelector mLodSelector;
+  RenderStats mRenderStats;
+  bool mMeshletCulling {true};
+  bool mLevelOfDetail {true};
   bool mQuit {false};
   bool mResizedFramebuffer : 1 {false};
 
@@ -99,7 +127,9 @@ class VulkanBackend final : public Backend {
 
   void render_model(const Scene& scene,
                     const Transform& transform,
-                    const vk::Model& model);
+                    const vk::Model& model,
+                    const Vec3& camera_position,
+                    Vector<usize>& selected_lods);
 
   void present_image();
 };
@@ -3,6 +3,7 @@
 #include <algorithm>  // min
 #include <utility>    // move
 
+#include <fmt/chrono.h>
 #include <imgui.h>
 #include <imgui_internal.h>
 #include <spdlog/spdlog.h>
@@ -12,14 +13,20 @@
 
 #include "common/debug/error.hpp"
 #include "common/type/math.hpp"
+#include "common/type/vector.hpp"
 #include "engine/backend.hpp"
 #include "graphics/camera.hpp"
 #include "graphics/environment.hpp"
 #include "graphics/rendering_options.hpp"
+#include "graphics/texture_streaming.hpp"
+#include "io/file_watcher.hpp"
+#include "io/files.hpp"
+#include "scene/asset_source.hpp"
 #include "scene/transform.hpp"
 #include "ui/camera_options.hpp"
 #include "ui/menu_bar.hpp"
 #include "ui/scene_tree_dock.hpp"
+#include "util/thread_pool.hpp"
 
 namespace glow {
 namespace {
@@ -47,6 +54,7 @@ Engine::Engine(const GraphicsAPI api)
   spdlog::debug("[Engine] Counter frequency: {:L}", mCounterFreq);
   spdlog::debug("[Engine] Fixed delta: {:.4f}", mFixedDelta);
   spdlog::debug("[Engine] Max ticks per frame: {}", mMaxTicksPerFrame);
+  spdlog::debug("[Engine] Load budget per frame: {}", mLoadBudget);
 
   SDL_MaximizeWindow(mWindow);
   SDL_ShowWindow(mWindow);
@@ -89,6 +97,8 @@ void Engine::register_events()
   mDispatcher.sink<ShowDemoWindowEvent>().connect<&Engine::on_show_demo_window>(this);
 
   mDispatcher.sink<ToggleRenderingOptionEvent>().connect<&Engine::on_toggle_rendering_option>(this);
+  mDispatcher.sink<UpdateRenderStatsEvent>().connect<&Engine::on_update_render_stats>(this);
+  mDispatcher.sink<SetTextureBudgetEvent>().connect<&Engine::on_set_texture_budget>(this);
   // clang-format on
 }
 
@@ -145,9 +155,15 @@ void Engine::start()
       last_framebuffer_scale = fb_scale;
     }
 
+    reload_changed_assets();
+
+    // Resume pending asynchronous work, e.g. model loading, within a fixed budget
+    mScheduler.run(mLoadBudget);
+
     render();
   }
 
+  mScheduler.stop();
   mBackend->on_quit();
 
   SDL_HideWindow(mWindow);
@@ -201,6 +217,8 @@ void Engine::update_camera_position(const float32 dt)
 
 void Engine::render()
 {
+  mBackend->update_textures(mScene);
+
   if (mBackend->begin_frame(mScene).failed()) {
     spdlog::error("[Engine] Skipping frame");
     return;
@@ -436,19 +454,89 @@ void Engine::on_toggle_rendering_option(const ToggleRenderingOptionEvent& event)
   value = !value;
 }
 
+void Engine::on_update_render_stats(const UpdateRenderStatsEvent& event)
+{
+  mScene.get<RenderStats>() = event.stats;
+}
+
+void Engine::on_set_texture_budget(const SetTextureBudgetEvent& event)
+{
+  spdlog::trace("SetTextureBudgetEvent");
+  set_texture_budget(event.budget);
+}
+
 void Engine::set_backend(Unique<Backend> backend)
 {
   mBackend = std::move(backend);
 }
 
-void Engine::set_environment_texture(const Path& path)
+void Engine::set_environment_texture(const Path& path, const EnvironmentQuality quality)
 {
-  mBackend->set_environment_texture(mScene, path);
+  mBackend->set_environment_texture(mScene, path, quality);
+}
+
+void Engine::set_texture_budget(const usize budget)
+{
+  mScene.get<TextureStreamer>().set_budget(budget);
+}
+
+void Engine::load_model(const Path& path, const ImportOptions& options)
+{
+  mScheduler.spawn(mBackend->load_model(mScene, mScheduler, path, options));
+}
+
+void Engine::reload_changed_assets()
+{
+  for (auto& path : mScene.get<FileWatcher>().poll()) {
+    mScheduler.spawn(reload_changed_asset(std::move(path)));
+  }
 }
 
-void Engine::load_model(const Path& path)
+auto Engine::reload_changed_asset(Path path) -> Task<>
 {
-  mBackend->load_model(mScene, path);
+  co_await get_thread_pool().schedule();
+
+  // The file might be missing or incomplete, in which case another event follows
+  const auto content = hash_file(path);
+
+  co_await mScheduler.schedule();
+
+  if (mScheduler.is_stopping() || !content.has_value()) {
+    co_return;
+  }
+
+  if (!mScene.get<FileWatcher>().update_content(path, *content)) {
+    co_return;
+  }
+
+  Vector<Entity> model_entities;
+  for (const auto& [entity, source] : mScene.each<ModelSource>()) {
+    if (source.path == path) {
+      model_entities.push_back(entity);
+    }
+  }
+
+  bool is_texture = false;
+  for (const auto& [entity, source] : mScene.each<MaterialSource>()) {
+    if (source.uses_texture(path)) {
+      is_texture = true;
+      break;
+    }
+  }
+
+  if (model_entities.empty() && !is_texture) {
+    co_return;
+  }
+
+  spdlog::info("[Engine] Detected change to {}", path.string());
+
+  for (const auto entity : model_entities) {
+    mScheduler.spawn(mBackend->reload_model(mScene, mScheduler, entity));
+  }
+
+  if (is_texture) {
+    mScheduler.spawn(mBackend->reload_texture(mScene, mScheduler, path));
+  }
 }
 
 auto Engine::query_counter() const -> float64
@@ -9,8 +9,12 @@
 #include "common/type/math.hpp"
 #include "common/type/memory.hpp"
 #include "common/type/path.hpp"
+#include "common/type/chrono.hpp"
 #include "engine/engine_initializer.hpp"
+#include "engine/frame_scheduler.hpp"
 #include "graphics/graphics_api.hpp"
+#include "io/hdr_texture.hpp"
+#include "io/import_options.hpp"
 #include "scene/scene.hpp"
 #include "ui/events.hpp"
 
@@ -28,9 +32,12 @@ class Engine final {
 
   void set_backend(Unique<Backend> backend);
 
-  void set_environment_texture(const Path& path);
+  void set_environment_texture(const Path& path, EnvironmentQuality quality);
 
-  void load_model(const Path& path);
+  /// Sets the GPU memory budget for the mip levels of model textures, in bytes.
+  void set_texture_budget(usize budget);
+
+  void load_model(const Path& path, const ImportOptions& options);
 
   [[nodiscard]] auto get_window() -> SDL_Window* { return mWindow; }
 
@@ -41,6 +48,8 @@ class Engine final {
   float64 mFixedDelta {};
   int32 mMaxTicksPerFrame {5};
   Unique<Backend> mBackend;
+  FrameScheduler mScheduler;
+  Microseconds mLoadBudget {4'000};
   Scene mScene;
   Dispatcher mDispatcher;
   Vec2i mViewportSize {};
@@ -55,6 +64,17 @@ class Engine final {
 
   void render();
 
+  /// Checks the asset files whose sizes or modification times have changed.
+  void reload_changed_assets();
+
+  /// Reloads the models and textures that use a file, if its contents have changed.
+  ///
+  /// \details
+  /// The file is hashed on a worker thread, so that large files don't stall the frame.
+  ///
+  /// \param path the normalized path of the file.
+  [[nodiscard]] auto reload_changed_asset(Path path) -> Task<>;
+
   void register_events();
 
   void on_quit(const QuitEvent&);
@@ -104,6 +124,10 @@ class Engine final {
 
   void on_toggle_rendering_option(const ToggleRenderingOptionEvent& event);
 
+  void on_update_render_stats(const UpdateRenderStatsEvent& event);
+
+  void on_set_texture_budget(const SetTextureBudgetEvent& event);
+
   [[nodiscard]] auto query_counter() const -> float64;
 };
 
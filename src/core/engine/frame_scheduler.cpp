@@ -0,0 +1,80 @@
+#include "frame_scheduler.hpp"
+
+#include <thread>   // this_thread
+#include <utility>  // move
+
+#include <spdlog/spdlog.h>
+
+#include "common/debug/assert.hpp"
+
+namespace glow {
+
+FrameScheduler::~FrameScheduler() noexcept
+{
+  GLOW_ASSERT_MSG(mPendingTaskCount == 0, "Frame scheduler destroyed with pending tasks");
+}
+
+void FrameScheduler::enqueue(const std::coroutine_handle<> handle)
+{
+  const std::lock_guard lock {mMutex};
+  mQueue.push_back(handle);
+}
+
+void FrameScheduler::spawn(Task<void> task)
+{
+  ++mPendingTaskCount;
+  glow::spawn(std::move(task), [this] { --mPendingTaskCount; });
+}
+
+void FrameScheduler::run(const Microseconds budget)
+{
+  mDeadline = SteadyClock::now() + budget;
+
+  // Coroutines that are scheduled while we're running are appended to the queue, so
+  // we only process the coroutines that were scheduled when this function was called.
+  usize remaining = 0;
+  {
+    const std::lock_guard lock {mMutex};
+    remaining = mQueue.size();
+  }
+
+  while (remaining > 0) {
+    std::coroutine_handle<> handle;
+
+    {
+      const std::lock_guard lock {mMutex};
+      handle = mQueue.front();
+      mQueue.pop_front();
+    }
+
+    handle.resume();
+    --remaining;
+
+    if (is_over_budget()) {
+      break;
+    }
+  }
+}
+
+void FrameScheduler::stop()
+{
+  mStopping = true;
+
+  if (mPendingTaskCount != 0) {
+    spdlog::debug("[Engine] Waiting for {} pending tasks", mPendingTaskCount.load());
+  }
+
+  // Tasks might still be executing on worker threads, in which case we need to wait
+  // for them to get back to the main thread before they can finish.
+  while (mPendingTaskCount != 0) {
+    run(Milliseconds {100});
+    std::this_thread::yield();
+  }
+}
+
+auto FrameScheduler::is_over_budget() const noexcept -> bool
+{
+  return SteadyClock::now() >= mDeadline;
+}
+
+}  // namespace glow
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>     // atomic
+#include <coroutine>  // coroutine_handle
+#include <deque>      // deque
+#include <mutex>      // mutex
+
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/chrono.hpp"
+#include "util/task.hpp"
+
+namespace glow {
+
+/// Executes coroutines on the main (render) thread, in between frames.
+///
+/// \details
+/// Coroutines move to the main thread by awaiting `schedule()`, and are then resumed
+/// during the next call to `run()`. Each call to `run()` is restricted by a time
+/// budget, so long-running tasks should periodically await `yield_if_over_budget()`
+/// to spread their work over several frames.
+class FrameScheduler final {
+ public:
+  using SteadyClock = chrono::steady_clock;
+
+  GLOW_DELETE_COPY(FrameScheduler);
+  GLOW_DELETE_MOVE(FrameScheduler);
+
+  FrameScheduler() = default;
+
+  ~FrameScheduler() noexcept;
+
+  /// Returns an awaitable that resumes the awaiting coroutine on the main thread.
+  [[nodiscard]] auto schedule() noexcept
+  {
+    struct Awaiter final {
+      FrameScheduler* scheduler {};
+
+      [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+      void await_suspend(const std::coroutine_handle<> handle)
+      {
+        scheduler->enqueue(handle);
+      }
+
+      void await_resume() const noexcept {}
+    };
+
+    return Awaiter {this};
+  }
+
+  /// Returns an awaitable that suspends the awaiting coroutine until the next frame,
+  /// but only if the time budget of the current frame has been used up.
+  ///
+  /// \pre This must only be awaited by coroutines running on the main thread.
+  [[nodiscard]] auto yield_if_over_budget() noexcept
+  {
+    struct Awaiter final {
+      FrameScheduler* scheduler {};
+
+      [[nodiscard]] auto await_ready() const noexcept -> bool
+      {
+        return !scheduler->is_over_budget();
+      }
+
+      void await_suspend(const std::coroutine_handle<> handle)
+      {
+        scheduler->enqueue(handle);
+      }
+
+      void await_resume() const noexcept {}
+    };
+
+    return Awaiter {this};
+  }
+
+  /// Starts a task, which is considered pending until it has finished.
+  void spawn(Task<void> task);
+
+  /// Resumes scheduled coroutines until there are none left or the budget is spent.
+  ///
+  /// \details
+  /// At least one coroutine is resumed per call (if any are scheduled), to guarantee
+  /// progress regardless of the budget.
+  ///
+  /// \param budget the maximum amount of time to spend resuming coroutines.
+  void run(Microseconds budget);
+
+  /// Requests all pending tasks to stop, and waits for them to finish.
+  ///
+  /// \details
+  /// Tasks are expected to check `is_stopping()` after each suspension point, and
+  /// return early if it returns true.
+  void stop();
+
+  [[nodiscard]] auto is_stopping() const noexcept -> bool { return mStopping; }
+
+  [[nodiscard]] auto is_over_budget() const noexcept -> bool;
+
+  [[nodiscard]] auto get_pending_task_count() const noexcept -> usize
+  {
+    return mPendingTaskCount;
+  }
+
+ private:
+  std::mutex mMutex;
+  std::deque<std::coroutine_handle<>> mQueue;
+  SteadyClock::time_point mDeadline {};
+  std::atomic<usize> mPendingTaskCount {0};
+  std::atomic<bool> mStopping {false};
+
+  void enqueue(std::coroutine_handle<> handle);
+};
+
+}  // namespace glow
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "common/primitives.hpp"
+
+namespace glow {
+
+/// Context component with statistics about GPU resources shared by content.
+///
+/// \details
+/// Textures and meshes are identified by the hashes of their contents, so that
+/// duplicated assets share GPU resources, even if they're stored in different files.
+struct AssetStats final {
+  usize texture_hits {};    ///< The number of textures that reused a GPU texture.
+  usize texture_misses {};  ///< The number of textures that required a new GPU texture.
+  usize mesh_hits {};       ///< The number of meshes that reused existing GPU buffers.
+  usize mesh_misses {};     ///< The number of meshes that required new GPU buffers.
+  usize saved_bytes {};     ///< The amount of GPU memory saved by sharing, in bytes.
+};
+
+}  // namespace glow
@@ -0,0 +1,106 @@
+#include "culling.hpp"
+
+#include <cmath>  // abs
+
+namespace glow {
+namespace {
+
+// Tolerance used to determine whether the scale factors of a transform are equal.
+inline constexpr float kUniformScaleTolerance = 0.01f;
+
+[[nodiscard]] auto _is_backfacing(const Meshlet& meshlet, const Vec3& camera_position)
+    -> bool
+{
+  const auto view_dir = meshlet.center - camera_position;
+  const auto distance = glm::length(view_dir);
+
+  return glm::dot(view_dir, meshlet.cone_axis) >=
+         meshlet.cone_cutoff * distance + meshlet.radius;
+}
+
+}  // namespace
+
+auto extract_frustum(const Mat4& clip_matrix) -> Frustum
+{
+  // See "Fast Extraction of Viewing Frustum Planes from the World-View-Projection
+  // Matrix" by Gribb and Hartmann. GLM matrices are column-major, so we transpose the
+  // matrix to be able to access the rows.
+  const auto rows = glm::transpose(clip_matrix);
+
+  Frustum frustum;
+  frustum.planes[0] = rows[3] + rows[0];  // Left
+  frustum.planes[1] = rows[3] - rows[0];  // Right
+  frustum.planes[2] = rows[3] + rows[1];  // Bottom
+  frustum.planes[3] = rows[3] - rows[1];  // Top
+  frustum.planes[4] = rows[3] + rows[2];  // Near
+  frustum.planes[5] = rows[3] - rows[2];  // Far
+
+  for (auto& plane : frustum.planes) {
+    const auto normal_length = glm::length(Vec3 {plane});
+    if (normal_length > 0.0f) {
+      plane /= normal_length;
+    }
+  }
+
+  return frustum;
+}
+
+auto intersects(const Frustum& frustum, const Vec3& center, const float radius) -> bool
+{
+  for (const auto& plane : frustum.planes) {
+    if (glm::dot(Vec3 {plane}, center) + plane.w < -radius) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+auto has_uniform_scale(const Mat4& transform) -> bool
+{
+  const auto scale_x = glm::length(Vec3 {transform[0]});
+  const auto scale_y = glm::length(Vec3 {transform[1]});
+  const auto scale_z = glm::length(Vec3 {transform[2]});
+
+  const auto tolerance = kUniformScaleTolerance * scale_x;
+  return std::abs(scale_x - scale_y) <= tolerance &&
+         std::abs(scale_x - scale_z) <= tolerance;
+}
+
+void cull_meshlets(const Vector<Meshlet>& meshlets,
+                   const Mat4& mvp,
+                   const Vec3& camera_position,
+                   const bool cull_backfaces,
+                   Vector<IndexRange>& ranges,
+                   RenderStats& stats)
+{
+  ranges.clear();
+
+  const auto frustum = extract_frustum(mvp);
+
+  for (const auto& meshlet : meshlets) {
+    ++stats.meshlet_count;
+    stats.triangle_count += meshlet.index_count / 3;
+
+    if (!intersects(frustum, meshlet.center, meshlet.radius)) {
+      continue;
+    }
+
+    if (cull_backfaces && _is_backfacing(meshlet, camera_position)) {
+      continue;
+    }
+
+    ++stats.visible_meshlet_count;
+    stats.submitted_triangle_count += meshlet.index_count / 3;
+
+    if (!ranges.empty() &&
+        ranges.back().offset + ranges.back().count == meshlet.index_offset) {
+      ranges.back().count += meshlet.index_count;
+    }
+    else {
+      ranges.push_back(IndexRange {meshlet.index_offset, meshlet.index_count});
+    }
+  }
+}
+
+}  // namespace glow
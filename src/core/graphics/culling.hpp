@@ -0,0 +1,60 @@
+#pragma once
+
+#include "common/primitives.hpp"
+#include "common/type/array.hpp"
+#include "common/type/math.hpp"
+#include "common/type/vector.hpp"
+#include "graphics/render_stats.hpp"
+#include "io/model_loader.hpp"
+
+namespace glow {
+
+/// A contiguous range of indices that is submitted in a single draw.
+struct IndexRange final {
+  uint32 offset {};  ///< Offset to the first index.
+  uint32 count {};   ///< The number of indices.
+};
+
+/// A view frustum, represented by six planes with normals pointing inwards.
+struct Frustum final {
+  Array<Vec4, 6> planes {};
+};
+
+/// Extracts the frustum planes from a clip matrix.
+///
+/// \details
+/// The planes are expressed in the space that the matrix transforms from, e.g. mesh
+/// space for a model-view-projection matrix. The near plane assumes a [-1, 1] depth
+/// range, which is conservative for APIs that use a [0, 1] depth range.
+///
+/// \param clip_matrix a matrix that transforms coordinates into clip space.
+[[nodiscard]] auto extract_frustum(const Mat4& clip_matrix) -> Frustum;
+
+/// Indicates whether a sphere is at least partially inside a frustum.
+[[nodiscard]] auto intersects(const Frustum& frustum, const Vec3& center, float radius)
+    -> bool;
+
+/// Indicates whether a transform scales all axes equally, i.e. preserves angles.
+[[nodiscard]] auto has_uniform_scale(const Mat4& transform) -> bool;
+
+/// Culls the meshlets of a mesh, and determines the index ranges that should be drawn.
+///
+/// \details
+/// Meshlets are culled if their bounding spheres are outside the view frustum, or if
+/// their normal cones show that all of their triangles are facing away from the camera.
+/// Adjacent visible meshlets are merged into a single index range.
+///
+/// \param meshlets the meshlets of the mesh.
+/// \param mvp the model-view-projection matrix used to render the mesh.
+/// \param camera_position the camera position, in mesh space.
+/// \param cull_backfaces whether to use the normal cones to cull back-facing meshlets.
+/// \param ranges the output vector for the visible index ranges, cleared first.
+/// \param stats the meshlet and triangle statistics that will be updated.
+void cull_meshlets(const Vector<Meshlet>& meshlets,
+                   const Mat4& mvp,
+                   const Vec3& camera_position,
+                   bool cull_backfaces,
+                   Vector<IndexRange>& ranges,
+                   RenderStats& stats);
+
+}  // namespace glow
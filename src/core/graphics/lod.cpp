@@ -0,0 +1,92 @@
+#include "lod.hpp"
+
+#include <algorithm>  // max
+#include <cmath>      // abs
+#include <limits>     // numeric_limits
+
+namespace glow {
+namespace {
+
+// The largest acceptable simplification error of a level of detail, in pixels.
+inline constexpr float kMaxLodPixelError = 1.0f;
+
+// Coarser levels must have errors this much smaller than the limit to be selected.
+inline constexpr float kLodHysteresis = 0.25f;
+
+[[nodiscard]] auto _get_max_scale(const Mat4& transform) -> float
+{
+  return std::max({glm::length(Vec3 {transform[0]}),
+                   glm::length(Vec3 {transform[1]}),
+                   glm::length(Vec3 {transform[2]})});
+}
+
+}  // namespace
+
+auto make_lod_selector(const Mat4& projection,
+                       const Vec3& camera_position,
+                       const float viewport_height,
+                       const bool hysteresis) -> LodSelector
+{
+  // The second diagonal element is the cotangent of half the vertical field of view,
+  // which may be negated to flip the Y-axis.
+  LodSelector selector;
+  selector.camera_position = camera_position;
+  selector.projection_scale = std::abs(projection[1][1]) * viewport_height * 0.5f;
+  selector.hysteresis = hysteresis;
+  return selector;
+}
+
+auto get_pixels_per_unit(const LodSelector& selector,
+                         const Mat4& model_matrix,
+                         const Vec3& center,
+                         const float radius) -> float
+{
+  const auto world_center = Vec3 {model_matrix * Vec4 {center, 1}};
+  const auto max_scale = _get_max_scale(model_matrix);
+  const auto distance = glm::distance(world_center, selector.camera_position);
+
+  if (distance <= radius * max_scale) {
+    return std::numeric_limits<float>::max();
+  }
+
+  return max_scale / distance * selector.projection_scale;
+}
+
+auto select_lod(const LodSelector& selector,
+                const Vector<MeshLod>& lods,
+                const Mat4& model_matrix,
+                const Vec3& center,
+                const float radius,
+                const usize current_lod) -> usize
+{
+  if (lods.size() < 2 || radius <= 0.0f) {
+    return 0;
+  }
+
+  const auto pixels_per_unit =
+      get_pixels_per_unit(selector, model_matrix, center, radius);
+
+  // Use full detail when the camera is inside the bounding sphere
+  if (pixels_per_unit == std::numeric_limits<float>::max()) {
+    return 0;
+  }
+
+  usize selected_lod = 0;
+
+  for (usize lod = 1; lod < lods.size(); ++lod) {
+    const auto max_error = (selector.hysteresis && lod > current_lod)
+                               ? kMaxLodPixelError * (1.0f - kLodHysteresis)
+                               : kMaxLodPixelError;
+
+    // The errors never decrease, so the remaining levels are worse
+    if (lods[lod].error * pixels_per_unit > max_error) {
+      break;
+    }
+
+    selected_lod = lod;
+  }
+
+  return selected_lod;
+}
+
+}  // namespace glow
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "common/primitives.hpp"
+#include "common/type/math.hpp"
+#include "common/type/vector.hpp"
+#include "io/model_loader.hpp"
+
+namespace glow {
+
+/// Per-frame parameters used to select the levels of detail of meshes.
+struct LodSelector final {
+  Vec3 camera_position {};    ///< The camera position, in world space.
+  float projection_scale {};  ///< Projected size in pixels of one unit at unit distance.
+  bool hysteresis {};         ///< Whether to delay switches to coarser levels.
+};
+
+/// Creates the parameters used to select levels of detail for a frame.
+///
+/// \param projection the projection matrix of the camera.
+/// \param camera_position the camera position, in world space.
+/// \param viewport_height the height of the viewport, in pixels.
+/// \param hysteresis whether to avoid popping when meshes hover around a threshold.
+[[nodiscard]] auto make_lod_selector(const Mat4& projection,
+                                     const Vec3& camera_position,
+                                     float viewport_height,
+                                     bool hysteresis) -> LodSelector;
+
+/// Returns the projected size of one mesh space unit, in pixels.
+///
+/// \details
+/// The size is computed at the distance of the bounding sphere of the mesh. If the
+/// camera is inside the bounding sphere, the largest finite float value is returned.
+///
+/// \param selector the level of detail selection parameters.
+/// \param model_matrix the transform from mesh space to world space.
+/// \param center the center of the bounding sphere of the mesh, in mesh space.
+/// \param radius the radius of the bounding sphere of the mesh, in mesh space.
+[[nodiscard]] auto get_pixels_per_unit(const LodSelector& selector,
+                                       const Mat4& model_matrix,
+                                       const Vec3& center,
+                                       float radius) -> float;
+
+/// Selects the coarsest level of detail of a mesh with an acceptable error on screen.
+///
+/// \details
+/// The bounding sphere of the mesh is projected onto the screen, and the error of each
+/// level is scaled accordingly, relative to the radius of the sphere. Levels with a
+/// projected error of at most a pixel are considered acceptable. With hysteresis
+/// enabled, coarser levels than the current one must have a noticeably smaller error.
+///
+/// \param selector the level of detail selection parameters.
+/// \param lods the levels of detail of the mesh, may be empty.
+/// \param model_matrix the transform from mesh space to world space.
+/// \param center the center of the bounding sphere of the mesh, in mesh space.
+/// \param radius the radius of the bounding sphere of the mesh, in mesh space.
+/// \param current_lod the previously selected level of the mesh.
+///
+/// \return the index of the selected level.
+[[nodiscard]] auto select_lod(const LodSelector& selector,
+                              const Vector<MeshLod>& lods,
+                              const Mat4& model_matrix,
+                              const Vec3& center,
+                              float radius,
+                              usize current_lod) -> usize;
+
+}  // namespace glow
@@ -5,6 +5,7 @@
 #include "common/debug/assert.hpp"
 #include "common/debug/error.hpp"
 #include "common/type/vector.hpp"
+#include "graphics/opengl/state_cache.hpp"
 #include "graphics/opengl/util.hpp"
 
 namespace glow::gl {
@@ -29,6 +30,7 @@ void Buffer::dispose() noexcept
 {
   if (mID != 0) {
     glDeleteBuffers(1, &mID);
+    get_state_cache().forget_buffer(mID);
   }
 }
 
@@ -57,13 +59,13 @@ auto Buffer::operator=(Buffer&& other) noexcept -> Buffer&
 
 void Buffer::bind() const
 {
-  glBindBuffer(mType, mID);
+  get_state_cache().bind_buffer(mType, mID);
   GLOW_GL_CHECK_ERRORS();
 }
 
 void Buffer::unbind() const
 {
-  glBindBuffer(mType, 0);
+  get_state_cache().bind_buffer(mType, 0);
   GLOW_GL_CHECK_ERRORS();
 }
 
@@ -71,7 +73,7 @@ void Buffer::bind_block(const int binding)
 {
   GLOW_ASSERT(mType == GL_UNIFORM_BUFFER);
 
-  glBindBufferBase(mType, binding, mID);
+  get_state_cache().bind_uniform_buffer_base(static_cast<uint>(binding), mID);
   GLOW_GL_CHECK_ERRORS();
 }
 
@@ -79,7 +81,7 @@ void Buffer::unbind_block(const int binding)
 {
   GLOW_ASSERT(mType == GL_UNIFORM_BUFFER);
 
-  glBindBufferBase(mType, binding, 0);
+  get_state_cache().bind_uniform_buffer_base(static_cast<uint>(binding), 0);
   GLOW_GL_CHECK_ERRORS();
 }
 
@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 
 #include "common/debug/error.hpp"
+#include "graphics/opengl/state_cache.hpp"
 
 namespace glow::gl {
 
@@ -22,6 +23,9 @@ Context::Context(SDL_Window* window)
   if (!gladLoadGLLoader(SDL_GL_GetProcAddress)) {
     throw Error {"[GL] Failed to initialize GLAD"};
   }
+
+  // State tracked for a previous context does not apply to the new one
+  get_state_cache().invalidate();
 }
 
 }  // namespace glow::gl
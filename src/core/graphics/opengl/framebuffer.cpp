@@ -5,6 +5,7 @@
 #include <glad/glad.h>
 
 #include "common/debug/assert.hpp"
+#include "graphics/opengl/state_cache.hpp"
 #include "graphics/opengl/util.hpp"
 
 namespace glow::gl {
@@ -66,17 +67,18 @@ void Framebuffer::dispose() noexcept
 {
   if (mID != 0) {
     glDeleteFramebuffers(1, &mID);
+    get_state_cache().forget_framebuffer(mID);
   }
 }
 
 void Framebuffer::bind() const
 {
-  glBindFramebuffer(GL_FRAMEBUFFER, mID);
+  get_state_cache().bind_framebuffer(GL_FRAMEBUFFER, mID);
 }
 
 void Framebuffer::unbind()
 {
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  get_state_cache().bind_framebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Framebuffer::resize(const Vec2i size)
@@ -0,0 +1,251 @@
+#include "geometry_pool.hpp"
+
+#include <algorithm>  // max
+#include <numeric>    // iota
+#include <utility>    // move
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include "common/debug/assert.hpp"
+#include "common/type/array.hpp"
+#include "graphics/opengl/shader_buffers.hpp"
+#include "graphics/opengl/state_cache.hpp"
+#include "graphics/opengl/util.hpp"
+
+namespace glow::gl {
+namespace {
+
+// The initial capacities of pools, which double whenever they run out of space.
+inline constexpr usize kInitialVertexCount = 64 * 1'024;
+inline constexpr usize kInitialIndexCount = 256 * 1'024;
+
+[[nodiscard]] auto _get_grown_capacity(const usize capacity,
+                                       const usize required,
+                                       const usize initial) -> usize
+{
+  return std::max({capacity * 2, capacity + required, initial});
+}
+
+/// Replaces a buffer with a larger one, keeping the contents of the old buffer.
+///
+/// \details
+/// Without direct state access, the copy targets are used, since binding an index buffer
+/// would modify the bound VAO.
+template <typename Buffer>
+void _grow_buffer(Buffer& buffer, const usize old_size, const usize new_size)
+{
+  Buffer new_buffer;
+
+  if (has_direct_state_access()) {
+    glNamedBufferData(new_buffer.get_id(),
+                      static_cast<GLsizeiptr>(new_size),
+                      nullptr,
+                      GL_STATIC_DRAW);
+
+    if (old_size != 0) {
+      glCopyNamedBufferSubData(buffer.get_id(),
+                               new_buffer.get_id(),
+                               0,
+                               0,
+                               static_cast<GLsizeiptr>(old_size));
+    }
+  }
+  else {
+    auto& state_cache = get_state_cache();
+
+    state_cache.bind_buffer(GL_COPY_WRITE_BUFFER, new_buffer.get_id());
+    glBufferData(GL_COPY_WRITE_BUFFER,
+                 static_cast<GLsizeiptr>(new_size),
+                 nullptr,
+                 GL_STATIC_DRAW);
+
+    if (old_size != 0) {
+      state_cache.bind_buffer(GL_COPY_READ_BUFFER, buffer.get_id());
+      glCopyBufferSubData(GL_COPY_READ_BUFFER,
+                          GL_COPY_WRITE_BUFFER,
+                          0,
+                          0,
+                          static_cast<GLsizeiptr>(old_size));
+    }
+  }
+
+  GLOW_GL_CHECK_ERRORS();
+
+  buffer = std::move(new_buffer);
+}
+
+void _write_buffer(const uint buffer_id, const usize offset, std::span<const Byte> data)
+{
+  if (data.empty()) {
+    return;
+  }
+
+  if (has_direct_state_access()) {
+    glNamedBufferSubData(buffer_id,
+                         static_cast<GLintptr>(offset),
+                         static_cast<GLsizeiptr>(data.size()),
+                         data.data());
+  }
+  else {
+    get_state_cache().bind_buffer(GL_COPY_WRITE_BUFFER, buffer_id);
+    glBufferSubData(GL_COPY_WRITE_BUFFER,
+                    static_cast<GLintptr>(offset),
+                    static_cast<GLsizeiptr>(data.size()),
+                    data.data());
+  }
+
+  GLOW_GL_CHECK_ERRORS();
+}
+
+}  // namespace
+
+GeometryPool::GeometryPool(const GeometryPoolKey& key)
+    : mKey {key},
+      mLayout {get_vertex_layout(key.vertex_format)},
+      mSplitLayout {split_vertex_layout(mLayout)},
+      mIndexSize {(key.index_type == GL_UNSIGNED_SHORT) ? sizeof(uint16) : sizeof(uint32)}
+{
+  if (mKey.split_positions) {
+    mPositionVBO.emplace();
+  }
+
+  // Each instance reads its own index, offset by the base instance of the draw call
+  Array<uint32, kMaxInstancesPerDraw> instance_indices;
+  std::iota(instance_indices.begin(), instance_indices.end(), uint32 {0});
+
+  mInstanceIndexVBO.upload_data(sizeof instance_indices, instance_indices.data());
+}
+
+auto GeometryPool::allocate(std::span<const Byte> vertices,
+                            const usize vertex_count,
+                            std::span<const Byte> indices,
+                            const usize index_count) -> GeometryAllocation
+{
+  GLOW_ASSERT(vertices.size() == vertex_count * mLayout.stride);
+  GLOW_ASSERT(indices.size() == index_count * mIndexSize);
+
+  auto first_vertex = mVertexRanges.allocate(vertex_count);
+  auto first_index = mIndexRanges.allocate(index_count);
+
+  if (!first_vertex.has_value()) {
+    grow_vertices(_get_grown_capacity(mVertexRanges.get_capacity(),
+                                      vertex_count,
+                                      kInitialVertexCount));
+    first_vertex = mVertexRanges.allocate(vertex_count);
+  }
+
+  if (!first_index.has_value()) {
+    grow_indices(_get_grown_capacity(mIndexRanges.get_capacity(),
+                                     index_count,
+                                     kInitialIndexCount));
+    first_index = mIndexRanges.allocate(index_count);
+  }
+
+  GLOW_ASSERT(first_vertex.has_value());
+  GLOW_ASSERT(first_index.has_value());
+
+  if (mKey.split_positions) {
+    split_vertex_streams(vertices, mLayout, mPositions, mAttributes);
+
+    _write_buffer(mPositionVBO->get_id(),
+                  *first_vertex * mSplitLayout.positions.stride,
+                  mPositions);
+    _write_buffer(mVBO.get_id(),
+                  *first_vertex * mSplitLayout.attributes.stride,
+                  mAttributes);
+  }
+  else {
+    _write_buffer(mVBO.get_id(), *first_vertex * mLayout.stride, vertices);
+  }
+
+  _write_buffer(mEBO.get_id(), *first_index * mIndexSize, indices);
+
+  return GeometryAllocation {
+      .first_vertex = static_cast<uint32>(*first_vertex),
+      .vertex_count = static_cast<uint32>(vertex_count),
+      .first_index = static_cast<uint32>(*first_index),
+      .index_count = static_cast<uint32>(index_count),
+  };
+}
+
+void GeometryPool::release(const GeometryAllocation& allocation)
+{
+  mVertexRanges.release(allocation.first_vertex, allocation.vertex_count);
+  mIndexRanges.release(allocation.first_index, allocation.index_count);
+}
+
+void GeometryPool::bind() const
+{
+  mVAO.bind();
+}
+
+void GeometryPool::grow_vertices(const usize capacity)
+{
+  const auto old_capacity = mVertexRanges.get_capacity();
+
+  spdlog::debug("[GL] Growing {} geometry pool to {} vertices",
+                get_short_name(mKey.vertex_format),
+                capacity);
+
+  if (mKey.split_positions) {
+    const usize position_stride = mSplitLayout.positions.stride;
+    const usize attribute_stride = mSplitLayout.attributes.stride;
+
+    _grow_buffer(*mPositionVBO,
+                 old_capacity * position_stride,
+                 capacity * position_stride);
+    _grow_buffer(mVBO, old_capacity * attribute_stride, capacity * attribute_stride);
+  }
+  else {
+    _grow_buffer(mVBO, old_capacity * mLayout.stride, capacity * mLayout.stride);
+  }
+
+  mVertexRanges.grow(capacity);
+
+  // The VAO refers to the replaced buffers, so the attributes must be specified again
+  init_vertex_array();
+}
+
+void GeometryPool::grow_indices(const usize capacity)
+{
+  const auto old_capacity = mIndexRanges.get_capacity();
+
+  spdlog::debug("[GL] Growing {} geometry pool to {} indices",
+                get_short_name(mKey.vertex_format),
+                capacity);
+
+  _grow_buffer(mEBO, old_capacity * mIndexSize, capacity * mIndexSize);
+  mIndexRanges.grow(capacity);
+
+  init_vertex_array();
+}
+
+void GeometryPool::init_vertex_array()
+{
+  mVAO.bind();
+
+  if (mKey.split_positions) {
+    mPositionVBO->bind();
+    mVAO.init_layout(mSplitLayout.positions);
+
+    mVBO.bind();
+    mVAO.init_layout(mSplitLayout.attributes);
+  }
+  else {
+    mVBO.bind();
+    mVAO.init_layout(mLayout);
+  }
+
+  mInstanceIndexVBO.bind();
+  mVAO.init_integer_attr(kInstanceIndexLocation, 1, GL_UNSIGNED_INT);
+  mVAO.set_attr_divisor(kInstanceIndexLocation, 1);
+
+  mEBO.bind();
+
+  VertexArray::unbind();
+  VertexBuffer::unbind();
+  IndexBuffer::unbind();
+}
+
+}  // namespace glow::gl
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <span>  // span
+
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/vector.hpp"
+#include "graphics/opengl/index_buffer.hpp"
+#include "graphics/opengl/vertex_array.hpp"
+#include "graphics/opengl/vertex_buffer.hpp"
+#include "graphics/vertex.hpp"
+#include "graphics/vertex_layout.hpp"
+#include "util/range_allocator.hpp"
+
+namespace glow::gl {
+
+/// The vertex attribute location of the instance index, see `GeometryPool`.
+inline constexpr uint kInstanceIndexLocation = 3;
+
+/// Identifies the geometry pool used by meshes with a given buffer layout.
+struct GeometryPoolKey final {
+  VertexFormat vertex_format {};  ///< The format of the vertices.
+  uint index_type {};             ///< GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+  bool split_positions {};        ///< Whether positions are stored in a separate buffer.
+
+  [[nodiscard]] auto operator<=>(const GeometryPoolKey&) const = default;
+};
+
+/// The location of the vertices and indices of a mesh in a geometry pool.
+struct GeometryAllocation final {
+  uint32 first_vertex {};  ///< The first vertex, i.e. the base vertex of draw calls.
+  uint32 vertex_count {};  ///< The number of vertices.
+  uint32 first_index {};   ///< The first index in the index buffer.
+  uint32 index_count {};   ///< The number of indices.
+};
+
+/// Vertex and index buffers that are shared by all meshes with the same buffer layout.
+///
+/// \details
+/// Meshes are stored in ranges of a single set of buffers, so that draw calls of
+/// different meshes use the same VAO. Indices are relative to the first vertex of their
+/// mesh, which is passed as the base vertex of draw calls. The buffers grow when they
+/// run out of space, and released ranges are reused by later allocations.
+///
+/// The VAO also provides an integer instance index attribute at location
+/// `kInstanceIndexLocation`, which is advanced once per instance. Unlike
+/// `gl_InstanceID`, it includes the base instance of indirect draw calls.
+class GeometryPool final {
+ public:
+  GLOW_DELETE_COPY(GeometryPool);
+  GLOW_DELETE_MOVE(GeometryPool);
+
+  explicit GeometryPool(const GeometryPoolKey& key);
+
+  /// Stores the vertices and indices of a mesh in the pool.
+  ///
+  /// \param vertices the interleaved vertex data, using the format of the pool.
+  /// \param vertex_count the number of vertices.
+  /// \param indices the raw index data, using the index type of the pool.
+  /// \param index_count the number of indices.
+  ///
+  /// \return the location of the mesh in the pool.
+  [[nodiscard]] auto allocate(std::span<const Byte> vertices,
+                              usize vertex_count,
+                              std::span<const Byte> indices,
+                              usize index_count) -> GeometryAllocation;
+
+  /// Releases the ranges of a mesh, which should no longer be drawn.
+  void release(const GeometryAllocation& allocation);
+
+  /// Binds the VAO of the pool for subsequent draw calls.
+  void bind() const;
+
+  [[nodiscard]] auto get_key() const noexcept -> const GeometryPoolKey& { return mKey; }
+
+  [[nodiscard]] auto get_index_size() const noexcept -> usize { return mIndexSize; }
+
+ private:
+  GeometryPoolKey mKey;
+  VertexLayout mLayout;            ///< The interleaved vertex layout.
+  SplitVertexLayout mSplitLayout;  ///< The layouts used if positions are split.
+  usize mIndexSize {};             ///< The size of each index, in bytes.
+
+  VertexArray mVAO;
+  Maybe<VertexBuffer> mPositionVBO;  ///< Separate position stream, if split.
+  VertexBuffer mVBO;
+  IndexBuffer mEBO;
+  VertexBuffer mInstanceIndexVBO;  ///< Holds the indices of the instances of a draw.
+
+  RangeAllocator mVertexRanges;
+  RangeAllocator mIndexRanges;
+
+  // Scratch buffers used to split vertex streams
+  Vector<Byte> mPositions;
+  Vector<Byte> mAttributes;
+
+  void grow_vertices(usize capacity);
+  void grow_indices(usize capacity);
+
+  void init_vertex_array();
+};
+
+}  // namespace glow::gl
@@ -3,13 +3,14 @@
 #include <glad/glad.h>
 
 #include "common/debug/assert.hpp"
+#include "graphics/opengl/state_cache.hpp"
 #include "graphics/opengl/util.hpp"
 
 namespace glow::gl {
 
 IndexBuffer::IndexBuffer()
 {
-  glGenBuffers(1, &mID);
+  mID = create_buffer();
 }
 
 IndexBuffer::~IndexBuffer() noexcept
@@ -39,29 +40,38 @@ void IndexBuffer::dispose() noexcept
 {
   if (mID != 0) {
     glDeleteBuffers(1, &mID);
+    get_state_cache().forget_buffer(mID);
   }
 }
 
 void IndexBuffer::bind() const
 {
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mID);
+  get_state_cache().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, mID);
 }
 
 void IndexBuffer::unbind()
 {
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  get_state_cache().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 void IndexBuffer::upload_data(const usize data_size,
-                              const uint* data,
+                              const void* data,
                               const BufferUsage usage)
 {
-  GLOW_ASSERT(get_bound_index_buffer() == mID);
+  if (has_direct_state_access()) {
+    glNamedBufferData(mID,
+                      static_cast<GLsizeiptr>(data_size),
+                      data,
+                      convert_buffer_usage(usage));
+  }
+  else {
+    GLOW_ASSERT(get_bound_index_buffer() == mID);
 
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-               static_cast<GLsizeiptr>(data_size),
-               data,
-               convert_buffer_usage(usage));
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(data_size),
+                 data,
+                 convert_buffer_usage(usage));
+  }
   GLOW_GL_CHECK_ERRORS();
 }
 
@@ -29,14 +29,15 @@ class IndexBuffer final {
   /**
    * Uploads indices to the index buffer.
    *
-   * \pre The EBO must be bound when this function is called.
+   * \pre The EBO must be bound when this function is called, since binding it modifies
+   * the bound VAO. This isn't required if direct state access is available.
    *
    * \param data_size the size of the data, in bytes.
    * \param data the raw index data.
    * \param usage buffer usage optimization hint.
    */
   void upload_data(usize data_size,
-                   const uint* data,
+                   const void* data,
                    BufferUsage usage = BufferUsage::Static);
 
   [[nodiscard]] auto get_id() const -> uint { return mID; }
@@ -0,0 +1,76 @@
+#include "indirect_buffer.hpp"
+
+#include <glad/glad.h>
+
+#include "graphics/opengl/state_cache.hpp"
+#include "graphics/opengl/util.hpp"
+
+namespace glow::gl {
+
+IndirectBuffer::IndirectBuffer()
+{
+  mID = create_buffer();
+}
+
+IndirectBuffer::~IndirectBuffer() noexcept
+{
+  dispose();
+}
+
+IndirectBuffer::IndirectBuffer(IndirectBuffer&& other) noexcept
+    : mID {other.mID}
+{
+  other.mID = 0;
+}
+
+auto IndirectBuffer::operator=(IndirectBuffer&& other) noexcept -> IndirectBuffer&
+{
+  if (this != &other) {
+    dispose();
+
+    mID = other.mID;
+    other.mID = 0;
+  }
+
+  return *this;
+}
+
+void IndirectBuffer::dispose() noexcept
+{
+  if (mID != 0) {
+    glDeleteBuffers(1, &mID);
+    get_state_cache().forget_buffer(mID);
+  }
+}
+
+void IndirectBuffer::bind() const
+{
+  get_state_cache().bind_buffer(GL_DRAW_INDIRECT_BUFFER, mID);
+}
+
+void IndirectBuffer::unbind()
+{
+  get_state_cache().bind_buffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void IndirectBuffer::upload_data(const usize data_size,
+                                 const void* data,
+                                 const BufferUsage usage)
+{
+  if (has_direct_state_access()) {
+    glNamedBufferData(mID,
+                      static_cast<GLsizeiptr>(data_size),
+                      data,
+                      convert_buffer_usage(usage));
+  }
+  else {
+    bind();
+    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                 static_cast<GLsizeiptr>(data_size),
+                 data,
+                 convert_buffer_usage(usage));
+  }
+  GLOW_GL_CHECK_ERRORS();
+}
+
+}  // namespace glow::gl
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "graphics/opengl/buffer_usage.hpp"
+
+namespace glow::gl {
+
+/// The layout of the commands read by `glMultiDrawElementsIndirect`.
+struct DrawElementsIndirectCommand final {
+  uint32 count {};           ///< The number of indices.
+  uint32 instance_count {};  ///< The number of instances.
+  uint32 first_index {};     ///< The first index in the bound index buffer.
+  int32 base_vertex {};      ///< The value added to each index.
+  uint32 base_instance {};   ///< The first instance, see `kInstanceIndexLocation`.
+};
+
+/// Represents an OpenGL buffer that provides the commands of indirect draw calls.
+class IndirectBuffer final {
+ public:
+  GLOW_DELETE_COPY(IndirectBuffer);
+
+  /// Creates an indirect buffer, but does not bind it.
+  IndirectBuffer();
+
+  ~IndirectBuffer() noexcept;
+
+  IndirectBuffer(IndirectBuffer&& other) noexcept;
+
+  auto operator=(IndirectBuffer&& other) noexcept -> IndirectBuffer&;
+
+  /// Binds the indirect buffer for subsequent draw calls.
+  void bind() const;
+
+  /// Unbinds any bound indirect buffer.
+  static void unbind();
+
+  /**
+   * Uploads draw commands to the indirect buffer.
+   *
+   * \note The buffer is bound by this function, unless direct state access is available.
+   *
+   * \param data_size the size of the data, in bytes.
+   * \param data the draw commands.
+   * \param usage buffer usage optimization hint.
+   */
+  void upload_data(usize data_size,
+                   const void* data,
+                   BufferUsage usage = BufferUsage::Stream);
+
+  [[nodiscard]] auto get_id() const -> uint { return mID; }
+
+ private:
+  uint mID {};
+
+  void dispose() noexcept;
+};
+
+}  // namespace glow::gl
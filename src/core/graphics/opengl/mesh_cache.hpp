@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common/hash.hpp"
+#include "common/predef.hpp"
+#include "common/type/map.hpp"
+#include "common/type/memory.hpp"
+#include "graphics/opengl/geometry_pool.hpp"
+#include "graphics/opengl/model.hpp"
+
+namespace glow::gl {
+
+/// Context component used to share the buffers of meshes with identical contents.
+///
+/// \details
+/// All meshes with the same buffer layout are stored in a shared geometry pool.
+struct MeshCache final {
+  MeshCache() = default;
+  ~MeshCache() = default;
+  GLOW_DELETE_COPY(MeshCache);
+  GLOW_DEFAULT_MOVE(MeshCache);
+
+  /// The buffers are owned by the meshes, and released along with the last mesh that
+  /// uses them. Expired entries are removed when models are reloaded.
+  Map<ContentHash, Weak<const MeshBuffers>> buffers;
+  Map<GeometryPoolKey, Shared<GeometryPool>> pools;
+};
+
+}  // namespace glow::gl
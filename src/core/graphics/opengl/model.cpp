@@ -1,119 +1,687 @@
 #include "model.hpp"
 
-#include <cstddef>  // offsetof
-#include <utility>  // move
+#include <algorithm>  // sort, unique
+#include <utility>    // move
 
+#include <fmt/chrono.h>
 #include <glad/glad.h>
+#include <spdlog/spdlog.h>
 
+#include "common/debug/error.hpp"
+#include "common/hash.hpp"
+#include "common/type/chrono.hpp"
 #include "common/type/map.hpp"
 #include "common/type/vector.hpp"
+#include "engine/frame_scheduler.hpp"
+#include "graphics/asset_stats.hpp"
+#include "graphics/opengl/mesh_cache.hpp"
 #include "graphics/opengl/texture_cache.hpp"
+#include "graphics/texture_streaming.hpp"
+#include "graphics/vertex_layout.hpp"
+#include "io/file_watcher.hpp"
+#include "io/files.hpp"
 #include "io/model_loader.hpp"
-#include "io/texture_loader.hpp"
+#include "io/texture_decoder.hpp"
+#include "scene/asset_source.hpp"
 #include "scene/scene.hpp"
+#include "util/process_memory.hpp"
+#include "util/thread_pool.hpp"
 
 namespace glow::gl {
 namespace {
 
-[[nodiscard]] auto _create_texture(TextureCache& cache, Path path) -> Maybe<uint>
+[[nodiscard]] auto _is_supported(const TextureCompression compression) -> bool
 {
-  if (const auto iter = cache.textures.find(path); iter != cache.textures.end()) {
-    return iter->second.get_id();
+  switch (compression) {
+    case TextureCompression::Fast:
+      return GLAD_GL_EXT_texture_compression_s3tc != 0;
+
+    case TextureCompression::High:
+      return GLAD_GL_ARB_texture_compression_bptc != 0;
+
+    default:
+      return true;
+  }
+}
+
+[[nodiscard]] auto _get_compressed_format(const PixelFormat format) -> uint
+{
+  switch (format) {
+    case PixelFormat::BC1:
+      return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+    case PixelFormat::BC3:
+      return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+    case PixelFormat::BC5:
+      return GL_COMPRESSED_RG_RGTC2;
+
+    case PixelFormat::BC7:
+      return GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;
+
+    default:
+      throw Error {"Invalid block compressed pixel format"};
+  }
+}
+
+/// Provides the pixel data of a mip level, or releases it if no data is specified.
+///
+/// \pre The texture must be bound when this function is called.
+void _set_level_data(Texture2D& texture,
+                     const EncodedTexture& data,
+                     const usize level,
+                     const bool release)
+{
+  const auto& info = data.levels[level];
+  const auto detail_level = static_cast<int>(level);
+
+  // Zero sized images are used to free the memory of levels that are dropped
+  const auto size = release ? Vec2i {0, 0} : info.size;
+  const auto* pixels = release ? nullptr : data.get_level_data(level);
+
+  if (is_block_compressed(data.format)) {
+    texture.set_compressed_data(detail_level,
+                                _get_compressed_format(data.format),
+                                size,
+                                release ? 0 : info.byte_size,
+                                pixels);
+  }
+  else {
+    texture.set_data(detail_level, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, size, pixels);
+  }
+}
+
+void _create_texture(Scene& scene, const Path& path, const DecodedTexture& decoded)
+{
+  auto& cache = scene.get<TextureCache>();
+  auto& stats = scene.get<AssetStats>();
+
+  // Identical files share the texture, regardless of their paths
+  if (cache.textures.contains(decoded.content)) {
+    ++stats.texture_hits;
+    stats.saved_bytes += decoded.texture->data.size();
+    return;
+  }
+
+  ++stats.texture_misses;
+
+  const auto& data = *decoded.texture;
+
+  // Only the smallest levels are uploaded here, the rest are streamed in later
+  auto& streamer = scene.get<TextureStreamer>();
+  const auto stream_id = streamer.add_texture(decoded.content, path, decoded.texture);
+  const auto first_level = streamer.get_resident_level(stream_id);
+
+  Texture2D texture;
+  texture.bind();
+
+  for (usize level = first_level; level < data.levels.size(); ++level) {
+    _set_level_data(texture, data, level, false);
+  }
+
+  texture.set_anisotropic_filtering(true);
+  texture.set_mip_level_count(static_cast<int>(data.levels.size()));
+  texture.set_base_level(static_cast<int>(first_level));
+
+  Texture2D::unbind();
+
+  cache.textures.try_emplace(decoded.content, std::move(texture));
+}
+
+/// Returns the texture with the contents of a decoded texture.
+///
+/// \details
+/// The texture is created again if it was released whilst the model was loading, which
+/// happens when the texture file is reloaded and no material used the texture yet.
+[[nodiscard]] auto _get_texture_id(Scene& scene,
+                                   const Path& path,
+                                   const DecodedTexture& decoded) -> uint
+{
+  const auto& cache = scene.get<TextureCache>();
+
+  if (!cache.textures.contains(decoded.content)) {
+    _create_texture(scene, path, decoded);
   }
 
-  if (auto texture = Texture2D::load_rgb(path)) {
-    texture->bind();
-    texture->set_anisotropic_filtering(true);
-    texture->generate_mipmap();
-    Texture2D::unbind();
+  return cache.textures.at(decoded.content).get_id();
+}
+
+void _collect_texture_contents(const TextureStreamer& streamer,
+                               const Material& material,
+                               Vector<ContentHash>& contents)
+{
+  for (const auto& stream_id : {material.diffuse_stream, material.specular_stream}) {
+    if (stream_id.has_value()) {
+      contents.push_back(streamer.get_content(*stream_id));
+    }
+  }
+}
+
+[[nodiscard]] auto _is_texture_used(const Scene& scene, const StreamedTextureId stream_id)
+    -> bool
+{
+  for (const auto& [material_entity, material] : scene.each<Material>()) {
+    if (material.diffuse_stream == stream_id || material.specular_stream == stream_id) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// Releases the textures with the specified contents that are no longer used by any
+/// material, along with their streaming data.
+void _release_unused_textures(Scene& scene, Vector<ContentHash> contents)
+{
+  auto& cache = scene.get<TextureCache>();
+  auto& streamer = scene.get<TextureStreamer>();
+
+  std::sort(contents.begin(), contents.end());
+  contents.erase(std::unique(contents.begin(), contents.end()), contents.end());
+
+  for (const auto& content : contents) {
+    const auto stream_id = streamer.find_texture(content);
+    if (!stream_id.has_value()) {
+      continue;
+    }
+
+    if (!_is_texture_used(scene, *stream_id)) {
+      spdlog::debug("[GL] Released texture {}", streamer.get_path(*stream_id).string());
 
-    const auto texture_id = texture->get_id();
-    cache.textures.try_emplace(std::move(path), std::move(*texture));
-    return texture_id;
+      cache.textures.erase(content);
+      streamer.remove_texture(*stream_id);
+    }
   }
+}
 
-  return kNothing;
+[[nodiscard]] auto _find_texture(const TextureMap& textures, const Path& path)
+    -> const DecodedTexture*
+{
+  const auto iter = textures.find(path);
+  return (iter != textures.end()) ? &iter->second : nullptr;
 }
 
-[[nodiscard]] auto _create_material(Scene& scene,
-                                    const MaterialData& material_data,
-                                    const Path& model_dir) -> Entity
+void _assign_material(Scene& scene,
+                      const Entity material_entity,
+                      const MaterialData& material_data,
+                      const Path& model_dir,
+                      const TextureMap& textures,
+                      const TextureCompression compression)
 {
-  auto& texture_cache = scene.get<TextureCache>();
+  const auto& streamer = scene.get<TextureStreamer>();
 
-  const auto material_entity = scene.get_registry().create();
-  auto& material = scene.add<Material>(material_entity);
+  auto& registry = scene.get_registry();
+  auto& material = registry.emplace_or_replace<Material>(material_entity);
+  auto& source = registry.emplace_or_replace<MaterialSource>(material_entity);
+  source.compression = compression;
 
   if (material_data.diffuse_tex.has_value()) {
-    material.diffuse_tex =
-        _create_texture(texture_cache, model_dir / *material_data.diffuse_tex);
+    const auto path = (model_dir / *material_data.diffuse_tex).lexically_normal();
+    source.diffuse_tex = path;
+
+    if (const auto* texture = _find_texture(textures, path)) {
+      material.diffuse_tex = _get_texture_id(scene, path, *texture);
+      material.diffuse_stream = streamer.find_texture(texture->content);
+    }
   }
 
   if (material_data.specular_tex.has_value()) {
-    material.specular_tex =
-        _create_texture(texture_cache, model_dir / *material_data.specular_tex);
+    const auto path = (model_dir / *material_data.specular_tex).lexically_normal();
+    source.specular_tex = path;
+
+    if (const auto* texture = _find_texture(textures, path)) {
+      material.specular_tex = _get_texture_id(scene, path, *texture);
+      material.specular_stream = streamer.find_texture(texture->content);
+    }
   }
 
   material.ambient = material_data.ambient;
   material.diffuse = material_data.diffuse;
   material.specular = material_data.specular;
   material.emission = material_data.emission;
+}
+
+[[nodiscard]] auto _create_mesh_buffers(MeshCache& cache,
+                                        const MeshData& mesh_data,
+                                        const uint index_type,
+                                        const bool split_positions)
+    -> Shared<const MeshBuffers>
+{
+  const GeometryPoolKey pool_key {
+      .vertex_format = mesh_data.vertex_format,
+      .index_type = index_type,
+      .split_positions = split_positions,
+  };
+
+  // Meshes with the same buffer layout share a pool, so draws can use the same VAO
+  auto& pool = cache.pools[pool_key];
+  if (!pool) {
+    pool = std::make_shared<GeometryPool>(pool_key);
+  }
 
-  return material_entity;
+  const auto allocation = pool->allocate(mesh_data.get_vertices(),
+                                         mesh_data.vertex_count,
+                                         mesh_data.get_indices(),
+                                         mesh_data.index_count);
+
+  return std::make_shared<const MeshBuffers>(pool, allocation);
+}
+
+[[nodiscard]] auto _find_mesh_buffers(const MeshCache& cache, const ContentHash& content)
+    -> Shared<const MeshBuffers>
+{
+  const auto iter = cache.buffers.find(content);
+  return (iter != cache.buffers.end()) ? iter->second.lock() : nullptr;
 }
 
-[[nodiscard]] auto _create_mesh(const MeshData& mesh_data, const Entity material_entity)
-    -> Mesh
+[[nodiscard]] auto _create_mesh(Scene& scene,
+                                const MeshData& mesh_data,
+                                const ContentHash& content,
+                                const Entity material_entity,
+                                const bool split_positions) -> Mesh
 {
   Mesh mesh;
   mesh.transform = mesh_data.transform;
   mesh.material = material_entity;
-  mesh.index_count = static_cast<uint>(mesh_data.indices.size());
+  mesh.index_count = mesh_data.lods.empty()
+                         ? static_cast<uint>(mesh_data.index_count)
+                         : static_cast<uint>(mesh_data.lods.front().index_count);
+  mesh.index_type = (mesh_data.index_type == IndexType::UInt16) ? GL_UNSIGNED_SHORT
+                                                                  : GL_UNSIGNED_INT;
+  mesh.meshlets = mesh_data.meshlets;
+  mesh.lods = mesh_data.lods;
+  mesh.bounds_center = mesh_data.bounds_center;
+  mesh.bounds_radius = mesh_data.bounds_radius;
+  mesh.uv_density = mesh_data.uv_density;
+  mesh.position_offset = mesh_data.position_offset;
+  mesh.position_scale = mesh_data.position_scale;
+  mesh.octahedral_normals = has_octahedral_normals(mesh_data.vertex_format);
 
-  mesh.vao.bind();
+  auto& cache = scene.get<MeshCache>();
+  auto& stats = scene.get<AssetStats>();
 
-  mesh.vbo.bind();
-  mesh.vbo.upload_data(mesh_data.vertices.size() * sizeof(Vertex),
-                       mesh_data.vertices.data());
+  // Identical meshes share their buffers, whether or not they're in the same file
+  if (auto buffers = _find_mesh_buffers(cache, content)) {
+    ++stats.mesh_hits;
+    stats.saved_bytes += content.size;
+    mesh.buffers = std::move(buffers);
+  }
+  else {
+    ++stats.mesh_misses;
+    mesh.buffers =
+        _create_mesh_buffers(cache, mesh_data, mesh.index_type, split_positions);
+    cache.buffers.insert_or_assign(content, mesh.buffers);
+  }
 
-  using IndexType = decltype(MeshData::indices)::value_type;
-  mesh.ebo.bind();
-  mesh.ebo.upload_data(mesh_data.indices.size() * sizeof(IndexType),
-                       mesh_data.indices.data());
+  return mesh;
+}
 
-  mesh.vao.init_attr(0, 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, position));
-  mesh.vao.init_attr(1, 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, normal));
-  mesh.vao.init_attr(2, 2, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, tex_coords));
+[[nodiscard]] auto _hash_meshes(const Vector<MeshData>& meshes, const uint64 seed)
+    -> Vector<ContentHash>
+{
+  Vector<ContentHash> contents(meshes.size());
 
-  VertexArray::unbind();
-  VertexBuffer::unbind();
-  IndexBuffer::unbind();
+  get_thread_pool().parallel_for(contents.size(), [&](const usize index) {
+    contents[index] = hash_mesh_data(meshes[index], seed);
+  });
 
-  return mesh;
+  return contents;
 }
 
 }  // namespace
 
-void assign_model(Scene& scene, const Entity entity, const Path& path)
+MeshBuffers::MeshBuffers(Shared<GeometryPool> pool, const GeometryAllocation& allocation)
+    : pool {std::move(pool)},
+      allocation {allocation}
+{
+}
+
+MeshBuffers::~MeshBuffers() noexcept
+{
+  pool->release(allocation);
+}
+
+void apply_residency_changes(Scene& scene, const Vector<ResidencyChange>& changes)
+{
+  const auto& streamer = scene.get<TextureStreamer>();
+  auto& cache = scene.get<TextureCache>();
+
+  for (const auto& change : changes) {
+    auto& texture = cache.textures.at(streamer.get_content(change.id));
+    const auto& data = streamer.get_texture(change.id);
+
+    texture.bind();
+
+    // New levels must be provided before they are used, and dropped levels must be
+    // unused before they are released.
+    if (change.new_level < change.old_level) {
+      for (auto level = change.new_level; level < change.old_level; ++level) {
+        _set_level_data(texture, data, level, false);
+      }
+
+      texture.set_base_level(static_cast<int>(change.new_level));
+    }
+    else {
+      texture.set_base_level(static_cast<int>(change.new_level));
+
+      for (auto level = change.old_level; level < change.new_level; ++level) {
+        _set_level_data(texture, data, level, true);
+      }
+    }
+  }
+
+  Texture2D::unbind();
+}
+
+auto assign_model(Scene& scene,
+                  FrameScheduler& scheduler,
+                  const Entity entity,
+                  Path path,
+                  ImportOptions options) -> Task<>
 {
-  if (const auto model_data = load_model_data(path, GraphicsAPI::OpenGL)) {
-    auto& model = scene.add<Model>(entity);
-    model.meshes.reserve(model_data->meshes.size());
+  const auto start_time = Clock::now();
+
+  path = path.lexically_normal();
+
+  if (!_is_supported(options.texture_compression)) {
+    spdlog::warn("[GL] Texture compression '{}' is not supported, using 'None' instead",
+                 get_short_name(options.texture_compression));
+    options.texture_compression = TextureCompression::None;
+  }
+
+  // Import the model and decode its textures on a worker thread
+  co_await get_thread_pool().schedule();
+
+  const auto memory_before = query_process_memory();
+  const auto model_content = hash_file(path);
+
+  // Low memory imports only convert the meshes right before they are uploaded
+  Maybe<ModelImporter> importer;
+  Maybe<ModelData> model_data;
+
+  if (options.low_memory) {
+    importer = ModelImporter::open(path, GraphicsAPI::OpenGL, options);
+  }
+  else {
+    model_data = load_model_data(path, GraphicsAPI::OpenGL, options);
+  }
+
+  if (!importer.has_value() && !model_data.has_value()) {
+    co_return;
+  }
+
+  const auto& model = importer.has_value() ? importer->get_model() : *model_data;
+  const auto mesh_count =
+      importer.has_value() ? importer->get_mesh_count() : model_data->meshes.size();
+
+  const auto textures = get_texture_decoder().decode(collect_texture_paths(model),
+                                                     options.texture_compression);
+
+  // The buffer layout is part of the hash, since it affects the contents of the buffers
+  const auto mesh_seed = static_cast<uint64>(options.split_positions);
+
+  Vector<MeshData> mesh_batch;
+  Vector<ContentHash> mesh_contents;
+
+  if (model_data.has_value()) {
+    mesh_batch = std::move(model_data->meshes);
+    mesh_contents = _hash_meshes(mesh_batch, mesh_seed);
+  }
+
+  // Create the GPU resources on the main thread
+  co_await scheduler.schedule();
+
+  const auto is_cancelled = [&] {
+    return scheduler.is_stopping() || !scene.get_registry().valid(entity);
+  };
+
+  if (is_cancelled()) {
+    co_return;
+  }
+
+  // Reloaded models keep their meshes until all new meshes are available
+  const auto reloading = scene.get_registry().all_of<Model, ModelSource>(entity);
+  const auto previous_mesh_misses = scene.get<AssetStats>().mesh_misses;
+
+  Vector<Mesh> new_meshes;
+  HashMap<usize, Entity> old_material_entities;
+
+  // The textures of the previous materials are released if they are no longer used
+  Vector<ContentHash> old_textures;
+
+  if (reloading) {
+    new_meshes.reserve(mesh_count);
+    old_material_entities = scene.get<ModelSource>(entity).materials;
+
+    const auto& streamer = scene.get<TextureStreamer>();
+    const auto& registry = scene.get_registry();
 
-    HashMap<usize, Entity> material_entities;
-    material_entities.reserve(model_data->materials.size());
+    for (const auto& [material_id, material_entity] : old_material_entities) {
+      if (const auto* material = registry.try_get<Material>(material_entity)) {
+        _collect_texture_contents(streamer, *material, old_textures);
+      }
+    }
+  }
+  else {
+    scene.add<Model>(entity).meshes.reserve(mesh_count);
+  }
+
+  for (const auto& [texture_path, texture] : textures) {
+    _create_texture(scene, texture_path, texture);
+
+    co_await scheduler.yield_if_over_budget();
+    if (is_cancelled()) {
+      co_return;
+    }
+  }
+
+  // Existing materials are updated in place, so that they keep their entities
+  HashMap<usize, Entity> material_entities;
+  material_entities.reserve(model.materials.size());
+
+  for (const auto& [material_id, material_data] : model.materials) {
+    auto material_entity = kNullEntity;
+
+    if (const auto iter = old_material_entities.find(material_id);
+        iter != old_material_entities.end() && scene.get_registry().valid(iter->second)) {
+      material_entity = iter->second;
+      old_material_entities.erase(iter);
+    }
+    else {
+      material_entity = scene.get_registry().create();
+    }
 
-    for (const auto& [material_id, material_data] : model_data->materials) {
-      const auto material_entity =
-          _create_material(scene, material_data, model_data->dir);
-      material_entities[material_id] = material_entity;
+    _assign_material(scene,
+                     material_entity,
+                     material_data,
+                     model.dir,
+                     textures,
+                     options.texture_compression);
+    material_entities[material_id] = material_entity;
+
+    co_await scheduler.yield_if_over_budget();
+    if (is_cancelled()) {
+      co_return;
+    }
+  }
+
+  // Low memory imports convert each batch of meshes on a worker thread, and release it
+  // once it has been uploaded. Otherwise, all meshes are uploaded as a single batch.
+  do {
+    if (importer.has_value()) {
+      mesh_batch.clear();
+
+      co_await get_thread_pool().schedule();
+
+      mesh_batch = importer->import_meshes();
+      mesh_contents = _hash_meshes(mesh_batch, mesh_seed);
+
+      co_await scheduler.schedule();
+      if (is_cancelled()) {
+        co_return;
+      }
     }
 
-    for (const auto& mesh_data : model_data->meshes) {
+    // Unchanged meshes have the same contents, so they reuse their buffers
+    for (usize mesh_index = 0; mesh_index < mesh_batch.size(); ++mesh_index) {
+      const auto& mesh_data = mesh_batch[mesh_index];
       const auto material_entity = material_entities.at(mesh_data.material_id);
-      model.meshes.push_back(_create_mesh(mesh_data, material_entity));
+
+      auto mesh = _create_mesh(scene,
+                               mesh_data,
+                               mesh_contents[mesh_index],
+                               material_entity,
+                               options.split_positions);
+
+      if (reloading) {
+        new_meshes.push_back(std::move(mesh));
+      }
+      else {
+        // The component is fetched every time since the storage may have been modified
+        scene.get<Model>(entity).meshes.push_back(std::move(mesh));
+      }
+
+      co_await scheduler.yield_if_over_budget();
+      if (is_cancelled()) {
+        co_return;
+      }
+    }
+  } while (importer.has_value() && importer->has_next_mesh());
+
+  if (reloading) {
+    scene.get<Model>(entity).meshes = std::move(new_meshes);
+
+    // The buffers of meshes that were only used by the previous meshes are gone now
+    std::erase_if(scene.get<MeshCache>().buffers,
+                  [](const auto& entry) { return entry.second.expired(); });
+
+    // Materials that are no longer part of the model are no longer referenced
+    for (const auto& [material_id, material_entity] : old_material_entities) {
+      if (scene.get_registry().valid(material_entity)) {
+        scene.get_registry().destroy(material_entity);
+      }
+    }
+
+    _release_unused_textures(scene, std::move(old_textures));
+  }
+
+  scene.get_registry().emplace_or_replace<ModelSource>(
+      entity,
+      ModelSource {path, options, std::move(material_entities)});
+
+  auto& watcher = scene.get<FileWatcher>();
+
+  if (model_content.has_value()) {
+    watcher.watch(path, *model_content);
+  }
+
+  for (const auto& [texture_path, texture] : textures) {
+    watcher.watch(texture_path, texture.content);
+  }
+
+  const auto end_time = Clock::now();
+  const auto duration = chrono::duration_cast<Milliseconds>(end_time - start_time);
+
+  if (reloading) {
+    spdlog::info("[GL] Reloaded model {} in {} ({} of {} meshes uploaded)",
+                 path.string(),
+                 duration,
+                 scene.get<AssetStats>().mesh_misses - previous_mesh_misses,
+                 mesh_count);
+  }
+  else {
+    spdlog::debug("[GL] Loaded model {} in {}", path.string(), duration);
+  }
+
+  // Loads may overlap, so the peak usage is only an upper bound for this model
+  const auto memory_after = query_process_memory();
+
+  if (memory_before.has_value() && memory_after.has_value()) {
+    spdlog::debug("[GL] Peak resident memory {} MiB -> {} MiB, now {} MiB ({} import)",
+                  memory_before->peak_resident / (1'024 * 1'024),
+                  memory_after->peak_resident / (1'024 * 1'024),
+                  memory_after->resident / (1'024 * 1'024),
+                  options.low_memory ? "low memory" : "regular");
+  }
+}
+
+auto reload_model(Scene& scene, FrameScheduler& scheduler, const Entity entity)
+    -> Task<>
+{
+  const auto& source = scene.get<ModelSource>(entity);
+  return assign_model(scene, scheduler, entity, source.path, source.options);
+}
+
+auto reload_texture(Scene& scene, FrameScheduler& scheduler, Path path) -> Task<>
+{
+  // The texture is decoded in the same way as when it was first loaded
+  Maybe<TextureCompression> compression;
+
+  for (const auto& [material_entity, source] : scene.each<MaterialSource>()) {
+    if (source.uses_texture(path)) {
+      compression = source.compression;
+      break;
+    }
+  }
+
+  if (!compression.has_value()) {
+    co_return;
+  }
+
+  co_await get_thread_pool().schedule();
+
+  const auto textures = get_texture_decoder().decode(Vector<Path> {path}, *compression);
+
+  co_await scheduler.schedule();
+
+  if (scheduler.is_stopping()) {
+    co_return;
+  }
+
+  const auto* texture = _find_texture(textures, path);
+  if (texture == nullptr) {
+    spdlog::error("[GL] Failed to reload texture {}", path.string());
+    co_return;
+  }
+
+  _create_texture(scene, path, *texture);
+
+  const auto& cache = scene.get<TextureCache>();
+  const auto texture_id = cache.textures.at(texture->content).get_id();
+  const auto stream_id = scene.get<TextureStreamer>().find_texture(texture->content);
+
+  // Only the materials that use the file are updated, even if other files had the same
+  // contents as the previous version of the file. The previous texture is released once
+  // no material uses it anymore.
+  Vector<ContentHash> old_textures;
+  usize material_count = 0;
+
+  for (auto [material_entity, source, material] :
+       scene.get_registry().view<MaterialSource, Material>().each()) {
+    if (source.uses_texture(path)) {
+      _collect_texture_contents(scene.get<TextureStreamer>(), material, old_textures);
+    }
+
+    if (source.diffuse_tex == path) {
+      material.diffuse_tex = texture_id;
+      material.diffuse_stream = stream_id;
+    }
+
+    if (source.specular_tex == path) {
+      material.specular_tex = texture_id;
+      material.specular_stream = stream_id;
+    }
+
+    if (source.uses_texture(path)) {
+      ++material_count;
     }
   }
+
+  _release_unused_textures(scene, std::move(old_textures));
+
+  spdlog::info("[GL] Reloaded texture {} ({} materials updated)",
+               path.string(),
+               material_count);
 }
 
-}  // namespace glow::gl
\ No newline at end of file
+}  // namespace glow::gl
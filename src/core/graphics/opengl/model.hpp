@@ -5,36 +5,65 @@
 #include "common/type/ecs.hpp"
 #include "common/type/math.hpp"
 #include "common/type/maybe.hpp"
+#include "common/type/memory.hpp"
 #include "common/type/path.hpp"
 #include "common/type/vector.hpp"
-#include "graphics/opengl/index_buffer.hpp"
-#include "graphics/opengl/vertex_array.hpp"
-#include "graphics/opengl/vertex_buffer.hpp"
+#include "graphics/opengl/geometry_pool.hpp"
+#include "graphics/texture_streaming.hpp"
+#include "io/import_options.hpp"
+#include "io/model_loader.hpp"
+#include "util/task.hpp"
 
 namespace glow {
 GLOW_FORWARD_DECLARE_C(Scene);
+GLOW_FORWARD_DECLARE_C(FrameScheduler);
 }  // namespace glow
 
 namespace glow::gl {
 
 /// OpenGL material component.
 struct Material final {
-  Maybe<uint> diffuse_tex;   ///< Optional ID of diffuse texture.
-  Maybe<uint> specular_tex;  ///< Optional ID of specular texture.
+  Maybe<uint> diffuse_tex;                   ///< Optional ID of diffuse texture.
+  Maybe<uint> specular_tex;                  ///< Optional ID of specular texture.
+  Maybe<StreamedTextureId> diffuse_stream;   ///< Streaming ID of diffuse texture.
+  Maybe<StreamedTextureId> specular_stream;  ///< Streaming ID of specular texture.
   Vec3 ambient {};
   Vec3 diffuse {};
   Vec3 specular {};
   Vec3 emission {};
 };
 
+/// The GPU buffer ranges of a mesh, which are shared by meshes with identical contents.
+struct MeshBuffers final {
+  GLOW_DELETE_COPY(MeshBuffers);
+  GLOW_DELETE_MOVE(MeshBuffers);
+
+  MeshBuffers(Shared<GeometryPool> pool, const GeometryAllocation& allocation);
+
+  /// Releases the ranges of the mesh in the geometry pool.
+  ~MeshBuffers() noexcept;
+
+  Shared<GeometryPool> pool;      ///< The pool that stores the vertices and indices.
+  GeometryAllocation allocation;  ///< The location of the mesh in the pool.
+};
+
 /// OpenGL mesh component.
 struct Mesh final {
   Mat4 transform {1.0f};          ///< Transform matrix relative to parent model.
-  VertexArray vao;                ///< Associated vertex array object.
-  VertexBuffer vbo;               ///< Associated vertex buffer object.
-  IndexBuffer ebo;                ///< Associated index buffer object.
   Entity material {kNullEntity};  ///< The associated material entity.
-  uint index_count {};            ///< The amount of indices needed to render the mesh.
+  uint index_count {};            ///< The amount of indices in the full detail mesh.
+  uint index_type {};             ///< GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+  Vector<Meshlet> meshlets;       ///< Optional meshlets used for culling.
+  Vector<MeshLod> lods;           ///< Optional levels of detail.
+  Vec3 bounds_center {};          ///< Center of the bounding sphere.
+  float bounds_radius {};         ///< Radius of the bounding sphere.
+  float uv_density {1};           ///< Texture coordinate units per mesh space unit.
+  Vec3 position_offset {0};       ///< Offset used to decode vertex positions.
+  Vec3 position_scale {1};        ///< Scale used to decode vertex positions.
+  bool octahedral_normals {};     ///< Whether vertex normals are octahedral encoded.
+
+  /// The vertex and index buffers, shared by meshes with identical contents.
+  Shared<const MeshBuffers> buffers;
 };
 
 /// OpenGL model component.
@@ -43,7 +72,58 @@ struct Model final {
   Vector<Mesh> meshes;  ///< The meshes that constitute the model.
 };
 
-/// Loads and assigns an OpenGL model component to an entity.
-void assign_model(Scene& scene, Entity entity, const Path& path);
+/// Applies changes of the resident mip levels of streamed textures to the GPU textures.
+///
+/// \param scene the associated scene.
+/// \param changes the residency changes returned by the texture streamer.
+void apply_residency_changes(Scene& scene, const Vector<ResidencyChange>& changes);
+
+/// Loads a model file and assigns an OpenGL model component to an entity.
+///
+/// \details
+/// The model file is imported and its textures are decoded on worker threads. The GPU
+/// resources are then created on the main thread, spread over several frames if
+/// needed. The model component is added as soon as the import has finished, and the
+/// meshes are added to it as they become available.
+///
+/// If the entity already has a model that was loaded by this function, the model is
+/// updated in place instead, see `reload_model`.
+///
+/// \param scene the associated scene.
+/// \param scheduler the scheduler used to execute work on the main thread.
+/// \param entity the entity that the model component will be added to.
+/// \param path the model file path.
+/// \param options the import options to use for the model file.
+[[nodiscard]] auto assign_model(Scene& scene,
+                                FrameScheduler& scheduler,
+                                Entity entity,
+                                Path path,
+                                ImportOptions options) -> Task<>;
+
+/// Reimports the model file of a model entity, and updates the model in place.
+///
+/// \details
+/// The entity and its material entities are kept, and only textures and meshes with
+/// changed contents are uploaded again, since unchanged meshes reuse their buffers
+/// through the mesh cache. The previous meshes are kept until all new meshes are
+/// available.
+///
+/// \param scene the associated scene.
+/// \param scheduler the scheduler used to execute work on the main thread.
+/// \param entity a model entity with a `ModelSource` component.
+[[nodiscard]] auto reload_model(Scene& scene, FrameScheduler& scheduler, Entity entity)
+    -> Task<>;
+
+/// Decodes a changed texture file again, and updates the materials that use it.
+///
+/// \details
+/// The previous texture of the file is released, along with its streaming data, unless
+/// it's still used by other materials.
+///
+/// \param scene the associated scene.
+/// \param scheduler the scheduler used to execute work on the main thread.
+/// \param path the normalized path of the texture file.
+[[nodiscard]] auto reload_texture(Scene& scene, FrameScheduler& scheduler, Path path)
+    -> Task<>;
 
 }  // namespace glow::gl
\ No newline at end of file
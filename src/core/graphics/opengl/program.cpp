@@ -1,13 +1,36 @@
 #include "program.hpp"
 
+#include <algorithm>  // find
+
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <spdlog/spdlog.h>
 
 #include "graphics/opengl/shader.hpp"
+#include "graphics/opengl/state_cache.hpp"
+#include "common/type/vector.hpp"
 #include "graphics/opengl/util.hpp"
 
 namespace glow::gl {
+namespace {
+
+[[nodiscard]] auto _is_supported_binary_format(const uint format) -> bool
+{
+  int format_count {};
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+
+  if (format_count <= 0) {
+    return false;
+  }
+
+  Vector<int> formats(static_cast<usize>(format_count));
+  glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+
+  return std::find(formats.begin(), formats.end(), static_cast<int>(format)) !=
+         formats.end();
+}
+
+}  // namespace
 
 Program::Program()
     : mID {glCreateProgram()}
@@ -41,6 +64,7 @@ void Program::dispose() noexcept
 {
   if (mID != 0) {
     glDeleteProgram(mID);
+    get_state_cache().forget_program(mID);
   }
 }
 
@@ -105,14 +129,73 @@ auto Program::link() -> Result
   }
 }
 
+void Program::set_binary_retrievable()
+{
+  glProgramParameteri(mID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+auto Program::load_binary(const ProgramBinary& binary) -> Result
+{
+  // Unknown formats would raise an error instead of just failing to link
+  if (!_is_supported_binary_format(binary.format)) {
+    return kFailure;
+  }
+
+  glProgramBinary(mID,
+                  binary.format,
+                  binary.data.data(),
+                  static_cast<GLsizei>(binary.data.size()));
+
+  int success {};
+  glGetProgramiv(mID, GL_LINK_STATUS, &success);
+
+  if (!success) {
+    // Rejected binaries are expected, so their errors must not be reported later
+    while (glGetError() != GL_NO_ERROR) {
+    }
+
+    return kFailure;
+  }
+
+  return kSuccess;
+}
+
+auto Program::get_binary() const -> Maybe<ProgramBinary>
+{
+  int binary_size {};
+  glGetProgramiv(mID, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+
+  if (binary_size <= 0) {
+    return kNothing;
+  }
+
+  ProgramBinary binary;
+  binary.data.resize(static_cast<usize>(binary_size));
+
+  GLsizei written_size {};
+  glGetProgramBinary(mID,
+                     binary_size,
+                     &written_size,
+                     &binary.format,
+                     binary.data.data());
+  GLOW_GL_CHECK_ERRORS();
+
+  if (written_size <= 0) {
+    return kNothing;
+  }
+
+  binary.data.resize(static_cast<usize>(written_size));
+  return binary;
+}
+
 void Program::bind()
 {
-  glUseProgram(mID);
+  get_state_cache().use_program(mID);
 }
 
 void Program::unbind()
 {
-  glUseProgram(0);
+  get_state_cache().use_program(0);
 }
 
 auto Program::set_uniform_block_binding(const char* name, const int binding) -> Result
@@ -15,6 +15,12 @@ namespace glow::gl {
 
 GLOW_FORWARD_DECLARE_C(Shader);
 
+/// The driver specific binary representation of a linked shader program.
+struct ProgramBinary final {
+  uint format {};     ///< The binary format, which is only understood by the same driver.
+  Vector<Byte> data;  ///< The raw binary data.
+};
+
 /// Represents an OpenGL shader program.
 class Program final {
  public:
@@ -41,6 +47,23 @@ class Program final {
   /// Attempts to link the shader program, using previously attached shaders.
   auto link() -> Result;
 
+  /// Hints that the program binary will be retrieved after the program is linked.
+  void set_binary_retrievable();
+
+  /// Attempts to load a previously retrieved program binary, instead of linking shaders.
+  ///
+  /// \details
+  /// Drivers may reject binaries at any time, e.g. after driver updates, in which case
+  /// the program has to be linked from its shaders instead. Binaries in formats that the
+  /// driver doesn't support are rejected without calling into the driver, and errors
+  /// raised by rejected binaries are cleared.
+  ///
+  /// \return success if the binary was accepted; failure otherwise.
+  auto load_binary(const ProgramBinary& binary) -> Result;
+
+  /// Returns the binary representation of the linked program, if it is available.
+  [[nodiscard]] auto get_binary() const -> Maybe<ProgramBinary>;
+
   /// Enables the associated shaders for subsequent draw calls.
   void bind();
 
@@ -0,0 +1,225 @@
+#include "program_cache.hpp"
+
+#include <cstring>       // memcpy
+#include <ios>           // streamsize
+#include <system_error>  // error_code
+#include <type_traits>   // is_trivially_copyable_v
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include "common/hash.hpp"
+#include "common/type/chrono.hpp"
+#include "common/type/string.hpp"
+#include "graphics/opengl/util.hpp"
+#include "io/files.hpp"
+#include "io/mapped_file.hpp"
+
+namespace glow::gl {
+namespace {
+
+inline constexpr uint32 kProgramCacheMagic = 0x50574C47;  // "GLWP"
+inline constexpr uint32 kProgramCacheVersion = 1;
+
+struct ProgramCacheHeader final {
+  uint32 magic {};
+  uint32 version {};
+  uint32 format {};
+  uint32 reserved {};
+  uint64 key {};
+  uint64 size {};
+};
+
+static_assert(std::is_trivially_copyable_v<ProgramCacheHeader>);
+
+[[nodiscard]] auto _get_program_cache_dir() -> Path
+{
+  return get_persistent_file_dir() / "cache" / "programs";
+}
+
+[[nodiscard]] auto _get_cache_entry_path(const uint64 key) -> Path
+{
+  return _get_program_cache_dir() / fmt::format("{:016x}.glprogram", key);
+}
+
+/// Computes the cache key of a program, which changes with the shaders or the driver.
+[[nodiscard]] auto _get_cache_key(const String& vertex_code, const String& fragment_code)
+    -> uint64
+{
+  const auto vendor = get_vendor_name();
+  const auto renderer = get_renderer_name();
+  const auto version = get_version();
+
+  auto key = hash_bytes(vendor.data(), vendor.size(), kProgramCacheVersion);
+  key = hash_bytes(renderer.data(), renderer.size(), key);
+  key = hash_bytes(version.data(), version.size(), key);
+  key = hash_bytes(vertex_code.data(), vertex_code.size(), key);
+  key = hash_bytes(fragment_code.data(), fragment_code.size(), key);
+
+  return key;
+}
+
+/// Drivers without any binary formats never provide program binaries.
+[[nodiscard]] auto _is_program_binary_supported() -> bool
+{
+  int format_count {};
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+  return format_count > 0;
+}
+
+[[nodiscard]] auto _load_cache_entry(const Path& entry_path, const uint64 key)
+    -> Maybe<ProgramBinary>
+{
+  std::error_code error;
+  if (!fs::exists(entry_path, error)) {
+    return kNothing;
+  }
+
+  const auto file = MappedFile::open(entry_path);
+  if (!file.has_value()) {
+    return kNothing;
+  }
+
+  const auto bytes = file->bytes();
+
+  ProgramCacheHeader header;
+  if (bytes.size() < sizeof header) {
+    return kNothing;
+  }
+
+  std::memcpy(&header, bytes.data(), sizeof header);
+
+  // The key is stored to detect the (unlikely) case of a file name collision.
+  if (header.magic != kProgramCacheMagic ||      //
+      header.version != kProgramCacheVersion ||  //
+      header.key != key ||                       //
+      header.size != bytes.size() - sizeof header) {
+    spdlog::debug("[GL] Ignoring incompatible program cache entry {}",
+                  entry_path.string());
+    return kNothing;
+  }
+
+  ProgramBinary binary;
+  binary.format = header.format;
+  binary.data.assign(bytes.begin() + sizeof header, bytes.end());
+
+  return binary;
+}
+
+auto _save_cache_entry(const Path& entry_path,
+                       const uint64 key,
+                       const ProgramBinary& binary) -> Result
+{
+  std::error_code error;
+  fs::create_directories(_get_program_cache_dir(), error);
+  if (error) {
+    spdlog::warn("[GL] Could not create program cache directory: {}", error.message());
+    return kFailure;
+  }
+
+  // Entries are written to a temporary file first, to avoid leaving partially written
+  // entries behind if something goes wrong.
+  auto temp_path = entry_path;
+  temp_path += ".tmp";
+
+  {
+    auto stream = create_file(temp_path, FileType::Binary);
+    if (!stream.has_value()) {
+      spdlog::warn("[GL] Could not create program cache entry {}", temp_path.string());
+      return kFailure;
+    }
+
+    ProgramCacheHeader header;
+    header.magic = kProgramCacheMagic;
+    header.version = kProgramCacheVersion;
+    header.format = binary.format;
+    header.key = key;
+    header.size = static_cast<uint64>(binary.data.size());
+
+    stream->write(reinterpret_cast<const char*>(&header),  // NOLINT
+                  static_cast<std::streamsize>(sizeof header));
+    stream->write(reinterpret_cast<const char*>(binary.data.data()),  // NOLINT
+                  static_cast<std::streamsize>(binary.data.size()));
+
+    if (!stream->good()) {
+      spdlog::warn("[GL] Could not write program cache entry {}", temp_path.string());
+      stream->close();
+      fs::remove(temp_path, error);
+      return kFailure;
+    }
+  }
+
+  fs::rename(temp_path, entry_path, error);
+  if (error) {
+    spdlog::warn("[GL] Could not store program cache entry: {}", error.message());
+    fs::remove(temp_path, error);
+    return kFailure;
+  }
+
+  spdlog::debug("[GL] Stored program cache entry {}", entry_path.string());
+  return kSuccess;
+}
+
+}  // namespace
+
+auto load_cached_program(Program& program,
+                         const Path& vertex_path,
+                         const Path& fragment_path) -> Result
+{
+  const auto start_time = Clock::now();
+
+  const auto vertex_code = load_file_as_string(vertex_path);
+  const auto fragment_code = load_file_as_string(fragment_path);
+
+  if (!vertex_code.has_value() || !fragment_code.has_value()) {
+    spdlog::error("[GL] Failed to read shader source files {} and {}",
+                  vertex_path.string(),
+                  fragment_path.string());
+    return kFailure;
+  }
+
+  const auto name = vertex_path.stem().string();
+  const auto use_cache = _is_program_binary_supported();
+  const auto key = _get_cache_key(*vertex_code, *fragment_code);
+  const auto entry_path = _get_cache_entry_path(key);
+
+  if (use_cache) {
+    if (const auto binary = _load_cache_entry(entry_path, key)) {
+      if (program.load_binary(*binary).succeeded()) {
+        const auto duration =
+            chrono::duration_cast<Microseconds>(Clock::now() - start_time);
+        spdlog::debug("[GL] Loaded cached program '{}' in {}", name, duration);
+        return kSuccess;
+      }
+
+      // Rejected binaries leave the program in an unlinked state, so start over
+      spdlog::debug("[GL] Driver rejected cached program '{}', compiling it instead",
+                    name);
+      program = Program {};
+    }
+
+    program.set_binary_retrievable();
+  }
+
+  if (program.load_shader_code(vertex_code->c_str(), fragment_code->c_str()).failed() ||
+      program.link().failed()) {
+    return kFailure;
+  }
+
+  const auto duration = chrono::duration_cast<Microseconds>(Clock::now() - start_time);
+  spdlog::debug("[GL] Compiled program '{}' in {}", name, duration);
+
+  if (use_cache) {
+    const auto binary = program.get_binary();
+
+    if (!binary.has_value() || _save_cache_entry(entry_path, key, *binary).failed()) {
+      spdlog::warn("[GL] Could not cache program '{}'", name);
+    }
+  }
+
+  return kSuccess;
+}
+
+}  // namespace glow::gl
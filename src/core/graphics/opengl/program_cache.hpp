@@ -0,0 +1,26 @@
+#pragma once
+
+#include "common/result.hpp"
+#include "common/type/path.hpp"
+#include "graphics/opengl/program.hpp"
+
+namespace glow::gl {
+
+/// Loads a vertex/fragment shader program, using the persistent program binary cache.
+///
+/// \details
+/// Cache entries are keyed by the shader source code, along with the vendor, renderer
+/// and version strings of the driver, since program binaries are only valid for the
+/// driver that created them. Programs without a usable cache entry, or with a binary
+/// that the driver rejects, are compiled from source and then stored in the cache.
+///
+/// \param program the program to load, which should not have any attached shaders.
+/// \param vertex_path the path to the vertex shader source file.
+/// \param fragment_path the path to the fragment shader source file.
+///
+/// \return success if the program is linked; failure otherwise.
+auto load_cached_program(Program& program,
+                         const Path& vertex_path,
+                         const Path& fragment_path) -> Result;
+
+}  // namespace glow::gl
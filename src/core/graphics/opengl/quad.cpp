@@ -5,6 +5,7 @@
 #include <glad/glad.h>
 
 #include "common/primitives.hpp"
+#include "graphics/opengl/state_cache.hpp"
 #include "graphics/opengl/util.hpp"
 #include "graphics/vertex.hpp"
 
@@ -65,14 +66,14 @@ void Quad::draw()
 
 void Quad::draw_without_depth_test()
 {
-  GLboolean depth_was_enabled = GL_FALSE;
-  glGetBooleanv(GL_DEPTH_TEST, &depth_was_enabled);
+  auto& state_cache = get_state_cache();
+  const auto depth_was_enabled = state_cache.is_enabled(GL_DEPTH_TEST);
 
-  glDisable(GL_DEPTH_TEST);
+  state_cache.set_option(GL_DEPTH_TEST, false);
   draw();
 
-  if (depth_was_enabled == GL_TRUE) {
-    glEnable(GL_DEPTH_TEST);
+  if (depth_was_enabled) {
+    state_cache.set_option(GL_DEPTH_TEST, true);
   }
 }
 
@@ -1,10 +1,14 @@
 #include "renderer.hpp"
 
+#include <algorithm>  // min, ranges::copy
+
 #include <SDL2/SDL.h>
+#include <fmt/chrono.h>
 #include <glad/glad.h>
 #include <imgui.h>
 #include <imgui_impl_opengl3.h>
 #include <imgui_impl_sdl2.h>
+#include <spdlog/spdlog.h>
 
 // This comment prevents moving the following include before <imgui.h>
 #include <ImGuizmo.h>
@@ -12,47 +16,60 @@
 #include "common/debug/assert.hpp"
 #include "common/predef.hpp"
 #include "graphics/opengl/model.hpp"
+#include "graphics/opengl/program_cache.hpp"
 #include "graphics/opengl/texture_2d.hpp"
+#include "graphics/opengl/texture_cube.hpp"
 #include "graphics/opengl/util.hpp"
 #include "init/window.hpp"
 
 namespace glow::gl {
 namespace {
 
+// The initial amount of per-draw uniform data per frame, which grows when needed.
+inline constexpr usize kDrawUniformFrameSize = 1'024 * 1'024;
+
 void _compile_and_link_program(Program& program,
                                const char* vert_path,
                                const char* frag_path)
 {
-  program.load_shader_files(vert_path, frag_path).check("Compilation error");
-  program.link().check("Link error");
+  load_cached_program(program, vert_path, frag_path).check("Shader program error");
 }
 
 }  // namespace
 
 Renderer::Renderer(SDL_Window* window)
-    : mWindow {window}
+    : mWindow {window},
+      mDrawUniforms {kDrawUniformFrameSize}
 {
+  const auto start_time = Clock::now();
+
+  // Filter across cubemap face edges, which would otherwise show up as visible seams
+  set_option(GL_TEXTURE_CUBE_MAP_SEAMLESS, true);
+
   init_uniform_buffers();
+
+  // Indirect commands provide the base instance, which is otherwise unavailable in 4.1
+  mMultiDrawIndirect = GLAD_GL_ARB_multi_draw_indirect && GLAD_GL_ARB_base_instance;
+  spdlog::debug("[GL] Multi-draw indirect is {}",
+                mMultiDrawIndirect ? "available" : "unavailable");
+
+  const auto program_start_time = Clock::now();
+
   load_environment_program();
   load_shading_program();
+  load_instanced_shading_program();
   load_framebuffer_program();
+
+  const auto end_time = Clock::now();
+  spdlog::debug("[GL] Initialized renderer in {} (shader programs: {})",
+                chrono::duration_cast<Milliseconds>(end_time - start_time),
+                chrono::duration_cast<Milliseconds>(end_time - program_start_time));
 }
 
 void Renderer::init_uniform_buffers()
 {
-  mEnvUBO.bind();
   mEnvUBO.reserve_space(sizeof(EnvironmentBuffer));
-
-  mMatrixUBO.bind();
-  mMatrixUBO.reserve_space(sizeof(MatrixBuffer));
-
-  mMaterialUBO.bind();
-  mMaterialUBO.reserve_space(sizeof(MaterialBuffer));
-
-  mFramebufferProgramOptionsUBO.bind();
   mFramebufferProgramOptionsUBO.reserve_space(sizeof(FramebufferProgramOptions));
-
-  UniformBuffer::unbind();
 }
 
 void Renderer::load_environment_program()
@@ -76,6 +93,22 @@ void Renderer::load_shading_program()
   mShadingProgram.set_uniform_block_binding("MaterialBuffer", 1).check("Material UBO");
 }
 
+void Renderer::load_instanced_shading_program()
+{
+  _compile_and_link_program(mInstancedShadingProgram,
+                            "assets/shaders/gl/shading_instanced.vert",
+                            "assets/shaders/gl/shading.frag");
+
+  mInstancedShadingProgram.set_uniform("uMaterialDiffuseTex", 5)
+      .check("uMaterialDiffuseTex");
+  mInstancedShadingProgram.set_uniform_block_binding("InstancedMatrixBuffer", 0)
+      .check("Instanced matrix UBO");
+  mInstancedShadingProgram.set_uniform_block_binding("MaterialBuffer", 1)
+      .check("Material UBO");
+  mInstancedShadingProgram.set_uniform_block_binding("InstanceBuffer", 2)
+      .check("Instance UBO");
+}
+
 void Renderer::load_framebuffer_program()
 {
   _compile_and_link_program(mFramebufferProgram,
@@ -90,6 +123,9 @@ void Renderer::load_framebuffer_program()
 void Renderer::begin_frame()
 {
   mFrameStart = Clock::now();
+  mStateCacheStats = get_state_cache().take_stats();
+
+  mDrawUniforms.begin_frame();
 
   ImGui_ImplSDL2_NewFrame();
   ImGui_ImplOpenGL3_NewFrame();
@@ -99,9 +135,14 @@ void Renderer::begin_frame()
 
 void Renderer::end_frame()
 {
+  mDrawUniforms.end_frame();
+
   ImGui::Render();
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
+  // The ImGui renderer modifies the GL state behind the back of the state cache
+  get_state_cache().invalidate();
+
   // Measure the render pass before swapping the framebuffers, avoiding VSync idle time.
   const auto render_pass_end = Clock::now();
   mFrameDuration = chrono::duration_cast<Microseconds>(render_pass_end - mFrameStart);
@@ -110,7 +151,7 @@ void Renderer::end_frame()
 void Renderer::swap_buffers()
 {
   if constexpr (kIsMacOS) {
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    get_state_cache().bind_framebuffer(GL_DRAW_FRAMEBUFFER, 0);
   }
 
   SDL_GL_SwapWindow(mWindow);
@@ -118,19 +159,27 @@ void Renderer::swap_buffers()
 
 void Renderer::bind_shading_program()
 {
-  mMatrixUBO.bind_block(0);
-  mMaterialUBO.bind_block(1);
   mShadingProgram.bind();
 }
 
+void Renderer::bind_instanced_shading_program()
+{
+  mInstancedShadingProgram.bind();
+}
+
 void Renderer::unbind_shading_program()
 {
-  GLOW_ASSERT(get_bound_program() == mShadingProgram.get_id());
+  GLOW_ASSERT(get_bound_program() == mShadingProgram.get_id() ||
+              get_bound_program() == mInstancedShadingProgram.get_id());
 
   VertexArray::unbind();
   Program::unbind();
   UniformBuffer::unbind_block(0);
   UniformBuffer::unbind_block(1);
+  UniformBuffer::unbind_block(2);
+  IndirectBuffer::unbind();
+
+  mBoundPool = nullptr;
 }
 
 void Renderer::render_buffer_to_screen(const Framebuffer& framebuffer)
@@ -145,14 +194,12 @@ void Renderer::render_buffer_to_screen(const Framebuffer& framebuffer)
   glClearColor(0, 0, 0, 1);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, framebuffer.get_color_texture_id());
+  get_state_cache().set_active_texture(GL_TEXTURE0);
+  Texture2D::bind(framebuffer.get_color_texture_id());
 
-  mFramebufferProgramOptionsUBO.bind();
   mFramebufferProgramOptionsUBO.update_data(0,
                                             sizeof mFramebufferProgramOptions,
                                             &mFramebufferProgramOptions);
-  UniformBuffer::unbind();
 
   mFramebufferProgramOptionsUBO.bind_block(0);
   mFramebufferProgram.bind();
@@ -160,14 +207,12 @@ void Renderer::render_buffer_to_screen(const Framebuffer& framebuffer)
   mQuad.draw_without_depth_test();
 }
 
-void Renderer::render_environment(const Texture2D& texture)
+void Renderer::render_environment(const TextureCube& texture)
 {
-  glActiveTexture(GL_TEXTURE0);
+  get_state_cache().set_active_texture(GL_TEXTURE0);
   texture.bind();
 
-  mEnvUBO.bind();
   mEnvUBO.update_data(0, sizeof mEnvBuffer, &mEnvBuffer);
-  UniformBuffer::unbind();
 
   mEnvUBO.bind_block(0);
   mEnvProgram.bind();
@@ -175,27 +220,184 @@ void Renderer::render_environment(const Texture2D& texture)
   mQuad.draw_without_depth_test();
 
   Program::unbind();
-  Texture2D::unbind();
+  TextureCube::unbind();
   UniformBuffer::unbind_block(0);
 }
 
-void Renderer::render_shaded_mesh(const Mesh& mesh, const Material& material)
+void Renderer::render_shaded_mesh(const Mesh& mesh,
+                                  const Material& material,
+                                  const Vector<IndexRange>& ranges)
 {
   GLOW_ASSERT(get_bound_program() == mShadingProgram.get_id());
 
-  mMatrixUBO.bind();
-  mMatrixUBO.update_data(0, sizeof mMatrixBuffer, &mMatrixBuffer);
+  // Every draw call gets its own slots, so the buffers are never overwritten while used
+  mDrawUniforms.bind_data(0, &mMatrixBuffer, sizeof mMatrixBuffer);
+  bind_material(material);
+
+  const auto& pool = *mesh.buffers->pool;
+  const auto& allocation = mesh.buffers->allocation;
+  bind_geometry_pool(pool);
+
+  const auto index_size = pool.get_index_size();
+  const auto base_vertex = static_cast<GLint>(allocation.first_vertex);
+
+  if (ranges.size() == 1) {
+    const auto& range = ranges.front();
+    const auto index_offset = (allocation.first_index + range.offset) * index_size;
+    glDrawElementsBaseVertex(GL_TRIANGLES,
+                             static_cast<GLsizei>(range.count),
+                             mesh.index_type,
+                             reinterpret_cast<const void*>(index_offset),  // NOLINT
+                             base_vertex);
+  }
+  else {
+    mDrawCounts.clear();
+    mDrawOffsets.clear();
+    mDrawBaseVertices.clear();
+
+    for (const auto& range : ranges) {
+      const auto index_offset = (allocation.first_index + range.offset) * index_size;
+      mDrawCounts.push_back(static_cast<GLsizei>(range.count));
+      mDrawOffsets.push_back(reinterpret_cast<const void*>(index_offset));  // NOLINT
+      mDrawBaseVertices.push_back(base_vertex);
+    }
+
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES,
+                                  mDrawCounts.data(),
+                                  mesh.index_type,
+                                  mDrawOffsets.data(),
+                                  static_cast<GLsizei>(ranges.size()),
+                                  mDrawBaseVertices.data());
+  }
+}
+
+auto Renderer::render_instanced_meshes(const Material& material,
+                                       const Vector<InstancedDraw>& draws) -> usize
+{
+  GLOW_ASSERT(get_bound_program() == mInstancedShadingProgram.get_id());
+  GLOW_ASSERT(!draws.empty());
 
-  mMaterialUBO.bind();
-  mMaterialUBO.update_data(0, sizeof mMaterialBuffer, &mMaterialBuffer);
+  mDrawUniforms.bind_data(0, &mInstancedMatrixBuffer, sizeof mInstancedMatrixBuffer);
+  bind_material(material);
+
+  bind_geometry_pool(*draws.front().mesh->buffers->pool);
+
+  return mMultiDrawIndirect ? render_indirect(draws) : render_instanced(draws);
+}
+
+auto Renderer::render_instanced(const Vector<InstancedDraw>& draws) -> usize
+{
+  usize draw_count = 0;
+
+  for (const auto& draw : draws) {
+    const auto& pool = *draw.mesh->buffers->pool;
+    const auto& allocation = draw.mesh->buffers->allocation;
+    GLOW_ASSERT(&pool == mBoundPool);
+
+    const auto index_offset =
+        (allocation.first_index + draw.range.offset) * pool.get_index_size();
+
+    for (usize first = 0; first < draw.instances.size(); first += kMaxInstancesPerDraw) {
+      const auto instances = draw.instances.subspan(first).first(
+          std::min(draw.instances.size() - first, kMaxInstancesPerDraw));
+      std::ranges::copy(instances, mInstanceBuffer.instances.begin());
+
+      // The whole block is bound, since the bound range may not be smaller than the block
+      mDrawUniforms.bind_data(2, &mInstanceBuffer, sizeof mInstanceBuffer);
+
+      glDrawElementsInstancedBaseVertex(
+          GL_TRIANGLES,
+          static_cast<GLsizei>(draw.range.count),
+          draw.mesh->index_type,
+          reinterpret_cast<const void*>(index_offset),  // NOLINT
+          static_cast<GLsizei>(instances.size()),
+          static_cast<GLint>(allocation.first_vertex));
+      ++draw_count;
+    }
+  }
+
+  return draw_count;
+}
+
+auto Renderer::render_indirect(const Vector<InstancedDraw>& draws) -> usize
+{
+  usize draw_count = 0;
+  usize instance_count = 0;
+
+  // Each indirect draw covers as many meshes as fit in the instance block
+  const auto flush = [&] {
+    if (mIndirectCommands.empty()) {
+      return;
+    }
+
+    mDrawUniforms.bind_data(2, &mInstanceBuffer, sizeof mInstanceBuffer);
+
+    mIndirectBuffer.bind();
+    mIndirectBuffer.upload_data(
+        mIndirectCommands.size() * sizeof(DrawElementsIndirectCommand),
+        mIndirectCommands.data());
+
+    glMultiDrawElementsIndirect(GL_TRIANGLES,
+                                draws.front().mesh->index_type,
+                                nullptr,
+                                static_cast<GLsizei>(mIndirectCommands.size()),
+                                0);
+    ++draw_count;
+
+    mIndirectCommands.clear();
+    instance_count = 0;
+  };
+
+  mIndirectCommands.clear();
+
+  for (const auto& draw : draws) {
+    const auto& allocation = draw.mesh->buffers->allocation;
+    GLOW_ASSERT(draw.mesh->buffers->pool.get() == mBoundPool);
+
+    for (usize first = 0; first < draw.instances.size();) {
+      if (instance_count == kMaxInstancesPerDraw) {
+        flush();
+      }
+
+      const auto instances = draw.instances.subspan(first).first(
+          std::min(draw.instances.size() - first, kMaxInstancesPerDraw - instance_count));
+      std::ranges::copy(instances, mInstanceBuffer.instances.begin() + instance_count);
+
+      mIndirectCommands.push_back(DrawElementsIndirectCommand {
+          .count = draw.range.count,
+          .instance_count = static_cast<uint32>(instances.size()),
+          .first_index = allocation.first_index + draw.range.offset,
+          .base_vertex = static_cast<int32>(allocation.first_vertex),
+          .base_instance = static_cast<uint32>(instance_count),
+      });
+
+      first += instances.size();
+      instance_count += instances.size();
+    }
+  }
+
+  flush();
+
+  return draw_count;
+}
+
+void Renderer::bind_geometry_pool(const GeometryPool& pool)
+{
+  // Consecutive draws of meshes in the same pool don't need to bind the VAO again
+  if (mBoundPool != &pool) {
+    pool.bind();
+    mBoundPool = &pool;
+  }
+}
+
+void Renderer::bind_material(const Material& material)
+{
+  mDrawUniforms.bind_data(1, &mMaterialBuffer, sizeof mMaterialBuffer);
 
   if (mMaterialBuffer.has_diffuse_tex) {
-    glActiveTexture(GL_TEXTURE5);
+    get_state_cache().set_active_texture(GL_TEXTURE5);
     Texture2D::bind(material.diffuse_tex.value());
   }
-
-  mesh.vao.bind();
-  glDrawElements(GL_TRIANGLES, mesh.index_count, GL_UNSIGNED_INT, nullptr);
 }
 
 }  // namespace glow::gl
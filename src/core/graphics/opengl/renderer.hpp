@@ -1,21 +1,36 @@
 #pragma once
 
+#include <span>  // span
+
 #include <SDL2/SDL.h>
 
 #include "common/predef.hpp"
 #include "common/type/chrono.hpp"
 #include "common/type/math.hpp"
+#include "common/type/vector.hpp"
+#include "graphics/culling.hpp"
 #include "graphics/opengl/framebuffer.hpp"
+#include "graphics/opengl/indirect_buffer.hpp"
 #include "graphics/opengl/program.hpp"
 #include "graphics/opengl/quad.hpp"
 #include "graphics/opengl/shader_buffers.hpp"
+#include "graphics/opengl/state_cache.hpp"
 #include "graphics/opengl/uniform_buffer.hpp"
+#include "graphics/opengl/uniform_ring_buffer.hpp"
 
 namespace glow::gl {
 
-GLOW_FORWARD_DECLARE_C(Texture2D);
+GLOW_FORWARD_DECLARE_C(TextureCube);
 GLOW_FORWARD_DECLARE_S(Mesh);
 GLOW_FORWARD_DECLARE_S(Material);
+GLOW_FORWARD_DECLARE_C(GeometryPool);
+
+/// An index range of a mesh that is rendered once per instance.
+struct InstancedDraw final {
+  const Mesh* mesh {};                       ///< The mesh to render.
+  IndexRange range {};                       ///< The index range to render.
+  std::span<const InstanceData> instances;  ///< The per-instance data.
+};
 
 class Renderer final {
  public:
@@ -28,18 +43,48 @@ class Renderer final {
   void swap_buffers();
 
   void bind_shading_program();
+  void bind_instanced_shading_program();
   void unbind_shading_program();
 
   void render_buffer_to_screen(const Framebuffer& framebuffer);
 
-  void render_environment(const Texture2D& texture);
-
-  void render_shaded_mesh(const Mesh& mesh, const Material& material);
+  void render_environment(const TextureCube& texture);
+
+  /// Renders index ranges of a mesh, using the shading program.
+  void render_shaded_mesh(const Mesh& mesh,
+                          const Material& material,
+                          const Vector<IndexRange>& ranges);
+
+  /// Renders meshes once per instance, using the instanced shading program.
+  ///
+  /// \details
+  /// If multi-draw indirect is available, the draws are combined into as few
+  /// indirect draw calls as possible, each covering up to `kMaxInstancesPerDraw`
+  /// instances. Otherwise, each draw is split into instanced draw calls of at most
+  /// `kMaxInstancesPerDraw` instances.
+  ///
+  /// \param material the material shared by the meshes.
+  /// \param draws the draws, which must use meshes from the same geometry pool.
+  ///
+  /// \return the number of issued draw calls.
+  auto render_instanced_meshes(const Material& material,
+                               const Vector<InstancedDraw>& draws) -> usize;
+
+  /// Indicates whether instanced draws are combined into indirect draw calls.
+  [[nodiscard]] auto has_multi_draw_indirect() const -> bool
+  {
+    return mMultiDrawIndirect;
+  }
 
   [[nodiscard]] auto get_env_buffer() -> EnvironmentBuffer& { return mEnvBuffer; }
 
   [[nodiscard]] auto get_matrix_buffer() -> MatrixBuffer& { return mMatrixBuffer; }
 
+  [[nodiscard]] auto get_instanced_matrix_buffer() -> InstancedMatrixBuffer&
+  {
+    return mInstancedMatrixBuffer;
+  }
+
   [[nodiscard]] auto get_material_buffer() -> MaterialBuffer& { return mMaterialBuffer; }
 
   [[nodiscard]] auto get_framebuffer_program_options_buffer()
@@ -50,6 +95,12 @@ class Renderer final {
 
   [[nodiscard]] auto get_frame_duration() const -> Duration { return mFrameDuration; }
 
+  /// Returns the state changes of the previous frame.
+  [[nodiscard]] auto get_state_cache_stats() const -> const StateCacheStats&
+  {
+    return mStateCacheStats;
+  }
+
  private:
   SDL_Window* mWindow {};
   Quad mQuad;
@@ -57,28 +108,50 @@ class Renderer final {
   // Shader programs
   Program mEnvProgram;
   Program mShadingProgram;
+  Program mInstancedShadingProgram;
   Program mFramebufferProgram;
 
   // UBOs
-  UniformBuffer mMatrixUBO;
-  UniformBuffer mMaterialUBO;
+  UniformRingBuffer mDrawUniforms;  ///< Per-draw matrix and material data.
   UniformBuffer mEnvUBO;
   UniformBuffer mFramebufferProgramOptionsUBO;
 
   // std140 layout buffer structs
   MatrixBuffer mMatrixBuffer;
+  InstancedMatrixBuffer mInstancedMatrixBuffer;
+  InstanceBuffer mInstanceBuffer;
   MaterialBuffer mMaterialBuffer;
   EnvironmentBuffer mEnvBuffer;
   FramebufferProgramOptions mFramebufferProgramOptions;
 
+  // Scratch buffers for multi-draw calls
+  Vector<int> mDrawCounts;
+  Vector<const void*> mDrawOffsets;
+  Vector<int> mDrawBaseVertices;
+  Vector<DrawElementsIndirectCommand> mIndirectCommands;
+  IndirectBuffer mIndirectBuffer;
+
+  const GeometryPool* mBoundPool {};  ///< The pool of the bound VAO, if any.
+  bool mMultiDrawIndirect {};         ///< Whether multi-draw indirect is available.
+
   // Performance info
   TimePoint mFrameStart {};
   Duration mFrameDuration {};
+  StateCacheStats mStateCacheStats;
 
   void init_uniform_buffers();
   void load_environment_program();
   void load_shading_program();
+  void load_instanced_shading_program();
   void load_framebuffer_program();
+
+  void bind_material(const Material& material);
+
+  void bind_geometry_pool(const GeometryPool& pool);
+
+  auto render_instanced(const Vector<InstancedDraw>& draws) -> usize;
+
+  auto render_indirect(const Vector<InstancedDraw>& draws) -> usize;
 };
 
 }  // namespace glow::gl
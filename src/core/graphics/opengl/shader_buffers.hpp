@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/primitives.hpp"
+#include "common/type/array.hpp"
 #include "common/type/math.hpp"
 
 namespace glow::gl {
@@ -16,12 +17,41 @@ struct EnvironmentBuffer final {
 
 /// This struct corresponds to a std140 layout uniform block.
 struct MatrixBuffer final {
-  alignas(16) Mat4 m {};       ///< Model matrix.
-  alignas(16) Mat4 mv {};      ///< Model-view matrix.
-  alignas(16) Mat4 mvp {};     ///< Model-view-projection matrix.
-  alignas(16) Mat4 normal {};  ///< Normal matrix.
+  alignas(16) Mat4 m {};                ///< Model matrix.
+  alignas(16) Mat4 mv {};               ///< Model-view matrix.
+  alignas(16) Mat4 mvp {};              ///< Model-view-projection matrix.
+  alignas(16) Mat4 normal {};           ///< Normal matrix.
+  alignas(16) Vec4 position_offset {};  ///< Offset used to decode vertex positions.
+  alignas(16) Vec4 position_scale {};   ///< Scale used to decode vertex positions.
+  int32 octahedral_normals {false};     ///< Whether normals are octahedral encoded.
 };
 
+/// The maximum number of instances drawn by a single instanced draw call.
+inline constexpr usize kMaxInstancesPerDraw = 128;
+
+/// This struct corresponds to a std140 layout uniform block, used by instanced draws.
+struct InstancedMatrixBuffer final {
+  alignas(16) Mat4 view {};          ///< View matrix.
+  alignas(16) Mat4 proj_view {};     ///< Projection-view matrix.
+  int32 octahedral_normals {false};  ///< Whether normals are octahedral encoded.
+};
+
+/// The per-instance data of an instanced draw.
+struct InstanceData final {
+  /// Model matrix, which also decodes the vertex positions of the mesh, since draws of
+  /// different meshes may share the instance block.
+  alignas(16) Mat4 model {};
+  alignas(16) Mat4 normal {};  ///< World space normal matrix.
+};
+
+/// This struct corresponds to a std140 layout uniform block.
+struct InstanceBuffer final {
+  Array<InstanceData, kMaxInstancesPerDraw> instances {};
+};
+
+// OpenGL only guarantees support for uniform blocks of up to 16 KiB
+static_assert(sizeof(InstanceBuffer) <= 16'384);
+
 /// This struct corresponds to a std140 layout uniform block.
 struct MaterialBuffer final {
   alignas(16) Vec4 ambient {};
@@ -0,0 +1,305 @@
+#include "state_cache.hpp"
+
+#include <glad/glad.h>
+
+#include "common/type/maybe.hpp"
+#include "graphics/opengl/util.hpp"
+
+namespace glow::gl {
+namespace {
+
+[[nodiscard]] auto _get_buffer_target_index(const uint target) -> Maybe<usize>
+{
+  switch (target) {
+    case GL_ARRAY_BUFFER:
+      return 0;
+
+    case GL_ELEMENT_ARRAY_BUFFER:
+      return 1;
+
+    case GL_UNIFORM_BUFFER:
+      return 2;
+
+    case GL_DRAW_INDIRECT_BUFFER:
+      return 3;
+
+    case GL_COPY_READ_BUFFER:
+      return 4;
+
+    case GL_COPY_WRITE_BUFFER:
+      return 5;
+
+    default:
+      return kNothing;
+  }
+}
+
+[[nodiscard]] auto _get_texture_target_index(const uint target) -> Maybe<usize>
+{
+  switch (target) {
+    case GL_TEXTURE_2D:
+      return 0;
+
+    case GL_TEXTURE_CUBE_MAP:
+      return 1;
+
+    default:
+      return kNothing;
+  }
+}
+
+}  // namespace
+
+StateCache::StateCache()
+{
+  invalidate();
+}
+
+void StateCache::invalidate() noexcept
+{
+  mProgram = kUnknown;
+  mVertexArray = kUnknown;
+  mActiveTexture = kUnknown;
+  mDrawFramebuffer = kUnknown;
+  mReadFramebuffer = kUnknown;
+
+  mBuffers.fill(kUnknown);
+  mUniformBindings.fill(BufferRange {});
+
+  for (auto& unit : mTextures) {
+    unit.fill(kUnknown);
+  }
+
+  mOptions.clear();
+}
+
+auto StateCache::update(uint& tracked, const uint value) noexcept -> bool
+{
+  if (tracked == value) {
+    ++mStats.redundant_state_change_count;
+    return false;
+  }
+
+  tracked = value;
+  ++mStats.state_change_count;
+
+  return true;
+}
+
+void StateCache::use_program(const uint program)
+{
+  if (update(mProgram, program)) {
+    glUseProgram(program);
+  }
+}
+
+void StateCache::bind_vertex_array(const uint vertex_array)
+{
+  if (update(mVertexArray, vertex_array)) {
+    glBindVertexArray(vertex_array);
+
+    // The index buffer binding is part of the VAO state
+    mBuffers[*_get_buffer_target_index(GL_ELEMENT_ARRAY_BUFFER)] = kUnknown;
+  }
+}
+
+void StateCache::bind_buffer(const uint target, const uint buffer)
+{
+  const auto target_index = _get_buffer_target_index(target);
+
+  if (!target_index.has_value()) {
+    ++mStats.state_change_count;
+    glBindBuffer(target, buffer);
+  }
+  else if (update(mBuffers[*target_index], buffer)) {
+    glBindBuffer(target, buffer);
+  }
+}
+
+void StateCache::bind_uniform_buffer_base(const uint binding, const uint buffer)
+{
+  // Indexed bindings also replace the generic binding
+  mBuffers[*_get_buffer_target_index(GL_UNIFORM_BUFFER)] = buffer;
+
+  if (binding < kUniformBindingCount) {
+    auto& range = mUniformBindings[binding];
+
+    if (range.buffer == buffer && range.size == 0) {
+      ++mStats.redundant_state_change_count;
+      return;
+    }
+
+    range = BufferRange {buffer, 0, 0};
+  }
+
+  ++mStats.state_change_count;
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+}
+
+void StateCache::bind_uniform_buffer_range(const uint binding,
+                                           const uint buffer,
+                                           const usize offset,
+                                           const usize size)
+{
+  mBuffers[*_get_buffer_target_index(GL_UNIFORM_BUFFER)] = buffer;
+
+  if (binding < kUniformBindingCount) {
+    auto& range = mUniformBindings[binding];
+
+    if (range.buffer == buffer && range.offset == offset && range.size == size) {
+      ++mStats.redundant_state_change_count;
+      return;
+    }
+
+    range = BufferRange {buffer, offset, size};
+  }
+
+  ++mStats.state_change_count;
+  glBindBufferRange(GL_UNIFORM_BUFFER,
+                    binding,
+                    buffer,
+                    static_cast<GLintptr>(offset),
+                    static_cast<GLsizeiptr>(size));
+}
+
+void StateCache::set_active_texture(const uint unit)
+{
+  if (update(mActiveTexture, unit)) {
+    glActiveTexture(unit);
+  }
+}
+
+void StateCache::bind_texture(const uint target, const uint texture)
+{
+  const auto unit_index = static_cast<usize>(mActiveTexture - GL_TEXTURE0);
+  const auto target_index = _get_texture_target_index(target);
+
+  if (mActiveTexture == kUnknown || unit_index >= kTextureUnitCount ||
+      !target_index.has_value()) {
+    ++mStats.state_change_count;
+    glBindTexture(target, texture);
+  }
+  else if (update(mTextures[unit_index][*target_index], texture)) {
+    glBindTexture(target, texture);
+  }
+}
+
+void StateCache::bind_framebuffer(const uint target, const uint framebuffer)
+{
+  if (target == GL_FRAMEBUFFER) {
+    if (mDrawFramebuffer == framebuffer && mReadFramebuffer == framebuffer) {
+      ++mStats.redundant_state_change_count;
+      return;
+    }
+
+    mDrawFramebuffer = framebuffer;
+    mReadFramebuffer = framebuffer;
+
+    ++mStats.state_change_count;
+    glBindFramebuffer(target, framebuffer);
+  }
+  else if (update((target == GL_DRAW_FRAMEBUFFER) ? mDrawFramebuffer : mReadFramebuffer,
+                  framebuffer)) {
+    glBindFramebuffer(target, framebuffer);
+  }
+}
+
+void StateCache::set_option(const uint option, const bool enabled)
+{
+  const auto [iter, inserted] = mOptions.try_emplace(option, enabled);
+
+  if (!inserted && iter->second == enabled) {
+    ++mStats.redundant_state_change_count;
+    return;
+  }
+
+  iter->second = enabled;
+  ++mStats.state_change_count;
+
+  if (enabled) {
+    glEnable(option);
+  }
+  else {
+    glDisable(option);
+  }
+}
+
+auto StateCache::is_enabled(const uint option) -> bool
+{
+  if (const auto iter = mOptions.find(option); iter != mOptions.end()) {
+    return iter->second;
+  }
+
+  const auto enabled = glIsEnabled(option) == GL_TRUE;
+  mOptions.try_emplace(option, enabled);
+
+  return enabled;
+}
+
+void StateCache::forget_program(const uint program) noexcept
+{
+  // Deleted programs remain in use until another program is used
+  if (mProgram == program) {
+    mProgram = kUnknown;
+  }
+}
+
+void StateCache::forget_vertex_array(const uint vertex_array) noexcept
+{
+  if (mVertexArray == vertex_array) {
+    mVertexArray = 0;
+  }
+}
+
+void StateCache::forget_buffer(const uint buffer) noexcept
+{
+  // Deleted buffers are unbound from all targets and binding points
+  for (auto& bound_buffer : mBuffers) {
+    if (bound_buffer == buffer) {
+      bound_buffer = 0;
+    }
+  }
+
+  for (auto& range : mUniformBindings) {
+    if (range.buffer == buffer) {
+      range = BufferRange {0, 0, 0};
+    }
+  }
+}
+
+void StateCache::forget_texture(const uint texture) noexcept
+{
+  for (auto& unit : mTextures) {
+    for (auto& bound_texture : unit) {
+      if (bound_texture == texture) {
+        bound_texture = 0;
+      }
+    }
+  }
+}
+
+void StateCache::forget_framebuffer(const uint framebuffer) noexcept
+{
+  if (mDrawFramebuffer == framebuffer) {
+    mDrawFramebuffer = 0;
+  }
+
+  if (mReadFramebuffer == framebuffer) {
+    mReadFramebuffer = 0;
+  }
+}
+
+auto StateCache::take_stats() noexcept -> StateCacheStats
+{
+  const auto stats = mStats;
+  mStats = StateCacheStats {};
+  return stats;
+}
+
+auto get_state_cache() -> StateCache&
+{
+  static StateCache cache;
+  return cache;
+}
+
+}  // namespace glow::gl
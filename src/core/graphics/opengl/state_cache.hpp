@@ -0,0 +1,105 @@
+#pragma once
+
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/array.hpp"
+#include "common/type/map.hpp"
+
+namespace glow::gl {
+
+/// Counts the state changes requested through a state cache.
+struct StateCacheStats final {
+  usize state_change_count {};            ///< The number of calls issued to the driver.
+  usize redundant_state_change_count {};  ///< The number of skipped redundant calls.
+};
+
+/// Shadows the OpenGL state that is modified by the GL wrappers, to skip redundant calls.
+///
+/// \details
+/// Binding an object that is already bound, or setting an option to its current value,
+/// doesn't reach the driver. State that the cache hasn't seen being set is unknown, and
+/// is always passed on to the driver.
+///
+/// The cache must be invalidated when other code modifies the GL state, e.g. the ImGui
+/// renderer. Deleted objects must also be reported, since their names may be reused.
+class StateCache final {
+ public:
+  GLOW_DELETE_COPY(StateCache);
+  GLOW_DELETE_MOVE(StateCache);
+
+  StateCache();
+
+  /// Forgets all tracked state, which is then treated as unknown.
+  void invalidate() noexcept;
+
+  void use_program(uint program);
+
+  void bind_vertex_array(uint vertex_array);
+
+  /// Binds a buffer to a generic binding target, e.g. GL_ARRAY_BUFFER.
+  void bind_buffer(uint target, uint buffer);
+
+  /// Binds a uniform buffer to an indexed binding point.
+  void bind_uniform_buffer_base(uint binding, uint buffer);
+
+  /// Binds a range of a uniform buffer to an indexed binding point.
+  void bind_uniform_buffer_range(uint binding, uint buffer, usize offset, usize size);
+
+  /// Selects the active texture unit, e.g. GL_TEXTURE0.
+  void set_active_texture(uint unit);
+
+  /// Binds a texture to the active texture unit.
+  void bind_texture(uint target, uint texture);
+
+  /// Binds a framebuffer, where GL_FRAMEBUFFER binds both the draw and read targets.
+  void bind_framebuffer(uint target, uint framebuffer);
+
+  /// Enables or disables a capability, e.g. GL_DEPTH_TEST.
+  void set_option(uint option, bool enabled);
+
+  /// Indicates whether a capability is enabled, only querying the driver if unknown.
+  [[nodiscard]] auto is_enabled(uint option) -> bool;
+
+  void forget_program(uint program) noexcept;
+  void forget_vertex_array(uint vertex_array) noexcept;
+  void forget_buffer(uint buffer) noexcept;
+  void forget_texture(uint texture) noexcept;
+  void forget_framebuffer(uint framebuffer) noexcept;
+
+  /// Returns the counters since the last call, and resets them.
+  [[nodiscard]] auto take_stats() noexcept -> StateCacheStats;
+
+ private:
+  /// Marks tracked state that hasn't been observed.
+  static constexpr uint kUnknown = ~uint {0};
+
+  static constexpr usize kBufferTargetCount = 6;
+  static constexpr usize kUniformBindingCount = 16;
+  static constexpr usize kTextureUnitCount = 16;
+  static constexpr usize kTextureTargetCount = 2;
+
+  struct BufferRange final {
+    uint buffer {kUnknown};
+    usize offset {};
+    usize size {};  ///< The size of the range, or zero if the whole buffer is bound.
+  };
+
+  uint mProgram {kUnknown};
+  uint mVertexArray {kUnknown};
+  uint mActiveTexture {kUnknown};
+  uint mDrawFramebuffer {kUnknown};
+  uint mReadFramebuffer {kUnknown};
+  Array<uint, kBufferTargetCount> mBuffers {};
+  Array<BufferRange, kUniformBindingCount> mUniformBindings {};
+  Array<Array<uint, kTextureTargetCount>, kTextureUnitCount> mTextures {};
+  HashMap<uint, bool> mOptions;
+  StateCacheStats mStats;
+
+  /// Updates a tracked value, returning true if the call must be issued.
+  [[nodiscard]] auto update(uint& tracked, uint value) noexcept -> bool;
+};
+
+/// Returns the state cache of the OpenGL context.
+[[nodiscard]] auto get_state_cache() -> StateCache&;
+
+}  // namespace glow::gl
@@ -3,6 +3,7 @@
 #include <glad/glad.h>
 
 #include "common/debug/assert.hpp"
+#include "graphics/opengl/state_cache.hpp"
 #include "graphics/opengl/util.hpp"
 #include "io/texture_loader.hpp"
 
@@ -50,6 +51,7 @@ void Texture2D::dispose() noexcept
 {
   if (mID != 0) {
     glDeleteTextures(1, &mID);
+    get_state_cache().forget_texture(mID);
   }
 }
 
@@ -69,37 +71,21 @@ auto Texture2D::load_rgb(const Path& path) -> Maybe<Texture2D>
   return texture;
 }
 
-auto Texture2D::load_rgb_f32(const Path& path) -> Maybe<Texture2D>
-{
-  const auto data = load_texture_data(path, TextureFormat::Float, TextureChannels::RGB);
-  if (!data) {
-    return kNothing;
-  }
-
-  Texture2D texture;
-
-  texture.bind();
-  texture.set_data(0, GL_RGB32F, GL_RGB, GL_FLOAT, data->size, data->pixels.get());
-  Texture2D::unbind();
-
-  return texture;
-}
-
 void Texture2D::bind() const
 {
-  glBindTexture(GL_TEXTURE_2D, mID);
+  get_state_cache().bind_texture(GL_TEXTURE_2D, mID);
   GLOW_GL_CHECK_ERRORS();
 }
 
 void Texture2D::bind(const uint id)
 {
-  glBindTexture(GL_TEXTURE_2D, id);
+  get_state_cache().bind_texture(GL_TEXTURE_2D, id);
   GLOW_GL_CHECK_ERRORS();
 }
 
 void Texture2D::unbind()
 {
-  glBindTexture(GL_TEXTURE_2D, 0);
+  get_state_cache().bind_texture(GL_TEXTURE_2D, 0);
   GLOW_GL_CHECK_ERRORS();
 }
 
@@ -123,6 +109,45 @@ void Texture2D::set_data(const int detail_level,
   GLOW_GL_CHECK_ERRORS();
 }
 
+void Texture2D::set_compressed_data(const int detail_level,
+                                    const uint texture_format,
+                                    const Vec2i& size,
+                                    const usize byte_size,
+                                    const void* data)
+{
+  GLOW_ASSERT(get_bound_texture() == mID);
+  glCompressedTexImage2D(GL_TEXTURE_2D,
+                         detail_level,
+                         texture_format,
+                         size.x,
+                         size.y,
+                         0,
+                         static_cast<GLsizei>(byte_size),
+                         data);
+  GLOW_GL_CHECK_ERRORS();
+}
+
+void Texture2D::set_mip_level_count(const int level_count)
+{
+  GLOW_ASSERT(get_bound_texture() == mID);
+  GLOW_ASSERT(level_count > 0);
+
+  const auto min_filter = (level_count > 1) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level_count - 1);
+
+  GLOW_GL_CHECK_ERRORS();
+}
+
+void Texture2D::set_base_level(const int level)
+{
+  GLOW_ASSERT(get_bound_texture() == mID);
+  GLOW_ASSERT(level >= 0);
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+  GLOW_GL_CHECK_ERRORS();
+}
+
 void Texture2D::generate_mipmap()
 {
   GLOW_ASSERT(get_bound_texture() == mID);
@@ -30,8 +30,6 @@ class Texture2D final {
 
   [[nodiscard]] static auto load_rgb(const Path& path) -> Maybe<Texture2D>;
 
-  [[nodiscard]] static auto load_rgb_f32(const Path& path) -> Maybe<Texture2D>;
-
   /// Enables the texture for subsequent draw calls.
   void bind() const;
 
@@ -58,6 +56,39 @@ class Texture2D final {
                 const Vec2i& size,
                 const void* pixel_data);
 
+  /// Sets the block compressed pixel data associated with a mip level.
+  ///
+  /// \pre The texture must be bound when this function is called.
+  ///
+  /// \param detail_level the level-of-detail (LOD) index.
+  /// \param texture_format the compressed format, e.g. 'GL_COMPRESSED_RG_RGTC2'.
+  /// \param size the size of the mip level.
+  /// \param byte_size the size of the compressed data, in bytes.
+  /// \param data the compressed pixel data.
+  void set_compressed_data(int detail_level,
+                           uint texture_format,
+                           const Vec2i& size,
+                           usize byte_size,
+                           const void* data);
+
+  /// Enables mipmapping using mip levels that have been provided manually.
+  ///
+  /// \pre The texture must be bound when this function is called.
+  ///
+  /// \param level_count the number of provided mip levels, including the base level.
+  void set_mip_level_count(int level_count);
+
+  /// Sets the most detailed mip level that may be sampled.
+  ///
+  /// \details
+  /// This is used to stream in mip levels, where the texture is usable as soon as the
+  /// levels from the base level to the maximum level have been provided.
+  ///
+  /// \pre The texture must be bound when this function is called.
+  ///
+  /// \param level the index of the base level.
+  void set_base_level(int level);
+
   /// Generates a mipmap for the texture.
   ///
   /// \note This should be called after the texture data has been provided.
@@ -1,20 +1,20 @@
 #pragma once
 
+#include "common/hash.hpp"
 #include "common/predef.hpp"
 #include "common/type/map.hpp"
-#include "common/type/path.hpp"
 #include "graphics/opengl/texture_2d.hpp"
 
 namespace glow::gl {
 
-/// Context component used to keep track of loaded textures.
+/// Context component used to keep track of loaded textures, by their contents.
 struct TextureCache final {
   TextureCache() = default;
   ~TextureCache() = default;
   GLOW_DELETE_COPY(TextureCache);
   GLOW_DEFAULT_MOVE(TextureCache);
 
-  Map<Path, Texture2D> textures;
+  Map<ContentHash, Texture2D> textures;
 };
 
 }  // namespace glow::gl
@@ -0,0 +1,149 @@
+#include "texture_cube.hpp"
+
+#include <glad/glad.h>
+
+#include "common/debug/assert.hpp"
+#include "graphics/opengl/state_cache.hpp"
+#include "graphics/opengl/util.hpp"
+
+namespace glow::gl {
+
+TextureCube::TextureCube()
+{
+  glGenTextures(1, &mID);
+  bind();
+
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+  unbind();
+  GLOW_GL_CHECK_ERRORS();
+}
+
+TextureCube::~TextureCube() noexcept
+{
+  dispose();
+}
+
+TextureCube::TextureCube(TextureCube&& other) noexcept
+    : mID {other.mID}
+{
+  other.mID = 0;
+}
+
+auto TextureCube::operator=(TextureCube&& other) noexcept -> TextureCube&
+{
+  if (this != &other) {
+    dispose();
+
+    mID = other.mID;
+    other.mID = 0;
+  }
+
+  return *this;
+}
+
+void TextureCube::dispose() noexcept
+{
+  if (mID != 0) {
+    glDeleteTextures(1, &mID);
+    get_state_cache().forget_texture(mID);
+  }
+}
+
+auto TextureCube::load_hdr(const Path& path, const EnvironmentQuality quality)
+    -> Maybe<TextureCube>
+{
+  const auto data = load_environment_cubemap(path, quality);
+  if (!data) {
+    return kNothing;
+  }
+
+  TextureCube texture;
+  texture.bind();
+
+  for (usize level = 0; level < data->levels.size(); ++level) {
+    for (usize face = 0; face < data->face_count; ++face) {
+      const auto detail_level = static_cast<int>(level);
+      const auto& size = data->levels[level].size;
+      const auto* face_data = data->get_face_data(level, face);
+
+      if (data->format == PixelFormat::RGB9E5) {
+        texture.set_face_data(face,
+                              detail_level,
+                              GL_RGB9_E5,
+                              GL_RGB,
+                              GL_UNSIGNED_INT_5_9_9_9_REV,
+                              size,
+                              face_data);
+      }
+      else {
+        texture.set_face_data(face,
+                              detail_level,
+                              GL_RGBA16F,
+                              GL_RGBA,
+                              GL_HALF_FLOAT,
+                              size,
+                              face_data);
+      }
+    }
+  }
+
+  texture.set_mip_level_count(static_cast<int>(data->levels.size()));
+  TextureCube::unbind();
+
+  return texture;
+}
+
+void TextureCube::bind() const
+{
+  get_state_cache().bind_texture(GL_TEXTURE_CUBE_MAP, mID);
+  GLOW_GL_CHECK_ERRORS();
+}
+
+void TextureCube::unbind()
+{
+  get_state_cache().bind_texture(GL_TEXTURE_CUBE_MAP, 0);
+  GLOW_GL_CHECK_ERRORS();
+}
+
+void TextureCube::set_face_data(const usize face,
+                                const int detail_level,
+                                const int texture_format,
+                                const uint pixel_format,
+                                const uint type,
+                                const Vec2i& size,
+                                const void* pixel_data)
+{
+  GLOW_ASSERT(get_bound_cube_texture() == mID);
+  GLOW_ASSERT(face < 6);
+
+  glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<uint>(face),
+               detail_level,
+               texture_format,
+               size.x,
+               size.y,
+               0,
+               pixel_format,
+               type,
+               pixel_data);
+  GLOW_GL_CHECK_ERRORS();
+}
+
+void TextureCube::set_mip_level_count(const int level_count)
+{
+  GLOW_ASSERT(get_bound_cube_texture() == mID);
+  GLOW_ASSERT(level_count > 0);
+
+  const auto min_filter = (level_count > 1) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, min_filter);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, level_count - 1);
+
+  GLOW_GL_CHECK_ERRORS();
+}
+
+}  // namespace glow::gl
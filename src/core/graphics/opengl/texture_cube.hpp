@@ -0,0 +1,74 @@
+#pragma once
+
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/math.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/path.hpp"
+#include "io/hdr_texture.hpp"
+
+namespace glow::gl {
+
+/// Represents an OpenGL cubemap texture.
+class TextureCube final {
+ public:
+  GLOW_DELETE_COPY(TextureCube);
+
+  /// Creates a cubemap texture.
+  ///
+  /// \details
+  /// The texture uses linear filtering and a clamp-to-edge wrapping strategy. The
+  /// texture will not be bound when the constructor returns.
+  TextureCube();
+
+  ~TextureCube() noexcept;
+
+  TextureCube(TextureCube&& other) noexcept;
+
+  auto operator=(TextureCube&& other) noexcept -> TextureCube&;
+
+  /// Loads an equirectangular HDR texture as a cubemap, see `load_environment_cubemap`.
+  [[nodiscard]] static auto load_hdr(const Path& path, EnvironmentQuality quality)
+      -> Maybe<TextureCube>;
+
+  /// Enables the texture for subsequent draw calls.
+  void bind() const;
+
+  /// Unbinds any bound cubemap texture.
+  static void unbind();
+
+  /// Sets the pixel data of a single face of a mip level.
+  ///
+  /// \pre The texture must be bound when this function is called.
+  ///
+  /// \param face the face index, in the order +X, -X, +Y, -Y, +Z, -Z.
+  /// \param detail_level the level-of-detail (LOD) index.
+  /// \param texture_format the texture format, e.g. 'GL_RGB9_E5'.
+  /// \param pixel_format the format of the pixel data, e.g. 'GL_RGB'.
+  /// \param type the texture format data type, e.g. 'GL_HALF_FLOAT'.
+  /// \param size the size of the face.
+  /// \param pixel_data the raw pixel data.
+  void set_face_data(usize face,
+                     int detail_level,
+                     int texture_format,
+                     uint pixel_format,
+                     uint type,
+                     const Vec2i& size,
+                     const void* pixel_data);
+
+  /// Enables mipmapping using mip levels that have been provided manually.
+  ///
+  /// \pre The texture must be bound when this function is called.
+  ///
+  /// \param level_count the number of provided mip levels, including the base level.
+  void set_mip_level_count(int level_count);
+
+  [[nodiscard]] auto get_id() const -> uint { return mID; }
+
+ private:
+  uint mID {};
+
+  void dispose() noexcept;
+};
+
+}  // namespace glow::gl
@@ -4,14 +4,14 @@
 
 #include <glad/glad.h>
 
-#include "common/debug/assert.hpp"
+#include "graphics/opengl/state_cache.hpp"
 #include "graphics/opengl/util.hpp"
 
 namespace glow::gl {
 
 UniformBuffer::UniformBuffer()
 {
-  glGenBuffers(1, &mID);
+  mID = create_buffer();
 }
 
 UniformBuffer::~UniformBuffer() noexcept
@@ -41,37 +41,36 @@ void UniformBuffer::dispose() noexcept
 {
   if (mID != 0) {
     glDeleteBuffers(1, &mID);
+    get_state_cache().forget_buffer(mID);
   }
 }
 
 void UniformBuffer::bind() const
 {
-  glBindBuffer(GL_UNIFORM_BUFFER, mID);
+  get_state_cache().bind_buffer(GL_UNIFORM_BUFFER, mID);
   GLOW_GL_CHECK_ERRORS();
 }
 
 void UniformBuffer::unbind()
 {
-  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  get_state_cache().bind_buffer(GL_UNIFORM_BUFFER, 0);
   GLOW_GL_CHECK_ERRORS();
 }
 
 void UniformBuffer::bind_block(const int binding)
 {
-  glBindBufferBase(GL_UNIFORM_BUFFER, binding, mID);
+  get_state_cache().bind_uniform_buffer_base(static_cast<uint>(binding), mID);
   GLOW_GL_CHECK_ERRORS();
 }
 
 void UniformBuffer::unbind_block(const int binding)
 {
-  glBindBufferBase(GL_UNIFORM_BUFFER, binding, 0);
+  get_state_cache().bind_uniform_buffer_base(static_cast<uint>(binding), 0);
   GLOW_GL_CHECK_ERRORS();
 }
 
 void UniformBuffer::reserve_space(const ssize data_size, const BufferUsage usage)
 {
-  GLOW_ASSERT(mID == get_bound_uniform_buffer());
-
   std::vector<Byte> buffer;
   buffer.resize(static_cast<usize>(data_size));
 
@@ -82,9 +81,13 @@ void UniformBuffer::set_data(const ssize data_size,
                              const void* data,
                              const BufferUsage usage)
 {
-  GLOW_ASSERT(mID == get_bound_uniform_buffer());
-
-  glBufferData(GL_UNIFORM_BUFFER, data_size, data, convert_buffer_usage(usage));
+  if (has_direct_state_access()) {
+    glNamedBufferData(mID, data_size, data, convert_buffer_usage(usage));
+  }
+  else {
+    bind();
+    glBufferData(GL_UNIFORM_BUFFER, data_size, data, convert_buffer_usage(usage));
+  }
   GLOW_GL_CHECK_ERRORS();
 }
 
@@ -92,9 +95,13 @@ void UniformBuffer::update_data(const ssize offset,
                                 const ssize data_size,
                                 const void* data)
 {
-  GLOW_ASSERT(mID == get_bound_uniform_buffer());
-
-  glBufferSubData(GL_UNIFORM_BUFFER, offset, data_size, data);
+  if (has_direct_state_access()) {
+    glNamedBufferSubData(mID, offset, data_size, data);
+  }
+  else {
+    bind();
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, data_size, data);
+  }
   GLOW_GL_CHECK_ERRORS();
 }
 
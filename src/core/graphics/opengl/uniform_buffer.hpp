@@ -35,7 +35,7 @@ class UniformBuffer final {
   /**
    * \brief Allocates the specified amount of zero-initialized storage in the UBO.
    *
-   * \pre The UBO must be bound when this function is called.
+   * \note The UBO is bound by this function, unless direct state access is available.
    *
    * \param data_size the size of the storage, in bytes.
    * \param usage buffer usage hint.
@@ -45,7 +45,7 @@ class UniformBuffer final {
   /**
    * Replaces the data in the UBO.
    *
-   * \pre The UBO must be bound when this function is called.
+   * \note The UBO is bound by this function, unless direct state access is available.
    *
    * \note Frequent updates to the buffer data should be done using `update_data`.
    *
@@ -60,7 +60,7 @@ class UniformBuffer final {
   /**
    * Updates existing data in the UBO.
    *
-   * \pre The UBO must be bound when this function is called.
+   * \note The UBO is bound by this function, unless direct state access is available.
    *
    * \param offset the offset of the data member that will be changed.
    * \param data_size the size of the data member, in bytes.
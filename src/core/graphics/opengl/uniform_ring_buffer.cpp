@@ -0,0 +1,287 @@
+#include "uniform_ring_buffer.hpp"
+
+#include <algorithm>  // max
+#include <cstring>    // memcpy
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include "common/debug/assert.hpp"
+#include "graphics/opengl/state_cache.hpp"
+#include "graphics/opengl/util.hpp"
+
+namespace glow::gl {
+namespace {
+
+// Fence waits are retried after this many nanoseconds, until the fence is signaled.
+inline constexpr GLuint64 kFenceTimeout = 1'000'000'000;
+
+[[nodiscard]] auto _align_offset(const usize offset, const usize alignment) -> usize
+{
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+void _wait_for_fence(GLsync fence)
+{
+  auto status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeout);
+
+  while (status == GL_TIMEOUT_EXPIRED) {
+    status = glClientWaitSync(fence, 0, kFenceTimeout);
+  }
+
+  if (status == GL_WAIT_FAILED) {
+    spdlog::error("[GL] Failed to wait for uniform buffer fence");
+  }
+}
+
+/// Replaces the storage of a buffer that is written with `glBufferSubData`.
+void _set_buffer_size(const uint buffer, const usize size)
+{
+  if (has_direct_state_access()) {
+    glNamedBufferData(buffer, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+  }
+  else {
+    get_state_cache().bind_buffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER,
+                 static_cast<GLsizeiptr>(size),
+                 nullptr,
+                 GL_STREAM_DRAW);
+  }
+}
+
+void _write_buffer(const uint buffer,
+                   const usize offset,
+                   const void* data,
+                   const usize data_size)
+{
+  if (has_direct_state_access()) {
+    glNamedBufferSubData(buffer,
+                         static_cast<GLintptr>(offset),
+                         static_cast<GLsizeiptr>(data_size),
+                         data);
+  }
+  else {
+    get_state_cache().bind_buffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER,
+                    static_cast<GLintptr>(offset),
+                    static_cast<GLsizeiptr>(data_size),
+                    data);
+  }
+}
+
+void _delete_buffer(uint& buffer) noexcept
+{
+  glDeleteBuffers(1, &buffer);
+  get_state_cache().forget_buffer(buffer);
+  buffer = 0;
+}
+
+}  // namespace
+
+UniformRingBuffer::UniformRingBuffer(const usize frame_size)
+{
+  int alignment {};
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  mAlignment = static_cast<usize>(std::max(alignment, 1));
+
+  allocate(frame_size);
+
+  spdlog::debug("[GL] Using {} uniform ring buffer ({} byte alignment)",
+                is_persistently_mapped() ? "persistently mapped" : "orphaned",
+                mAlignment);
+}
+
+UniformRingBuffer::~UniformRingBuffer() noexcept
+{
+  dispose();
+}
+
+void UniformRingBuffer::dispose() noexcept
+{
+  release_overflow_buffers();
+
+  for (auto& fence : mFences) {
+    if (fence != nullptr) {
+      glDeleteSync(static_cast<GLsync>(fence));
+      fence = nullptr;
+    }
+  }
+
+  if (mID != 0) {
+    // Buffers are only released by the driver once they are no longer used by the GPU
+    if (mMappedData != nullptr) {
+      if (has_direct_state_access()) {
+        glUnmapNamedBuffer(mID);
+      }
+      else {
+        get_state_cache().bind_buffer(GL_UNIFORM_BUFFER, mID);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+      }
+    }
+
+    _delete_buffer(mID);
+    mMappedData = nullptr;
+  }
+}
+
+void UniformRingBuffer::allocate(const usize frame_size)
+{
+  dispose();
+
+  mFrameSize = _align_offset(frame_size, mAlignment);
+  mFrameOffset = 0;
+
+  mID = create_buffer();
+
+  if (GLAD_GL_ARB_buffer_storage) {
+    const auto buffer_size = static_cast<GLsizeiptr>(mFrameSize * kFrameCount);
+    const GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    void* mapped_data {};
+
+    if (has_direct_state_access()) {
+      glNamedBufferStorage(mID, buffer_size, nullptr, flags);
+      mapped_data = glMapNamedBufferRange(mID, 0, buffer_size, flags);
+    }
+    else {
+      get_state_cache().bind_buffer(GL_UNIFORM_BUFFER, mID);
+      glBufferStorage(GL_UNIFORM_BUFFER, buffer_size, nullptr, flags);
+      mapped_data = glMapBufferRange(GL_UNIFORM_BUFFER, 0, buffer_size, flags);
+    }
+
+    mMappedData = static_cast<Byte*>(mapped_data);
+  }
+  else {
+    orphan();
+  }
+
+  GLOW_GL_CHECK_ERRORS();
+}
+
+void UniformRingBuffer::orphan()
+{
+  _set_buffer_size(mID, mFrameSize);
+}
+
+void UniformRingBuffer::release_overflow_buffers() noexcept
+{
+  // Deleted buffers are only released by the driver once the GPU no longer uses them
+  for (auto& buffer : mRetiredOverflowBuffers) {
+    _delete_buffer(buffer);
+  }
+
+  mRetiredOverflowBuffers.clear();
+
+  if (mOverflowID != 0) {
+    _delete_buffer(mOverflowID);
+  }
+
+  mOverflowSize = 0;
+  mOverflowOffset = 0;
+}
+
+void UniformRingBuffer::begin_frame()
+{
+  // Buffers are only replaced between frames, since deleting a buffer resets the
+  // bindings that the pending draw call of the frame may still depend on.
+  release_overflow_buffers();
+
+  if (mFrameUsage > mFrameSize) {
+    const auto frame_size = std::max(mFrameSize * 2, mFrameUsage);
+    spdlog::debug("[GL] Growing uniform ring buffer to {} KiB per frame",
+                  frame_size / 1'024);
+
+    // The new buffer isn't used by any frame yet, so there's nothing to wait for
+    allocate(frame_size);
+  }
+  else if (mMappedData != nullptr) {
+    mFrameIndex = (mFrameIndex + 1) % kFrameCount;
+
+    if (auto& fence = mFences[mFrameIndex]; fence != nullptr) {
+      _wait_for_fence(static_cast<GLsync>(fence));
+      glDeleteSync(static_cast<GLsync>(fence));
+      fence = nullptr;
+    }
+  }
+  else {
+    // Orphaning lets the driver allocate new storage, instead of waiting for the GPU
+    orphan();
+  }
+
+  mFrameOffset = 0;
+  mFrameUsage = 0;
+
+  GLOW_GL_CHECK_ERRORS();
+}
+
+void UniformRingBuffer::end_frame()
+{
+  if (mMappedData != nullptr) {
+    GLOW_ASSERT(mFences[mFrameIndex] == nullptr);
+    mFences[mFrameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+}
+
+void UniformRingBuffer::bind_data(const int binding,
+                                  const void* data,
+                                  const usize data_size)
+{
+  // The partitions are resized to fit the data of the largest frame in the next frame
+  mFrameUsage += _align_offset(data_size, mAlignment);
+
+  if (mFrameOffset + data_size > mFrameSize) {
+    bind_overflow_data(binding, data, data_size);
+    return;
+  }
+
+  const auto partition_offset = (mMappedData != nullptr) ? mFrameIndex * mFrameSize : 0;
+  const auto offset = partition_offset + mFrameOffset;
+
+  if (mMappedData != nullptr) {
+    std::memcpy(mMappedData + offset, data, data_size);
+  }
+  else {
+    _write_buffer(mID, offset, data, data_size);
+  }
+
+  get_state_cache().bind_uniform_buffer_range(static_cast<uint>(binding),
+                                              mID,
+                                              offset,
+                                              data_size);
+  GLOW_GL_CHECK_ERRORS();
+
+  mFrameOffset = _align_offset(mFrameOffset + data_size, mAlignment);
+}
+
+void UniformRingBuffer::bind_overflow_data(const int binding,
+                                           const void* data,
+                                           const usize data_size)
+{
+  // Slots that were already written this frame may still be bound for the pending draw
+  // call, so a full overflow buffer is kept alive until the next frame.
+  if (mOverflowOffset + data_size > mOverflowSize) {
+    if (mOverflowID != 0) {
+      mRetiredOverflowBuffers.push_back(mOverflowID);
+    }
+
+    mOverflowSize = _align_offset(std::max({mOverflowSize * 2, mFrameSize, data_size}),
+                                  mAlignment);
+    mOverflowOffset = 0;
+
+    mOverflowID = create_buffer();
+    _set_buffer_size(mOverflowID, mOverflowSize);
+  }
+
+  _write_buffer(mOverflowID, mOverflowOffset, data, data_size);
+
+  get_state_cache().bind_uniform_buffer_range(static_cast<uint>(binding),
+                                              mOverflowID,
+                                              mOverflowOffset,
+                                              data_size);
+  GLOW_GL_CHECK_ERRORS();
+
+  mOverflowOffset = _align_offset(mOverflowOffset + data_size, mAlignment);
+}
+
+}  // namespace glow::gl
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/array.hpp"
+#include "common/type/vector.hpp"
+
+namespace glow::gl {
+
+/// A uniform buffer for data that changes with every draw call.
+///
+/// \details
+/// The buffer is split into one partition per frame in flight. Each write goes to the
+/// next aligned slot of the partition of the current frame, and the slot is bound with
+/// `glBindBufferRange`, so no slot is overwritten while the GPU may still read from it.
+///
+/// If `ARB_buffer_storage` is available, the buffer is persistently mapped, and fences
+/// guard the reuse of each partition. Otherwise, a single partition is orphaned at the
+/// start of each frame, and the slots are written with `glBufferSubData`.
+///
+/// When a frame writes more data than a partition can hold, the remaining slots of the
+/// frame are written to temporary overflow buffers, and the partitions are enlarged at
+/// the start of the next frame. Buffers are never replaced during a frame, since that
+/// would reset the bindings of slots that were already bound for the pending draw call.
+class UniformRingBuffer final {
+ public:
+  GLOW_DELETE_COPY(UniformRingBuffer);
+  GLOW_DELETE_MOVE(UniformRingBuffer);
+
+  /// The maximum number of frames that the GPU may lag behind the CPU.
+  static constexpr usize kFrameCount = 3;
+
+  /// Creates a ring buffer.
+  ///
+  /// \param frame_size the initial size of each frame partition, in bytes.
+  explicit UniformRingBuffer(usize frame_size);
+
+  ~UniformRingBuffer() noexcept;
+
+  /// Starts writing to the partition of the next frame.
+  ///
+  /// \details
+  /// This waits for the GPU to finish the frame that last used the partition, which
+  /// should rarely block since that frame was submitted several frames ago.
+  void begin_frame();
+
+  /// Marks the end of the draw calls that use the partition of the current frame.
+  void end_frame();
+
+  /// Copies data into the next slot, and binds the slot to a uniform block binding.
+  ///
+  /// \param binding the uniform block binding point.
+  /// \param data the data to copy.
+  /// \param data_size the size of the data, in bytes.
+  void bind_data(int binding, const void* data, usize data_size);
+
+  [[nodiscard]] auto is_persistently_mapped() const noexcept -> bool
+  {
+    return mMappedData != nullptr;
+  }
+
+ private:
+  uint mID {};
+  Byte* mMappedData {};   ///< The persistently mapped buffer, if supported.
+  usize mAlignment {};    ///< The required alignment of slot offsets.
+  usize mFrameSize {};    ///< The size of each frame partition, in bytes.
+  usize mFrameIndex {};   ///< The index of the partition of the current frame.
+  usize mFrameOffset {};  ///< Offset of the next slot, relative to the partition.
+  usize mFrameUsage {};   ///< The amount of slot data written by the current frame.
+  Array<void*, kFrameCount> mFences {};  ///< Guards each partition, see `GLsync`.
+
+  uint mOverflowID {};                   ///< Holds slots that didn't fit the partition.
+  usize mOverflowSize {};                ///< The size of the overflow buffer, in bytes.
+  usize mOverflowOffset {};              ///< Offset of the next overflow slot.
+  Vector<uint> mRetiredOverflowBuffers;  ///< Full overflow buffers of the frame.
+
+  void allocate(usize frame_size);
+
+  /// Replaces the storage of the single partition, if the buffer isn't mapped.
+  void orphan();
+
+  /// Copies data into the next slot of the overflow buffer, and binds the slot.
+  void bind_overflow_data(int binding, const void* data, usize data_size);
+
+  /// Deletes the overflow buffers, which must no longer be bound for any draw calls.
+  void release_overflow_buffers() noexcept;
+
+  void dispose() noexcept;
+};
+
+}  // namespace glow::gl
@@ -9,6 +9,7 @@
 
 #include "common/debug/error.hpp"
 #include "common/type/map.hpp"
+#include "graphics/opengl/state_cache.hpp"
 
 namespace glow::gl {
 namespace {
@@ -86,12 +87,26 @@ auto check_errors(const char* file, const int line) -> bool
 
 void set_option(const uint option, const bool value)
 {
-  if (value) {
-    glEnable(option);
+  get_state_cache().set_option(option, value);
+}
+
+auto has_direct_state_access() -> bool
+{
+  return GLAD_GL_ARB_direct_state_access != 0;
+}
+
+auto create_buffer() -> uint
+{
+  uint id {};
+
+  if (has_direct_state_access()) {
+    glCreateBuffers(1, &id);
   }
   else {
-    glDisable(option);
+    glGenBuffers(1, &id);
   }
+
+  return id;
 }
 
 auto convert_shader_type(const ShaderType type) -> uint
@@ -127,6 +142,27 @@ auto convert_buffer_usage(const BufferUsage usage) -> uint
   }
 }
 
+auto convert_attribute_type(const AttributeType type) -> uint
+{
+  switch (type) {
+    case AttributeType::Float32:
+      return GL_FLOAT;
+
+    case AttributeType::Float16:
+      return GL_HALF_FLOAT;
+
+    case AttributeType::Int16:
+      return GL_SHORT;
+
+    case AttributeType::UInt16:
+      return GL_UNSIGNED_SHORT;
+
+    default:
+      throw Error {fmt::format("[GL] Unsupported attribute type: {}",  //
+                               magic_enum::enum_name(type))};
+  }
+}
+
 auto get_bound_vertex_array() -> uint
 {
   return _get_integer(GL_VERTEX_ARRAY_BINDING);
@@ -157,6 +193,11 @@ auto get_bound_texture() -> uint
   return _get_integer(GL_TEXTURE_BINDING_2D);
 }
 
+auto get_bound_cube_texture() -> uint
+{
+  return _get_integer(GL_TEXTURE_BINDING_CUBE_MAP);
+}
+
 auto get_bound_program() -> uint
 {
   return _get_integer(GL_CURRENT_PROGRAM);
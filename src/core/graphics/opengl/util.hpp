@@ -7,6 +7,7 @@
 #include "common/type/string.hpp"
 #include "graphics/opengl/buffer_usage.hpp"
 #include "graphics/shader_type.hpp"
+#include "graphics/vertex_layout.hpp"
 
 namespace glow::gl {
 
@@ -15,8 +16,17 @@ auto check_errors(const char* file, int line) -> bool;
 
 void set_option(uint option, bool value);
 
+/// Indicates whether buffers can be edited without binding them, see
+/// `ARB_direct_state_access`.
+[[nodiscard]] auto has_direct_state_access() -> bool;
+
+/// Creates a buffer name, which is initialized immediately if direct state access is
+/// available.
+[[nodiscard]] auto create_buffer() -> uint;
+
 [[nodiscard]] auto convert_shader_type(ShaderType type) -> uint;
 [[nodiscard]] auto convert_buffer_usage(BufferUsage usage) -> uint;
+[[nodiscard]] auto convert_attribute_type(AttributeType type) -> uint;
 
 [[nodiscard]] auto get_bound_vertex_array() -> uint;
 [[nodiscard]] auto get_bound_vertex_buffer() -> uint;
@@ -24,6 +34,7 @@ void set_option(uint option, bool value);
 [[nodiscard]] auto get_bound_uniform_buffer() -> uint;
 [[nodiscard]] auto get_bound_framebuffer() -> uint;
 [[nodiscard]] auto get_bound_texture() -> uint;
+[[nodiscard]] auto get_bound_cube_texture() -> uint;
 [[nodiscard]] auto get_bound_program() -> uint;
 
 [[nodiscard]] auto get_renderer_name() -> String;
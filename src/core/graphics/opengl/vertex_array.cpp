@@ -3,6 +3,7 @@
 #include <glad/glad.h>
 
 #include "common/debug/assert.hpp"
+#include "graphics/opengl/state_cache.hpp"
 #include "graphics/opengl/util.hpp"
 #include "util/bits.hpp"
 
@@ -40,17 +41,18 @@ void VertexArray::dispose() noexcept
 {
   if (mID != 0) {
     glDeleteVertexArrays(1, &mID);
+    get_state_cache().forget_vertex_array(mID);
   }
 }
 
 void VertexArray::bind() const
 {
-  glBindVertexArray(mID);
+  get_state_cache().bind_vertex_array(mID);
 }
 
 void VertexArray::unbind()
 {
-  glBindVertexArray(0);
+  get_state_cache().bind_vertex_array(0);
 }
 
 void VertexArray::init_attr(const uint location,
@@ -73,4 +75,43 @@ void VertexArray::init_attr(const uint location,
   GLOW_GL_CHECK_ERRORS();
 }
 
+void VertexArray::init_integer_attr(const uint location,
+                                    const int value_count,
+                                    const uint value_type,
+                                    const usize vertex_size,
+                                    const usize offset)
+{
+  GLOW_ASSERT(get_bound_vertex_array() == mID);
+
+  glVertexAttribIPointer(location,
+                         value_count,
+                         value_type,
+                         static_cast<int>(vertex_size),
+                         bitcast<void*>(offset));
+  glEnableVertexAttribArray(location);
+
+  GLOW_GL_CHECK_ERRORS();
+}
+
+void VertexArray::set_attr_divisor(const uint location, const uint divisor)
+{
+  GLOW_ASSERT(get_bound_vertex_array() == mID);
+
+  glVertexAttribDivisor(location, divisor);
+
+  GLOW_GL_CHECK_ERRORS();
+}
+
+void VertexArray::init_layout(const VertexLayout& layout)
+{
+  for (const auto& attribute : layout.get_attributes()) {
+    init_attr(attribute.location,
+              static_cast<int>(attribute.component_count),
+              convert_attribute_type(attribute.type),
+              layout.stride,
+              attribute.offset,
+              attribute.normalized);
+  }
+}
+
 }  // namespace glow::gl
\ No newline at end of file
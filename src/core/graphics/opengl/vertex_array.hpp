@@ -2,6 +2,7 @@
 
 #include "common/predef.hpp"
 #include "common/primitives.hpp"
+#include "graphics/vertex_layout.hpp"
 
 namespace glow::gl {
 
@@ -44,6 +45,46 @@ class VertexArray final {
                  usize offset = 0,
                  bool normalized = false);
 
+  /**
+   * Initializes an integer vertex attribute slot and enables it.
+   *
+   * \details
+   * Unlike other attributes, the values are not converted to floats, and are read as
+   * integers by shaders.
+   *
+   * \pre The VAO must be bound when this function is called.
+   *
+   * \param location the vertex attribute index.
+   * \param value_count the amount of values in the attribute.
+   * \param value_type the integer type stored in the attribute, e.g. 'GL_UNSIGNED_INT'.
+   * \param vertex_size the total size of a vertex including all attributes.
+   * \param offset the offset of the attribute.
+   */
+  void init_integer_attr(uint location,
+                         int value_count,
+                         uint value_type,
+                         usize vertex_size = 0,
+                         usize offset = 0);
+
+  /**
+   * Sets the number of instances that share each value of a vertex attribute.
+   *
+   * \pre The VAO must be bound when this function is called.
+   *
+   * \param location the vertex attribute index.
+   * \param divisor the number of instances per value, or zero for per-vertex values.
+   */
+  void set_attr_divisor(uint location, uint divisor);
+
+  /**
+   * Initializes and enables all vertex attributes in a vertex layout.
+   *
+   * \pre The VAO and the vertex buffer must be bound when this function is called.
+   *
+   * \param layout the layout of the vertices in the bound vertex buffer.
+   */
+  void init_layout(const VertexLayout& layout);
+
   /// Returns the OpenGL identifier associated with the VAO.
   [[nodiscard]] auto get_id() const -> uint { return mID; }
 
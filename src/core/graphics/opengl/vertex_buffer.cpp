@@ -2,14 +2,14 @@
 
 #include <glad/glad.h>
 
-#include "common/debug/assert.hpp"
+#include "graphics/opengl/state_cache.hpp"
 #include "graphics/opengl/util.hpp"
 
 namespace glow::gl {
 
 VertexBuffer::VertexBuffer()
 {
-  glGenBuffers(1, &mID);
+  mID = create_buffer();
 }
 
 VertexBuffer::~VertexBuffer() noexcept
@@ -39,29 +39,37 @@ void VertexBuffer::dispose() noexcept
 {
   if (mID != 0) {
     glDeleteBuffers(1, &mID);
+    get_state_cache().forget_buffer(mID);
   }
 }
 
 void VertexBuffer::bind() const
 {
-  glBindBuffer(GL_ARRAY_BUFFER, mID);
+  get_state_cache().bind_buffer(GL_ARRAY_BUFFER, mID);
 }
 
 void VertexBuffer::unbind()
 {
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  get_state_cache().bind_buffer(GL_ARRAY_BUFFER, 0);
 }
 
 void VertexBuffer::upload_data(const usize data_size,
                                const void* data,
                                const BufferUsage usage)
 {
-  GLOW_ASSERT(get_bound_vertex_buffer() == mID);
-
-  glBufferData(GL_ARRAY_BUFFER,
-               static_cast<GLsizeiptr>(data_size),
-               data,
-               convert_buffer_usage(usage));
+  if (has_direct_state_access()) {
+    glNamedBufferData(mID,
+                      static_cast<GLsizeiptr>(data_size),
+                      data,
+                      convert_buffer_usage(usage));
+  }
+  else {
+    bind();
+    glBufferData(GL_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(data_size),
+                 data,
+                 convert_buffer_usage(usage));
+  }
   GLOW_GL_CHECK_ERRORS();
 }
 
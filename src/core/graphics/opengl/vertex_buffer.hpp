@@ -29,7 +29,7 @@ class VertexBuffer final {
   /**
    * Uploads data to the VBO.
    *
-   * \pre The VBO must be bound when this function is called.
+   * \note The VBO is bound by this function, unless direct state access is available.
    *
    * \param data_size the size of the buffer, in bytes.
    * \param data pointer to the data that will be copied into the VBO.
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "common/primitives.hpp"
+
+namespace glow {
+
+/// Context component with statistics about the most recently rendered frame.
+struct RenderStats final {
+  usize draw_count {};                ///< The number of issued draw calls.
+  usize instanced_mesh_count {};      ///< The number of meshes drawn as instances.
+  usize lod_mesh_count {};            ///< The number of meshes drawn with a coarser LOD.
+  usize meshlet_count {};             ///< The number of meshlets considered for culling.
+  usize visible_meshlet_count {};     ///< The number of meshlets that passed culling.
+  usize triangle_count {};            ///< The number of triangles in rendered meshes.
+  usize submitted_triangle_count {};  ///< The number of triangles submitted for drawing.
+  usize state_change_count {};        ///< The number of issued GL state changes.
+  usize skipped_change_count {};      ///< The number of skipped GL state changes.
+};
+
+}  // namespace glow
@@ -11,7 +11,10 @@ enum class RenderingOption {
   DepthTest,
   FaceCulling,
   Wireframe,
-  Blending
+  Blending,
+  MeshletCulling,
+  LevelOfDetail,
+  LodHysteresis
 };
 
 /// Context component for various rendering options.
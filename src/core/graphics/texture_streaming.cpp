@@ -0,0 +1,375 @@
+#include "texture_streaming.hpp"
+
+#include <algorithm>  // max, min, sort, find, find_if
+#include <cmath>      // floor, log2
+#include <utility>    // move
+
+#include "common/debug/assert.hpp"
+
+namespace glow {
+namespace {
+
+// Levels at most this large are uploaded when textures are loaded, and always kept.
+inline constexpr int kTailLevelSize = 64;
+
+// Limits the amount of level data streamed in per frame, to avoid frame spikes.
+inline constexpr usize kMaxUploadBytesPerFrame = 16 * 1'024 * 1'024;
+
+// Textures that haven't been drawn for this many frames no longer need any detail.
+inline constexpr uint64 kUnusedFrameCount = 120;
+
+[[nodiscard]] auto _get_tail_level(const EncodedTexture& texture) -> usize
+{
+  for (usize level = 0; level < texture.levels.size(); ++level) {
+    const auto& size = texture.levels[level].size;
+    if (std::max(size.x, size.y) <= kTailLevelSize) {
+      return level;
+    }
+  }
+
+  return texture.levels.size() - 1;
+}
+
+[[nodiscard]] auto _get_byte_size(const EncodedTexture& texture, const usize first_level)
+    -> usize
+{
+  usize byte_size = 0;
+
+  for (usize level = first_level; level < texture.levels.size(); ++level) {
+    byte_size += texture.levels[level].byte_size;
+  }
+
+  return byte_size;
+}
+
+/// Returns the coarsest level with at least one texel per pixel at a texel density.
+[[nodiscard]] auto _get_wanted_level(const EncodedTexture& texture,
+                                     const float pixels_per_uv) -> usize
+{
+  const auto last_level = texture.levels.size() - 1;
+
+  if (!(pixels_per_uv > 0.0f)) {
+    return last_level;
+  }
+
+  const auto max_size = static_cast<float>(std::max(texture.size.x, texture.size.y));
+  const auto texels_per_pixel = max_size / pixels_per_uv;
+
+  if (texels_per_pixel <= 1.0f) {
+    return 0;
+  }
+
+  const auto level = std::floor(std::log2(texels_per_pixel));
+  return static_cast<usize>(std::min(level, static_cast<float>(last_level)));
+}
+
+}  // namespace
+
+auto TextureStreamer::add_texture(const ContentHash& content,
+                                  const Path& path,
+                                  SharedTexture texture) -> StreamedTextureId
+{
+  GLOW_ASSERT(texture != nullptr);
+  GLOW_ASSERT(!texture->levels.empty());
+
+  if (const auto iter = mTextureIds.find(content); iter != mTextureIds.end()) {
+    return iter->second;
+  }
+
+  // The slots of removed textures are reused, so that the IDs remain small
+  StreamedTextureId id = mTextures.size();
+
+  if (mFreeIds.empty()) {
+    mTextures.emplace_back();
+  }
+  else {
+    id = mFreeIds.back();
+    mFreeIds.pop_back();
+  }
+
+  auto& streamed = mTextures[id];
+  streamed.content = content;
+  streamed.path = path;
+  streamed.tail_level = _get_tail_level(*texture);
+  streamed.resident_level = streamed.tail_level;
+  streamed.wanted_level = streamed.tail_level;
+  streamed.texture = std::move(texture);
+
+  mResidentBytes += _get_byte_size(*streamed.texture, streamed.resident_level);
+  mTextureIds[content] = id;
+
+  return id;
+}
+
+void TextureStreamer::remove_texture(const StreamedTextureId id)
+{
+  auto& texture = mTextures.at(id);
+  GLOW_ASSERT(texture.texture != nullptr);
+
+  mResidentBytes -= _get_byte_size(*texture.texture, texture.resident_level);
+  mTextureIds.erase(texture.content);
+
+  // Empty slots have no levels to stream or drop, so they are ignored by updates
+  texture = StreamedTexture {};
+  mFreeIds.push_back(id);
+  mRemovedIds.push_back(id);
+}
+
+auto TextureStreamer::update(const Vector<TextureRequest>& requests)
+    -> Vector<ResidencyChange>
+{
+  ++mFrame;
+
+  for (const auto& request : requests) {
+    auto& texture = mTextures.at(request.id);
+
+    // Requests for removed textures are stale, even if a new texture reused the slot
+    if (texture.texture == nullptr ||
+        std::find(mRemovedIds.begin(), mRemovedIds.end(), request.id) !=
+            mRemovedIds.end()) {
+      continue;
+    }
+
+    if (texture.last_used_frame != mFrame) {
+      texture.last_used_frame = mFrame;
+      texture.pixels_per_uv = 0.0f;
+    }
+
+    texture.pixels_per_uv = std::max(texture.pixels_per_uv, request.pixels_per_uv);
+  }
+
+  mRemovedIds.clear();
+
+  Vector<StreamedTextureId> candidates;
+
+  for (StreamedTextureId id = 0; id < mTextures.size(); ++id) {
+    auto& texture = mTextures[id];
+
+    if (texture.last_used_frame == mFrame) {
+      texture.wanted_level = std::min(_get_wanted_level(*texture.texture,  //
+                                                        texture.pixels_per_uv),
+                                      texture.tail_level);
+    }
+    else if (mFrame - texture.last_used_frame > kUnusedFrameCount) {
+      texture.wanted_level = texture.tail_level;
+    }
+
+    if (texture.wanted_level < texture.resident_level) {
+      candidates.push_back(id);
+    }
+  }
+
+  Vector<ResidencyChange> changes;
+
+  // The budget may have been reduced, in which case the least important levels go first
+  make_room(0, kNothing, changes);
+
+  // Textures that lack the most detail, relative to what is needed, are streamed first
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [this](const StreamedTextureId lhs, const StreamedTextureId rhs) {
+              const auto& a = mTextures[lhs];
+              const auto& b = mTextures[rhs];
+
+              const auto a_missing = a.resident_level - a.wanted_level;
+              const auto b_missing = b.resident_level - b.wanted_level;
+
+              if (a_missing != b_missing) {
+                return a_missing > b_missing;
+              }
+
+              return a.pixels_per_uv > b.pixels_per_uv;
+            });
+
+  usize uploaded_bytes = 0;
+  mPendingCount = 0;
+
+  for (const auto id : candidates) {
+    auto& texture = mTextures[id];
+
+    // Levels that were just dropped are not streamed back in during the same frame
+    if (texture.evicted_frame == mFrame) {
+      ++mPendingCount;
+      continue;
+    }
+
+    const auto level = texture.resident_level - 1;
+    const auto byte_size = texture.texture->levels[level].byte_size;
+
+    if (uploaded_bytes != 0 && uploaded_bytes + byte_size > kMaxUploadBytesPerFrame) {
+      ++mPendingCount;
+      continue;
+    }
+
+    if (!make_room(byte_size, id, changes)) {
+      ++mPendingCount;
+      continue;
+    }
+
+    set_resident_level(id, level, changes);
+    uploaded_bytes += byte_size;
+
+    if (texture.wanted_level < texture.resident_level) {
+      ++mPendingCount;
+    }
+  }
+
+  return changes;
+}
+
+auto TextureStreamer::get_priority(const StreamedTexture& texture,
+                                   const usize resident_level) const -> Priority
+{
+  // Unused textures always want their tail level, so they never need any detail
+  return Priority {
+      .needed = resident_level >= texture.wanted_level,
+      .last_used_frame = texture.last_used_frame,
+      .pixels_per_uv = texture.pixels_per_uv,
+  };
+}
+
+auto TextureStreamer::make_room(const usize byte_size,
+                                const Maybe<StreamedTextureId> requester,
+                                Vector<ResidencyChange>& changes) -> bool
+{
+  // Only levels that are less important than the requested level may be dropped
+  Maybe<Priority> requester_priority;
+  if (requester.has_value()) {
+    const auto& texture = mTextures[*requester];
+    requester_priority = get_priority(texture, texture.resident_level);
+  }
+
+  // The levels to drop are selected up front, so that nothing is dropped in vain
+  Vector<usize> resident_levels;
+  resident_levels.reserve(mTextures.size());
+
+  for (const auto& texture : mTextures) {
+    resident_levels.push_back(texture.resident_level);
+  }
+
+  Vector<StreamedTextureId> victims;
+  auto resident_bytes = mResidentBytes;
+
+  while (resident_bytes + byte_size > mBudget) {
+    Maybe<StreamedTextureId> victim;
+    Priority victim_priority;
+
+    for (StreamedTextureId id = 0; id < mTextures.size(); ++id) {
+      const auto& texture = mTextures[id];
+      const auto resident_level = resident_levels[id];
+
+      if (id == requester || resident_level >= texture.tail_level) {
+        continue;
+      }
+
+      const auto priority = get_priority(texture, resident_level);
+
+      if (requester_priority.has_value() && !(priority < *requester_priority)) {
+        continue;
+      }
+
+      if (!victim.has_value() || priority < victim_priority) {
+        victim = id;
+        victim_priority = priority;
+      }
+    }
+
+    if (!victim.has_value()) {
+      break;
+    }
+
+    const auto& texture = mTextures[*victim];
+    resident_bytes -= texture.texture->levels[resident_levels[*victim]].byte_size;
+    ++resident_levels[*victim];
+
+    victims.push_back(*victim);
+  }
+
+  // Without a requester, levels are dropped even if the budget can't be met
+  const auto fits = resident_bytes + byte_size <= mBudget;
+
+  if (fits || !requester.has_value()) {
+    for (const auto id : victims) {
+      evict_level(id, changes);
+    }
+  }
+
+  return fits;
+}
+
+void TextureStreamer::evict_level(const StreamedTextureId id,
+                                  Vector<ResidencyChange>& changes)
+{
+  auto& texture = mTextures[id];
+  GLOW_ASSERT(texture.resident_level < texture.tail_level);
+
+  texture.evicted_frame = mFrame;
+  set_resident_level(id, texture.resident_level + 1, changes);
+}
+
+void TextureStreamer::set_resident_level(const StreamedTextureId id,
+                                         const usize level,
+                                         Vector<ResidencyChange>& changes)
+{
+  auto& texture = mTextures[id];
+  const auto& levels = texture.texture->levels;
+
+  GLOW_ASSERT(level + 1 == texture.resident_level || level == texture.resident_level + 1);
+
+  if (level < texture.resident_level) {
+    mResidentBytes += levels[level].byte_size;
+  }
+  else {
+    mResidentBytes -= levels[texture.resident_level].byte_size;
+  }
+
+  // Several changes of the same texture are merged into one
+  auto iter = std::find_if(changes.begin(), changes.end(), [=](const auto& change) {
+    return change.id == id;
+  });
+
+  if (iter == changes.end()) {
+    changes.push_back(ResidencyChange {id, texture.resident_level, level});
+  }
+  else if (iter->old_level == level) {
+    changes.erase(iter);
+  }
+  else {
+    iter->new_level = level;
+  }
+
+  texture.resident_level = level;
+}
+
+auto TextureStreamer::find_texture(const ContentHash& content) const
+    -> Maybe<StreamedTextureId>
+{
+  if (const auto iter = mTextureIds.find(content); iter != mTextureIds.end()) {
+    return iter->second;
+  }
+
+  return kNothing;
+}
+
+auto TextureStreamer::get_content(const StreamedTextureId id) const -> const ContentHash&
+{
+  return mTextures.at(id).content;
+}
+
+auto TextureStreamer::get_path(const StreamedTextureId id) const -> const Path&
+{
+  return mTextures.at(id).path;
+}
+
+auto TextureStreamer::get_texture(const StreamedTextureId id) const
+    -> const EncodedTexture&
+{
+  return *mTextures.at(id).texture;
+}
+
+auto TextureStreamer::get_resident_level(const StreamedTextureId id) const -> usize
+{
+  return mTextures.at(id).resident_level;
+}
+
+}  // namespace glow
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "common/hash.hpp"
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/map.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/path.hpp"
+#include "common/type/vector.hpp"
+#include "io/texture_compression.hpp"
+#include "io/texture_decoder.hpp"
+
+namespace glow {
+
+using StreamedTextureId = usize;
+
+/// The default budget for the resident mip levels of streamed textures, in bytes.
+inline constexpr usize kDefaultTextureBudget = 512 * 1'024 * 1'024;
+
+/// Reports the texel density at which a streamed texture was drawn.
+struct TextureRequest final {
+  StreamedTextureId id {};  ///< The drawn texture.
+  float pixels_per_uv {};   ///< Projected size of one texture coordinate unit, in pixels.
+};
+
+/// Describes a change of the resident mip levels of a streamed texture.
+struct ResidencyChange final {
+  StreamedTextureId id {};  ///< The affected texture.
+  usize old_level {};       ///< The previous most detailed resident level.
+  usize new_level {};       ///< The new most detailed resident level.
+};
+
+/// Context component that decides which mip levels of textures reside on the GPU.
+///
+/// \details
+/// Textures are registered as models are loaded, at which point only the smallest mip
+/// levels are resident, so that models can be drawn right away. The renderers report
+/// the texel densities at which textures are drawn each frame, from which the levels
+/// that are needed are derived. Missing levels are streamed in one level per texture
+/// and frame, starting with the textures that lack the most detail, and the amount of
+/// data uploaded per frame is limited.
+///
+/// The resident levels are restricted by a memory budget. When a level doesn't fit,
+/// levels of textures that are unused or drawn with more detail than needed are dropped
+/// first, followed by levels of textures drawn at lower texel densities. The smallest
+/// levels of textures are always kept resident.
+///
+/// The streamer only makes decisions, the renderers are responsible for applying the
+/// resulting changes to their GPU textures.
+class TextureStreamer final {
+ public:
+  GLOW_MOVE_ONLY_COMPONENT(TextureStreamer);
+
+  /// Registers a texture, or returns the ID of the texture if it's already registered.
+  ///
+  /// \param content the content hash of the texture file, which identifies the texture.
+  /// \param path the path of the texture file, only used for diagnostics.
+  /// \param texture the texture data, which is retained for later uploads.
+  ///
+  /// \return the ID of the texture.
+  [[nodiscard]] auto add_texture(const ContentHash& content,
+                                 const Path& path,
+                                 SharedTexture texture) -> StreamedTextureId;
+
+  /// Unregisters a texture that is no longer used, and releases its texture data.
+  ///
+  /// \details
+  /// The ID of the texture may be reused by textures that are registered later, so it
+  /// must no longer be referenced. Requests for the ID that were gathered before the
+  /// removal are ignored by the next update, even if the ID has been reused since.
+  ///
+  /// \param id the ID of the texture.
+  void remove_texture(StreamedTextureId id);
+
+  /// Updates the resident levels of all textures, based on the requests of a frame.
+  ///
+  /// \param requests the textures drawn during the frame, duplicates are allowed.
+  ///
+  /// \return the resulting residency changes, at most one for each texture.
+  [[nodiscard]] auto update(const Vector<TextureRequest>& requests)
+      -> Vector<ResidencyChange>;
+
+  /// Sets the memory budget for resident levels, in bytes.
+  void set_budget(const usize budget) noexcept { mBudget = budget; }
+
+  /// Returns the ID of a registered texture, if there is one.
+  [[nodiscard]] auto find_texture(const ContentHash& content) const
+      -> Maybe<StreamedTextureId>;
+
+  /// Returns the content hash of a texture.
+  [[nodiscard]] auto get_content(StreamedTextureId id) const -> const ContentHash&;
+
+  /// Returns the path of the file that a texture was first loaded from.
+  [[nodiscard]] auto get_path(StreamedTextureId id) const -> const Path&;
+
+  /// Returns the complete texture data of a texture.
+  [[nodiscard]] auto get_texture(StreamedTextureId id) const -> const EncodedTexture&;
+
+  /// Returns the most detailed resident level of a texture.
+  [[nodiscard]] auto get_resident_level(StreamedTextureId id) const -> usize;
+
+  [[nodiscard]] auto get_budget() const noexcept -> usize { return mBudget; }
+  [[nodiscard]] auto get_resident_bytes() const noexcept -> usize
+  {
+    return mResidentBytes;
+  }
+  [[nodiscard]] auto get_pending_count() const noexcept -> usize { return mPendingCount; }
+  [[nodiscard]] auto get_texture_count() const noexcept -> usize
+  {
+    return mTextures.size() - mFreeIds.size();
+  }
+
+ private:
+  struct StreamedTexture final {
+    ContentHash content;        ///< The content hash of the texture file.
+    Path path;                  ///< The path of the texture file.
+    SharedTexture texture;      ///< The complete mip chain.
+    usize tail_level {};        ///< The most detailed level that is always resident.
+    usize resident_level {};    ///< The most detailed resident level.
+    usize wanted_level {};      ///< The most detailed level needed by recent frames.
+    float pixels_per_uv {};     ///< The highest texel density of the last use.
+    uint64 last_used_frame {};  ///< The last frame in which the texture was drawn.
+    uint64 evicted_frame {};    ///< The last frame in which a level was dropped.
+  };
+
+  struct Priority final {
+    bool needed {};             ///< Whether the most detailed level is needed.
+    uint64 last_used_frame {};  ///< The last frame in which the texture was drawn.
+    float pixels_per_uv {};     ///< The highest texel density of the last use.
+
+    [[nodiscard]] auto operator<=>(const Priority&) const = default;
+  };
+
+  Vector<StreamedTexture> mTextures;
+  Map<ContentHash, StreamedTextureId> mTextureIds;
+  Vector<StreamedTextureId> mFreeIds;
+  Vector<StreamedTextureId> mRemovedIds;  ///< Textures removed since the last update.
+  usize mBudget {kDefaultTextureBudget};
+  usize mResidentBytes {};
+  usize mPendingCount {};
+  uint64 mFrame {};
+
+  [[nodiscard]] auto get_priority(const StreamedTexture& texture,
+                                  usize resident_level) const -> Priority;
+
+  /// Drops less important levels until the specified amount of memory is available.
+  auto make_room(usize byte_size,
+                 Maybe<StreamedTextureId> requester,
+                 Vector<ResidencyChange>& changes) -> bool;
+
+  void evict_level(StreamedTextureId id, Vector<ResidencyChange>& changes);
+
+  void set_resident_level(StreamedTextureId id,
+                          usize level,
+                          Vector<ResidencyChange>& changes);
+};
+
+}  // namespace glow
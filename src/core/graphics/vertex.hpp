@@ -6,10 +6,20 @@
 #include <glm/gtx/hash.hpp>
 
 #include "common/hash.hpp"
+#include "common/primitives.hpp"
+#include "common/type/array.hpp"
 #include "common/type/math.hpp"
 
 namespace glow {
 
+/// The vertex formats used to store mesh vertices in GPU buffers.
+enum class VertexFormat : uint8 {
+  Float,     ///< 32 bytes, see `Vertex`.
+  Packed,    ///< 20 bytes, see `PackedVertex`.
+  Quantized  ///< 16 bytes, see `QuantizedVertex`.
+};
+
+/// The full precision vertex format, also used when processing meshes.
 struct Vertex final {
   Vec3 position {};
   Vec3 normal {};
@@ -18,6 +28,24 @@ struct Vertex final {
   [[nodiscard]] auto operator==(const Vertex&) const -> bool = default;
 };
 
+/// Vertex with full precision positions, but compressed normals and texture coordinates.
+struct PackedVertex final {
+  Vec3 position {};                ///< Mesh space position.
+  Array<int16, 2> normal {};       ///< Octahedral encoded normal.
+  Array<uint16, 2> tex_coords {};  ///< Half-precision texture coordinates.
+};
+
+/// Vertex with positions quantized to 16-bit integers relative to the mesh bounds.
+struct QuantizedVertex final {
+  Array<uint16, 4> position {};    ///< Position relative to the mesh AABB, W is unused.
+  Array<int16, 2> normal {};       ///< Octahedral encoded normal.
+  Array<uint16, 2> tex_coords {};  ///< Half-precision texture coordinates.
+};
+
+static_assert(sizeof(Vertex) == 32);
+static_assert(sizeof(PackedVertex) == 20);
+static_assert(sizeof(QuantizedVertex) == 16);
+
 }  // namespace glow
 
 template <>
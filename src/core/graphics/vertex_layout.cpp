@@ -0,0 +1,62 @@
+#include "vertex_layout.hpp"
+
+#include <cstring>  // memcpy
+
+#include "common/debug/assert.hpp"
+#include "common/debug/error.hpp"
+
+namespace glow {
+
+void split_vertex_streams(const std::span<const Byte> vertices,
+                          const VertexLayout& layout,
+                          Vector<Byte>& positions,
+                          Vector<Byte>& attributes)
+{
+  GLOW_ASSERT(vertices.size() % layout.stride == 0);
+
+  const auto split = split_vertex_layout(layout);
+  const auto vertex_count = vertices.size() / layout.stride;
+
+  positions.resize(vertex_count * split.positions.stride);
+  attributes.resize(vertex_count * split.attributes.stride);
+
+  for (const auto& attribute : layout.get_attributes()) {
+    const auto& stream = (attribute.location == 0) ? split.positions : split.attributes;
+    auto& output = (attribute.location == 0) ? positions : attributes;
+
+    // Find the offset of the attribute in the split stream
+    uint32 output_offset = 0;
+    for (const auto& split_attribute : stream.get_attributes()) {
+      if (split_attribute.location == attribute.location) {
+        output_offset = split_attribute.offset;
+      }
+    }
+
+    const auto size = get_attribute_size(attribute);
+
+    for (usize index = 0; index < vertex_count; ++index) {
+      std::memcpy(output.data() + index * stream.stride + output_offset,
+                  vertices.data() + index * layout.stride + attribute.offset,
+                  size);
+    }
+  }
+}
+
+auto get_short_name(const VertexFormat format) -> StringView
+{
+  switch (format) {
+    case VertexFormat::Float:
+      return "Float";
+
+    case VertexFormat::Packed:
+      return "Packed";
+
+    case VertexFormat::Quantized:
+      return "Quantized";
+
+    default:
+      throw Error {"Unknown vertex format enumerator"};
+  }
+}
+
+}  // namespace glow
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>  // offsetof
+#include <span>     // span
+
+#include "common/primitives.hpp"
+#include "common/type/array.hpp"
+#include "common/type/string.hpp"
+#include "common/type/vector.hpp"
+#include "graphics/vertex.hpp"
+
+namespace glow {
+
+/// The component types used by vertex attributes.
+enum class AttributeType : uint8 {
+  Float32,
+  Float16,
+  Int16,
+  UInt16
+};
+
+/// Describes a single vertex attribute, which is always read as floats by shaders.
+struct VertexAttribute final {
+  uint32 location {};         ///< The shader input location.
+  uint32 component_count {};  ///< The number of components, e.g. '3' for 3D vectors.
+  AttributeType type {};      ///< The type of each component.
+  bool normalized {};         ///< Whether integers are mapped to [0, 1] or [-1, 1].
+  uint32 offset {};           ///< The offset of the attribute within a vertex.
+};
+
+/// Returns the size of a single component of the specified type, in bytes.
+[[nodiscard]] constexpr auto get_attribute_type_size(const AttributeType type) noexcept
+    -> uint32
+{
+  return (type == AttributeType::Float32) ? 4 : 2;
+}
+
+/// Returns the size of a vertex attribute, in bytes.
+[[nodiscard]] constexpr auto get_attribute_size(const VertexAttribute& attribute) noexcept
+    -> uint32
+{
+  return attribute.component_count * get_attribute_type_size(attribute.type);
+}
+
+/// Describes how vertices are laid out in a vertex buffer.
+///
+/// \details
+/// All vertex formats provide a position, a normal and texture coordinates, at the
+/// shader locations 0, 1 and 2, respectively. Formats that quantize positions must be
+/// decoded using the mesh bounds, and octahedral encoded normals provide only two
+/// components, see the shading shaders.
+struct VertexLayout final {
+  uint32 stride {};                         ///< The size of a vertex.
+  uint32 attribute_count {};                ///< The number of used attribute slots.
+  Array<VertexAttribute, 3> attributes {};  ///< The vertex attributes.
+
+  [[nodiscard]] constexpr auto get_attributes() const noexcept
+      -> std::span<const VertexAttribute>
+  {
+    return {attributes.data(), attribute_count};
+  }
+};
+
+/// The layouts of vertices that have been split into two separate streams.
+///
+/// \details
+/// Passes that only need vertex positions, e.g. depth prepasses and shadow passes, can
+/// then read tightly packed positions without fetching any of the other attributes.
+struct SplitVertexLayout final {
+  VertexLayout positions;   ///< Layout of the position stream, i.e. the first binding.
+  VertexLayout attributes;  ///< Layout of the other attributes, i.e. the second binding.
+};
+
+template <typename T>
+inline constexpr VertexLayout kVertexLayout = {};
+
+template <>
+inline constexpr VertexLayout kVertexLayout<Vertex> = {
+    .stride = sizeof(Vertex),
+    .attribute_count = 3,
+    .attributes = {{
+        {0, 3, AttributeType::Float32, false, offsetof(Vertex, position)},
+        {1, 3, AttributeType::Float32, false, offsetof(Vertex, normal)},
+        {2, 2, AttributeType::Float32, false, offsetof(Vertex, tex_coords)},
+    }},
+};
+
+template <>
+inline constexpr VertexLayout kVertexLayout<PackedVertex> = {
+    .stride = sizeof(PackedVertex),
+    .attribute_count = 3,
+    .attributes = {{
+        {0, 3, AttributeType::Float32, false, offsetof(PackedVertex, position)},
+        {1, 2, AttributeType::Int16, true, offsetof(PackedVertex, normal)},
+        {2, 2, AttributeType::Float16, false, offsetof(PackedVertex, tex_coords)},
+    }},
+};
+
+template <>
+inline constexpr VertexLayout kVertexLayout<QuantizedVertex> = {
+    .stride = sizeof(QuantizedVertex),
+    .attribute_count = 3,
+    .attributes = {{
+        {0, 4, AttributeType::UInt16, true, offsetof(QuantizedVertex, position)},
+        {1, 2, AttributeType::Int16, true, offsetof(QuantizedVertex, normal)},
+        {2, 2, AttributeType::Float16, false, offsetof(QuantizedVertex, tex_coords)},
+    }},
+};
+
+/// Returns the layout of vertices in the specified format.
+[[nodiscard]] constexpr auto get_vertex_layout(const VertexFormat format) noexcept
+    -> const VertexLayout&
+{
+  switch (format) {
+    case VertexFormat::Packed:
+      return kVertexLayout<PackedVertex>;
+
+    case VertexFormat::Quantized:
+      return kVertexLayout<QuantizedVertex>;
+
+    default:
+      return kVertexLayout<Vertex>;
+  }
+}
+
+/// Returns the size of a single vertex in the specified format, in bytes.
+[[nodiscard]] constexpr auto get_vertex_size(const VertexFormat format) noexcept -> usize
+{
+  return get_vertex_layout(format).stride;
+}
+
+/// Indicates whether normals are octahedral encoded in the specified format.
+[[nodiscard]] constexpr auto has_octahedral_normals(const VertexFormat format) noexcept
+    -> bool
+{
+  return get_vertex_layout(format).attributes[1].component_count == 2;
+}
+
+/// Returns the layouts used when positions are split from the other vertex attributes.
+///
+/// \param layout an interleaved vertex layout, with positions at location 0.
+[[nodiscard]] constexpr auto split_vertex_layout(const VertexLayout& layout) noexcept
+    -> SplitVertexLayout
+{
+  SplitVertexLayout split;
+
+  for (const auto& attribute : layout.get_attributes()) {
+    auto& stream = (attribute.location == 0) ? split.positions : split.attributes;
+
+    auto& split_attribute = stream.attributes[stream.attribute_count];
+    split_attribute = attribute;
+    split_attribute.offset = stream.stride;
+
+    stream.stride += get_attribute_size(attribute);
+    ++stream.attribute_count;
+  }
+
+  return split;
+}
+
+static_assert(split_vertex_layout(kVertexLayout<Vertex>).positions.stride == 12);
+static_assert(split_vertex_layout(kVertexLayout<Vertex>).attributes.stride == 20);
+
+/// Splits interleaved vertices into a position stream and an attribute stream.
+///
+/// \param vertices the interleaved vertex data.
+/// \param layout the layout of the interleaved vertices.
+/// \param positions the output position stream, see `SplitVertexLayout::positions`.
+/// \param attributes the output attribute stream, see `SplitVertexLayout::attributes`.
+void split_vertex_streams(std::span<const Byte> vertices,
+                          const VertexLayout& layout,
+                          Vector<Byte>& positions,
+                          Vector<Byte>& attributes);
+
+[[nodiscard]] auto get_short_name(VertexFormat format) -> StringView;
+
+}  // namespace glow
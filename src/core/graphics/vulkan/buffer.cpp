@@ -14,6 +14,7 @@ Buffer::Buffer(const uint64 size,
                const VkMemoryPropertyFlags memory_properties,
                const VmaAllocationCreateFlags allocation_flags,
                const VmaMemoryUsage memory_usage)
+    : mSize {size}
 {
   const VkBufferCreateInfo buffer_info {
       .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -82,11 +83,26 @@ auto Buffer::create(const VkBufferUsageFlags usage,
                     const void* data,
                     const usize data_size) -> Buffer
 {
-  auto staging_buffer = Buffer::staging(data_size, usage);
-  staging_buffer.set_data(data, data_size);
+  Maybe<Buffer> staging_buffer;
+  return Buffer::create(usage, data, data_size, staging_buffer);
+}
+
+auto Buffer::create(const VkBufferUsageFlags usage,
+                    const void* data,
+                    const usize data_size,
+                    Maybe<Buffer>& staging_buffer) -> Buffer
+{
+  if (!staging_buffer.has_value() || staging_buffer->get_size() < data_size) {
+    // Drop the previous buffer first, so that both buffers are never allocated at once
+    staging_buffer.reset();
+    staging_buffer = Buffer::staging(data_size, 0);
+  }
+
+  staging_buffer->set_data(data, data_size);
 
   auto gpu_buffer = Buffer::gpu(data_size, usage);
 
+  // The copy is complete when this function returns, so the staging buffer can be reused
   execute(get_graphics_command_pool(), [&](VkCommandBuffer cmd_buffer) {
     const VkBufferCopy region {
         .srcOffset = 0,
@@ -94,7 +110,7 @@ auto Buffer::create(const VkBufferUsageFlags usage,
         .size = data_size,
     };
 
-    vkCmdCopyBuffer(cmd_buffer, staging_buffer.get(), gpu_buffer.get(), 1, &region);
+    vkCmdCopyBuffer(cmd_buffer, staging_buffer->get(), gpu_buffer.get(), 1, &region);
   });
 
   return gpu_buffer;
@@ -116,10 +132,12 @@ void Buffer::dispose() noexcept
 
 Buffer::Buffer(Buffer&& other) noexcept
     : mBuffer {other.mBuffer},
-      mAllocation {other.mAllocation}
+      mAllocation {other.mAllocation},
+      mSize {other.mSize}
 {
   other.mBuffer = VK_NULL_HANDLE;
   other.mAllocation = VK_NULL_HANDLE;
+  other.mSize = 0;
 }
 
 auto Buffer::operator=(Buffer&& other) noexcept -> Buffer&
@@ -129,9 +147,11 @@ auto Buffer::operator=(Buffer&& other) noexcept -> Buffer&
 
     mBuffer = other.mBuffer;
     mAllocation = other.mAllocation;
+    mSize = other.mSize;
 
     other.mBuffer = VK_NULL_HANDLE;
     other.mAllocation = VK_NULL_HANDLE;
+    other.mSize = 0;
   }
 
   return *this;
@@ -152,10 +172,11 @@ void Buffer::set_data(const void* data, const usize data_size)
   vmaUnmapMemory(get_allocator(), mAllocation);
 }
 
-void Buffer::bind_as_vertex_buffer(VkCommandBuffer cmd_buffer) const
+void Buffer::bind_as_vertex_buffer(VkCommandBuffer cmd_buffer,
+                                   const uint32 binding) const
 {
   const VkDeviceSize offset = 0;
-  vkCmdBindVertexBuffers(cmd_buffer, 0, 1, &mBuffer, &offset);
+  vkCmdBindVertexBuffers(cmd_buffer, binding, 1, &mBuffer, &offset);
 }
 
 void Buffer::bind_as_index_buffer(VkCommandBuffer cmd_buffer, VkIndexType type) const
@@ -5,6 +5,7 @@
 
 #include "common/predef.hpp"
 #include "common/primitives.hpp"
+#include "common/type/maybe.hpp"
 #include "graphics/vulkan/context.hpp"
 
 namespace glow::vk {
@@ -42,6 +43,21 @@ class Buffer final {
                                    const void* data,
                                    usize data_size) -> Buffer;
 
+  /// Creates an GPU-side buffer with the provided data, using an existing staging buffer.
+  ///
+  /// \details
+  /// This avoids allocating a new staging buffer for each of a series of uploads. The
+  /// staging buffer is replaced with a larger one if it is too small for the data.
+  ///
+  /// \param usage bitmask of buffer usage flags.
+  /// \param data the raw data to copy into the buffer.
+  /// \param data_size the size of the data, in bytes.
+  /// \param staging_buffer the reused staging buffer, created if there is none.
+  [[nodiscard]] static auto create(VkBufferUsageFlags usage,
+                                   const void* data,
+                                   usize data_size,
+                                   Maybe<Buffer>& staging_buffer) -> Buffer;
+
   ~Buffer() noexcept;
 
   Buffer(Buffer&& other) noexcept;
@@ -58,7 +74,10 @@ class Buffer final {
   void set_data(const void* data, usize data_size);
 
   /// Binds the contents of the buffer as vertex data.
-  void bind_as_vertex_buffer(VkCommandBuffer cmd_buffer) const;
+  ///
+  /// \param cmd_buffer the target command buffer.
+  /// \param binding the vertex input binding to bind the buffer to.
+  void bind_as_vertex_buffer(VkCommandBuffer cmd_buffer, uint32 binding = 0) const;
 
   /// Binds the contents of the buffer as vertex indices.
   ///
@@ -68,9 +87,12 @@ class Buffer final {
 
   [[nodiscard]] auto get() -> VkBuffer { return mBuffer; }
 
+  [[nodiscard]] auto get_size() const -> uint64 { return mSize; }
+
  private:
   VkBuffer mBuffer {VK_NULL_HANDLE};
   VmaAllocation mAllocation {VK_NULL_HANDLE};
+  uint64 mSize {};
 
   void dispose() noexcept;
 
@@ -79,10 +79,17 @@ auto create_device() -> DevicePtr
     });
   }
 
+  VkPhysicalDeviceFeatures supported_device_features {};
+  vkGetPhysicalDeviceFeatures(get_gpu(), &supported_device_features);
+
   VkPhysicalDeviceFeatures enabled_device_features {};
   enabled_device_features.samplerAnisotropy = VK_TRUE;
   enabled_device_features.fillModeNonSolid = VK_TRUE;
 
+  // Block compressed textures are only used if they are supported
+  enabled_device_features.textureCompressionBC =
+      supported_device_features.textureCompressionBC;
+
   VkPhysicalDeviceDescriptorIndexingFeatures indexing_features {};
   indexing_features.sType =
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
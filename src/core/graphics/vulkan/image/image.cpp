@@ -11,6 +11,7 @@
 #include "common/debug/error.hpp"
 #include "common/type/chrono.hpp"
 #include "common/type/map.hpp"
+#include "common/type/vector.hpp"
 #include "graphics/vulkan/buffer.hpp"
 #include "graphics/vulkan/command_buffer.hpp"
 #include "graphics/vulkan/context.hpp"
@@ -219,6 +220,52 @@ void Image::copy_from_buffer(VkBuffer buffer)
   });
 }
 
+void Image::copy_from_buffer(VkBuffer buffer,
+                             const std::span<const VkBufferImageCopy> regions)
+{
+  execute(get_graphics_command_pool(), [=, this](VkCommandBuffer cmd_buffer) {
+    vkCmdCopyBufferToImage(cmd_buffer,
+                           buffer,
+                           mData.image,
+                           mLayout,
+                           static_cast<uint32>(regions.size()),
+                           regions.data());
+  });
+}
+
+void Image::record_level_upload(VkCommandBuffer cmd_buffer,
+                                VkBuffer buffer,
+                                const std::span<const VkBufferImageCopy> regions)
+{
+  GLOW_ASSERT(mLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  GLOW_ASSERT(!regions.empty());
+
+  const auto base_level = regions.front().imageSubresource.mipLevel;
+  const auto level_count = static_cast<uint32>(regions.size());
+
+  // The other levels may still be sampled, so they keep their layout
+  _transition_image_layout(cmd_buffer,
+                           mData.image,
+                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           level_count,
+                           base_level);
+
+  vkCmdCopyBufferToImage(cmd_buffer,
+                         buffer,
+                         mData.image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         level_count,
+                         regions.data());
+
+  _transition_image_layout(cmd_buffer,
+                           mData.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                           level_count,
+                           base_level);
+}
+
 void Image::generate_mipmaps()
 {
   GLOW_ASSERT(mSamples | VK_SAMPLE_COUNT_1_BIT);
@@ -359,4 +406,63 @@ auto load_image_2d(const void* data,
   return image;
 }
 
+auto load_image_2d(const EncodedTexture& texture,
+                   const VkFormat format,
+                   const VkImageUsageFlags usage,
+                   const usize first_level) -> Maybe<Image>
+{
+  GLOW_ASSERT(first_level < texture.levels.size());
+
+  // The levels are stored in order, so the uploaded levels form a contiguous range
+  const auto& base_level = texture.levels[first_level];
+  const auto data_offset = base_level.offset;
+  const auto data_size = static_cast<uint64>(texture.data.size() - data_offset);
+
+  auto staging_buffer = Buffer::staging(data_size, 0);
+  staging_buffer.set_data(texture.data.data() + data_offset, data_size);
+
+  Vector<VkBufferImageCopy> regions;
+  regions.reserve(texture.levels.size() - first_level);
+
+  for (usize level = first_level; level < texture.levels.size(); ++level) {
+    const auto& info = texture.levels[level];
+
+    regions.push_back(VkBufferImageCopy {
+        .bufferOffset = static_cast<VkDeviceSize>(info.offset - data_offset),
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource =
+            VkImageSubresourceLayers {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = static_cast<uint32>(level),
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        .imageOffset = VkOffset3D {0, 0, 0},
+        .imageExtent = VkExtent3D {static_cast<uint32>(info.size.x),
+                                   static_cast<uint32>(info.size.y),
+                                   1},
+    });
+  }
+
+  // Streamed levels are uploaded into the existing image later, so all levels are
+  // allocated up front. The levels that are left out have undefined contents.
+  Image image {VK_IMAGE_TYPE_2D,
+               VkExtent3D {static_cast<uint32>(texture.size.x),
+                           static_cast<uint32>(texture.size.y),
+                           1},
+               format,
+               usage,
+               static_cast<uint32>(texture.levels.size()),
+               VK_SAMPLE_COUNT_1_BIT};
+
+  image.change_layout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+  image.copy_from_buffer(staging_buffer.get(), regions);
+  image.change_layout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  GLOW_ASSERT(image.get_format() == format);
+
+  return image;
+}
+
 }  // namespace glow::vk
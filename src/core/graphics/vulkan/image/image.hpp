@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>  // span
+
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
@@ -8,6 +10,7 @@
 #include "common/type/maybe.hpp"
 #include "common/type/memory.hpp"
 #include "common/type/path.hpp"
+#include "io/texture_compression.hpp"
 
 namespace glow::vk {
 
@@ -63,6 +66,27 @@ class Image final {
   /// Uploads pixel data from a buffer into the image.
   void copy_from_buffer(VkBuffer buffer);
 
+  /// Uploads pixel data from a buffer into several regions of the image.
+  ///
+  /// \param buffer the buffer that provides the pixel data.
+  /// \param regions the buffer regions to copy, e.g. one region for each mip level.
+  void copy_from_buffer(VkBuffer buffer, std::span<const VkBufferImageCopy> regions);
+
+  /// Records an upload of pixel data into a range of mip levels of a readable image.
+  ///
+  /// \details
+  /// Unlike `copy_from_buffer`, the copy is only recorded, so that several uploads can be
+  /// submitted at once. The image must be in the `VK_IMAGE_LAYOUT_SHADER_READ_ONLY`
+  /// layout, and only the uploaded levels are transitioned for the copy.
+  ///
+  /// \param cmd_buffer the command buffer to record the upload into.
+  /// \param buffer the buffer that provides the pixel data.
+  /// \param regions the buffer regions to copy, one for each of a contiguous range of
+  ///                mip levels.
+  void record_level_upload(VkCommandBuffer cmd_buffer,
+                           VkBuffer buffer,
+                           std::span<const VkBufferImageCopy> regions);
+
   void generate_mipmaps();
 
   [[nodiscard]] static auto max_mip_levels(const VkExtent3D extent) -> uint32;
@@ -98,4 +122,22 @@ class Image final {
                                  VkFormat format,
                                  VkImageUsageFlags usage) -> Maybe<Image>;
 
+/// Creates a 2D image with the pixel data of an encoded texture.
+///
+/// \details
+/// The mip levels are uploaded as is, using a single staging buffer and one copy region
+/// per level, so no mip levels are generated on the GPU. The image always has all levels
+/// of the texture, but the most detailed levels may be left out of the upload, in which
+/// case image views must start at the first uploaded level. This is used to stream
+/// textures, see `Image::record_level_upload`.
+///
+/// \param texture the encoded texture.
+/// \param format the image format, which must be compatible with the texture format.
+/// \param usage image usage mask, e.g. `VK_IMAGE_USAGE_SAMPLED_BIT`.
+/// \param first_level the most detailed texture level to upload.
+[[nodiscard]] auto load_image_2d(const EncodedTexture& texture,
+                                 VkFormat format,
+                                 VkImageUsageFlags usage,
+                                 usize first_level = 0) -> Maybe<Image>;
+
 }  // namespace glow::vk
@@ -16,7 +16,8 @@ auto create_image_view(VkImage image,
                        const VkFormat image_format,
                        const VkImageViewType type,
                        const VkImageAspectFlags aspects,
-                       const uint32 mip_levels) -> ImageViewPtr
+                       const uint32 mip_levels,
+                       const uint32 base_level) -> ImageViewPtr
 {
   GLOW_ASSERT(image != VK_NULL_HANDLE);
   GLOW_ASSERT(image_format != VK_FORMAT_UNDEFINED);
@@ -30,7 +31,7 @@ auto create_image_view(VkImage image,
 
   const VkImageSubresourceRange subresource_range {
       .aspectMask = aspects,
-      .baseMipLevel = 0,
+      .baseMipLevel = base_level,
       .levelCount = mip_levels,
       .baseArrayLayer = 0,
       .layerCount = 1,
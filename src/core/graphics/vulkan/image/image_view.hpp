@@ -23,12 +23,14 @@ using ImageViewPtr = Unique<VkImageView_T, ImageViewDeleter>;
 /// \param type the type of the image view, e.g. `VK_IMAGE_VIEW_TYPE_2D`.
 /// \param aspects bitmask of image aspects accessible by the view.
 /// \param mip_levels the amount of mipmap levels accessible by the view.
+/// \param base_level the most detailed mipmap level accessible by the view.
 /// \return an automatically managed image view.
 [[nodiscard]] auto create_image_view(VkImage image,
                                      VkFormat image_format,
                                      VkImageViewType type,
                                      VkImageAspectFlags aspects,
-                                     uint32 mip_levels = 1) -> ImageViewPtr;
+                                     uint32 mip_levels = 1,
+                                     uint32 base_level = 0) -> ImageViewPtr;
 
 /// Creates an image view.
 ///
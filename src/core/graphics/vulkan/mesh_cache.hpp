@@ -0,0 +1,20 @@
+#pragma once
+
+#include "common/hash.hpp"
+#include "common/predef.hpp"
+#include "common/type/map.hpp"
+#include "common/type/memory.hpp"
+#include "graphics/vulkan/model.hpp"
+
+namespace glow::vk {
+
+/// Context component used to share the buffers of meshes with identical contents.
+struct MeshCache final {
+  GLOW_MOVE_ONLY_COMPONENT(MeshCache);
+
+  /// The buffers are owned by the meshes, and released along with the last mesh that
+  /// uses them. Expired entries are removed when models are reloaded.
+  Map<ContentHash, Weak<const MeshBuffers>> buffers;
+};
+
+}  // namespace glow::vk
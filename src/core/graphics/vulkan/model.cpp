@@ -1,106 +1,789 @@
 #include "model.hpp"
 
-#include <utility>  // move
+#include <algorithm>  // sort, unique
+#include <span>       // span
+#include <utility>    // move
 
+#include <fmt/chrono.h>
 #include <spdlog/spdlog.h>
 
+#include "common/debug/error.hpp"
+#include "common/hash.hpp"
+#include "common/type/chrono.hpp"
+#include "common/type/map.hpp"
+#include "common/type/vector.hpp"
+#include "engine/frame_scheduler.hpp"
+#include "graphics/asset_stats.hpp"
+#include "graphics/texture_streaming.hpp"
+#include "graphics/vertex_layout.hpp"
+#include "graphics/vulkan/buffer.hpp"
+#include "graphics/vulkan/command_buffer.hpp"
+#include "graphics/vulkan/context.hpp"
 #include "graphics/vulkan/image/image.hpp"
 #include "graphics/vulkan/image/image_cache.hpp"
 #include "graphics/vulkan/image/image_view.hpp"
-#include "graphics/vulkan/util/size.hpp"
+#include "graphics/vulkan/mesh_cache.hpp"
+#include "graphics/vulkan/queue.hpp"
+#include "io/file_watcher.hpp"
+#include "io/files.hpp"
 #include "io/model_loader.hpp"
+#include "io/texture_decoder.hpp"
+#include "scene/asset_source.hpp"
 #include "scene/scene.hpp"
+#include "util/process_memory.hpp"
+#include "util/thread_pool.hpp"
 
 namespace glow::vk {
 namespace {
 
-[[nodiscard]] auto _load_image_if_missing(const Path& model_dir,
-                                          Maybe<Path> path,
-                                          ImageCache& cache) -> VkImageView
+[[nodiscard]] auto _is_supported(const TextureCompression compression) -> bool
 {
-  if (path.has_value() && !cache.images.contains(*path)) {
-    if (auto image = load_image_2d(model_dir / *path,
-                                   VK_FORMAT_R8G8B8A8_SRGB,
-                                   VK_IMAGE_USAGE_SAMPLED_BIT)) {
-      auto view =
-          create_image_view(*image, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT);
-      VkImageView result = view.get();
+  if (compression == TextureCompression::None) {
+    return true;
+  }
+
+  VkPhysicalDeviceFeatures features {};
+  vkGetPhysicalDeviceFeatures(get_gpu(), &features);
+
+  return features.textureCompressionBC == VK_TRUE;
+}
+
+[[nodiscard]] auto _get_image_format(const PixelFormat format) -> VkFormat
+{
+  switch (format) {
+    case PixelFormat::RGBA8:
+      return VK_FORMAT_R8G8B8A8_SRGB;
+
+    case PixelFormat::BC1:
+      return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+
+    case PixelFormat::BC3:
+      return VK_FORMAT_BC3_SRGB_BLOCK;
+
+    case PixelFormat::BC5:
+      return VK_FORMAT_BC5_UNORM_BLOCK;
+
+    case PixelFormat::BC7:
+      return VK_FORMAT_BC7_SRGB_BLOCK;
+
+    default:
+      throw Error {"Unknown pixel format enumerator"};
+  }
+}
+
+/// Creates a view of the resident levels of a streamed image.
+[[nodiscard]] auto _create_streamed_view(Image& image, const usize base_level)
+    -> ImageViewPtr
+{
+  const auto level = static_cast<uint32>(base_level);
+  return create_image_view(image.get(),
+                           image.get_format(),
+                           VK_IMAGE_VIEW_TYPE_2D,
+                           VK_IMAGE_ASPECT_COLOR_BIT,
+                           image.get_mip_levels() - level,
+                           level);
+}
+
+void _create_image(Scene& scene, const Path& path, const DecodedTexture& decoded)
+{
+  auto& cache = scene.get<ImageCache>();
+  auto& stats = scene.get<AssetStats>();
+
+  // Identical files share the image, regardless of their paths
+  if (cache.images.contains(decoded.content)) {
+    ++stats.texture_hits;
+    stats.saved_bytes += decoded.texture->data.size();
+    return;
+  }
+
+  ++stats.texture_misses;
+
+  const auto& texture = *decoded.texture;
+
+  // Only the smallest levels are uploaded here, the rest are streamed in later
+  auto& streamer = scene.get<TextureStreamer>();
+  const auto stream_id = streamer.add_texture(decoded.content, path, decoded.texture);
+
+  const auto first_level = streamer.get_resident_level(stream_id);
+
+  if (auto image = load_image_2d(texture,
+                                 _get_image_format(texture.format),
+                                 VK_IMAGE_USAGE_SAMPLED_BIT,
+                                 first_level)) {
+    auto view = _create_streamed_view(*image, first_level);
+
+    cache.views.try_emplace(image->get(), std::move(view));
+    cache.images.try_emplace(decoded.content, std::move(*image));
+  }
+  else {
+    spdlog::error("[VK] Failed to load model texture {}", path.string());
+  }
+}
+
+/// Returns the image view of a decoded texture.
+///
+/// \details
+/// The image is created again if it was released whilst the model was loading, which
+/// happens when the texture file is reloaded and no material used the image yet.
+[[nodiscard]] auto _get_image_view(Scene& scene,
+                                   const TextureMap& textures,
+                                   const Path& path) -> VkImageView
+{
+  const auto texture_iter = textures.find(path);
+  if (texture_iter == textures.end()) {
+    spdlog::error("[VK] Failed to load model texture");
+    return VK_NULL_HANDLE;
+  }
+
+  const auto& cache = scene.get<ImageCache>();
+  const auto& decoded = texture_iter->second;
+
+  if (!cache.images.contains(decoded.content)) {
+    _create_image(scene, path, decoded);
+  }
+
+  const auto image_iter = cache.images.find(decoded.content);
+  if (image_iter == cache.images.end()) {
+    return VK_NULL_HANDLE;
+  }
 
-      cache.views.try_emplace(image->get(), std::move(view));
-      cache.images.try_emplace(*path, std::move(*image));
+  return cache.views.at(image_iter->second.get()).get();
+}
 
-      return result;
+void _collect_texture_contents(const TextureStreamer& streamer,
+                               const Material& material,
+                               Vector<ContentHash>& contents)
+{
+  for (const auto& stream_id : {material.diffuse_stream, material.specular_stream}) {
+    if (stream_id.has_value()) {
+      contents.push_back(streamer.get_content(*stream_id));
     }
-    else {
-      spdlog::error("[VK] Failed to load model texture");
+  }
+}
+
+[[nodiscard]] auto _is_texture_used(const Scene& scene, const StreamedTextureId stream_id)
+    -> bool
+{
+  for (const auto& [material_entity, material] : scene.each<Material>()) {
+    if (material.diffuse_stream == stream_id || material.specular_stream == stream_id) {
+      return true;
     }
   }
 
-  return VK_NULL_HANDLE;
+  return false;
 }
 
-[[nodiscard]] auto _create_material(Scene& scene,
-                                    const MaterialData& material_data,
-                                    const Path& model_dir) -> Entity
+/// Releases the images with the specified contents that are no longer used by any
+/// material, along with their streaming data.
+void _release_unused_images(Scene& scene, Vector<ContentHash> contents)
 {
-  const auto material_entity = scene.get_registry().create();
-  auto& material = scene.add<Material>(material_entity);
-
   auto& cache = scene.get<ImageCache>();
+  auto& streamer = scene.get<TextureStreamer>();
+
+  std::sort(contents.begin(), contents.end());
+  contents.erase(std::unique(contents.begin(), contents.end()), contents.end());
+
+  bool idle = false;
+
+  for (const auto& content : contents) {
+    const auto stream_id = streamer.find_texture(content);
+    if (!stream_id.has_value() || _is_texture_used(scene, *stream_id)) {
+      continue;
+    }
+
+    // The images may still be used by frames that are in flight
+    if (!idle) {
+      vkDeviceWaitIdle(get_device());
+      idle = true;
+    }
+
+    spdlog::debug("[VK] Released image {}", streamer.get_path(*stream_id).string());
+
+    if (const auto iter = cache.images.find(content); iter != cache.images.end()) {
+      cache.views.erase(iter->second.get());
+      cache.images.erase(iter);
+    }
+
+    streamer.remove_texture(*stream_id);
+  }
+}
+
+[[nodiscard]] auto _find_stream_id(const TextureStreamer& streamer,
+                                   const TextureMap& textures,
+                                   const Path& path) -> Maybe<StreamedTextureId>
+{
+  if (const auto iter = textures.find(path); iter != textures.end()) {
+    return streamer.find_texture(iter->second.content);
+  }
+
+  return kNothing;
+}
 
-  material.diffuse_tex =
-      _load_image_if_missing(model_dir, material_data.diffuse_tex, cache);
-  material.specular_tex =
-      _load_image_if_missing(model_dir, material_data.specular_tex, cache);
+void _assign_material(Scene& scene,
+                      const Entity material_entity,
+                      const MaterialData& material_data,
+                      const Path& model_dir,
+                      const TextureMap& textures,
+                      const TextureCompression compression)
+{
+  const auto& streamer = scene.get<TextureStreamer>();
+
+  auto& registry = scene.get_registry();
+  auto& material = registry.emplace_or_replace<Material>(material_entity);
+  auto& source = registry.emplace_or_replace<MaterialSource>(material_entity);
+  source.compression = compression;
+
+  if (material_data.diffuse_tex.has_value()) {
+    const auto path = (model_dir / *material_data.diffuse_tex).lexically_normal();
+    source.diffuse_tex = path;
+    material.diffuse_tex = _get_image_view(scene, textures, path);
+    material.diffuse_stream = _find_stream_id(streamer, textures, path);
+  }
+
+  if (material_data.specular_tex.has_value()) {
+    const auto path = (model_dir / *material_data.specular_tex).lexically_normal();
+    source.specular_tex = path;
+    material.specular_tex = _get_image_view(scene, textures, path);
+    material.specular_stream = _find_stream_id(streamer, textures, path);
+  }
 
   material.ambient = material_data.ambient;
   material.diffuse = material_data.diffuse;
   material.specular = material_data.specular;
   material.emission = material_data.emission;
+}
 
-  return material_entity;
+[[nodiscard]] auto _create_mesh_buffers(const MeshData& mesh_data,
+                                        const bool split_positions,
+                                        Maybe<Buffer>& staging_buffer)
+    -> Shared<const MeshBuffers>
+{
+  auto buffers = std::make_shared<MeshBuffers>();
+
+  const auto vertices = mesh_data.get_vertices();
+  const auto indices = mesh_data.get_indices();
+
+  if (split_positions) {
+    Vector<Byte> positions;
+    Vector<Byte> attributes;
+    split_vertex_streams(vertices,
+                         get_vertex_layout(mesh_data.vertex_format),
+                         positions,
+                         attributes);
+
+    buffers->position_buffer = Buffer::create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                              positions.data(),
+                                              byte_size(positions),
+                                              staging_buffer);
+    buffers->vertex_buffer = Buffer::create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                            attributes.data(),
+                                            byte_size(attributes),
+                                            staging_buffer);
+  }
+  else {
+    buffers->vertex_buffer = Buffer::create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                            vertices.data(),
+                                            vertices.size(),
+                                            staging_buffer);
+  }
+
+  buffers->index_buffer = Buffer::create(VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                         indices.data(),
+                                         indices.size(),
+                                         staging_buffer);
+
+  return buffers;
+}
+
+[[nodiscard]] auto _find_mesh_buffers(const MeshCache& cache, const ContentHash& content)
+    -> Shared<const MeshBuffers>
+{
+  const auto iter = cache.buffers.find(content);
+  return (iter != cache.buffers.end()) ? iter->second.lock() : nullptr;
 }
 
-[[nodiscard]] auto _create_mesh(const MeshData& mesh_data, const Entity material_entity)
-    -> Mesh
+[[nodiscard]] auto _create_mesh(Scene& scene,
+                                const MeshData& mesh_data,
+                                const ContentHash& content,
+                                const Entity material_entity,
+                                const bool split_positions,
+                                Maybe<Buffer>& staging_buffer) -> Mesh
 {
   Mesh mesh;
   mesh.transform = mesh_data.transform;
   mesh.material = material_entity;
-  mesh.index_count = u32_size(mesh_data.indices);
+  mesh.index_count = mesh_data.lods.empty()
+                         ? static_cast<uint32>(mesh_data.index_count)
+                         : mesh_data.lods.front().index_count;
+  mesh.index_type = (mesh_data.index_type == IndexType::UInt16) ? VK_INDEX_TYPE_UINT16
+                                                                : VK_INDEX_TYPE_UINT32;
+  mesh.meshlets = mesh_data.meshlets;
+  mesh.lods = mesh_data.lods;
+  mesh.bounds_center = mesh_data.bounds_center;
+  mesh.bounds_radius = mesh_data.bounds_radius;
+  mesh.uv_density = mesh_data.uv_density;
 
-  mesh.vertex_buffer = Buffer::create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                                      mesh_data.vertices.data(),
-                                      byte_size(mesh_data.vertices));
-  mesh.index_buffer = Buffer::create(VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                                     mesh_data.indices.data(),
-                                     byte_size(mesh_data.indices));
+  auto& cache = scene.get<MeshCache>();
+  auto& stats = scene.get<AssetStats>();
+
+  // Identical meshes share their buffers, whether or not they're in the same file
+  if (auto buffers = _find_mesh_buffers(cache, content)) {
+    ++stats.mesh_hits;
+    stats.saved_bytes += content.size;
+    mesh.buffers = std::move(buffers);
+  }
+  else {
+    ++stats.mesh_misses;
+    mesh.buffers = _create_mesh_buffers(mesh_data, split_positions, staging_buffer);
+    cache.buffers.insert_or_assign(content, mesh.buffers);
+  }
 
   return mesh;
 }
 
+[[nodiscard]] auto _hash_meshes(const Vector<MeshData>& meshes, const uint64 seed)
+    -> Vector<ContentHash>
+{
+  Vector<ContentHash> contents(meshes.size());
+
+  get_thread_pool().parallel_for(contents.size(), [&](const usize index) {
+    contents[index] = hash_mesh_data(meshes[index], seed);
+  });
+
+  return contents;
+}
+
 }  // namespace
 
-void assign_model(Scene& scene, const Entity entity, const Path& path)
+void apply_residency_changes(Scene& scene, const Vector<ResidencyChange>& changes)
 {
-  if (const auto model_data = load_model_data(path, GraphicsAPI::Vulkan)) {
-    auto& model = scene.add<Model>(entity);
-    model.meshes.reserve(model_data->meshes.size());
+  if (changes.empty()) {
+    return;
+  }
+
+  const auto& streamer = scene.get<TextureStreamer>();
+  auto& cache = scene.get<ImageCache>();
+
+  struct LevelUpload final {
+    Image* image {};        ///< The image that receives the levels.
+    usize first_region {};  ///< The index of the first copy region of the image.
+    usize region_count {};  ///< The amount of uploaded levels.
+  };
+
+  // The new levels of all textures share one staging buffer and one submission
+  Vector<Byte> staging_data;
+  Vector<VkBufferImageCopy> regions;
+  Vector<LevelUpload> uploads;
+
+  HashMap<VkImageView, VkImageView> replaced_views;
+  Vector<ImageViewPtr> old_views;
+
+  for (const auto& change : changes) {
+    const auto image_iter = cache.images.find(streamer.get_content(change.id));
+    if (image_iter == cache.images.end()) {
+      continue;
+    }
+
+    auto& image = image_iter->second;
 
-    HashMap<usize, Entity> material_entities;
-    material_entities.reserve(model_data->materials.size());
+    // Images contain all levels, so dropped levels are only excluded from the view
+    if (change.new_level < change.old_level) {
+      const auto& texture = streamer.get_texture(change.id);
+      uploads.push_back(
+          LevelUpload {&image, regions.size(), change.old_level - change.new_level});
 
-    for (const auto& [material_id, material_data] : model_data->materials) {
-      const auto material_entity =
-          _create_material(scene, material_data, model_data->dir);
-      material_entities[material_id] = material_entity;
+      for (auto level = change.new_level; level < change.old_level; ++level) {
+        const auto& info = texture.levels[level];
+
+        // Copies must start at a multiple of the texel block size
+        staging_data.resize((staging_data.size() + 15) & ~usize {15});
+
+        regions.push_back(VkBufferImageCopy {
+            .bufferOffset = static_cast<VkDeviceSize>(staging_data.size()),
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource =
+                VkImageSubresourceLayers {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = static_cast<uint32>(level),
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+            .imageOffset = VkOffset3D {0, 0, 0},
+            .imageExtent = VkExtent3D {static_cast<uint32>(info.size.x),
+                                       static_cast<uint32>(info.size.y),
+                                       1},
+        });
+
+        const auto* level_data = texture.get_level_data(level);
+        staging_data.insert(staging_data.end(), level_data, level_data + info.byte_size);
+      }
+    }
+
+    auto& view = cache.views.at(image.get());
+    auto new_view = _create_streamed_view(image, change.new_level);
+
+    replaced_views[view.get()] = new_view.get();
+    old_views.push_back(std::move(view));
+    view = std::move(new_view);
+  }
+
+  for (auto [entity, material] : scene.get_registry().view<Material>().each()) {
+    if (const auto iter = replaced_views.find(material.diffuse_tex);
+        iter != replaced_views.end()) {
+      material.diffuse_tex = iter->second;
+    }
+
+    if (const auto iter = replaced_views.find(material.specular_tex);
+        iter != replaced_views.end()) {
+      material.specular_tex = iter->second;
     }
+  }
+
+  // Both the submission and the wait ensure that the previous views are no longer used
+  // by any submitted frame once they are destroyed.
+  if (uploads.empty()) {
+    wait_on_queue(get_graphics_queue());
+    return;
+  }
+
+  auto staging_buffer = Buffer::staging(staging_data.size(), 0);
+  staging_buffer.set_data(staging_data.data(), staging_data.size());
 
-    for (const auto& mesh_data : model_data->meshes) {
+  execute(get_graphics_command_pool(), [&](VkCommandBuffer cmd_buffer) {
+    for (const auto& upload : uploads) {
+      upload.image->record_level_upload(
+          cmd_buffer,
+          staging_buffer.get(),
+          std::span {regions}.subspan(upload.first_region, upload.region_count));
+    }
+  });
+}
+
+auto assign_model(Scene& scene,
+                  FrameScheduler& scheduler,
+                  const Entity entity,
+                  Path path,
+                  ImportOptions options) -> Task<>
+{
+  const auto start_time = Clock::now();
+
+  path = path.lexically_normal();
+
+  // The precompiled Vulkan shaders only support full precision vertices
+  if (options.vertex_format != VertexFormat::Float) {
+    spdlog::warn("[VK] Vertex format '{}' is not supported, using 'Float' instead",
+                 get_short_name(options.vertex_format));
+    options.vertex_format = VertexFormat::Float;
+  }
+
+  if (!_is_supported(options.texture_compression)) {
+    spdlog::warn("[VK] Texture compression '{}' is not supported, using 'None' instead",
+                 get_short_name(options.texture_compression));
+    options.texture_compression = TextureCompression::None;
+  }
+
+  // Import the model and decode its textures on a worker thread
+  co_await get_thread_pool().schedule();
+
+  const auto memory_before = query_process_memory();
+  const auto model_content = hash_file(path);
+
+  // Low memory imports only convert the meshes right before they are uploaded
+  Maybe<ModelImporter> importer;
+  Maybe<ModelData> model_data;
+
+  if (options.low_memory) {
+    importer = ModelImporter::open(path, GraphicsAPI::Vulkan, options);
+  }
+  else {
+    model_data = load_model_data(path, GraphicsAPI::Vulkan, options);
+  }
+
+  if (!importer.has_value() && !model_data.has_value()) {
+    co_return;
+  }
+
+  const auto& model = importer.has_value() ? importer->get_model() : *model_data;
+  const auto mesh_count =
+      importer.has_value() ? importer->get_mesh_count() : model_data->meshes.size();
+
+  const auto textures = get_texture_decoder().decode(collect_texture_paths(model),
+                                                     options.texture_compression);
+
+  // The buffer layout is part of the hash, since it affects the contents of the buffers
+  const auto mesh_seed = static_cast<uint64>(options.split_positions);
+
+  Vector<MeshData> mesh_batch;
+  Vector<ContentHash> mesh_contents;
+
+  if (model_data.has_value()) {
+    mesh_batch = std::move(model_data->meshes);
+    mesh_contents = _hash_meshes(mesh_batch, mesh_seed);
+  }
+
+  // Create the GPU resources on the main thread
+  co_await scheduler.schedule();
+
+  const auto is_cancelled = [&] {
+    return scheduler.is_stopping() || !scene.get_registry().valid(entity);
+  };
+
+  if (is_cancelled()) {
+    co_return;
+  }
+
+  // Reloaded models keep their meshes until all new meshes are available
+  const auto reloading = scene.get_registry().all_of<Model, ModelSource>(entity);
+  const auto previous_mesh_misses = scene.get<AssetStats>().mesh_misses;
+
+  Vector<Mesh> new_meshes;
+  HashMap<usize, Entity> old_material_entities;
+
+  // The images of the previous materials are released if they are no longer used
+  Vector<ContentHash> old_textures;
+
+  if (reloading) {
+    new_meshes.reserve(mesh_count);
+    old_material_entities = scene.get<ModelSource>(entity).materials;
+
+    const auto& streamer = scene.get<TextureStreamer>();
+    const auto& registry = scene.get_registry();
+
+    for (const auto& [material_id, material_entity] : old_material_entities) {
+      if (const auto* material = registry.try_get<Material>(material_entity)) {
+        _collect_texture_contents(streamer, *material, old_textures);
+      }
+    }
+  }
+  else {
+    scene.add<Model>(entity).meshes.reserve(mesh_count);
+  }
+
+  for (const auto& [texture_path, texture] : textures) {
+    _create_image(scene, texture_path, texture);
+
+    co_await scheduler.yield_if_over_budget();
+    if (is_cancelled()) {
+      co_return;
+    }
+  }
+
+  // Existing materials are updated in place, so that they keep their entities
+  HashMap<usize, Entity> material_entities;
+  material_entities.reserve(model.materials.size());
+
+  for (const auto& [material_id, material_data] : model.materials) {
+    auto material_entity = kNullEntity;
+
+    if (const auto iter = old_material_entities.find(material_id);
+        iter != old_material_entities.end() && scene.get_registry().valid(iter->second)) {
+      material_entity = iter->second;
+      old_material_entities.erase(iter);
+    }
+    else {
+      material_entity = scene.get_registry().create();
+    }
+
+    _assign_material(scene,
+                     material_entity,
+                     material_data,
+                     model.dir,
+                     textures,
+                     options.texture_compression);
+    material_entities[material_id] = material_entity;
+
+    co_await scheduler.yield_if_over_budget();
+    if (is_cancelled()) {
+      co_return;
+    }
+  }
+
+  // A single staging buffer is used for all mesh uploads, see Buffer::create
+  Maybe<Buffer> staging_buffer;
+
+  // Low memory imports convert each batch of meshes on a worker thread, and release it
+  // once it has been uploaded. Otherwise, all meshes are uploaded as a single batch.
+  do {
+    if (importer.has_value()) {
+      mesh_batch.clear();
+
+      co_await get_thread_pool().schedule();
+
+      mesh_batch = importer->import_meshes();
+      mesh_contents = _hash_meshes(mesh_batch, mesh_seed);
+
+      co_await scheduler.schedule();
+      if (is_cancelled()) {
+        co_return;
+      }
+    }
+
+    // Unchanged meshes have the same contents, so they reuse their buffers
+    for (usize mesh_index = 0; mesh_index < mesh_batch.size(); ++mesh_index) {
+      const auto& mesh_data = mesh_batch[mesh_index];
       const auto material_entity = material_entities.at(mesh_data.material_id);
-      model.meshes.push_back(_create_mesh(mesh_data, material_entity));
+
+      auto mesh = _create_mesh(scene,
+                               mesh_data,
+                               mesh_contents[mesh_index],
+                               material_entity,
+                               options.split_positions,
+                               staging_buffer);
+
+      if (reloading) {
+        new_meshes.push_back(std::move(mesh));
+      }
+      else {
+        // The component is fetched every time since the storage may have been modified
+        scene.get<Model>(entity).meshes.push_back(std::move(mesh));
+      }
+
+      co_await scheduler.yield_if_over_budget();
+      if (is_cancelled()) {
+        co_return;
+      }
+    }
+  } while (importer.has_value() && importer->has_next_mesh());
+
+  if (reloading) {
+    // Buffers that are no longer used are destroyed along with the previous meshes,
+    // so they must not be used by any frame that is still in flight.
+    vkDeviceWaitIdle(get_device());
+
+    scene.get<Model>(entity).meshes = std::move(new_meshes);
+
+    // The buffers of meshes that were only used by the previous meshes are gone now
+    std::erase_if(scene.get<MeshCache>().buffers,
+                  [](const auto& entry) { return entry.second.expired(); });
+
+    // Materials that are no longer part of the model are no longer referenced
+    for (const auto& [material_id, material_entity] : old_material_entities) {
+      if (scene.get_registry().valid(material_entity)) {
+        scene.get_registry().destroy(material_entity);
+      }
     }
+
+    _release_unused_images(scene, std::move(old_textures));
+  }
+
+  scene.get_registry().emplace_or_replace<ModelSource>(
+      entity,
+      ModelSource {path, options, std::move(material_entities)});
+
+  auto& watcher = scene.get<FileWatcher>();
+
+  if (model_content.has_value()) {
+    watcher.watch(path, *model_content);
   }
+
+  for (const auto& [texture_path, texture] : textures) {
+    watcher.watch(texture_path, texture.content);
+  }
+
+  const auto end_time = Clock::now();
+  const auto duration = chrono::duration_cast<Milliseconds>(end_time - start_time);
+
+  if (reloading) {
+    spdlog::info("[VK] Reloaded model {} in {} ({} of {} meshes uploaded)",
+                 path.string(),
+                 duration,
+                 scene.get<AssetStats>().mesh_misses - previous_mesh_misses,
+                 mesh_count);
+  }
+  else {
+    spdlog::debug("[VK] Loaded model {} in {}", path.string(), duration);
+  }
+
+  // Loads may overlap, so the peak usage is only an upper bound for this model
+  const auto memory_after = query_process_memory();
+
+  if (memory_before.has_value() && memory_after.has_value()) {
+    spdlog::debug("[VK] Peak resident memory {} MiB -> {} MiB, now {} MiB ({} import)",
+                  memory_before->peak_resident / (1'024 * 1'024),
+                  memory_after->peak_resident / (1'024 * 1'024),
+                  memory_after->resident / (1'024 * 1'024),
+                  options.low_memory ? "low memory" : "regular");
+  }
+}
+
+auto reload_model(Scene& scene, FrameScheduler& scheduler, const Entity entity)
+    -> Task<>
+{
+  const auto& source = scene.get<ModelSource>(entity);
+  return assign_model(scene, scheduler, entity, source.path, source.options);
+}
+
+auto reload_texture(Scene& scene, FrameScheduler& scheduler, Path path) -> Task<>
+{
+  // The texture is decoded in the same way as when it was first loaded
+  Maybe<TextureCompression> compression;
+
+  for (const auto& [material_entity, source] : scene.each<MaterialSource>()) {
+    if (source.uses_texture(path)) {
+      compression = source.compression;
+      break;
+    }
+  }
+
+  if (!compression.has_value()) {
+    co_return;
+  }
+
+  co_await get_thread_pool().schedule();
+
+  const auto textures = get_texture_decoder().decode(Vector<Path> {path}, *compression);
+
+  co_await scheduler.schedule();
+
+  if (scheduler.is_stopping()) {
+    co_return;
+  }
+
+  const auto texture_iter = textures.find(path);
+  if (texture_iter == textures.end()) {
+    spdlog::error("[VK] Failed to reload texture {}", path.string());
+    co_return;
+  }
+
+  _create_image(scene, path, texture_iter->second);
+
+  const auto view = _get_image_view(scene, textures, path);
+  const auto stream_id =
+      _find_stream_id(scene.get<TextureStreamer>(), textures, path);
+
+  // Only the materials that use the file are updated, even if other files had the same
+  // contents as the previous version of the file. The previous image is released once
+  // no material uses it anymore.
+  Vector<ContentHash> old_textures;
+  usize material_count = 0;
+
+  for (auto [material_entity, source, material] :
+       scene.get_registry().view<MaterialSource, Material>().each()) {
+    if (source.uses_texture(path)) {
+      _collect_texture_contents(scene.get<TextureStreamer>(), material, old_textures);
+    }
+
+    if (source.diffuse_tex == path) {
+      material.diffuse_tex = view;
+      material.diffuse_stream = stream_id;
+    }
+
+    if (source.specular_tex == path) {
+      material.specular_tex = view;
+      material.specular_stream = stream_id;
+    }
+
+    if (source.uses_texture(path)) {
+      ++material_count;
+    }
+  }
+
+  _release_unused_images(scene, std::move(old_textures));
+
+  spdlog::info("[VK] Reloaded texture {} ({} materials updated)",
+               path.string(),
+               material_count);
 }
 
 }  // namespace glow::vk
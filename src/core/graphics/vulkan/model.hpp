@@ -5,12 +5,18 @@
 #include "common/type/ecs.hpp"
 #include "common/type/math.hpp"
 #include "common/type/maybe.hpp"
+#include "common/type/memory.hpp"
 #include "common/type/path.hpp"
 #include "common/type/vector.hpp"
+#include "graphics/texture_streaming.hpp"
 #include "graphics/vulkan/buffer.hpp"
+#include "io/import_options.hpp"
+#include "io/model_loader.hpp"
+#include "util/task.hpp"
 
 namespace glow {
 GLOW_FORWARD_DECLARE_C(Scene);
+GLOW_FORWARD_DECLARE_C(FrameScheduler);
 }  // namespace glow
 
 namespace glow::vk {
@@ -19,22 +25,41 @@ namespace glow::vk {
 struct Material final {
   VkImageView diffuse_tex {VK_NULL_HANDLE};
   VkImageView specular_tex {VK_NULL_HANDLE};
+  Maybe<StreamedTextureId> diffuse_stream;   ///< Streaming ID of diffuse texture.
+  Maybe<StreamedTextureId> specular_stream;  ///< Streaming ID of specular texture.
   Vec3 ambient {};
   Vec3 diffuse {};
   Vec3 specular {};
   Vec3 emission {};
 };
 
-/// Vulkan mesh component.
+/// The GPU buffers of a mesh, which are shared by meshes with identical contents.
 /// TODO use one buffer for the vertex and index data
+struct MeshBuffers final {
+  Maybe<Buffer> vertex_buffer;  ///< Associated vertex buffer.
+  Maybe<Buffer> index_buffer;   ///< Associated index buffer.
+
+  /// Optional separate position stream, the other attributes are then stored in
+  /// `vertex_buffer`.
+  Maybe<Buffer> position_buffer;
+};
+
+/// Vulkan mesh component.
 struct Mesh final {
   GLOW_MOVE_ONLY_COMPONENT(Mesh);
 
   Mat4 transform {1.0f};          ///< Transform matrix relative to parent model.
-  Maybe<Buffer> vertex_buffer;    ///< Associated vertex buffer.
-  Maybe<Buffer> index_buffer;     ///< Associated index buffer.
   Entity material {kNullEntity};  ///< The associated material entity.
-  uint32 index_count {};          ///< The amount of indices needed to render the mesh.
+  uint32 index_count {};          ///< The amount of indices in the full detail mesh.
+  VkIndexType index_type {VK_INDEX_TYPE_UINT32};
+  Vector<Meshlet> meshlets;       ///< Optional meshlets used for culling.
+  Vector<MeshLod> lods;           ///< Optional levels of detail.
+  Vec3 bounds_center {};          ///< Center of the bounding sphere.
+  float bounds_radius {};         ///< Radius of the bounding sphere.
+  float uv_density {1};           ///< Texture coordinate units per mesh space unit.
+
+  /// The vertex and index buffers, shared by meshes with identical contents.
+  Shared<const MeshBuffers> buffers;
 };
 
 /// Vulkan model component.
@@ -44,7 +69,66 @@ struct Model final {
   Vector<Mesh> meshes;
 };
 
-/// Loads and assigns a Vulkan model component to an entity.
-void assign_model(Scene& scene, Entity entity, const Path& path);
+/// Applies changes of the resident mip levels of streamed textures to the GPU images.
+///
+/// \details
+/// Images always contain all mip levels, of which only the resident levels are accessible
+/// through their image views. New levels are uploaded into the existing images, using a
+/// single submission for all changes. The views are then replaced, and the materials
+/// that use them are updated accordingly.
+///
+/// \pre No frame that uses the affected images may be recorded when this is called.
+///
+/// \param scene the associated scene.
+/// \param changes the residency changes returned by the texture streamer.
+void apply_residency_changes(Scene& scene, const Vector<ResidencyChange>& changes);
+
+/// Loads a model file and assigns a Vulkan model component to an entity.
+///
+/// \details
+/// The model file is imported and its textures are decoded on worker threads. The GPU
+/// resources are then created on the main thread, spread over several frames if
+/// needed. The model component is added as soon as the import has finished, and the
+/// meshes are added to it as they become available.
+///
+/// If the entity already has a model that was loaded by this function, the model is
+/// updated in place instead, see `reload_model`.
+///
+/// \param scene the associated scene.
+/// \param scheduler the scheduler used to execute work on the main thread.
+/// \param entity the entity that the model component will be added to.
+/// \param path the model file path.
+/// \param options the import options to use for the model file.
+[[nodiscard]] auto assign_model(Scene& scene,
+                                FrameScheduler& scheduler,
+                                Entity entity,
+                                Path path,
+                                ImportOptions options) -> Task<>;
+
+/// Reimports the model file of a model entity, and updates the model in place.
+///
+/// \details
+/// The entity and its material entities are kept, and only textures and meshes with
+/// changed contents are uploaded again, since unchanged meshes reuse their buffers
+/// through the mesh cache. The previous meshes are kept until all new meshes are
+/// available.
+///
+/// \param scene the associated scene.
+/// \param scheduler the scheduler used to execute work on the main thread.
+/// \param entity a model entity with a `ModelSource` component.
+[[nodiscard]] auto reload_model(Scene& scene, FrameScheduler& scheduler, Entity entity)
+    -> Task<>;
+
+/// Decodes a changed texture file again, and updates the materials that use it.
+///
+/// \details
+/// The previous image of the file is released, along with its streaming data, unless
+/// it's still used by other materials.
+///
+/// \param scene the associated scene.
+/// \param scheduler the scheduler used to execute work on the main thread.
+/// \param path the normalized path of the texture file.
+[[nodiscard]] auto reload_texture(Scene& scene, FrameScheduler& scheduler, Path path)
+    -> Task<>;
 
 }  // namespace glow::vk
@@ -8,6 +8,69 @@
 #include "util/arrays.hpp"
 
 namespace glow::vk {
+namespace {
+
+[[nodiscard]] auto _convert_attribute_format(const VertexAttribute& attribute)
+    -> VkFormat
+{
+  constexpr VkFormat kFloat32Formats[] = {
+      VK_FORMAT_R32_SFLOAT,
+      VK_FORMAT_R32G32_SFLOAT,
+      VK_FORMAT_R32G32B32_SFLOAT,
+      VK_FORMAT_R32G32B32A32_SFLOAT,
+  };
+
+  constexpr VkFormat kFloat16Formats[] = {
+      VK_FORMAT_R16_SFLOAT,
+      VK_FORMAT_R16G16_SFLOAT,
+      VK_FORMAT_R16G16B16_SFLOAT,
+      VK_FORMAT_R16G16B16A16_SFLOAT,
+  };
+
+  constexpr VkFormat kSnorm16Formats[] = {
+      VK_FORMAT_R16_SNORM,
+      VK_FORMAT_R16G16_SNORM,
+      VK_FORMAT_R16G16B16_SNORM,
+      VK_FORMAT_R16G16B16A16_SNORM,
+  };
+
+  constexpr VkFormat kUnorm16Formats[] = {
+      VK_FORMAT_R16_UNORM,
+      VK_FORMAT_R16G16_UNORM,
+      VK_FORMAT_R16G16B16_UNORM,
+      VK_FORMAT_R16G16B16A16_UNORM,
+  };
+
+  if (attribute.component_count < 1 || attribute.component_count > 4) {
+    throw Error {"[VK] Unsupported vertex attribute component count"};
+  }
+
+  const auto index = attribute.component_count - 1;
+
+  switch (attribute.type) {
+    case AttributeType::Float32:
+      return kFloat32Formats[index];
+
+    case AttributeType::Float16:
+      return kFloat16Formats[index];
+
+    case AttributeType::Int16:
+      if (attribute.normalized) {
+        return kSnorm16Formats[index];
+      }
+      break;
+
+    case AttributeType::UInt16:
+      if (attribute.normalized) {
+        return kUnorm16Formats[index];
+      }
+      break;
+  }
+
+  throw Error {"[VK] Unsupported vertex attribute format"};
+}
+
+}  // namespace
 
 auto DescriptorSetLayoutBuilder::reset() -> Self&
 {
@@ -201,6 +264,21 @@ auto PipelineBuilder::vertex_attribute(const uint32 binding,
   return *this;
 }
 
+auto PipelineBuilder::vertex_layout(const uint32 binding, const VertexLayout& layout)
+    -> Self&
+{
+  vertex_input_binding(binding, layout.stride);
+
+  for (const auto& attribute : layout.get_attributes()) {
+    vertex_attribute(binding,
+                     attribute.location,
+                     _convert_attribute_format(attribute),
+                     attribute.offset);
+  }
+
+  return *this;
+}
+
 auto PipelineBuilder::rasterization(const VkPolygonMode polygon_mode,
                                     const VkCullModeFlags cull_mode) -> Self&
 {
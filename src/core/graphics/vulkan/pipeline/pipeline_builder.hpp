@@ -6,6 +6,7 @@
 #include "common/type/array.hpp"
 #include "common/type/maybe.hpp"
 #include "common/type/vector.hpp"
+#include "graphics/vertex_layout.hpp"
 #include "graphics/vulkan/pipeline/descriptor_set_layout.hpp"
 #include "graphics/vulkan/pipeline/pipeline.hpp"
 #include "graphics/vulkan/pipeline/pipeline_layout.hpp"
@@ -78,6 +79,9 @@ class PipelineBuilder final {
   auto vertex_attribute(uint32 binding, uint32 location, VkFormat format, uint32 offset)
       -> Self&;
 
+  /// Adds a vertex input binding along with all of the attributes in a vertex layout.
+  auto vertex_layout(uint32 binding, const VertexLayout& layout) -> Self&;
+
   auto rasterization(VkPolygonMode polygon_mode, VkCullModeFlags cull_mode) -> Self&;
 
   auto multisample(VkSampleCountFlagBits samples) -> Self&;
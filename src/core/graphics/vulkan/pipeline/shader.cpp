@@ -3,7 +3,7 @@
 #include "common/debug/error.hpp"
 #include "graphics/vulkan/context.hpp"
 #include "graphics/vulkan/util/vk_call.hpp"
-#include "io/files.hpp"
+#include "io/mapped_file.hpp"
 
 namespace glow::vk {
 
@@ -14,7 +14,7 @@ void ShaderModuleDeleter::operator()(VkShaderModule shader) noexcept
 
 auto create_shader_module(const Path& shader_path) -> ShaderModulePtr
 {
-  const auto code = load_binary_file(shader_path);
+  const auto code = MappedFile::open(shader_path);
   if (!code) {
     throw Error {"[VK] Could not load shader code"};
   }
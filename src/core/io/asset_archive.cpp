@@ -0,0 +1,469 @@
+#include "asset_archive.hpp"
+
+#include <algorithm>     // lower_bound, min, sort
+#include <cstring>       // memcpy
+#include <ios>           // streamoff, streamsize
+#include <limits>        // numeric_limits
+#include <mutex>         // mutex, lock_guard
+#include <system_error>  // error_code
+#include <type_traits>   // is_trivially_copyable_v
+#include <utility>       // move
+
+#include <fmt/chrono.h>
+#include <spdlog/spdlog.h>
+
+#include "common/hash.hpp"
+#include "common/type/array.hpp"
+#include "common/type/chrono.hpp"
+#include "common/type/fstream.hpp"
+#include "common/type/map.hpp"
+#include "common/type/vector.hpp"
+#include "io/files.hpp"
+#include "io/lz4.hpp"
+
+namespace glow {
+namespace {
+
+inline constexpr uint32 kAssetArchiveMagic = 0x4B415047;  // "GPAK"
+inline constexpr uint32 kAssetArchiveVersion = 1;
+
+// Entry data is aligned to page boundaries, so that mapped entries start on a new page.
+inline constexpr usize kAssetArchiveAlignment = 4'096;
+
+struct ArchiveHeader final {
+  uint32 magic {};
+  uint32 version {};
+  uint64 entry_count {};
+  uint64 toc_offset {};
+  uint64 names_offset {};
+  uint64 names_size {};
+};
+
+static_assert(std::is_trivially_copyable_v<ArchiveHeader>);
+static_assert(std::is_trivially_copyable_v<ArchiveEntry>);
+static_assert(sizeof(ArchiveHeader) % alignof(ArchiveEntry) == 0);
+
+struct OpenedArchive final {
+  uint64 size {};
+  int64 time {};
+  Shared<const AssetArchive> archive;
+};
+
+struct ArchiveRegistry final {
+  std::mutex mutex;
+  Map<Path, OpenedArchive> archives;
+};
+
+struct PackedFile final {
+  Path path;
+  String name;
+};
+
+[[nodiscard]] constexpr auto _align_offset(const uint64 offset) noexcept -> uint64
+{
+  return (offset + kAssetArchiveAlignment - 1) / kAssetArchiveAlignment *
+         kAssetArchiveAlignment;
+}
+
+/// Checks whether a range fits within a total size, without overflowing.
+[[nodiscard]] constexpr auto _is_within(const uint64 offset,
+                                        const uint64 size,
+                                        const uint64 total_size) noexcept -> bool
+{
+  return offset <= total_size && size <= total_size - offset;
+}
+
+[[nodiscard]] auto _get_archive_registry() -> ArchiveRegistry&
+{
+  static ArchiveRegistry registry;
+  return registry;
+}
+
+[[nodiscard]] auto _collect_packed_files(const Path& dir, const Path& archive_path)
+    -> Maybe<Vector<PackedFile>>
+{
+  std::error_code error;
+  const auto archive_file = fs::weakly_canonical(archive_path, error);
+
+  fs::recursive_directory_iterator iter {dir, error};
+  if (error) {
+    spdlog::error("[IO] Could not open directory {}", dir.string());
+    return kNothing;
+  }
+
+  Vector<PackedFile> files;
+
+  for (const auto& dir_entry : iter) {
+    if (!dir_entry.is_regular_file(error)) {
+      continue;
+    }
+
+    // The archive might be created in the directory that is packed
+    if (fs::weakly_canonical(dir_entry.path(), error) == archive_file) {
+      continue;
+    }
+
+    auto name = dir_entry.path().lexically_relative(dir).generic_string();
+
+    if (name.size() > std::numeric_limits<uint16>::max()) {
+      spdlog::warn("[IO] Skipping file with too long path {}", dir_entry.path().string());
+      continue;
+    }
+
+    files.push_back(PackedFile {dir_entry.path(), std::move(name)});
+  }
+
+  std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) {
+    return a.name < b.name;
+  });
+
+  return files;
+}
+
+void _write_bytes(OfStream& stream, const void* data, const usize size)
+{
+  stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+void _write_padding(OfStream& stream, uint64 size)
+{
+  static constexpr Array<char, 256> kZeros {};
+
+  while (size != 0) {
+    const auto chunk_size = std::min(size, static_cast<uint64>(kZeros.size()));
+    _write_bytes(stream, kZeros.data(), static_cast<usize>(chunk_size));
+    size -= chunk_size;
+  }
+}
+
+}  // namespace
+
+AssetArchive::AssetArchive(Path path, MappedFile file) noexcept
+    : mPath {std::move(path)},
+      mFile {std::move(file)}
+{
+}
+
+auto AssetArchive::open(const Path& path) -> Maybe<AssetArchive>
+{
+  auto file = MappedFile::open(path);
+  if (!file.has_value()) {
+    return kNothing;
+  }
+
+  const auto file_size = static_cast<uint64>(file->size());
+
+  ArchiveHeader header;
+  if (file_size < sizeof header) {
+    spdlog::error("[IO] Asset archive {} is truncated", path.string());
+    return kNothing;
+  }
+
+  std::memcpy(&header, file->data(), sizeof header);
+
+  if (header.magic != kAssetArchiveMagic || header.version != kAssetArchiveVersion) {
+    spdlog::error("[IO] File {} is not a supported asset archive", path.string());
+    return kNothing;
+  }
+
+  const auto max_entry_count = file_size / sizeof(ArchiveEntry);
+  const auto toc_size = header.entry_count * sizeof(ArchiveEntry);
+
+  if (header.entry_count > max_entry_count ||
+      header.toc_offset % alignof(ArchiveEntry) != 0 ||
+      !_is_within(header.toc_offset, toc_size, file_size) ||
+      !_is_within(header.names_offset, header.names_size, file_size)) {
+    spdlog::error("[IO] Asset archive {} has a malformed header", path.string());
+    return kNothing;
+  }
+
+  AssetArchive archive {path, std::move(*file)};
+
+  const auto* data = archive.mFile.data();
+
+  // The table of contents is used in place, which requires the file to be suitably
+  // aligned. This is always the case, since mapped files start at page boundaries.
+  archive.mEntries = {
+      reinterpret_cast<const ArchiveEntry*>(data + header.toc_offset),  // NOLINT
+      static_cast<usize>(header.entry_count)};
+  archive.mNames = {reinterpret_cast<const char*>(data + header.names_offset),  // NOLINT
+                    static_cast<usize>(header.names_size)};
+
+  StringView previous_name;
+
+  for (const auto& entry : archive.mEntries) {
+    const auto is_valid =
+        _is_within(entry.name_offset, entry.name_size, header.names_size) &&
+        _is_within(entry.offset, entry.stored_size, file_size) &&
+        entry.compression <= static_cast<uint8>(ArchiveCompression::LZ4) &&
+        (entry.compression != static_cast<uint8>(ArchiveCompression::None) ||
+         entry.stored_size == entry.size);
+
+    // Lookups rely on the entries being sorted by name
+    if (!is_valid || (&entry != archive.mEntries.data() &&
+                      archive.get_name(entry) <= previous_name)) {
+      spdlog::error("[IO] Asset archive {} has a malformed table of contents",
+                    path.string());
+      return kNothing;
+    }
+
+    previous_name = archive.get_name(entry);
+  }
+
+  return archive;
+}
+
+auto AssetArchive::find(const StringView name) const -> const ArchiveEntry*
+{
+  const auto iter = std::lower_bound(mEntries.begin(),
+                                     mEntries.end(),
+                                     name,
+                                     [this](const ArchiveEntry& entry, StringView key) {
+                                       return get_name(entry) < key;
+                                     });
+
+  if (iter != mEntries.end() && get_name(*iter) == name) {
+    return &*iter;
+  }
+
+  return nullptr;
+}
+
+auto AssetArchive::get_stored_bytes(const ArchiveEntry& entry) const
+    -> std::span<const Byte>
+{
+  return mFile.bytes().subspan(static_cast<usize>(entry.offset),
+                               static_cast<usize>(entry.stored_size));
+}
+
+auto AssetArchive::extract(const ArchiveEntry& entry, const std::span<Byte> output) const
+    -> bool
+{
+  if (output.size() != entry.size) {
+    return false;
+  }
+
+  const auto stored_bytes = get_stored_bytes(entry);
+
+  switch (static_cast<ArchiveCompression>(entry.compression)) {
+    case ArchiveCompression::None:
+      if (!stored_bytes.empty()) {
+        std::memcpy(output.data(), stored_bytes.data(), stored_bytes.size());
+      }
+
+      return true;
+
+    case ArchiveCompression::LZ4:
+      return lz4_decompress(stored_bytes, output);
+
+    default:
+      return false;
+  }
+}
+
+auto AssetArchive::get_name(const ArchiveEntry& entry) const -> StringView
+{
+  return mNames.substr(entry.name_offset, entry.name_size);
+}
+
+auto split_archive_path(const Path& path) -> Maybe<ArchivePath>
+{
+  const auto normal_path = path.lexically_normal();
+  const Path extension {kAssetArchiveExtension};
+
+  Path archive;
+
+  for (auto iter = normal_path.begin(); iter != normal_path.end(); ++iter) {
+    archive /= *iter;
+
+    if (iter->extension() != extension) {
+      continue;
+    }
+
+    std::error_code error;
+    if (!fs::is_regular_file(archive, error)) {
+      continue;
+    }
+
+    Path name;
+    for (++iter; iter != normal_path.end(); ++iter) {
+      name /= *iter;
+    }
+
+    if (name.empty()) {
+      return kNothing;
+    }
+
+    return ArchivePath {std::move(archive), name.generic_string()};
+  }
+
+  return kNothing;
+}
+
+auto get_asset_archive(const Path& path) -> Shared<const AssetArchive>
+{
+  const auto info = get_file_info(path);
+  if (!info.has_value()) {
+    return nullptr;
+  }
+
+  auto& registry = _get_archive_registry();
+  const std::lock_guard lock {registry.mutex};
+
+  auto& opened = registry.archives[info->path];
+
+  if (opened.archive && opened.size == info->size && opened.time == info->time) {
+    return opened.archive;
+  }
+
+  // Previously opened versions are kept alive by the files that still refer to them
+  auto archive = AssetArchive::open(info->path);
+  if (!archive.has_value()) {
+    registry.archives.erase(info->path);
+    return nullptr;
+  }
+
+  spdlog::debug("[IO] Opened asset archive {} ({} entries)",
+                info->path.string(),
+                archive->get_entries().size());
+
+  opened.size = info->size;
+  opened.time = info->time;
+  opened.archive = std::make_shared<const AssetArchive>(std::move(*archive));
+
+  return opened.archive;
+}
+
+auto pack_asset_archive(const Path& dir,
+                        const Path& archive_path,
+                        const ArchiveCompression compression) -> bool
+{
+  const auto start_time = Clock::now();
+
+  const auto files = _collect_packed_files(dir, archive_path);
+  if (!files.has_value()) {
+    return false;
+  }
+
+  String names;
+  Vector<ArchiveEntry> entries;
+  entries.reserve(files->size());
+
+  for (const auto& file : *files) {
+    auto& entry = entries.emplace_back();
+    entry.name_offset = static_cast<uint32>(names.size());
+    entry.name_size = static_cast<uint16>(file.name.size());
+    names += file.name;
+  }
+
+  ArchiveHeader header;
+  header.magic = kAssetArchiveMagic;
+  header.version = kAssetArchiveVersion;
+  header.entry_count = entries.size();
+  header.toc_offset = sizeof header;
+  header.names_offset = header.toc_offset + entries.size() * sizeof(ArchiveEntry);
+  header.names_size = names.size();
+
+  // Opened archives are memory mapped, so the archive is written to a temporary file
+  // that replaces the archive once it's complete, rather than truncating it in place.
+  const auto temp_path = make_temp_path(archive_path);
+
+  auto stream = create_file(temp_path, FileType::Binary);
+  if (!stream.has_value()) {
+    spdlog::error("[IO] Could not create asset archive {}", temp_path.string());
+    return false;
+  }
+
+  std::error_code error;
+  const auto discard = [&] {
+    stream->close();
+    fs::remove(temp_path, error);
+  };
+
+  // The table of contents is written last, once the stored sizes are known
+  auto offset = _align_offset(header.names_offset + header.names_size);
+  _write_padding(*stream, offset);
+
+  uint64 total_size = 0;
+  uint64 total_stored_size = 0;
+
+  for (usize index = 0; index < files->size(); ++index) {
+    const auto& file = (*files)[index];
+    auto& entry = entries[index];
+
+    const auto data = MappedFile::open(file.path);
+    if (!data.has_value()) {
+      spdlog::error("[IO] Could not read file {}", file.path.string());
+      discard();
+      return false;
+    }
+
+    const auto content = hash_content(data->data(), data->size());
+    entry.hash = content.hash;
+    entry.size = content.size;
+
+    Vector<Byte> compressed;
+    if (compression == ArchiveCompression::LZ4) {
+      compressed = lz4_compress(data->bytes());
+    }
+
+    const auto use_compressed = !compressed.empty() &&  //
+                                compressed.size() <= data->size() - data->size() / 8;
+
+    const auto stored_bytes = use_compressed ? std::span<const Byte> {compressed}  //
+                                             : data->bytes();
+
+    entry.offset = offset;
+    entry.stored_size = stored_bytes.size();
+    entry.compression = static_cast<uint8>(use_compressed ? ArchiveCompression::LZ4  //
+                                                          : ArchiveCompression::None);
+
+    _write_bytes(*stream, stored_bytes.data(), stored_bytes.size());
+
+    const auto next_offset = _align_offset(offset + entry.stored_size);
+    _write_padding(*stream, next_offset - offset - entry.stored_size);
+    offset = next_offset;
+
+    total_size += entry.size;
+    total_stored_size += entry.stored_size;
+
+    spdlog::debug("[IO] Packed {} ({} -> {} bytes)",
+                  file.name,
+                  entry.size,
+                  entry.stored_size);
+  }
+
+  stream->seekp(0);
+  _write_bytes(*stream, &header, sizeof header);
+  _write_bytes(*stream, entries.data(), entries.size() * sizeof(ArchiveEntry));
+  _write_bytes(*stream, names.data(), names.size());
+
+  if (!stream->good()) {
+    spdlog::error("[IO] Could not write asset archive {}", temp_path.string());
+    discard();
+    return false;
+  }
+
+  stream->close();
+
+  fs::rename(temp_path, archive_path, error);
+  if (error) {
+    spdlog::error("[IO] Could not store asset archive {}: {}",
+                  archive_path.string(),
+                  error.message());
+    fs::remove(temp_path, error);
+    return false;
+  }
+
+  const auto end_time = Clock::now();
+  spdlog::info("[IO] Packed {} files into {} in {} ({:.1f} MiB -> {:.1f} MiB)",
+               entries.size(),
+               archive_path.string(),
+               chrono::duration_cast<Milliseconds>(end_time - start_time),
+               static_cast<float64>(total_size) / (1'024.0 * 1'024.0),
+               static_cast<float64>(total_stored_size) / (1'024.0 * 1'024.0));
+
+  return true;
+}
+
+}  // namespace glow
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <span>  // span
+
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/memory.hpp"
+#include "common/type/path.hpp"
+#include "common/type/string.hpp"
+#include "io/mapped_file.hpp"
+
+namespace glow {
+
+/// The file extension of asset archives.
+inline constexpr StringView kAssetArchiveExtension = ".glowpak";
+
+enum class ArchiveCompression : uint8 {
+  None,
+  LZ4
+};
+
+/// Describes a file stored in an asset archive.
+///
+/// \details
+/// Entries are stored in the table of contents of an archive, sorted by name, and are
+/// accessed directly in the memory mapped archive file.
+struct ArchiveEntry final {
+  uint64 offset {};       ///< Offset of the stored data, from the start of the archive.
+  uint64 stored_size {};  ///< Size of the stored data, which may be compressed.
+  uint64 size {};         ///< Size of the original file.
+  uint64 hash {};         ///< Hash of the original file, see `hash_content`.
+  uint32 name_offset {};  ///< Offset of the name, from the start of the name table.
+  uint16 name_size {};    ///< Size of the name, in bytes.
+  uint8 compression {};   ///< See ArchiveCompression.
+  uint8 reserved {};
+};
+
+/// Refers to a file inside an asset archive.
+struct ArchivePath final {
+  Path archive;  ///< The path of the archive file.
+  String name;   ///< The name of the entry, i.e. its path relative to the archive root.
+};
+
+/// Read-only view of an asset archive (.glowpak) file.
+///
+/// \details
+/// An asset archive stores a directory of asset files in a single file, which avoids the
+/// cost of opening many small files. The archive starts with a header, followed by the
+/// table of contents and the entry names. The data of each entry starts at a 4 KiB
+/// boundary, so that uncompressed entries can be used directly from the mapped archive.
+///
+/// Files in archives are referred to by regular paths that pass through the archive,
+/// e.g. "assets/sponza.glowpak/textures/brick.png". Such paths are understood by
+/// `MappedFile`, `get_file_info` and `hash_file`, and therefore by the model and
+/// texture loaders as well.
+class AssetArchive final {
+ public:
+  GLOW_DELETE_COPY(AssetArchive);
+  GLOW_DEFAULT_MOVE(AssetArchive);
+
+  ~AssetArchive() noexcept = default;
+
+  /// Opens an asset archive, and validates its table of contents.
+  ///
+  /// \param path the path to the archive file.
+  ///
+  /// \return the archive, or nothing if the file could not be read or is malformed.
+  [[nodiscard]] static auto open(const Path& path) -> Maybe<AssetArchive>;
+
+  /// Returns the entry with the specified name, if there is one.
+  [[nodiscard]] auto find(StringView name) const -> const ArchiveEntry*;
+
+  /// Returns the stored bytes of an entry, which are compressed for compressed entries.
+  [[nodiscard]] auto get_stored_bytes(const ArchiveEntry& entry) const
+      -> std::span<const Byte>;
+
+  /// Decompresses the data of an entry.
+  ///
+  /// \param entry an entry of the archive.
+  /// \param output the decompressed data, must have the size of the original file.
+  ///
+  /// \return true if the entry was decompressed; false if the stored data is malformed.
+  [[nodiscard]] auto extract(const ArchiveEntry& entry, std::span<Byte> output) const
+      -> bool;
+
+  [[nodiscard]] auto get_name(const ArchiveEntry& entry) const -> StringView;
+
+  [[nodiscard]] auto get_entries() const noexcept -> std::span<const ArchiveEntry>
+  {
+    return mEntries;
+  }
+
+  [[nodiscard]] auto get_path() const noexcept -> const Path& { return mPath; }
+
+ private:
+  Path mPath;
+  MappedFile mFile;
+  std::span<const ArchiveEntry> mEntries;
+  StringView mNames;
+
+  AssetArchive(Path path, MappedFile file) noexcept;
+};
+
+/// Splits a path that refers to a file inside an asset archive.
+///
+/// \details
+/// The first path component with the archive extension that is a regular file is
+/// treated as the archive, and the remaining components form the entry name.
+///
+/// \return the archive path and entry name, or nothing if the path isn't in an archive.
+[[nodiscard]] auto split_archive_path(const Path& path) -> Maybe<ArchivePath>;
+
+/// Returns a shared asset archive, which is opened on first use.
+///
+/// \details
+/// Opened archives are kept open, and are reopened if the archive file has changed. This
+/// function may be called from any thread.
+///
+/// \param path the path to the archive file.
+///
+/// \return the archive, or null if the archive could not be opened.
+[[nodiscard]] auto get_asset_archive(const Path& path) -> Shared<const AssetArchive>;
+
+/// Packs all files in a directory into an asset archive.
+///
+/// \details
+/// Compressed entries are only kept if they are at least an eighth smaller than the
+/// original files, since already compressed formats such as PNG hardly shrink further.
+///
+/// An existing archive is replaced atomically, so that processes that have the previous
+/// archive mapped keep reading the previous contents.
+///
+/// \param dir the directory to pack, its files are stored relative to it.
+/// \param archive_path the path of the archive file to create.
+/// \param compression the compression to use for the entries.
+///
+/// \return true if the archive was created; false otherwise.
+[[nodiscard]] auto pack_asset_archive(const Path& dir,
+                                      const Path& archive_path,
+                                      ArchiveCompression compression) -> bool;
+
+}  // namespace glow
@@ -0,0 +1,131 @@
+#include "asset_io_system.hpp"
+
+#include <algorithm>     // min
+#include <cstring>       // memcpy, strchr
+#include <utility>       // move
+
+#include <assimp/IOStream.hpp>
+
+#include "common/primitives.hpp"
+#include "common/type/path.hpp"
+#include "io/files.hpp"
+#include "io/mapped_file.hpp"
+
+namespace glow {
+namespace {
+
+/// Read-only Assimp stream over the contents of a mapped file.
+class MappedIOStream final : public Assimp::IOStream {
+ public:
+  explicit MappedIOStream(MappedFile file) noexcept
+      : mFile {std::move(file)}
+  {
+  }
+
+  auto Read(void* buffer, const std::size_t size, const std::size_t count)
+      -> std::size_t override
+  {
+    if (size == 0) {
+      return 0;
+    }
+
+    // Only complete elements are read, like fread
+    const auto read_count = std::min(count, (mFile.size() - mOffset) / size);
+    const auto byte_count = read_count * size;
+
+    if (byte_count != 0) {
+      std::memcpy(buffer, mFile.data() + mOffset, byte_count);
+      mOffset += byte_count;
+    }
+
+    return read_count;
+  }
+
+  auto Write(const void*, std::size_t, std::size_t) -> std::size_t override { return 0; }
+
+  auto Seek(const std::size_t offset, const aiOrigin origin) -> aiReturn override
+  {
+    const auto size = mFile.size();
+
+    switch (origin) {
+      case aiOrigin_SET:
+        if (offset > size) {
+          return aiReturn_FAILURE;
+        }
+
+        mOffset = offset;
+        return aiReturn_SUCCESS;
+
+      case aiOrigin_CUR:
+        if (offset > size - mOffset) {
+          return aiReturn_FAILURE;
+        }
+
+        mOffset += offset;
+        return aiReturn_SUCCESS;
+
+      case aiOrigin_END:
+        if (offset > size) {
+          return aiReturn_FAILURE;
+        }
+
+        mOffset = size - offset;
+        return aiReturn_SUCCESS;
+
+      default:
+        return aiReturn_FAILURE;
+    }
+  }
+
+  [[nodiscard]] auto Tell() const -> std::size_t override { return mOffset; }
+
+  [[nodiscard]] auto FileSize() const -> std::size_t override { return mFile.size(); }
+
+  void Flush() override {}
+
+ private:
+  MappedFile mFile;
+  usize mOffset {};
+};
+
+}  // namespace
+
+AssetIOSystem::AssetIOSystem(Vector<Path>* opened_files) noexcept
+    : mOpenedFiles {opened_files}
+{
+}
+
+auto AssetIOSystem::Exists(const char* file) const -> bool
+{
+  return get_file_info(Path {file}).has_value();
+}
+
+auto AssetIOSystem::getOsSeparator() const -> char
+{
+  return static_cast<char>(Path::preferred_separator);
+}
+
+auto AssetIOSystem::Open(const char* file, const char* mode) -> Assimp::IOStream*
+{
+  // Assets are never written by the importer
+  if (std::strchr(mode, 'w') != nullptr || std::strchr(mode, 'a') != nullptr) {
+    return nullptr;
+  }
+
+  if (auto mapped_file = MappedFile::open(Path {file})) {
+    if (mOpenedFiles != nullptr) {
+      mOpenedFiles->emplace_back(file);
+    }
+
+    return new MappedIOStream {std::move(*mapped_file)};  // NOLINT
+  }
+
+  return nullptr;
+}
+
+void AssetIOSystem::Close(Assimp::IOStream* stream)
+{
+  delete stream;  // NOLINT
+}
+
+}  // namespace glow
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>  // size_t
+
+#include <assimp/IOSystem.hpp>
+
+#include "common/type/path.hpp"
+#include "common/type/vector.hpp"
+
+namespace glow {
+
+/// Assimp file system that reads files through `MappedFile`.
+///
+/// \details
+/// This makes it possible to import models, along with any files they refer to such as
+/// material libraries, directly from asset archives. Regular files are supported as
+/// well, in which case large files are memory mapped instead of read with stdio.
+class AssetIOSystem final : public Assimp::IOSystem {
+ public:
+  /// Creates a file system.
+  ///
+  /// \param opened_files optional list that receives the path of every opened file.
+  explicit AssetIOSystem(Vector<Path>* opened_files = nullptr) noexcept;
+
+  [[nodiscard]] auto Exists(const char* file) const -> bool override;
+
+  [[nodiscard]] auto getOsSeparator() const -> char override;
+
+  [[nodiscard]] auto Open(const char* file, const char* mode)
+      -> Assimp::IOStream* override;
+
+  void Close(Assimp::IOStream* stream) override;
+
+ private:
+  Vector<Path>* mOpenedFiles {};
+};
+
+}  // namespace glow
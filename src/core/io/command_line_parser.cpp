@@ -13,14 +13,30 @@ namespace {
 
 inline constexpr const char* kApiHelp = "graphics API that will be used";
 inline constexpr const char* kEnvHelp = "path to environment texture to load";
+inline constexpr const char* kEnvQualityHelp = "storage format of the environment texture";
 inline constexpr const char* kLogHelp = "verbosity of log output";
 inline constexpr const char* kModelsHelp = "list of model files to load";
+inline constexpr const char* kThreadsHelp = "number of threads used for loading assets";
+inline constexpr const char* kProfileHelp = "import profile used for model files";
+inline constexpr const char* kVertexFormatHelp = "vertex format used for model meshes";
+inline constexpr const char* kSplitPositionsHelp = "store positions in a separate stream";
+inline constexpr const char* kLowMemoryHelp = "import models in small batches to save memory";
+inline constexpr const char* kCompressionHelp = "block compression used for model textures";
+inline constexpr const char* kTextureBudgetHelp = "GPU memory budget for textures in MiB";
 
 inline constexpr const char* kEpilog =
     "Supported graphics APIs: 'OpenGL', 'Vulkan'\n"
+    "Supported import profiles: 'Fast', 'Optimized'\n"
+    "Supported vertex formats: 'Float', 'Packed', 'Quantized' (OpenGL only)\n"
+    "Supported texture compressions: 'None', 'Fast' (BC1/BC3), 'High' (BC7)\n"
+    "Supported environment qualities: 'Compact' (RGB9E5), 'High' (RGBA16F)\n"
     "Supported log levels: [0, 6]";
 
 inline constexpr StringView kDefaultApi = "OpenGL";
+inline constexpr StringView kDefaultProfile = "Optimized";
+inline constexpr StringView kDefaultVertexFormat = "Float";
+inline constexpr StringView kDefaultCompression = "None";
+inline constexpr StringView kDefaultEnvQuality = "Compact";
 inline constexpr int kDefaultLogLevel = 4;
 
 inline const Map<StringView, GraphicsAPI> kSupportedAPIs {
@@ -28,6 +44,28 @@ inline const Map<StringView, GraphicsAPI> kSupportedAPIs {
     {"Vulkan", GraphicsAPI::Vulkan},
 };
 
+inline const Map<StringView, ImportProfile> kImportProfiles {
+    {"Fast", ImportProfile::Fast},
+    {"Optimized", ImportProfile::Optimized},
+};
+
+inline const Map<StringView, VertexFormat> kVertexFormats {
+    {"Float", VertexFormat::Float},
+    {"Packed", VertexFormat::Packed},
+    {"Quantized", VertexFormat::Quantized},
+};
+
+inline const Map<StringView, TextureCompression> kTextureCompressions {
+    {"None", TextureCompression::None},
+    {"Fast", TextureCompression::Fast},
+    {"High", TextureCompression::High},
+};
+
+inline const Map<StringView, EnvironmentQuality> kEnvQualities {
+    {"Compact", EnvironmentQuality::Compact},
+    {"High", EnvironmentQuality::High},
+};
+
 inline const HashMap<int, LogLevel> kLogLevels {
     {0, LogLevel::off},
     {1, LogLevel::critical},
@@ -49,8 +87,16 @@ auto parse_command_line_args(const int argc, char** argv) -> Maybe<CommandLineAr
   // clang-format off
   parser.add_argument("--api", "-a").nargs(1).default_value(kDefaultApi).help(kApiHelp);
   parser.add_argument("--env", "-e").nargs(1).help(kEnvHelp);
+  parser.add_argument("--env-quality").nargs(1).default_value(kDefaultEnvQuality).help(kEnvQualityHelp);
   parser.add_argument("--models", "-m").nargs(argparse::nargs_pattern::any).help(kModelsHelp);
   parser.add_argument("--log", "-l").nargs(1).scan<'i', int>().default_value(kDefaultLogLevel).help(kLogHelp);
+  parser.add_argument("--threads", "-t").nargs(1).scan<'i', int>().help(kThreadsHelp);
+  parser.add_argument("--profile", "-p").nargs(1).default_value(kDefaultProfile).help(kProfileHelp);
+  parser.add_argument("--vertex-format").nargs(1).default_value(kDefaultVertexFormat).help(kVertexFormatHelp);
+  parser.add_argument("--split-positions").default_value(false).implicit_value(true).help(kSplitPositionsHelp);
+  parser.add_argument("--low-memory").default_value(false).implicit_value(true).help(kLowMemoryHelp);
+  parser.add_argument("--texture-compression").nargs(1).default_value(kDefaultCompression).help(kCompressionHelp);
+  parser.add_argument("--texture-budget").nargs(1).scan<'i', int>().help(kTextureBudgetHelp);
   parser.add_epilog(kEpilog);
   // clang-format on
 
@@ -83,6 +129,17 @@ auto parse_command_line_args(const int argc, char** argv) -> Maybe<CommandLineAr
     args.env_path = parser.get<String>("--env");
   }
 
+  if (parser.is_used("--env-quality")) {
+    const auto& quality = parser.get<String>("--env-quality");
+
+    if (const auto iter = kEnvQualities.find(quality); iter != kEnvQualities.end()) {
+      args.env_quality = iter->second;
+    }
+    else {
+      spdlog::warn("[IO] Unsupported environment quality option '{}'", quality);
+    }
+  }
+
   if (parser.is_used("--models")) {
     const auto models = parser.get<Vector<String>>("--models");
     args.model_paths.reserve(models.size());
@@ -103,6 +160,65 @@ auto parse_command_line_args(const int argc, char** argv) -> Maybe<CommandLineAr
     }
   }
 
+  if (parser.is_used("--threads")) {
+    const auto thread_count = parser.get<int>("--threads");
+
+    if (thread_count > 0) {
+      args.thread_count = static_cast<usize>(thread_count);
+    }
+    else {
+      spdlog::warn("[IO] Invalid thread count '{}'", thread_count);
+    }
+  }
+
+  if (parser.is_used("--profile")) {
+    const auto& profile = parser.get<String>("--profile");
+
+    if (const auto iter = kImportProfiles.find(profile); iter != kImportProfiles.end()) {
+      args.import_options.profile = iter->second;
+    }
+    else {
+      spdlog::warn("[IO] Unsupported import profile option '{}'", profile);
+    }
+  }
+
+  if (parser.is_used("--vertex-format")) {
+    const auto& format = parser.get<String>("--vertex-format");
+
+    if (const auto iter = kVertexFormats.find(format); iter != kVertexFormats.end()) {
+      args.import_options.vertex_format = iter->second;
+    }
+    else {
+      spdlog::warn("[IO] Unsupported vertex format option '{}'", format);
+    }
+  }
+
+  args.import_options.split_positions = parser.get<bool>("--split-positions");
+  args.import_options.low_memory = parser.get<bool>("--low-memory");
+
+  if (parser.is_used("--texture-compression")) {
+    const auto& compression = parser.get<String>("--texture-compression");
+
+    if (const auto iter = kTextureCompressions.find(compression);
+        iter != kTextureCompressions.end()) {
+      args.import_options.texture_compression = iter->second;
+    }
+    else {
+      spdlog::warn("[IO] Unsupported texture compression option '{}'", compression);
+    }
+  }
+
+  if (parser.is_used("--texture-budget")) {
+    const auto budget = parser.get<int>("--texture-budget");
+
+    if (budget > 0) {
+      args.texture_budget = static_cast<usize>(budget) * 1'024 * 1'024;
+    }
+    else {
+      spdlog::warn("[IO] Invalid texture budget '{}'", budget);
+    }
+  }
+
   return args;
 }
 
@@ -2,10 +2,13 @@
 
 #include <spdlog/spdlog.h>
 
+#include "common/primitives.hpp"
 #include "common/type/maybe.hpp"
 #include "common/type/path.hpp"
 #include "common/type/vector.hpp"
 #include "graphics/graphics_api.hpp"
+#include "io/hdr_texture.hpp"
+#include "io/import_options.hpp"
 
 namespace glow {
 
@@ -15,7 +18,13 @@ struct CommandLineArgs final {
   LogLevel log_level {LogLevel::info};    ///< Log level to use.
   GraphicsAPI api {GraphicsAPI::OpenGL};  ///< The graphics backend to use.
   Maybe<Path> env_path;                   ///< Path to an environment texture to load.
+  EnvironmentQuality env_quality {};      ///< Storage format of the environment texture.
   Vector<Path> model_paths;               ///< Paths to model files to load at startup.
+  Maybe<usize> thread_count;              ///< Total number of threads used for jobs.
+  Maybe<usize> texture_budget;            ///< GPU memory budget for textures, in bytes.
+
+  /// The import options used for model files.
+  ImportOptions import_options;
 };
 
 [[nodiscard]] auto parse_command_line_args(int argc, char* argv[])
@@ -0,0 +1,245 @@
+#include "file_watcher.hpp"
+
+#include <cerrno>   // errno, EAGAIN
+#include <cstring>  // memcpy
+#include <utility>  // exchange, move
+
+#include <spdlog/spdlog.h>
+
+#include "common/type/array.hpp"
+#include "common/type/set.hpp"
+#include "io/asset_archive.hpp"
+#include "io/files.hpp"
+
+#if GLOW_OS_LINUX
+
+#include <sys/inotify.h>  // inotify_init1, inotify_add_watch, inotify_event
+#include <unistd.h>       // close, read
+
+#endif  // GLOW_OS_LINUX
+
+namespace glow {
+namespace {
+
+// Limits how often files are checked when their directories can't be monitored.
+inline constexpr chrono::seconds kScanInterval {1};
+
+}  // namespace
+
+FileWatcher::FileWatcher()
+{
+#if GLOW_OS_LINUX
+  mInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (mInotify == -1) {
+    spdlog::warn("[IO] Could not initialize inotify, falling back to polling files");
+  }
+#endif  // GLOW_OS_LINUX
+}
+
+FileWatcher::~FileWatcher() noexcept
+{
+  dispose();
+}
+
+FileWatcher::FileWatcher(FileWatcher&& other) noexcept
+    : mFiles {std::move(other.mFiles)},
+      mLastScanTime {other.mLastScanTime}
+#if GLOW_OS_LINUX
+      ,
+      mInotify {std::exchange(other.mInotify, -1)},
+      mDirectories {std::move(other.mDirectories)},
+      mWatchDirs {std::move(other.mWatchDirs)}
+#endif  // GLOW_OS_LINUX
+{
+}
+
+auto FileWatcher::operator=(FileWatcher&& other) noexcept -> FileWatcher&
+{
+  if (this != &other) {
+    dispose();
+
+    mFiles = std::move(other.mFiles);
+    mLastScanTime = other.mLastScanTime;
+
+#if GLOW_OS_LINUX
+    mInotify = std::exchange(other.mInotify, -1);
+    mDirectories = std::move(other.mDirectories);
+    mWatchDirs = std::move(other.mWatchDirs);
+#endif  // GLOW_OS_LINUX
+  }
+
+  return *this;
+}
+
+void FileWatcher::dispose() noexcept
+{
+#if GLOW_OS_LINUX
+  if (mInotify != -1) {
+    close(mInotify);
+    mInotify = -1;
+  }
+#endif  // GLOW_OS_LINUX
+}
+
+void FileWatcher::watch(const Path& path, const ContentHash& content)
+{
+  const auto file_path = path.lexically_normal();
+
+  // Files in asset archives change along with the archive file
+  const auto archive_path = split_archive_path(file_path);
+
+  auto& file = mFiles[file_path];
+  file.disk_path = archive_path.has_value() ? archive_path->archive : file_path;
+  file.content = content;
+
+  if (const auto info = get_file_info(file_path)) {
+    file.size = info->size;
+    file.time = info->time;
+  }
+
+#if GLOW_OS_LINUX
+  if (mInotify == -1) {
+    return;
+  }
+
+  auto dir = file.disk_path.parent_path();
+  if (dir.empty()) {
+    dir = ".";
+  }
+
+  if (mDirectories.contains(dir)) {
+    return;
+  }
+
+  // Editors often save by writing a temporary file and renaming it, which replaces the
+  // file, so the directory is watched rather than the file itself.
+  const auto watch_id =
+      inotify_add_watch(mInotify, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+  if (watch_id == -1) {
+    spdlog::warn("[IO] Could not watch directory {}", dir.string());
+    return;
+  }
+
+  mDirectories[dir] = watch_id;
+  mWatchDirs[watch_id] = dir;
+#endif  // GLOW_OS_LINUX
+}
+
+auto FileWatcher::poll() -> Vector<Path>
+{
+  Vector<Path> candidates;
+
+#if GLOW_OS_LINUX
+  if (mInotify != -1) {
+    read_events(candidates);
+  }
+  else {
+    scan_files(candidates);
+  }
+#else
+  scan_files(candidates);
+#endif  // GLOW_OS_LINUX
+
+  Vector<Path> changed_files;
+  Set<Path> checked_files;
+
+  for (auto& path : candidates) {
+    if (!checked_files.insert(path).second) {
+      continue;
+    }
+
+    // The file might be missing, in which case another event follows
+    const auto info = get_file_info(path);
+    if (!info.has_value()) {
+      continue;
+    }
+
+    auto& file = mFiles.at(path);
+    if (info->size != file.size || info->time != file.time) {
+      file.size = info->size;
+      file.time = info->time;
+      changed_files.push_back(std::move(path));
+    }
+  }
+
+  return changed_files;
+}
+
+auto FileWatcher::update_content(const Path& path, const ContentHash& content) -> bool
+{
+  const auto file_iter = mFiles.find(path);
+  if (file_iter == mFiles.end() || file_iter->second.content == content) {
+    return false;
+  }
+
+  file_iter->second.content = content;
+  return true;
+}
+
+#if GLOW_OS_LINUX
+
+void FileWatcher::read_events(Vector<Path>& candidates)
+{
+  alignas(inotify_event) Array<char, 4'096> buffer;
+
+  while (true) {
+    const auto byte_count = read(mInotify, buffer.data(), buffer.size());
+
+    if (byte_count <= 0) {
+      if (byte_count == -1 && errno != EAGAIN) {
+        spdlog::warn("[IO] Could not read file system events");
+      }
+
+      break;
+    }
+
+    usize offset = 0;
+    while (offset < static_cast<usize>(byte_count)) {
+      inotify_event event;
+      std::memcpy(&event, buffer.data() + offset, sizeof event);
+
+      const auto* name = buffer.data() + offset + sizeof event;
+      offset += sizeof event + event.len;
+
+      // Events were dropped, so any watched file might have changed
+      if ((event.mask & IN_Q_OVERFLOW) != 0) {
+        for (const auto& [path, file] : mFiles) {
+          candidates.push_back(path);
+        }
+
+        continue;
+      }
+
+      const auto dir_iter = mWatchDirs.find(event.wd);
+      if (dir_iter == mWatchDirs.end() || event.len == 0) {
+        continue;
+      }
+
+      const auto disk_path = (dir_iter->second / name).lexically_normal();
+      for (const auto& [path, file] : mFiles) {
+        if (file.disk_path == disk_path) {
+          candidates.push_back(path);
+        }
+      }
+    }
+  }
+}
+
+#endif  // GLOW_OS_LINUX
+
+void FileWatcher::scan_files(Vector<Path>& candidates)
+{
+  const auto now = SteadyClock::now();
+  if (now - mLastScanTime < kScanInterval) {
+    return;
+  }
+
+  mLastScanTime = now;
+
+  for (const auto& [path, file] : mFiles) {
+    candidates.push_back(path);
+  }
+}
+
+}  // namespace glow
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "common/hash.hpp"
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/chrono.hpp"
+#include "common/type/map.hpp"
+#include "common/type/path.hpp"
+#include "common/type/vector.hpp"
+
+namespace glow {
+
+/// Context component that detects changes to the contents of asset files.
+///
+/// \details
+/// On Linux, the directories of watched files are monitored using inotify, so polling
+/// is cheap and changes are noticed as soon as a file is closed after writing, or moved
+/// into place by an editor that saves atomically. On other platforms, or if inotify is
+/// unavailable, the sizes and modification times of the files are compared instead, at
+/// most once per second.
+///
+/// File system events only nominate candidates, which are reported if their sizes or
+/// modification times have changed. Hashing the contents of a candidate is left to the
+/// caller, since it reads the whole file, which should not happen on the main thread.
+/// The hash is then passed to `update_content()`, which filters out files that are
+/// touched or saved without changes.
+///
+/// Files are identified by their lexically normalized paths. Files in asset archives are
+/// monitored through the archive file, and only the entries whose contents differ from
+/// the last seen versions are reported when the archive changes.
+class FileWatcher final {
+ public:
+  GLOW_DELETE_COPY(FileWatcher);
+
+  FileWatcher();
+
+  ~FileWatcher() noexcept;
+
+  FileWatcher(FileWatcher&& other) noexcept;
+
+  auto operator=(FileWatcher&& other) noexcept -> FileWatcher&;
+
+  /// Starts watching a file, or updates the known contents of a watched file.
+  ///
+  /// \param path the path of the file.
+  /// \param content the content hash of the current version of the file.
+  void watch(const Path& path, const ContentHash& content);
+
+  /// Returns the watched files whose sizes or modification times have changed since the
+  /// last call.
+  ///
+  /// \details
+  /// This only queries file system metadata, so it is cheap enough to call every frame.
+  ///
+  /// \return the normalized paths of the changed files.
+  [[nodiscard]] auto poll() -> Vector<Path>;
+
+  /// Records the content hash of a watched file that was reported by `poll()`.
+  ///
+  /// \param path the normalized path of the file.
+  /// \param content the content hash of the current version of the file.
+  /// \return true if the contents differ from the last seen version; false otherwise.
+  [[nodiscard]] auto update_content(const Path& path, const ContentHash& content) -> bool;
+
+  [[nodiscard]] auto get_file_count() const noexcept -> usize { return mFiles.size(); }
+
+ private:
+  using SteadyClock = chrono::steady_clock;
+
+  struct WatchedFile final {
+    Path disk_path;       ///< The file on disk, which is the archive for archived files.
+    ContentHash content;  ///< The hash of the last seen version.
+    uint64 size {};       ///< The last seen size.
+    int64 time {};        ///< The last seen modification time.
+  };
+
+  Map<Path, WatchedFile> mFiles;
+  SteadyClock::time_point mLastScanTime {};
+
+#if GLOW_OS_LINUX
+  int mInotify {-1};              ///< The inotify instance, or -1 if unavailable.
+  Map<Path, int> mDirectories;    ///< Watch descriptors of watched directories.
+  HashMap<int, Path> mWatchDirs;  ///< Watched directories, by watch descriptor.
+
+  /// Reads pending inotify events, and collects the affected watched files.
+  void read_events(Vector<Path>& candidates);
+#endif  // GLOW_OS_LINUX
+
+  /// Collects all watched files, at most once per scan interval.
+  void scan_files(Vector<Path>& candidates);
+
+  void dispose() noexcept;
+};
+
+}  // namespace glow
@@ -1,13 +1,19 @@
 #include "files.hpp"
 
-#include <ios>       // ios
-#include <iterator>  // istreambuf_iterator
+#include <atomic>        // atomic
+#include <ios>           // ios
+#include <random>        // random_device
+#include <system_error>  // error_code
+#include <utility>       // make_pair, move
 
 #include <SDL2/SDL.h>
 #include <fmt/format.h>
 
 #include "common/debug/error.hpp"
 #include "common/type/memory.hpp"
+#include "common/type/pair.hpp"
+#include "io/asset_archive.hpp"
+#include "io/mapped_file.hpp"
 
 namespace glow {
 namespace {
@@ -28,6 +34,23 @@ struct SDLPathDeleter final {
   return Path {raw_path.get()};
 }
 
+/// Looks up the entry of a file in an asset archive, along with the archive itself.
+[[nodiscard]] auto _find_archive_entry(const ArchivePath& archive_path)
+    -> Maybe<Pair<Shared<const AssetArchive>, const ArchiveEntry*>>
+{
+  auto archive = get_asset_archive(archive_path.archive);
+  if (!archive) {
+    return kNothing;
+  }
+
+  const auto* entry = archive->find(archive_path.name);
+  if (!entry) {
+    return kNothing;
+  }
+
+  return std::make_pair(std::move(archive), entry);
+}
+
 }  // namespace
 
 auto open_input_stream(const Path& file, const FileType type) -> Maybe<IfStream>
@@ -44,10 +67,9 @@ auto open_input_stream(const Path& file, const FileType type) -> Maybe<IfStream>
 
 auto load_file_as_string(const Path& file) -> Maybe<String>
 {
-  if (auto stream = open_input_stream(file)) {
-    String content {std::istreambuf_iterator {*stream},
-                    std::istreambuf_iterator<char> {}};
-    return content;
+  if (const auto mapped_file = MappedFile::open(file)) {
+    const auto* chars = reinterpret_cast<const char*>(mapped_file->data());  // NOLINT
+    return String {chars, mapped_file->size()};
   }
 
   return kNothing;
@@ -55,10 +77,9 @@ auto load_file_as_string(const Path& file) -> Maybe<String>
 
 auto load_binary_file(const Path& path) -> Maybe<Vector<char>>
 {
-  if (auto stream = open_input_stream(path, FileType::Binary)) {
-    Vector<char> content {std::istreambuf_iterator {*stream},
-                          std::istreambuf_iterator<char> {}};
-    return content;
+  if (const auto mapped_file = MappedFile::open(path)) {
+    const auto* chars = reinterpret_cast<const char*>(mapped_file->data());  // NOLINT
+    return Vector<char> {chars, chars + mapped_file->size()};
   }
 
   return kNothing;
@@ -79,6 +100,78 @@ auto create_file(const Path& path, FileType type) -> Maybe<OfStream>
   return kNothing;
 }
 
+auto make_temp_path(const Path& path) -> Path
+{
+  // The process tag separates concurrent processes, the counter separates threads
+  static const auto process_tag = std::random_device {}();
+  static std::atomic<uint64> counter {0};
+
+  auto temp_path = path;
+  temp_path += fmt::format(".{:08x}.{}.tmp", process_tag, counter++);
+
+  return temp_path;
+}
+
+auto get_file_info(const Path& path) -> Maybe<FileInfo>
+{
+  // Files in archives are considered to be modified along with the archive
+  if (const auto archive_path = split_archive_path(path)) {
+    const auto archive_info = get_file_info(archive_path->archive);
+    const auto archive_entry = _find_archive_entry(*archive_path);
+
+    if (!archive_info.has_value() || !archive_entry.has_value()) {
+      return kNothing;
+    }
+
+    FileInfo info;
+    info.path = archive_info->path / archive_path->name;
+    info.size = archive_entry->second->size;
+    info.time = archive_info->time;
+
+    return info;
+  }
+
+  std::error_code error;
+
+  FileInfo info;
+  info.path = fs::canonical(path, error);
+  if (error) {
+    return kNothing;
+  }
+
+  info.size = static_cast<uint64>(fs::file_size(info.path, error));
+  if (error) {
+    return kNothing;
+  }
+
+  const auto time = fs::last_write_time(info.path, error);
+  if (error) {
+    return kNothing;
+  }
+
+  info.time = static_cast<int64>(time.time_since_epoch().count());
+  return info;
+}
+
+auto hash_file(const Path& path) -> Maybe<ContentHash>
+{
+  // Archive entries store the hash of the original file, so they don't need to be read
+  if (const auto archive_path = split_archive_path(path)) {
+    if (const auto archive_entry = _find_archive_entry(*archive_path)) {
+      const auto* entry = archive_entry->second;
+      return ContentHash {entry->hash, entry->size};
+    }
+
+    return kNothing;
+  }
+
+  if (const auto file = MappedFile::open(path)) {
+    return hash_content(file->data(), file->size());
+  }
+
+  return kNothing;
+}
+
 auto get_persistent_file_dir() -> const Path&
 {
   static const auto dir = _determine_persistent_file_dir();
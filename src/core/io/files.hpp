@@ -1,5 +1,7 @@
 #pragma once
 
+#include "common/hash.hpp"
+#include "common/primitives.hpp"
 #include "common/type/fstream.hpp"
 #include "common/type/maybe.hpp"
 #include "common/type/path.hpp"
@@ -13,6 +15,13 @@ enum class FileType {
   Binary
 };
 
+/// Provides the information used to detect changes to files.
+struct FileInfo final {
+  Path path;       ///< The canonical path of the file.
+  uint64 size {};  ///< The size of the file, in bytes.
+  int64 time {};   ///< The last modification time, in file clock ticks.
+};
+
 [[nodiscard]] auto open_input_stream(const Path& file, FileType type = FileType::Text)
     -> Maybe<IfStream>;
 
@@ -23,6 +32,27 @@ enum class FileType {
 [[nodiscard]] auto create_file(const Path& path, FileType type = FileType::Text)
     -> Maybe<OfStream>;
 
+/// Returns a unique path in the same directory as a file, for writing a replacement.
+///
+/// \details
+/// Files are written to a temporary path first and then renamed over the target, so
+/// that readers never observe partially written files. The temporary paths are unique
+/// across threads and processes, so concurrent writers of the same file never write to
+/// the same temporary file.
+[[nodiscard]] auto make_temp_path(const Path& path) -> Path;
+
+/// Returns the canonical path, size and modification time of an existing file.
+[[nodiscard]] auto get_file_info(const Path& path) -> Maybe<FileInfo>;
+
+/// Computes the content hash of the bytes of a file.
+///
+/// \details
+/// Files with identical contents get the same hash, regardless of their paths, which
+/// makes it possible to share the resources of duplicated asset files.
+///
+/// \return the content hash, or nothing if the file could not be read.
+[[nodiscard]] auto hash_file(const Path& path) -> Maybe<ContentHash>;
+
 [[nodiscard]] auto get_persistent_file_dir() -> const Path&;
 
 }  // namespace glow
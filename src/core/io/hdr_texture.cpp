@@ -0,0 +1,374 @@
+#include "hdr_texture.hpp"
+
+#include <algorithm>  // clamp, max, min
+#include <bit>        // bit_cast, bit_floor
+#include <cmath>      // acos, atan2, floor, isnan
+#include <cstring>    // memcpy
+
+#include <fmt/chrono.h>
+#include <spdlog/spdlog.h>
+
+#include "common/debug/error.hpp"
+#include "common/type/array.hpp"
+#include "common/type/chrono.hpp"
+#include "io/mip_chain.hpp"
+#include "io/texture_cache.hpp"
+#include "util/thread_pool.hpp"
+
+namespace glow {
+namespace {
+
+// The largest finite values of the formats.
+inline constexpr float kMaxHalf = 65'504.0f;
+inline constexpr float kMaxRgb9e5 = 65'408.0f;
+
+// Bit patterns used to convert floats to halfs, see Fabian Giesen's float_to_half_fast3.
+inline constexpr uint32 kMinNormalHalf = 0x3880'0000;  // 2^-14 as a float
+inline constexpr uint32 kSubnormalMagic = 0x3F00'0000;
+inline constexpr uint32 kExponentRebias = 0xC800'0000;  // (15 - 127) << 23
+inline constexpr uint16 kHalfOne = 0x3C00;
+
+inline constexpr usize kCubeFaceCount = 6;
+inline constexpr float kPi = 3.14159265358979f;
+
+[[nodiscard]] auto _encode_half(const float value) noexcept -> uint16
+{
+  const auto clamped = std::isnan(value) ? 0.0f : std::clamp(value, -kMaxHalf, kMaxHalf);
+
+  auto bits = std::bit_cast<uint32>(clamped);
+  const auto sign = bits & 0x8000'0000u;
+  bits ^= sign;
+
+  // Subnormal results are rounded by the float addition, which aligns the mantissa
+  const auto subnormal =
+      std::bit_cast<uint32>(std::bit_cast<float>(bits) +
+                            std::bit_cast<float>(kSubnormalMagic)) -
+      kSubnormalMagic;
+
+  // Normal results are rebiased and rounded to the nearest even mantissa
+  const auto odd_mantissa = (bits >> 13u) & 1u;
+  const auto normal = (bits + kExponentRebias + 0xFFFu + odd_mantissa) >> 13u;
+
+  const auto result = (bits < kMinNormalHalf) ? subnormal : normal;
+  return static_cast<uint16>(result | (sign >> 16u));
+}
+
+/// Returns 2^(24 - exponent), i.e. the scale of the 9-bit mantissas of an exponent.
+[[nodiscard]] auto _get_rgb9e5_scale(const uint32 exponent) noexcept -> float
+{
+  return std::bit_cast<float>((151u - exponent) << 23u);
+}
+
+/// Encodes a color as RGB9E5, see the EXT_texture_shared_exponent specification.
+[[nodiscard]] auto _encode_rgb9e5(const float red,
+                                  const float green,
+                                  const float blue) noexcept -> uint32
+{
+  const auto clamp = [](const float value) {
+    return std::isnan(value) ? 0.0f : std::clamp(value, 0.0f, kMaxRgb9e5);
+  };
+
+  const auto r = clamp(red);
+  const auto g = clamp(green);
+  const auto b = clamp(blue);
+
+  // The floor of the base 2 logarithm is read directly from the exponent bits
+  const auto max_channel = std::max(r, std::max(g, b));
+  const auto max_exponent = static_cast<int>(std::bit_cast<uint32>(max_channel) >> 23u);
+  auto exponent = static_cast<uint32>(std::max(max_exponent - 127, -16) + 16);
+
+  // The exponent is increased if the largest channel rounds up to 2^9
+  const auto max_mantissa =
+      static_cast<uint32>(max_channel * _get_rgb9e5_scale(exponent) + 0.5f);
+  exponent += max_mantissa >> 9u;
+
+  const auto scale = _get_rgb9e5_scale(exponent);
+  const auto r_mantissa = static_cast<uint32>(r * scale + 0.5f);
+  const auto g_mantissa = static_cast<uint32>(g * scale + 0.5f);
+  const auto b_mantissa = static_cast<uint32>(b * scale + 0.5f);
+
+  return r_mantissa | (g_mantissa << 9u) | (b_mantissa << 18u) | (exponent << 27u);
+}
+
+void _encode_rgb9e5_row(const float* src, Byte* dst, const usize width)
+{
+  for (usize x = 0; x < width; ++x) {
+    const auto* pixel = src + x * 3;
+    const auto value = _encode_rgb9e5(pixel[0], pixel[1], pixel[2]);
+    std::memcpy(dst + x * sizeof value, &value, sizeof value);
+  }
+}
+
+void _encode_rgba16f_row(const float* src, Byte* dst, const usize width)
+{
+  for (usize x = 0; x < width; ++x) {
+    const auto* pixel = src + x * 3;
+    const Array<uint16, 4> value = {_encode_half(pixel[0]),
+                                    _encode_half(pixel[1]),
+                                    _encode_half(pixel[2]),
+                                    kHalfOne};
+    std::memcpy(dst + x * sizeof value, value.data(), sizeof value);
+  }
+}
+
+void _encode_row(const PixelFormat format, const float* src, Byte* dst, const usize width)
+{
+  if (format == PixelFormat::RGB9E5) {
+    _encode_rgb9e5_row(src, dst, width);
+  }
+  else {
+    _encode_rgba16f_row(src, dst, width);
+  }
+}
+
+/// Returns the direction through a point on a cubemap face, using the GL conventions.
+///
+/// \param face the face index, in the order +X, -X, +Y, -Y, +Z, -Z.
+/// \param s the horizontal face coordinate, in [-1, 1].
+/// \param t the vertical face coordinate, in [-1, 1], which increases with the row.
+[[nodiscard]] auto _get_face_direction(const usize face, const float s, const float t)
+    -> Vec3
+{
+  switch (face) {
+    case 0:
+      return Vec3 {1, -t, -s};
+
+    case 1:
+      return Vec3 {-1, -t, s};
+
+    case 2:
+      return Vec3 {s, 1, t};
+
+    case 3:
+      return Vec3 {s, -1, -t};
+
+    case 4:
+      return Vec3 {s, -t, 1};
+
+    case 5:
+      return Vec3 {-s, -t, -1};
+
+    default:
+      throw Error {"Invalid cubemap face"};
+  }
+}
+
+/// Samples an RGB float equirectangular image in a direction, using bilinear filtering.
+///
+/// \details
+/// The mapping matches the one previously used by the environment shader, i.e. the
+/// polar angle is measured from the Y axis and the image rows are stored bottom-up.
+[[nodiscard]] auto _sample_equirect(const float* pixels,
+                                    const Vec2i& size,
+                                    const Vec3& direction) -> Vec3
+{
+  const auto dir = glm::normalize(direction);
+
+  const auto theta = std::acos(std::clamp(dir.y, -1.0f, 1.0f));
+  auto phi = std::atan2(dir.z, dir.x);
+  if (phi < 0.0f) {
+    phi += 2.0f * kPi;
+  }
+
+  const auto x = phi / (2.0f * kPi) * static_cast<float>(size.x) - 0.5f;
+  const auto y = (1.0f - theta / kPi) * static_cast<float>(size.y) - 0.5f;
+
+  const auto x_floor = std::floor(x);
+  const auto y_floor = std::floor(y);
+  const auto fx = x - x_floor;
+  const auto fy = y - y_floor;
+
+  // The image wraps around horizontally, but not vertically
+  const auto x0 = (static_cast<int>(x_floor) % size.x + size.x) % size.x;
+  const auto x1 = (x0 + 1) % size.x;
+  const auto y0 = std::clamp(static_cast<int>(y_floor), 0, size.y - 1);
+  const auto y1 = std::clamp(static_cast<int>(y_floor) + 1, 0, size.y - 1);
+
+  const auto texel = [&](const int px, const int py) {
+    const auto* pixel = pixels + (static_cast<usize>(py) * static_cast<usize>(size.x) +
+                                  static_cast<usize>(px)) *
+                                     3;
+    return Vec3 {pixel[0], pixel[1], pixel[2]};
+  };
+
+  const auto top = texel(x0, y0) * (1.0f - fx) + texel(x1, y0) * fx;
+  const auto bottom = texel(x0, y1) * (1.0f - fx) + texel(x1, y1) * fx;
+
+  return top * (1.0f - fy) + bottom * fy;
+}
+
+/// Downsamples a square RGB float image by averaging 2x2 pixels.
+[[nodiscard]] auto _downsample_face(const Vector<float>& src, const int src_size)
+    -> Vector<float>
+{
+  const auto dst_size = static_cast<usize>(std::max(src_size / 2, 1));
+  const auto src_width = static_cast<usize>(src_size);
+  const auto src_max = src_width - 1;
+
+  Vector<float> dst(dst_size * dst_size * 3);
+
+  get_thread_pool().parallel_for(dst_size, [&](const usize y) {
+    const auto y0 = std::min(y * 2, src_max);
+    const auto y1 = std::min(y * 2 + 1, src_max);
+
+    for (usize x = 0; x < dst_size; ++x) {
+      const auto x0 = std::min(x * 2, src_max);
+      const auto x1 = std::min(x * 2 + 1, src_max);
+
+      for (usize channel = 0; channel < 3; ++channel) {
+        const auto sum = src[(y0 * src_width + x0) * 3 + channel] +
+                         src[(y0 * src_width + x1) * 3 + channel] +
+                         src[(y1 * src_width + x0) * 3 + channel] +
+                         src[(y1 * src_width + x1) * 3 + channel];
+        dst[(y * dst_size + x) * 3 + channel] = 0.25f * sum;
+      }
+    }
+  });
+
+  return dst;
+}
+
+}  // namespace
+
+auto get_pixel_format(const EnvironmentQuality quality) -> PixelFormat
+{
+  switch (quality) {
+    case EnvironmentQuality::Compact:
+      return PixelFormat::RGB9E5;
+
+    case EnvironmentQuality::High:
+      return PixelFormat::RGBA16F;
+
+    default:
+      throw Error {"Unknown environment quality enumerator"};
+  }
+}
+
+auto get_cubemap_face_size(const Vec2i& equirect_size) -> int
+{
+  const auto quarter_width = static_cast<uint32>(std::max(equirect_size.x / 4, 1));
+  return static_cast<int>(std::bit_floor(quarter_width));
+}
+
+auto convert_equirect_to_cubemap(const TextureData& texture, const PixelFormat format)
+    -> EncodedTexture
+{
+  if (format != PixelFormat::RGB9E5 && format != PixelFormat::RGBA16F) {
+    throw Error {"Invalid HDR pixel format"};
+  }
+
+  const auto face_size = get_cubemap_face_size(texture.size);
+  const Vec2i base_size {face_size, face_size};
+  const auto level_count = get_mip_level_count(base_size);
+
+  EncodedTexture result;
+  result.format = format;
+  result.size = base_size;
+  result.face_count = kCubeFaceCount;
+  result.levels.reserve(level_count);
+
+  usize data_size = 0;
+  for (usize level = 0; level < level_count; ++level) {
+    const auto level_size = get_mip_level_size(base_size, level);
+    const auto byte_size = get_image_byte_size(format, level_size) * kCubeFaceCount;
+
+    result.levels.push_back(TextureLevel {level_size, data_size, byte_size});
+    data_size += byte_size;
+  }
+
+  result.data.resize(data_size);
+
+  const auto* src = reinterpret_cast<const float*>(texture.pixels.get());  // NOLINT
+  const auto face_width = static_cast<usize>(face_size);
+  const auto pixel_size = get_block_byte_size(format);
+
+  for (usize face = 0; face < kCubeFaceCount; ++face) {
+    Vector<float> pixels(face_width * face_width * 3);
+
+    get_thread_pool().parallel_for(face_width, [&](const usize y) {
+      const auto t = (static_cast<float>(y) + 0.5f) / static_cast<float>(face_size);
+
+      for (usize x = 0; x < face_width; ++x) {
+        const auto s = (static_cast<float>(x) + 0.5f) / static_cast<float>(face_size);
+        const auto direction =
+            _get_face_direction(face, s * 2.0f - 1.0f, t * 2.0f - 1.0f);
+        const auto color = _sample_equirect(src, texture.size, direction);
+
+        auto* pixel = pixels.data() + (y * face_width + x) * 3;
+        pixel[0] = color.x;
+        pixel[1] = color.y;
+        pixel[2] = color.z;
+      }
+    });
+
+    for (usize level = 0; level < level_count; ++level) {
+      const auto& info = result.levels[level];
+      const auto width = static_cast<usize>(info.size.x);
+      const auto face_byte_size = info.byte_size / kCubeFaceCount;
+
+      auto* dst = result.data.data() + info.offset + face * face_byte_size;
+
+      get_thread_pool().parallel_for(width, [&](const usize y) {
+        _encode_row(format,
+                    pixels.data() + y * width * 3,
+                    dst + y * width * pixel_size,
+                    width);
+      });
+
+      if (level + 1 < level_count) {
+        pixels = _downsample_face(pixels, info.size.x);
+      }
+    }
+  }
+
+  return result;
+}
+
+auto load_environment_cubemap(const Path& path, const EnvironmentQuality quality)
+    -> Maybe<EncodedTexture>
+{
+  const auto format = get_pixel_format(quality);
+
+  if (auto texture = load_cached_texture(path, format)) {
+    return texture;
+  }
+
+  const auto data = load_texture_data(path, TextureFormat::Float, TextureChannels::RGB);
+  if (!data.has_value()) {
+    return kNothing;
+  }
+
+  const auto start_time = Clock::now();
+
+  auto texture = convert_equirect_to_cubemap(*data, format);
+
+  const auto end_time = Clock::now();
+  spdlog::debug("[IO] Converted environment to {}x{} {} cubemap in {} ({} KiB)",
+                texture.size.x,
+                texture.size.y,
+                get_short_name(format),
+                chrono::duration_cast<Milliseconds>(end_time - start_time),
+                texture.data.size() / 1024);
+
+  if (save_cached_texture(path, format, texture).failed()) {
+    spdlog::warn("[IO] Could not cache environment cubemap {}", path.string());
+  }
+
+  return texture;
+}
+
+auto get_short_name(const EnvironmentQuality quality) -> StringView
+{
+  switch (quality) {
+    case EnvironmentQuality::Compact:
+      return "Compact";
+
+    case EnvironmentQuality::High:
+      return "High";
+
+    default:
+      throw Error {"Unknown environment quality enumerator"};
+  }
+}
+
+}  // namespace glow
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "common/primitives.hpp"
+#include "common/type/math.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/path.hpp"
+#include "common/type/string.hpp"
+#include "io/texture_compression.hpp"
+#include "io/texture_loader.hpp"
+
+namespace glow {
+
+/// Determines the pixel format used to store HDR environment textures.
+enum class EnvironmentQuality : uint8 {
+  Compact,  ///< RGB9E5, 4 bytes per pixel, which is enough for most environments.
+  High      ///< RGBA16F, 8 bytes per pixel, which preserves more color precision.
+};
+
+/// Returns the pixel format used by an environment quality.
+[[nodiscard]] auto get_pixel_format(EnvironmentQuality quality) -> PixelFormat;
+
+/// Returns the face size of the cubemap that an equirectangular image is converted to.
+///
+/// \details
+/// The face size is the largest power of two that doesn't exceed a quarter of the image
+/// width, which roughly preserves the texel density at the horizon.
+[[nodiscard]] auto get_cubemap_face_size(const Vec2i& equirect_size) -> int;
+
+/// Converts an RGB float equirectangular image to a cubemap in a compact HDR format.
+///
+/// \details
+/// The faces are resampled with bilinear filtering, and the complete mip chain of each
+/// face is generated using a box filter. Faces are processed one at a time, with rows
+/// distributed across the shared thread pool, to limit the amount of temporary memory.
+///
+/// The format conversions only use branch-free arithmetic and bit manipulation, so that
+/// compilers are able to vectorize them. Values that can't be represented are clamped
+/// to the largest finite value of the format, negative values are clamped to zero for
+/// RGB9E5, and NaNs are flushed to zero.
+///
+/// \param texture the source image, which must provide three float channels.
+/// \param format the desired pixel format, either RGB9E5 or RGBA16F.
+///
+/// \return the cubemap, with the faces ordered as +X, -X, +Y, -Y, +Z, -Z.
+[[nodiscard]] auto convert_equirect_to_cubemap(const TextureData& texture,
+                                               PixelFormat format) -> EncodedTexture;
+
+/// Loads an equirectangular HDR texture and converts it to a cubemap.
+///
+/// \details
+/// Converted cubemaps are stored in the persistent texture cache, so subsequent loads
+/// of the same file skip both decoding and conversion.
+///
+/// \param path the path of the HDR texture file.
+/// \param quality determines the pixel format of the cubemap.
+///
+/// \return the cubemap, or nothing if the file could not be loaded.
+[[nodiscard]] auto load_environment_cubemap(const Path& path, EnvironmentQuality quality)
+    -> Maybe<EncodedTexture>;
+
+[[nodiscard]] auto get_short_name(EnvironmentQuality quality) -> StringView;
+
+}  // namespace glow
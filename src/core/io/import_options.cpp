@@ -0,0 +1,21 @@
+#include "import_options.hpp"
+
+#include "common/debug/error.hpp"
+
+namespace glow {
+
+auto get_short_name(const ImportProfile profile) -> StringView
+{
+  switch (profile) {
+    case ImportProfile::Fast:
+      return "Fast";
+
+    case ImportProfile::Optimized:
+      return "Optimized";
+
+    default:
+      throw Error {"Unknown import profile enumerator"};
+  }
+}
+
+}  // namespace glow
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "common/type/string.hpp"
+#include "graphics/vertex.hpp"
+#include "io/texture_compression.hpp"
+
+namespace glow {
+
+/// Determines which optional processing steps are performed when importing models.
+enum class ImportProfile {
+  Fast,      ///< Only performs the processing needed to render models.
+  Optimized  ///< Also optimizes meshes and generates LODs, at the cost of slower imports.
+};
+
+/// Options that control how model files are imported.
+struct ImportOptions final {
+  ImportProfile profile {ImportProfile::Optimized};  ///< The processing to perform.
+  VertexFormat vertex_format {VertexFormat::Float};  ///< The format of mesh vertices.
+
+  /// Whether vertex positions are uploaded to a separate vertex stream.
+  bool split_positions {false};
+
+  /// Whether meshes are imported and uploaded in small batches, to reduce peak memory.
+  bool low_memory {false};
+
+  /// The block compression used for textures, see `TextureCompression`.
+  TextureCompression texture_compression {TextureCompression::None};
+};
+
+[[nodiscard]] auto get_short_name(ImportProfile profile) -> StringView;
+
+}  // namespace glow
@@ -0,0 +1,476 @@
+#include "ktx2.hpp"
+
+#include <algorithm>    // max
+#include <cstring>      // memchr, memcpy
+#include <ios>          // streamsize
+#include <span>         // span
+#include <type_traits>  // is_trivially_copyable_v
+
+#include <spdlog/spdlog.h>
+
+#include "common/debug/error.hpp"
+#include "common/type/array.hpp"
+#include "common/type/fstream.hpp"
+#include "common/type/vector.hpp"
+#include "io/files.hpp"
+#include "io/mapped_file.hpp"
+
+namespace glow {
+namespace {
+
+// See https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+inline constexpr Array<uint8, 12> kKtx2Identifier = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A,
+};
+
+// The relevant VkFormat values, defined here to avoid depending on the Vulkan headers.
+inline constexpr uint32 kVkFormatR8G8B8A8Unorm = 37;
+inline constexpr uint32 kVkFormatR8G8B8A8Srgb = 43;
+inline constexpr uint32 kVkFormatR16G16B16A16Sfloat = 97;
+inline constexpr uint32 kVkFormatE5B9G9R9UfloatPack32 = 123;
+inline constexpr uint32 kVkFormatBC1RgbUnorm = 131;
+inline constexpr uint32 kVkFormatBC1RgbSrgb = 132;
+inline constexpr uint32 kVkFormatBC3Unorm = 137;
+inline constexpr uint32 kVkFormatBC3Srgb = 138;
+inline constexpr uint32 kVkFormatBC5Unorm = 141;
+inline constexpr uint32 kVkFormatBC7Unorm = 145;
+inline constexpr uint32 kVkFormatBC7Srgb = 146;
+
+// Data format descriptor constants, see the Khronos Data Format Specification.
+inline constexpr uint32 kDfdModelRgbsda = 1;
+inline constexpr uint32 kDfdModelBC1A = 128;
+inline constexpr uint32 kDfdModelBC3 = 130;
+inline constexpr uint32 kDfdModelBC5 = 132;
+inline constexpr uint32 kDfdModelBC7 = 134;
+inline constexpr uint32 kDfdPrimariesBT709 = 1;
+inline constexpr uint32 kDfdTransferLinear = 1;
+inline constexpr uint32 kDfdTransferSrgb = 2;
+inline constexpr uint32 kDfdChannelAlpha = 15;
+inline constexpr uint32 kDfdSampleLinear = 0x10;
+inline constexpr uint32 kDfdSampleExponent = 0x20;
+inline constexpr uint32 kDfdSampleSigned = 0x40;
+inline constexpr uint32 kDfdSampleFloat = 0x80;
+inline constexpr uint32 kFloatOne = 0x3F800000;       // Bit pattern of 1.0f
+inline constexpr uint32 kFloatMinusOne = 0xBF800000;  // Bit pattern of -1.0f
+
+struct Ktx2Header final {
+  Array<uint8, 12> identifier {};
+  uint32 vk_format {};
+  uint32 type_size {};
+  uint32 pixel_width {};
+  uint32 pixel_height {};
+  uint32 pixel_depth {};
+  uint32 layer_count {};
+  uint32 face_count {};
+  uint32 level_count {};
+  uint32 supercompression_scheme {};
+  uint32 dfd_byte_offset {};
+  uint32 dfd_byte_length {};
+  uint32 kvd_byte_offset {};
+  uint32 kvd_byte_length {};
+  uint64 sgd_byte_offset {};
+  uint64 sgd_byte_length {};
+};
+
+struct Ktx2LevelIndex final {
+  uint64 byte_offset {};
+  uint64 byte_length {};
+  uint64 uncompressed_byte_length {};
+};
+
+static_assert(sizeof(Ktx2Header) == 80);
+static_assert(sizeof(Ktx2LevelIndex) == 24);
+static_assert(std::is_trivially_copyable_v<Ktx2Header>);
+static_assert(std::is_trivially_copyable_v<Ktx2LevelIndex>);
+
+/// Describes a single sample of a basic data format descriptor block.
+struct DfdSample final {
+  uint32 bit_offset {};
+  uint32 bit_length {};
+  uint32 channel {};
+  uint32 upper {};
+  uint32 lower {};
+};
+
+/// Indicates whether the color channels of a pixel format are sRGB encoded.
+[[nodiscard]] auto _is_srgb(const PixelFormat format) -> bool
+{
+  switch (format) {
+    case PixelFormat::RGBA8:
+    case PixelFormat::BC1:
+    case PixelFormat::BC3:
+    case PixelFormat::BC7:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+[[nodiscard]] auto _get_vk_format(const PixelFormat format) -> uint32
+{
+  switch (format) {
+    case PixelFormat::RGBA8:
+      return kVkFormatR8G8B8A8Srgb;
+
+    case PixelFormat::BC1:
+      return kVkFormatBC1RgbSrgb;
+
+    case PixelFormat::BC3:
+      return kVkFormatBC3Srgb;
+
+    case PixelFormat::BC5:
+      return kVkFormatBC5Unorm;
+
+    case PixelFormat::BC7:
+      return kVkFormatBC7Srgb;
+
+    case PixelFormat::RGB9E5:
+      return kVkFormatE5B9G9R9UfloatPack32;
+
+    case PixelFormat::RGBA16F:
+      return kVkFormatR16G16B16A16Sfloat;
+
+    default:
+      throw Error {"Unknown pixel format enumerator"};
+  }
+}
+
+[[nodiscard]] auto _get_pixel_format(const uint32 vk_format) -> Maybe<PixelFormat>
+{
+  switch (vk_format) {
+    case kVkFormatR8G8B8A8Unorm:
+    case kVkFormatR8G8B8A8Srgb:
+      return PixelFormat::RGBA8;
+
+    case kVkFormatBC1RgbUnorm:
+    case kVkFormatBC1RgbSrgb:
+      return PixelFormat::BC1;
+
+    case kVkFormatBC3Unorm:
+    case kVkFormatBC3Srgb:
+      return PixelFormat::BC3;
+
+    case kVkFormatBC5Unorm:
+      return PixelFormat::BC5;
+
+    case kVkFormatBC7Unorm:
+    case kVkFormatBC7Srgb:
+      return PixelFormat::BC7;
+
+    case kVkFormatE5B9G9R9UfloatPack32:
+      return PixelFormat::RGB9E5;
+
+    case kVkFormatR16G16B16A16Sfloat:
+      return PixelFormat::RGBA16F;
+
+    default:
+      return kNothing;
+  }
+}
+
+/// Creates the data format descriptor of a pixel format, including the total size.
+[[nodiscard]] auto _make_dfd(const PixelFormat format) -> Vector<uint32>
+{
+  constexpr uint32 kBlockUpper = 0xFFFFFFFF;
+
+  const auto srgb = _is_srgb(format);
+  const auto alpha_channel = kDfdChannelAlpha | (srgb ? kDfdSampleLinear : 0u);
+
+  uint32 model = kDfdModelRgbsda;
+  Vector<DfdSample> samples;
+
+  switch (format) {
+    case PixelFormat::RGBA8:
+      samples = {{0, 8, 0, 255},
+                 {8, 8, 1, 255},
+                 {16, 8, 2, 255},
+                 {24, 8, alpha_channel, 255}};
+      break;
+
+    case PixelFormat::BC1:
+      model = kDfdModelBC1A;
+      samples = {{0, 64, 0, kBlockUpper}};
+      break;
+
+    case PixelFormat::BC3:
+      model = kDfdModelBC3;
+      samples = {{0, 64, alpha_channel, kBlockUpper}, {64, 64, 0, kBlockUpper}};
+      break;
+
+    case PixelFormat::BC5:
+      model = kDfdModelBC5;
+      samples = {{0, 64, 0, kBlockUpper}, {64, 64, 1, kBlockUpper}};
+      break;
+
+    case PixelFormat::BC7:
+      model = kDfdModelBC7;
+      samples = {{0, 128, 0, kBlockUpper}};
+      break;
+
+    case PixelFormat::RGB9E5: {
+      // Each channel is described by its mantissa and the shared exponent
+      constexpr uint32 kMantissaUpper = 8448;
+      constexpr uint32 kExponentBits = 5;
+
+      for (uint32 channel = 0; channel < 3; ++channel) {
+        samples.push_back({channel * 9, 9, channel, kMantissaUpper});
+        samples.push_back({27, kExponentBits, channel | kDfdSampleExponent, 31, 15});
+      }
+
+      break;
+    }
+
+    case PixelFormat::RGBA16F: {
+      constexpr uint32 kSignedFloat = kDfdSampleSigned | kDfdSampleFloat;
+
+      for (uint32 channel = 0; channel < 4; ++channel) {
+        const auto id = (channel == 3) ? kDfdChannelAlpha : channel;
+        samples.push_back(
+            {channel * 16, 16, id | kSignedFloat, kFloatOne, kFloatMinusOne});
+      }
+
+      break;
+    }
+
+    default:
+      throw Error {"Unknown pixel format enumerator"};
+  }
+
+  const auto block_dim = is_block_compressed(format) ? 3u : 0u;
+  const auto block_size = static_cast<uint32>(24 + 16 * samples.size());
+
+  Vector<uint32> dfd;
+  dfd.push_back(4 + block_size);
+  dfd.push_back(0);  // Khronos vendor ID and basic descriptor type
+  dfd.push_back(2u | (block_size << 16u));
+  dfd.push_back(model | (kDfdPrimariesBT709 << 8u) |
+                ((srgb ? kDfdTransferSrgb : kDfdTransferLinear) << 16u));
+  dfd.push_back(block_dim | (block_dim << 8u));
+  dfd.push_back(static_cast<uint32>(get_block_byte_size(format)));
+  dfd.push_back(0);
+
+  for (const auto& sample : samples) {
+    dfd.push_back(sample.bit_offset | ((sample.bit_length - 1) << 16u) |
+                  (sample.channel << 24u));
+    dfd.push_back(0);
+    dfd.push_back(sample.lower);
+    dfd.push_back(sample.upper);
+  }
+
+  return dfd;
+}
+
+void _append_bytes(Vector<Byte>& buffer, const void* data, const usize size)
+{
+  const auto offset = buffer.size();
+  buffer.resize(offset + size);
+  std::memcpy(buffer.data() + offset, data, size);
+}
+
+void _align(Vector<Byte>& buffer, const usize alignment)
+{
+  buffer.resize((buffer.size() + alignment - 1) / alignment * alignment);
+}
+
+/// Appends the key/value data, where each entry is a length, a NUL terminated key and
+/// the value, padded to four bytes. Entries are sorted by key, as required by the spec.
+void _append_key_values(Vector<Byte>& buffer, const Ktx2KeyValues& key_values)
+{
+  for (const auto& [key, value] : key_values) {
+    const auto length = static_cast<uint32>(key.size() + 1 + value.size());
+
+    _append_bytes(buffer, &length, sizeof length);
+    _append_bytes(buffer, key.c_str(), key.size() + 1);
+    _append_bytes(buffer, value.data(), value.size());
+    _align(buffer, 4);
+  }
+}
+
+[[nodiscard]] auto _read_key_values(std::span<const Byte> bytes,
+                                    Ktx2KeyValues& key_values) -> bool
+{
+  usize offset = 0;
+
+  while (bytes.size() - offset >= sizeof(uint32)) {
+    uint32 length {};
+    std::memcpy(&length, bytes.data() + offset, sizeof length);
+    offset += sizeof length;
+
+    if (length > bytes.size() - offset) {
+      return false;
+    }
+
+    const auto* entry = reinterpret_cast<const char*>(bytes.data() + offset);  // NOLINT
+    const auto* key_end = static_cast<const char*>(std::memchr(entry, '\0', length));
+    if (key_end == nullptr) {
+      return false;
+    }
+
+    const auto key_size = static_cast<usize>(key_end - entry);
+    key_values.insert_or_assign(String {entry, key_size},
+                                String {key_end + 1, length - key_size - 1});
+
+    offset += (static_cast<usize>(length) + 3) / 4 * 4;
+  }
+
+  return true;
+}
+
+}  // namespace
+
+auto save_ktx2(const Path& path,
+               const EncodedTexture& texture,
+               const Ktx2KeyValues& key_values) -> Result
+{
+  const auto dfd = _make_dfd(texture.format);
+  const auto level_count = texture.levels.size();
+
+  Ktx2Header header;
+  header.identifier = kKtx2Identifier;
+  header.vk_format = _get_vk_format(texture.format);
+  header.type_size = 1;
+  header.pixel_width = static_cast<uint32>(texture.size.x);
+  header.pixel_height = static_cast<uint32>(texture.size.y);
+  header.face_count = static_cast<uint32>(texture.face_count);
+  header.level_count = static_cast<uint32>(level_count);
+  header.dfd_byte_offset =
+      static_cast<uint32>(sizeof(Ktx2Header) + level_count * sizeof(Ktx2LevelIndex));
+  header.dfd_byte_length = static_cast<uint32>(byte_size(dfd));
+
+  Vector<Byte> buffer;
+  buffer.reserve(header.dfd_byte_offset + header.dfd_byte_length + texture.data.size());
+  buffer.resize(header.dfd_byte_offset);
+  _append_bytes(buffer, dfd.data(), byte_size(dfd));
+
+  if (!key_values.empty()) {
+    header.kvd_byte_offset = static_cast<uint32>(buffer.size());
+    _append_key_values(buffer, key_values);
+    header.kvd_byte_length = static_cast<uint32>(buffer.size() - header.kvd_byte_offset);
+  }
+
+  // The level data is stored in order of increasing size, i.e. starting with the
+  // smallest mip level, and each level is aligned to the size of a block.
+  const auto alignment = std::max(get_block_byte_size(texture.format), usize {4});
+
+  Vector<Ktx2LevelIndex> level_index(level_count);
+  for (auto level = level_count; level > 0; --level) {
+    const auto& info = texture.levels[level - 1];
+
+    _align(buffer, alignment);
+
+    auto& entry = level_index[level - 1];
+    entry.byte_offset = static_cast<uint64>(buffer.size());
+    entry.byte_length = static_cast<uint64>(info.byte_size);
+    entry.uncompressed_byte_length = entry.byte_length;
+
+    _append_bytes(buffer, texture.get_level_data(level - 1), info.byte_size);
+  }
+
+  std::memcpy(buffer.data(), &header, sizeof header);
+  std::memcpy(buffer.data() + sizeof header, level_index.data(), byte_size(level_index));
+
+  auto stream = create_file(path, FileType::Binary);
+  if (!stream.has_value()) {
+    return kFailure;
+  }
+
+  stream->write(reinterpret_cast<const char*>(buffer.data()),  // NOLINT
+                static_cast<std::streamsize>(buffer.size()));
+
+  return stream->good() ? kSuccess : kFailure;
+}
+
+auto load_ktx2(const Path& path, Ktx2KeyValues* key_values) -> Maybe<EncodedTexture>
+{
+  const auto file = MappedFile::open(path);
+  if (!file.has_value() || file->size() < sizeof(Ktx2Header)) {
+    return kNothing;
+  }
+
+  Ktx2Header header;
+  std::memcpy(&header, file->data(), sizeof header);
+
+  if (header.identifier != kKtx2Identifier) {
+    spdlog::warn("[IO] {} is not a KTX2 file", path.string());
+    return kNothing;
+  }
+
+  // Cubemaps must have square faces
+  const auto valid_faces =
+      header.face_count == 1 ||
+      (header.face_count == 6 && header.pixel_width == header.pixel_height);
+
+  const auto format = _get_pixel_format(header.vk_format);
+  if (!format.has_value() ||             //
+      header.pixel_width == 0 ||         //
+      header.pixel_height == 0 ||        //
+      header.pixel_depth != 0 ||         //
+      header.layer_count > 1 ||          //
+      !valid_faces ||                    //
+      header.level_count == 0 ||         //
+      header.level_count > 32 ||         //
+      header.supercompression_scheme != 0) {
+    spdlog::warn("[IO] Unsupported KTX2 file {}", path.string());
+    return kNothing;
+  }
+
+  const auto level_count = static_cast<usize>(header.level_count);
+  if (file->size() < sizeof(Ktx2Header) + level_count * sizeof(Ktx2LevelIndex)) {
+    return kNothing;
+  }
+
+  Vector<Ktx2LevelIndex> level_index(level_count);
+  std::memcpy(level_index.data(),
+              file->data() + sizeof(Ktx2Header),
+              byte_size(level_index));
+
+  if (key_values != nullptr && header.kvd_byte_length != 0) {
+    const auto bytes = file->bytes();
+
+    if (header.kvd_byte_offset > bytes.size() ||
+        header.kvd_byte_length > bytes.size() - header.kvd_byte_offset ||
+        !_read_key_values(bytes.subspan(header.kvd_byte_offset, header.kvd_byte_length),
+                          *key_values)) {
+      spdlog::warn("[IO] Corrupt KTX2 file {}", path.string());
+      return kNothing;
+    }
+  }
+
+  EncodedTexture texture;
+  texture.format = *format;
+  texture.size = Vec2i {static_cast<int>(header.pixel_width),
+                        static_cast<int>(header.pixel_height)};
+  texture.face_count = header.face_count;
+  texture.levels.reserve(level_count);
+
+  usize data_size = 0;
+  for (usize level = 0; level < level_count; ++level) {
+    const Vec2i size {std::max(texture.size.x >> level, 1),
+                      std::max(texture.size.y >> level, 1)};
+    const auto level_size = get_image_byte_size(*format, size) * texture.face_count;
+
+    // Guard against corrupt files claiming more data than there is in the file.
+    const auto& entry = level_index[level];
+    if (entry.byte_length != level_size || entry.byte_offset > file->size() ||
+        entry.byte_length > file->size() - entry.byte_offset) {
+      spdlog::warn("[IO] Corrupt KTX2 file {}", path.string());
+      return kNothing;
+    }
+
+    texture.levels.push_back(TextureLevel {size, data_size, level_size});
+    data_size += level_size;
+  }
+
+  texture.data.resize(data_size);
+
+  for (usize level = 0; level < level_count; ++level) {
+    std::memcpy(texture.data.data() + texture.levels[level].offset,
+                file->data() + level_index[level].byte_offset,
+                texture.levels[level].byte_size);
+  }
+
+  return texture;
+}
+
+}  // namespace glow
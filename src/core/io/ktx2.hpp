@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common/result.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/map.hpp"
+#include "common/type/path.hpp"
+#include "common/type/string.hpp"
+#include "io/texture_compression.hpp"
+
+namespace glow {
+
+/// Arbitrary key/value data stored in a KTX2 file, where values may hold binary data.
+using Ktx2KeyValues = Map<String, String>;
+
+/// Writes an encoded texture to a KTX2 file.
+///
+/// \details
+/// The texture is stored without supercompression, together with a basic data format
+/// descriptor. Color formats are tagged as sRGB, whereas BC5 textures are tagged as
+/// linear, since these are expected to contain normal maps. HDR formats are linear.
+///
+/// \param path the path of the file to write.
+/// \param texture the texture to store.
+/// \param key_values optional key/value data to store along with the texture.
+///
+/// \return success if the file was written; failure otherwise.
+auto save_ktx2(const Path& path,
+               const EncodedTexture& texture,
+               const Ktx2KeyValues& key_values = {}) -> Result;
+
+/// Reads an encoded texture from a KTX2 file.
+///
+/// \details
+/// Only 2D textures and cubemaps without supercompression, using one of the formats
+/// described by `PixelFormat`, are supported. Both the sRGB and linear variants of these
+/// formats are accepted, since the color space is determined by the renderers.
+///
+/// \param path the path of the file to read.
+/// \param key_values optional map that receives the key/value data of the file.
+///
+/// \return the texture, or nothing if the file could not be read.
+[[nodiscard]] auto load_ktx2(const Path& path, Ktx2KeyValues* key_values = nullptr)
+    -> Maybe<EncodedTexture>;
+
+}  // namespace glow
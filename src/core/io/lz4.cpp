@@ -0,0 +1,207 @@
+#include "lz4.hpp"
+
+#include <algorithm>  // min
+#include <cstring>    // memcpy
+
+namespace glow {
+namespace {
+
+inline constexpr usize kMinMatchLength = 4;
+inline constexpr usize kMaxTokenLength = 15;
+inline constexpr usize kMaxMatchOffset = 65'535;
+
+// The last five bytes of a block are always literals, and the last match must start at
+// least twelve bytes before the end of the block.
+inline constexpr usize kLastLiteralCount = 5;
+inline constexpr usize kMatchStartLimit = 12;
+
+inline constexpr int kHashBits = 16;
+
+[[nodiscard]] auto _read_uint32(const Byte* bytes) noexcept -> uint32
+{
+  uint32 value {};
+  std::memcpy(&value, bytes, sizeof value);
+  return value;
+}
+
+[[nodiscard]] auto _hash(const uint32 value) noexcept -> usize
+{
+  return static_cast<usize>((value * 2'654'435'761u) >> (32 - kHashBits));
+}
+
+void _write_length(Vector<Byte>& block, usize length)
+{
+  while (length >= 255) {
+    block.push_back(Byte {255});
+    length -= 255;
+  }
+
+  block.push_back(static_cast<Byte>(length));
+}
+
+/// Appends a sequence of literals, optionally followed by a match.
+void _write_sequence(Vector<Byte>& block,
+                     const Byte* literals,
+                     const usize literal_count,
+                     const usize match_length,
+                     const usize match_offset)
+{
+  const auto literal_token = std::min(literal_count, kMaxTokenLength);
+  const auto match_token =
+      (match_length != 0) ? std::min(match_length - kMinMatchLength, kMaxTokenLength) : 0;
+
+  block.push_back(static_cast<Byte>((literal_token << 4) | match_token));
+
+  if (literal_count >= kMaxTokenLength) {
+    _write_length(block, literal_count - kMaxTokenLength);
+  }
+
+  block.insert(block.end(), literals, literals + literal_count);
+
+  if (match_length != 0) {
+    block.push_back(static_cast<Byte>(match_offset & 0xFF));
+    block.push_back(static_cast<Byte>(match_offset >> 8));
+
+    if (match_length - kMinMatchLength >= kMaxTokenLength) {
+      _write_length(block, match_length - kMinMatchLength - kMaxTokenLength);
+    }
+  }
+}
+
+[[nodiscard]] auto _read_length(const std::span<const Byte> block,
+                                usize& offset,
+                                usize& length) noexcept -> bool
+{
+  Byte value {};
+
+  do {
+    if (offset == block.size()) {
+      return false;
+    }
+
+    value = block[offset++];
+    length += std::to_integer<usize>(value);
+  } while (value == Byte {255});
+
+  return true;
+}
+
+}  // namespace
+
+auto lz4_compress(const std::span<const Byte> bytes) -> Vector<Byte>
+{
+  const auto* data = bytes.data();
+  const auto size = bytes.size();
+
+  Vector<Byte> block;
+  block.reserve(get_lz4_bound(size));
+
+  usize anchor = 0;
+
+  if (size > kMatchStartLimit) {
+    // Stores the position after the last occurrence of each hashed 4-byte sequence
+    Vector<usize> positions(usize {1} << kHashBits, 0);
+
+    const auto match_end = size - kLastLiteralCount;
+    usize pos = 0;
+
+    while (pos + kMatchStartLimit <= size) {
+      const auto value = _read_uint32(data + pos);
+      auto& slot = positions[_hash(value)];
+
+      const auto candidate = slot;
+      slot = pos + 1;
+
+      if (candidate == 0 || pos - (candidate - 1) > kMaxMatchOffset ||
+          _read_uint32(data + candidate - 1) != value) {
+        ++pos;
+        continue;
+      }
+
+      const auto match_pos = candidate - 1;
+
+      auto match_length = kMinMatchLength;
+      while (pos + match_length < match_end &&
+             data[match_pos + match_length] == data[pos + match_length]) {
+        ++match_length;
+      }
+
+      _write_sequence(block, data + anchor, pos - anchor, match_length, pos - match_pos);
+
+      pos += match_length;
+      anchor = pos;
+    }
+  }
+
+  _write_sequence(block, data + anchor, size - anchor, 0, 0);
+
+  return block;
+}
+
+auto lz4_decompress(const std::span<const Byte> block, const std::span<Byte> output)
+    -> bool
+{
+  usize in = 0;
+  usize out = 0;
+
+  while (in < block.size()) {
+    const auto token = std::to_integer<usize>(block[in++]);
+
+    usize literal_count = token >> 4;
+    if (literal_count == kMaxTokenLength && !_read_length(block, in, literal_count)) {
+      return false;
+    }
+
+    if (literal_count > block.size() - in || literal_count > output.size() - out) {
+      return false;
+    }
+
+    if (literal_count != 0) {
+      std::memcpy(output.data() + out, block.data() + in, literal_count);
+      in += literal_count;
+      out += literal_count;
+    }
+
+    // The last sequence only consists of literals
+    if (in == block.size()) {
+      break;
+    }
+
+    if (block.size() - in < 2) {
+      return false;
+    }
+
+    const auto match_offset = std::to_integer<usize>(block[in]) |  //
+                              (std::to_integer<usize>(block[in + 1]) << 8);
+    in += 2;
+
+    if (match_offset == 0 || match_offset > out) {
+      return false;
+    }
+
+    usize match_length = token & 0xF;
+    if (match_length == kMaxTokenLength && !_read_length(block, in, match_length)) {
+      return false;
+    }
+
+    match_length += kMinMatchLength;
+    if (match_length > output.size() - out) {
+      return false;
+    }
+
+    // Matches that overlap their own output repeat a pattern, and must be copied in order
+    if (match_offset >= match_length) {
+      std::memcpy(output.data() + out, output.data() + out - match_offset, match_length);
+      out += match_length;
+    }
+    else {
+      for (usize index = 0; index < match_length; ++index, ++out) {
+        output[out] = output[out - match_offset];
+      }
+    }
+  }
+
+  return out == output.size();
+}
+
+}  // namespace glow
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <span>  // span
+
+#include "common/primitives.hpp"
+#include "common/type/vector.hpp"
+
+namespace glow {
+
+/// Returns the largest possible size of an LZ4 compressed block.
+[[nodiscard]] constexpr auto get_lz4_bound(const usize size) noexcept -> usize
+{
+  return size + size / 255 + 16;
+}
+
+/// Compresses a sequence of bytes to a single LZ4 block.
+///
+/// \details
+/// The output follows the LZ4 block format, but only a simple greedy match search is
+/// used. This is meant for offline packing, where the decompression speed matters far
+/// more than the compression ratio.
+///
+/// \param bytes the bytes to compress.
+///
+/// \return the compressed block, which is not prefixed with the original size.
+[[nodiscard]] auto lz4_compress(std::span<const Byte> bytes) -> Vector<Byte>;
+
+/// Decompresses a single LZ4 block.
+///
+/// \details
+/// All offsets and lengths are validated, so malformed blocks are rejected rather than
+/// causing out-of-bounds accesses.
+///
+/// \param block the compressed block.
+/// \param output the decompressed bytes, must have the exact original size.
+///
+/// \return true if the block was valid and filled the entire output; false otherwise.
+[[nodiscard]] auto lz4_decompress(std::span<const Byte> block, std::span<Byte> output)
+    -> bool;
+
+}  // namespace glow
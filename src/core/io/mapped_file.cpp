@@ -0,0 +1,277 @@
+#include "mapped_file.hpp"
+
+#include <ios>           // ios, streamsize
+#include <string>        // char_traits
+#include <system_error>  // error_code
+#include <utility>       // exchange, move
+
+#include <fmt/chrono.h>
+#include <spdlog/spdlog.h>
+
+#include "common/type/chrono.hpp"
+#include "common/type/fstream.hpp"
+#include "io/asset_archive.hpp"
+
+#if GLOW_OS_WINDOWS
+
+#include <windows.h>
+
+#else
+
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+
+#endif  // GLOW_OS_WINDOWS
+
+namespace glow {
+namespace {
+
+// Mapping a file has a fixed cost (and causes page faults on first access), so small
+// files are cheaper to read into a buffer.
+inline constexpr usize kMinMappedFileSize = 64 * 1'024;
+
+// Read chunk size used when the file size is unknown.
+inline constexpr usize kReadChunkSize = 64 * 1'024;
+
+}  // namespace
+
+MappedFile::~MappedFile() noexcept
+{
+  dispose();
+}
+
+void MappedFile::dispose() noexcept
+{
+#if GLOW_OS_WINDOWS
+  if (mMapped) {
+    UnmapViewOfFile(mData);
+  }
+
+  if (mMapping) {
+    CloseHandle(mMapping);
+  }
+
+  if (mFile) {
+    CloseHandle(mFile);
+  }
+
+  mMapping = nullptr;
+  mFile = nullptr;
+#else
+  if (mMapped) {
+    munmap(const_cast<Byte*>(mData), mSize);
+  }
+#endif  // GLOW_OS_WINDOWS
+
+  mData = nullptr;
+  mSize = 0;
+  mMapped = false;
+  mBuffer = {};
+  mArchive.reset();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mData {std::exchange(other.mData, nullptr)},
+      mSize {std::exchange(other.mSize, 0)},
+      mMapped {std::exchange(other.mMapped, false)},
+      mBuffer {std::move(other.mBuffer)},
+      mArchive {std::move(other.mArchive)}
+#if GLOW_OS_WINDOWS
+      ,
+      mFile {std::exchange(other.mFile, nullptr)},
+      mMapping {std::exchange(other.mMapping, nullptr)}
+#endif  // GLOW_OS_WINDOWS
+{
+}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+  if (this != &other) {
+    dispose();
+
+    mData = std::exchange(other.mData, nullptr);
+    mSize = std::exchange(other.mSize, 0);
+    mMapped = std::exchange(other.mMapped, false);
+    mBuffer = std::move(other.mBuffer);
+    mArchive = std::move(other.mArchive);
+
+#if GLOW_OS_WINDOWS
+    mFile = std::exchange(other.mFile, nullptr);
+    mMapping = std::exchange(other.mMapping, nullptr);
+#endif  // GLOW_OS_WINDOWS
+  }
+
+  return *this;
+}
+
+auto MappedFile::open(const Path& path) -> Maybe<MappedFile>
+{
+  const auto start_time = Clock::now();
+
+  MappedFile file;
+
+  if (const auto archive_path = split_archive_path(path)) {
+    if (!file.read_archive_entry(*archive_path)) {
+      return kNothing;
+    }
+  }
+  else {
+    std::error_code error;
+    const auto file_size = fs::file_size(path, error);
+
+    const auto should_map = !error && file_size >= kMinMappedFileSize;
+    if (!should_map || !file.map(path)) {
+      file.dispose();
+
+      if (!file.read(path)) {
+        return kNothing;
+      }
+    }
+  }
+
+  const auto end_time = Clock::now();
+  spdlog::trace("[IO] Read '{}' ({} bytes, {}) in {}",
+                path.string(),
+                file.size(),
+                file.mArchive ? "archived" : (file.is_mapped() ? "mapped" : "buffered"),
+                chrono::duration_cast<Microseconds>(end_time - start_time));
+
+  return file;
+}
+
+auto MappedFile::map(const Path& path) -> bool
+{
+#if GLOW_OS_WINDOWS
+  mFile = CreateFileW(path.c_str(),
+                      GENERIC_READ,
+                      FILE_SHARE_READ,
+                      nullptr,
+                      OPEN_EXISTING,
+                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                      nullptr);
+  if (mFile == INVALID_HANDLE_VALUE) {
+    mFile = nullptr;
+    return false;
+  }
+
+  LARGE_INTEGER file_size {};
+  if (!GetFileSizeEx(mFile, &file_size) || file_size.QuadPart == 0) {
+    return false;
+  }
+
+  mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mMapping) {
+    return false;
+  }
+
+  mData = static_cast<const Byte*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+  if (!mData) {
+    return false;
+  }
+
+  mSize = static_cast<usize>(file_size.QuadPart);
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat file_info {};
+  if (fstat(fd, &file_info) != 0 || file_info.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+
+  const auto file_size = static_cast<usize>(file_info.st_size);
+  void* data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping remains valid after the file descriptor is closed.
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  mData = static_cast<const Byte*>(data);
+  mSize = file_size;
+#endif  // GLOW_OS_WINDOWS
+
+  mMapped = true;
+  return true;
+}
+
+auto MappedFile::read(const Path& path) -> bool
+{
+  IfStream stream {path, std::ios::in | std::ios::binary};
+  if (!stream.is_open()) {
+    return false;
+  }
+
+  // The file size is only used as a hint, since it's unknown for e.g. pipes.
+  std::error_code error;
+  const auto file_size = fs::file_size(path, error);
+  mBuffer.resize(error ? kReadChunkSize : static_cast<usize>(file_size));
+
+  usize total_size = 0;
+  while (stream.peek() != std::char_traits<char>::eof()) {
+    if (total_size == mBuffer.size()) {
+      mBuffer.resize(mBuffer.size() + kReadChunkSize);
+    }
+
+    stream.read(reinterpret_cast<char*>(mBuffer.data() + total_size),  // NOLINT
+                static_cast<std::streamsize>(mBuffer.size() - total_size));
+    total_size += static_cast<usize>(stream.gcount());
+  }
+
+  if (stream.bad()) {
+    mBuffer = {};
+    return false;
+  }
+
+  mBuffer.resize(total_size);
+
+  mData = mBuffer.data();
+  mSize = mBuffer.size();
+
+  return true;
+}
+
+auto MappedFile::read_archive_entry(const ArchivePath& archive_path) -> bool
+{
+  auto archive = get_asset_archive(archive_path.archive);
+  if (!archive) {
+    return false;
+  }
+
+  const auto* entry = archive->find(archive_path.name);
+  if (!entry) {
+    return false;
+  }
+
+  if (entry->compression == static_cast<uint8>(ArchiveCompression::None)) {
+    const auto bytes = archive->get_stored_bytes(*entry);
+    mData = bytes.data();
+    mSize = bytes.size();
+  }
+  else {
+    mBuffer.resize(static_cast<usize>(entry->size));
+
+    if (!archive->extract(*entry, mBuffer)) {
+      spdlog::error("[IO] Asset archive entry {} in {} is corrupt",
+                    archive_path.name,
+                    archive_path.archive.string());
+      mBuffer = {};
+      return false;
+    }
+
+    mData = mBuffer.data();
+    mSize = mBuffer.size();
+  }
+
+  mArchive = std::move(archive);
+  return true;
+}
+
+}  // namespace glow
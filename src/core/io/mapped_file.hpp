@@ -0,0 +1,82 @@
+#pragma once
+
+#include <span>  // span
+
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/memory.hpp"
+#include "common/type/path.hpp"
+#include "common/type/vector.hpp"
+
+namespace glow {
+
+GLOW_FORWARD_DECLARE_C(AssetArchive);
+GLOW_FORWARD_DECLARE_S(ArchivePath);
+
+/// Read-only view of the contents of a file.
+///
+/// \details
+/// Files are mapped into the address space of the process when possible, in which case
+/// the contents are paged in by the OS on demand without any intermediate copies. Small
+/// files, and files that can't be mapped (e.g. pipes), are instead read into an internal
+/// buffer using a single bulk read. In both cases, the data is suitably aligned for any
+/// fundamental type.
+///
+/// Files inside asset archives are opened through the archive, see `AssetArchive`.
+/// Uncompressed entries are used directly from the mapped archive, which is kept alive
+/// for as long as the file is open, whilst compressed entries are decompressed into the
+/// internal buffer.
+class MappedFile final {
+ public:
+  GLOW_DELETE_COPY(MappedFile);
+
+  ~MappedFile() noexcept;
+
+  MappedFile(MappedFile&& other) noexcept;
+
+  auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+  /// Opens an existing file for reading.
+  ///
+  /// \param path the path to the file to open.
+  ///
+  /// \return the file contents, or nothing if the file could not be read.
+  [[nodiscard]] static auto open(const Path& path) -> Maybe<MappedFile>;
+
+  [[nodiscard]] auto bytes() const noexcept -> std::span<const Byte>
+  {
+    return {mData, mSize};
+  }
+
+  [[nodiscard]] auto data() const noexcept -> const Byte* { return mData; }
+
+  [[nodiscard]] auto size() const noexcept -> usize { return mSize; }
+
+  /// Indicates whether the file is memory mapped, as opposed to buffered.
+  [[nodiscard]] auto is_mapped() const noexcept -> bool { return mMapped; }
+
+ private:
+  const Byte* mData {};
+  usize mSize {};
+  bool mMapped {};
+  Vector<Byte> mBuffer;
+  Shared<const AssetArchive> mArchive;
+
+#if GLOW_OS_WINDOWS
+  void* mFile {};
+  void* mMapping {};
+#endif  // GLOW_OS_WINDOWS
+
+  MappedFile() noexcept = default;
+
+  [[nodiscard]] auto map(const Path& path) -> bool;
+
+  [[nodiscard]] auto read(const Path& path) -> bool;
+
+  [[nodiscard]] auto read_archive_entry(const ArchivePath& archive_path) -> bool;
+
+  void dispose() noexcept;
+};
+
+}  // namespace glow
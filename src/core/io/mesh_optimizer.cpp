@@ -0,0 +1,1213 @@
+#include "mesh_optimizer.hpp"
+
+#include <algorithm>  // stable_sort, fill, min, max
+#include <bit>        // bit_cast
+#include <cmath>      // sqrt, abs
+#include <cstring>    // memcpy
+#include <limits>     // numeric_limits
+#include <utility>    // move
+
+#include <glm/gtc/packing.hpp>
+
+#include "common/type/array.hpp"
+#include "common/type/map.hpp"
+#include "common/type/math.hpp"
+#include "common/type/set.hpp"
+
+namespace glow {
+namespace {
+
+inline constexpr uint32 kInvalidIndex = std::numeric_limits<uint32>::max();
+
+// 0xFFFF is reserved, since it's the primitive restart index for 16-bit indices.
+inline constexpr usize kMaxUInt16VertexCount = std::numeric_limits<uint16>::max();
+
+inline constexpr uint32 kVertexCacheSize = 16;
+
+// Meshlet limits, similar to what is commonly used for mesh shaders.
+inline constexpr usize kMaxMeshletVertices = 64;
+inline constexpr usize kMaxMeshletTriangles = 124;
+
+// Normal cones wider than this (the dot product between the axis and the normal that
+// deviates the most from it) are pointless, since they would almost never be culled.
+inline constexpr float kMinMeshletConeSpread = 0.1f;
+
+// Weight of the planes that keep open borders in place during simplification.
+inline constexpr double kBorderWeight = 10.0;
+
+/// Simulates a FIFO post-transform vertex cache.
+class VertexCache final {
+ public:
+  explicit VertexCache(const usize vertex_count)
+      : mTimestamps(vertex_count, 0)
+  {
+  }
+
+  /// Accesses a vertex, and returns true if it wasn't in the cache.
+  auto access(const uint32 vertex) -> bool
+  {
+    if (!contains(vertex)) {
+      mTimestamps[vertex] = mTimestamp;
+      ++mTimestamp;
+      return true;
+    }
+
+    return false;
+  }
+
+  /// Accesses the vertices of a triangle, and returns the number of cache misses.
+  auto access(const uint32* triangle) -> uint32
+  {
+    return static_cast<uint32>(access(triangle[0])) +
+           static_cast<uint32>(access(triangle[1])) +
+           static_cast<uint32>(access(triangle[2]));
+  }
+
+  [[nodiscard]] auto contains(const uint32 vertex) const -> bool
+  {
+    return mTimestamp - mTimestamps[vertex] <= kVertexCacheSize;
+  }
+
+  /// Returns how long ago the vertex entered the cache, or a large value if it isn't
+  /// in the cache.
+  [[nodiscard]] auto get_age(const uint32 vertex) const -> uint32
+  {
+    return mTimestamp - mTimestamps[vertex];
+  }
+
+  /// Evicts all vertices from the cache.
+  void clear() { mTimestamp += kVertexCacheSize + 1; }
+
+ private:
+  Vector<uint32> mTimestamps;
+  uint32 mTimestamp {kVertexCacheSize + 1};
+};
+
+/// Triangle adjacency information for each vertex, stored in a compact format.
+struct VertexAdjacency final {
+  Vector<uint32> offsets;    ///< Offsets into the triangle array, one per vertex.
+  Vector<uint32> counts;     ///< The number of adjacent triangles, one per vertex.
+  Vector<uint32> triangles;  ///< Indices of adjacent triangles.
+};
+
+[[nodiscard]] auto _build_vertex_adjacency(const Vector<uint32>& indices,
+                                           const usize vertex_count) -> VertexAdjacency
+{
+  VertexAdjacency adjacency;
+  adjacency.offsets.resize(vertex_count);
+  adjacency.counts.resize(vertex_count);
+  adjacency.triangles.resize(indices.size());
+
+  for (const auto index : indices) {
+    ++adjacency.counts[index];
+  }
+
+  uint32 offset = 0;
+  for (usize vertex = 0; vertex < vertex_count; ++vertex) {
+    adjacency.offsets[vertex] = offset;
+    offset += adjacency.counts[vertex];
+  }
+
+  auto next_slots = adjacency.offsets;
+  for (usize index = 0; index < indices.size(); ++index) {
+    const auto triangle = static_cast<uint32>(index / 3);
+    adjacency.triangles[next_slots[indices[index]]++] = triangle;
+  }
+
+  return adjacency;
+}
+
+/// Selects the next fanning vertex in the Tipsify algorithm.
+[[nodiscard]] auto _select_next_vertex(const VertexCache& cache,
+                                       const Vector<uint32>& live_triangles,
+                                       const Vector<uint32>& candidates,
+                                       Vector<uint32>& dead_ends,
+                                       usize& cursor) -> uint32
+{
+  auto best_vertex = kInvalidIndex;
+  int64 best_priority = -1;
+
+  for (const auto vertex : candidates) {
+    const auto live_count = live_triangles[vertex];
+    if (live_count == 0) {
+      continue;
+    }
+
+    // Prefer vertices that will still be in the cache after emitting all of their
+    // remaining triangles, and among those, the vertices that entered the cache first.
+    int64 priority = 0;
+    const auto age = static_cast<int64>(cache.get_age(vertex));
+    if (age + 2 * static_cast<int64>(live_count) <= int64 {kVertexCacheSize}) {
+      priority = age;
+    }
+
+    if (priority > best_priority) {
+      best_vertex = vertex;
+      best_priority = priority;
+    }
+  }
+
+  if (best_vertex != kInvalidIndex) {
+    return best_vertex;
+  }
+
+  // We've reached a dead end, so look for recently used vertices with live triangles.
+  while (!dead_ends.empty()) {
+    const auto vertex = dead_ends.back();
+    dead_ends.pop_back();
+
+    if (live_triangles[vertex] > 0) {
+      return vertex;
+    }
+  }
+
+  // Otherwise, fall back to the next vertex in input order that has live triangles.
+  while (cursor < live_triangles.size()) {
+    if (live_triangles[cursor] > 0) {
+      return static_cast<uint32>(cursor);
+    }
+
+    ++cursor;
+  }
+
+  return kInvalidIndex;
+}
+
+/// Splits a triangle list into clusters, returning the first triangle of each cluster.
+[[nodiscard]] auto _find_clusters(const Vector<uint32>& indices,
+                                  const usize vertex_count,
+                                  const float threshold) -> Vector<usize>
+{
+  const auto triangle_count = indices.size() / 3;
+  VertexCache cache {vertex_count};
+
+  // Hard boundaries are where the cache had to be refilled completely, i.e. where the
+  // vertex cache optimization reached a dead end.
+  Vector<usize> hard_boundaries;
+  for (usize triangle = 0; triangle < triangle_count; ++triangle) {
+    if (cache.access(indices.data() + triangle * 3) == 3) {
+      hard_boundaries.push_back(triangle);
+    }
+  }
+
+  hard_boundaries.push_back(triangle_count);
+
+  // Hard clusters are further split at points where the ACMR of the cluster so far is
+  // close enough to the ACMR of the entire hard cluster.
+  Vector<usize> clusters;
+
+  for (usize boundary = 0; boundary + 1 < hard_boundaries.size(); ++boundary) {
+    const auto begin = hard_boundaries[boundary];
+    const auto end = hard_boundaries[boundary + 1];
+
+    cache.clear();
+
+    usize cluster_misses = 0;
+    for (auto triangle = begin; triangle < end; ++triangle) {
+      cluster_misses += cache.access(indices.data() + triangle * 3);
+    }
+
+    const auto cluster_acmr =
+        static_cast<float>(cluster_misses) / static_cast<float>(end - begin);
+    const auto target_acmr = cluster_acmr * threshold;
+
+    cache.clear();
+    clusters.push_back(begin);
+
+    usize running_misses = 0;
+    usize running_triangles = 0;
+
+    for (auto triangle = begin; triangle < end; ++triangle) {
+      running_misses += cache.access(indices.data() + triangle * 3);
+      ++running_triangles;
+
+      const auto running_acmr =
+          static_cast<float>(running_misses) / static_cast<float>(running_triangles);
+
+      if (running_acmr <= target_acmr && triangle + 1 < end) {
+        clusters.push_back(triangle + 1);
+
+        cache.clear();
+        running_misses = 0;
+        running_triangles = 0;
+      }
+    }
+  }
+
+  return clusters;
+}
+
+void _compute_meshlet_bounds(const Vector<Vertex>& vertices,
+                             const Vector<uint32>& indices,
+                             Meshlet& meshlet)
+{
+  const auto begin = static_cast<usize>(meshlet.index_offset);
+  const auto end = begin + static_cast<usize>(meshlet.index_count);
+
+  Vec3 min_pos {std::numeric_limits<float>::max()};
+  Vec3 max_pos {std::numeric_limits<float>::lowest()};
+
+  for (auto index_idx = begin; index_idx < end; ++index_idx) {
+    const auto& position = vertices[indices[index_idx]].position;
+    min_pos = glm::min(min_pos, position);
+    max_pos = glm::max(max_pos, position);
+  }
+
+  meshlet.center = (min_pos + max_pos) * 0.5f;
+  meshlet.radius = 0.0f;
+
+  for (auto index_idx = begin; index_idx < end; ++index_idx) {
+    const auto& position = vertices[indices[index_idx]].position;
+    meshlet.radius = std::max(meshlet.radius, glm::distance(meshlet.center, position));
+  }
+
+  // The face normals are oriented using the vertex normals, which makes the cones
+  // independent of the winding order convention of the source file.
+  Vector<Vec3> normals;
+  normals.reserve(meshlet.index_count / 3);
+
+  Vec3 normal_sum {};
+
+  for (auto index_idx = begin; index_idx < end; index_idx += 3) {
+    const auto& v0 = vertices[indices[index_idx + 0]];
+    const auto& v1 = vertices[indices[index_idx + 1]];
+    const auto& v2 = vertices[indices[index_idx + 2]];
+
+    auto normal = glm::cross(v1.position - v0.position, v2.position - v0.position);
+    const auto normal_length = glm::length(normal);
+
+    if (normal_length > 0.0f) {
+      normal /= normal_length;
+
+      if (glm::dot(normal, v0.normal + v1.normal + v2.normal) < 0.0f) {
+        normal = -normal;
+      }
+
+      normals.push_back(normal);
+      normal_sum += normal;
+    }
+  }
+
+  meshlet.cone_axis = Vec3 {0, 0, 0};
+  meshlet.cone_cutoff = 1.0f;
+
+  const auto axis_length = glm::length(normal_sum);
+  if (normals.empty() || axis_length <= 0.0f) {
+    return;
+  }
+
+  const auto axis = normal_sum / axis_length;
+
+  float min_dot = 1.0f;
+  for (const auto& normal : normals) {
+    min_dot = std::min(min_dot, glm::dot(normal, axis));
+  }
+
+  if (min_dot > kMinMeshletConeSpread) {
+    meshlet.cone_axis = axis;
+    meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+  }
+}
+
+/// Classification of vertices, which determines how they may be collapsed.
+enum class VertexKind : uint8 {
+  Interior,  ///< May be collapsed into any neighbor.
+  Border,    ///< On an open border, may only be collapsed along border edges.
+  Locked     ///< Shares its position with other vertices, never collapsed.
+};
+
+/// A symmetric 4x4 matrix that measures the squared distances to a set of planes.
+struct Quadric final {
+  Array<double, 10> m {};  ///< The upper triangle of the matrix, row by row.
+  double weight {};        ///< The accumulated weight of the planes.
+};
+
+/// A candidate edge collapse, which merges one vertex into another.
+struct Collapse final {
+  uint32 from {};
+  uint32 to {};
+  double cost {};
+};
+
+void _add_plane(Quadric& quadric,
+                const Vec3& normal,
+                const float distance,
+                const double weight)
+{
+  const auto a = static_cast<double>(normal.x);
+  const auto b = static_cast<double>(normal.y);
+  const auto c = static_cast<double>(normal.z);
+  const auto d = static_cast<double>(distance);
+
+  quadric.m[0] += weight * a * a;
+  quadric.m[1] += weight * a * b;
+  quadric.m[2] += weight * a * c;
+  quadric.m[3] += weight * a * d;
+  quadric.m[4] += weight * b * b;
+  quadric.m[5] += weight * b * c;
+  quadric.m[6] += weight * b * d;
+  quadric.m[7] += weight * c * c;
+  quadric.m[8] += weight * c * d;
+  quadric.m[9] += weight * d * d;
+  quadric.weight += weight;
+}
+
+void _add_quadric(Quadric& quadric, const Quadric& other)
+{
+  for (usize i = 0; i < quadric.m.size(); ++i) {
+    quadric.m[i] += other.m[i];
+  }
+
+  quadric.weight += other.weight;
+}
+
+/// Returns the weighted sum of the squared distances from a point to the planes.
+[[nodiscard]] auto _evaluate_quadric(const Quadric& quadric, const Vec3& point) -> double
+{
+  const auto x = static_cast<double>(point.x);
+  const auto y = static_cast<double>(point.y);
+  const auto z = static_cast<double>(point.z);
+  const auto& m = quadric.m;
+
+  const auto sum = m[0] * x * x + m[4] * y * y + m[7] * z * z +  //
+                   2.0 * (m[1] * x * y + m[2] * x * z + m[5] * y * z) +
+                   2.0 * (m[3] * x + m[6] * y + m[8] * z) + m[9];
+
+  // Rounding errors may produce slightly negative sums
+  return std::abs(sum);
+}
+
+[[nodiscard]] auto _make_edge_key(const uint32 a, const uint32 b) noexcept -> uint64
+{
+  return (static_cast<uint64>(a) << 32) | static_cast<uint64>(b);
+}
+
+/// Maps each vertex to the first vertex with an identical position.
+[[nodiscard]] auto _build_position_remap(const Vector<Vertex>& vertices) -> Vector<uint32>
+{
+  HashMap<Vec3, uint32> unique_positions;
+  unique_positions.reserve(vertices.size());
+
+  Vector<uint32> remap(vertices.size());
+
+  for (usize vertex = 0; vertex < vertices.size(); ++vertex) {
+    const auto& position = vertices[vertex].position;
+    const auto [iter, inserted] =
+        unique_positions.try_emplace(position, static_cast<uint32>(vertex));
+    remap[vertex] = iter->second;
+  }
+
+  return remap;
+}
+
+/// Returns the edges that are only used by a single triangle, in terms of positions.
+[[nodiscard]] auto _find_border_edges(const Vector<uint32>& indices,
+                                      const Vector<uint32>& position_remap)
+    -> HashSet<uint64>
+{
+  HashSet<uint64> edges;
+  edges.reserve(indices.size());
+
+  for (usize index_idx = 0; index_idx < indices.size(); ++index_idx) {
+    const auto next_idx = (index_idx % 3 == 2) ? index_idx - 2 : index_idx + 1;
+    edges.insert(_make_edge_key(position_remap[indices[index_idx]],
+                                position_remap[indices[next_idx]]));
+  }
+
+  HashSet<uint64> border_edges;
+
+  for (const auto edge : edges) {
+    const auto reverse_edge = (edge << 32) | (edge >> 32);
+    if (!edges.contains(reverse_edge)) {
+      border_edges.insert(edge);
+    }
+  }
+
+  return border_edges;
+}
+
+[[nodiscard]] auto _classify_vertices(const Vector<uint32>& indices,
+                                      const Vector<uint32>& position_remap,
+                                      const HashSet<uint64>& border_edges)
+    -> Vector<VertexKind>
+{
+  const auto vertex_count = position_remap.size();
+
+  Vector<uint32> position_use_count(vertex_count, 0);
+  for (usize vertex = 0; vertex < vertex_count; ++vertex) {
+    ++position_use_count[position_remap[vertex]];
+  }
+
+  Vector<VertexKind> kinds(vertex_count, VertexKind::Interior);
+
+  for (const auto edge : border_edges) {
+    kinds[static_cast<usize>(edge >> 32)] = VertexKind::Border;
+    kinds[static_cast<usize>(edge & 0xFFFF'FFFF)] = VertexKind::Border;
+  }
+
+  for (usize vertex = 0; vertex < vertex_count; ++vertex) {
+    // Attribute seams are preserved by never moving vertices that share positions
+    if (position_use_count[position_remap[vertex]] > 1) {
+      kinds[vertex] = VertexKind::Locked;
+    }
+  }
+
+  // Unreferenced vertices are simply left alone
+  Vector<bool> referenced(vertex_count, false);
+  for (const auto index : indices) {
+    referenced[index] = true;
+  }
+
+  for (usize vertex = 0; vertex < vertex_count; ++vertex) {
+    if (!referenced[vertex]) {
+      kinds[vertex] = VertexKind::Locked;
+    }
+  }
+
+  return kinds;
+}
+
+/// Computes the quadrics of all positions, indexed by the position remap.
+[[nodiscard]] auto _build_quadrics(const Vector<Vertex>& vertices,
+                                   const Vector<uint32>& indices,
+                                   const Vector<uint32>& position_remap,
+                                   const HashSet<uint64>& border_edges) -> Vector<Quadric>
+{
+  Vector<Quadric> quadrics(vertices.size());
+
+  for (usize index_idx = 0; index_idx + 2 < indices.size(); index_idx += 3) {
+    const Array<uint32, 3> triangle = {position_remap[indices[index_idx + 0]],
+                                       position_remap[indices[index_idx + 1]],
+                                       position_remap[indices[index_idx + 2]]};
+
+    const auto& p0 = vertices[triangle[0]].position;
+    const auto& p1 = vertices[triangle[1]].position;
+    const auto& p2 = vertices[triangle[2]].position;
+
+    const auto normal = glm::cross(p1 - p0, p2 - p0);
+    const auto double_area = glm::length(normal);
+    if (double_area <= 0.0f) {
+      continue;
+    }
+
+    const auto unit_normal = normal / double_area;
+    const auto distance = -glm::dot(unit_normal, p0);
+
+    for (const auto vertex : triangle) {
+      _add_plane(quadrics[vertex], unit_normal, distance, double_area);
+    }
+
+    // Border edges get an additional plane perpendicular to the triangle, which
+    // penalizes collapses that would move the border.
+    for (usize corner = 0; corner < 3; ++corner) {
+      const auto a = triangle[corner];
+      const auto b = triangle[(corner + 1) % 3];
+
+      if (!border_edges.contains(_make_edge_key(a, b))) {
+        continue;
+      }
+
+      const auto edge = vertices[b].position - vertices[a].position;
+      const auto edge_length = glm::length(edge);
+      if (edge_length <= 0.0f) {
+        continue;
+      }
+
+      const auto border_normal = glm::normalize(glm::cross(edge, unit_normal));
+      const auto border_distance = -glm::dot(border_normal, vertices[a].position);
+      const auto weight = static_cast<double>(edge_length * edge_length);
+
+      _add_plane(quadrics[a], border_normal, border_distance, weight * kBorderWeight);
+      _add_plane(quadrics[b], border_normal, border_distance, weight * kBorderWeight);
+    }
+  }
+
+  return quadrics;
+}
+
+/// Returns the mean squared distance error of merging one vertex into another.
+[[nodiscard]] auto _get_collapse_cost(const Vector<Vertex>& vertices,
+                                      const Vector<Quadric>& quadrics,
+                                      const Vector<uint32>& position_remap,
+                                      const uint32 from,
+                                      const uint32 to) -> double
+{
+  const auto& from_quadric = quadrics[position_remap[from]];
+  const auto& to_quadric = quadrics[position_remap[to]];
+
+  const auto weight = from_quadric.weight + to_quadric.weight;
+  if (weight <= 0.0) {
+    return 0.0;
+  }
+
+  const auto& position = vertices[to].position;
+  return (_evaluate_quadric(from_quadric, position) +
+          _evaluate_quadric(to_quadric, position)) /
+         weight;
+}
+
+[[nodiscard]] auto _can_collapse(const Vector<VertexKind>& kinds,
+                                 const Vector<uint32>& position_remap,
+                                 const HashSet<uint64>& border_edges,
+                                 const uint32 from,
+                                 const uint32 to) -> bool
+{
+  switch (kinds[from]) {
+    case VertexKind::Interior:
+      return true;
+
+    case VertexKind::Border:
+      return border_edges.contains(
+                 _make_edge_key(position_remap[from], position_remap[to])) ||
+             border_edges.contains(
+                 _make_edge_key(position_remap[to], position_remap[from]));
+
+    default:
+      return false;
+  }
+}
+
+/// Indicates whether merging a vertex into another would flip any triangle normals.
+[[nodiscard]] auto _has_flipped_triangles(const Vector<Vertex>& vertices,
+                                          const Vector<uint32>& indices,
+                                          const Vector<uint32>& position_remap,
+                                          const VertexAdjacency& adjacency,
+                                          const uint32 from,
+                                          const uint32 to) -> bool
+{
+  const auto& new_position = vertices[to].position;
+
+  const auto begin = adjacency.offsets[from];
+  const auto end = begin + adjacency.counts[from];
+
+  for (auto slot = begin; slot < end; ++slot) {
+    const auto* triangle = indices.data() + adjacency.triangles[slot] * 3;
+
+    // Triangles that contain both vertices are removed by the collapse
+    if (position_remap[triangle[0]] == position_remap[to] ||
+        position_remap[triangle[1]] == position_remap[to] ||
+        position_remap[triangle[2]] == position_remap[to]) {
+      continue;
+    }
+
+    Array<Vec3, 3> positions = {vertices[triangle[0]].position,
+                                vertices[triangle[1]].position,
+                                vertices[triangle[2]].position};
+
+    const auto old_normal =
+        glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+
+    for (usize corner = 0; corner < 3; ++corner) {
+      if (triangle[corner] == from) {
+        positions[corner] = new_position;
+      }
+    }
+
+    const auto new_normal =
+        glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+
+    if (glm::dot(old_normal, new_normal) <= 0.0f) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// Returns the number of triangles that contain both vertices of an edge.
+[[nodiscard]] auto _count_edge_triangles(const Vector<uint32>& indices,
+                                         const Vector<uint32>& position_remap,
+                                         const VertexAdjacency& adjacency,
+                                         const uint32 from,
+                                         const uint32 to) -> usize
+{
+  const auto begin = adjacency.offsets[from];
+  const auto end = begin + adjacency.counts[from];
+
+  usize count = 0;
+  for (auto slot = begin; slot < end; ++slot) {
+    const auto* triangle = indices.data() + adjacency.triangles[slot] * 3;
+
+    if (position_remap[triangle[0]] == position_remap[to] ||
+        position_remap[triangle[1]] == position_remap[to] ||
+        position_remap[triangle[2]] == position_remap[to]) {
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+/// Removes triangles with two or more corners at the same position.
+void _remove_degenerate_triangles(Vector<uint32>& indices,
+                                  const Vector<uint32>& position_remap)
+{
+  usize write_idx = 0;
+
+  for (usize index_idx = 0; index_idx + 2 < indices.size(); index_idx += 3) {
+    const auto a = position_remap[indices[index_idx + 0]];
+    const auto b = position_remap[indices[index_idx + 1]];
+    const auto c = position_remap[indices[index_idx + 2]];
+
+    if (a == b || b == c || a == c) {
+      continue;
+    }
+
+    indices[write_idx + 0] = indices[index_idx + 0];
+    indices[write_idx + 1] = indices[index_idx + 1];
+    indices[write_idx + 2] = indices[index_idx + 2];
+    write_idx += 3;
+  }
+
+  indices.resize(write_idx);
+}
+
+/// Encodes a unit vector using octahedral mapping, as normalized 16-bit integers.
+[[nodiscard]] auto _encode_normal(const Vec3& normal) -> Array<int16, 2>
+{
+  const auto l1_norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+  if (l1_norm == 0.0f) {
+    return {0, 0};
+  }
+
+  auto x = normal.x / l1_norm;
+  auto y = normal.y / l1_norm;
+
+  // The lower hemisphere is folded over the diagonals
+  if (normal.z < 0.0f) {
+    const auto folded_x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+    const auto folded_y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+    x = folded_x;
+    y = folded_y;
+  }
+
+  return {std::bit_cast<int16>(glm::packSnorm1x16(x)),
+          std::bit_cast<int16>(glm::packSnorm1x16(y))};
+}
+
+[[nodiscard]] auto _encode_tex_coords(const Vec2& tex_coords) -> Array<uint16, 2>
+{
+  return {glm::packHalf1x16(tex_coords.x), glm::packHalf1x16(tex_coords.y)};
+}
+
+template <typename T>
+void _store_vertices(const Vector<T>& vertices, MeshData& mesh)
+{
+  mesh.vertices.resize(vertices.size() * sizeof(T));
+  std::memcpy(mesh.vertices.data(), vertices.data(), mesh.vertices.size());
+}
+
+[[nodiscard]] auto _encode_packed_vertices(const Vector<Vertex>& vertices)
+    -> Vector<PackedVertex>
+{
+  Vector<PackedVertex> packed(vertices.size());
+
+  for (usize i = 0; i < vertices.size(); ++i) {
+    packed[i].position = vertices[i].position;
+    packed[i].normal = _encode_normal(vertices[i].normal);
+    packed[i].tex_coords = _encode_tex_coords(vertices[i].tex_coords);
+  }
+
+  return packed;
+}
+
+/// Quantizes vertices, and stores the parameters needed to decode the positions.
+[[nodiscard]] auto _encode_quantized_vertices(const Vector<Vertex>& vertices,
+                                              MeshData& mesh) -> Vector<QuantizedVertex>
+{
+  Vec3 min_position {0};
+  Vec3 max_position {0};
+
+  if (!vertices.empty()) {
+    min_position = vertices.front().position;
+    max_position = vertices.front().position;
+  }
+
+  for (const auto& vertex : vertices) {
+    min_position = glm::min(min_position, vertex.position);
+    max_position = glm::max(max_position, vertex.position);
+  }
+
+  const auto extent = max_position - min_position;
+  mesh.position_offset = min_position;
+  mesh.position_scale = extent;
+
+  Vector<QuantizedVertex> quantized(vertices.size());
+
+  for (usize i = 0; i < vertices.size(); ++i) {
+    const auto relative_position = vertices[i].position - min_position;
+
+    for (int axis = 0; axis < 3; ++axis) {
+      const auto value =
+          (extent[axis] > 0.0f) ? relative_position[axis] / extent[axis] : 0.0f;
+      quantized[i].position[static_cast<usize>(axis)] = glm::packUnorm1x16(value);
+    }
+
+    quantized[i].normal = _encode_normal(vertices[i].normal);
+    quantized[i].tex_coords = _encode_tex_coords(vertices[i].tex_coords);
+  }
+
+  return quantized;
+}
+
+}  // namespace
+
+auto VertexCacheStats::acmr() const noexcept -> float
+{
+  return (triangle_count != 0)
+             ? static_cast<float>(transform_count) / static_cast<float>(triangle_count)
+             : 0.0f;
+}
+
+auto VertexCacheStats::atvr() const noexcept -> float
+{
+  return (vertex_count != 0)
+             ? static_cast<float>(transform_count) / static_cast<float>(vertex_count)
+             : 0.0f;
+}
+
+auto VertexCacheStats::operator+=(const VertexCacheStats& other) noexcept
+    -> VertexCacheStats&
+{
+  triangle_count += other.triangle_count;
+  vertex_count += other.vertex_count;
+  transform_count += other.transform_count;
+  return *this;
+}
+
+auto analyze_vertex_cache(const Vector<uint32>& indices, const usize vertex_count)
+    -> VertexCacheStats
+{
+  VertexCacheStats stats;
+  stats.triangle_count = indices.size() / 3;
+
+  VertexCache cache {vertex_count};
+  Vector<bool> used(vertex_count, false);
+
+  for (const auto index : indices) {
+    if (cache.access(index)) {
+      ++stats.transform_count;
+    }
+
+    if (!used[index]) {
+      used[index] = true;
+      ++stats.vertex_count;
+    }
+  }
+
+  return stats;
+}
+
+auto weld_vertices(Vector<Vertex>& vertices, Vector<uint32>& indices) -> usize
+{
+  const auto original_vertex_count = vertices.size();
+
+  HashMap<Vertex, uint32> unique_vertices;
+  unique_vertices.reserve(vertices.size());
+
+  Vector<Vertex> welded_vertices;
+  welded_vertices.reserve(vertices.size());
+
+  Vector<uint32> remap(vertices.size(), kInvalidIndex);
+
+  for (auto& index : indices) {
+    auto& new_index = remap[index];
+
+    if (new_index == kInvalidIndex) {
+      const auto& vertex = vertices[index];
+      const auto next_index = static_cast<uint32>(welded_vertices.size());
+
+      const auto [iter, inserted] = unique_vertices.try_emplace(vertex, next_index);
+      if (inserted) {
+        welded_vertices.push_back(vertex);
+      }
+
+      new_index = iter->second;
+    }
+
+    index = new_index;
+  }
+
+  vertices = std::move(welded_vertices);
+
+  return original_vertex_count - vertices.size();
+}
+
+void optimize_vertex_cache(Vector<uint32>& indices, const usize vertex_count)
+{
+  if (indices.empty()) {
+    return;
+  }
+
+  const auto triangle_count = indices.size() / 3;
+  const auto adjacency = _build_vertex_adjacency(indices, vertex_count);
+
+  auto live_triangles = adjacency.counts;
+  Vector<bool> emitted(triangle_count, false);
+
+  Vector<uint32> dead_ends;
+  dead_ends.reserve(indices.size());
+
+  Vector<uint32> candidates;
+  candidates.reserve(64);
+
+  Vector<uint32> result;
+  result.reserve(indices.size());
+
+  VertexCache cache {vertex_count};
+  usize cursor = 0;
+  auto fanning_vertex = indices.front();
+
+  while (fanning_vertex != kInvalidIndex) {
+    candidates.clear();
+
+    const auto begin = adjacency.offsets[fanning_vertex];
+    const auto end = begin + adjacency.counts[fanning_vertex];
+
+    for (auto adjacency_idx = begin; adjacency_idx < end; ++adjacency_idx) {
+      const auto triangle = adjacency.triangles[adjacency_idx];
+      if (emitted[triangle]) {
+        continue;
+      }
+
+      for (usize corner = 0; corner < 3; ++corner) {
+        const auto vertex = indices[triangle * 3 + corner];
+
+        result.push_back(vertex);
+        dead_ends.push_back(vertex);
+        candidates.push_back(vertex);
+
+        --live_triangles[vertex];
+        cache.access(vertex);
+      }
+
+      emitted[triangle] = true;
+    }
+
+    fanning_vertex =
+        _select_next_vertex(cache, live_triangles, candidates, dead_ends, cursor);
+  }
+
+  indices = std::move(result);
+}
+
+void optimize_overdraw(const Vector<Vertex>& vertices,
+                       Vector<uint32>& indices,
+                       const float threshold)
+{
+  const auto triangle_count = indices.size() / 3;
+  if (triangle_count == 0) {
+    return;
+  }
+
+  const auto clusters = _find_clusters(indices, vertices.size(), threshold);
+
+  struct Cluster final {
+    usize begin {};
+    usize end {};
+    Vec3 centroid {};
+    Vec3 normal {};
+    float area {};
+    float sort_key {};
+  };
+
+  Vector<Cluster> cluster_info;
+  cluster_info.reserve(clusters.size());
+
+  Vec3 mesh_centroid {};
+  float mesh_area = 0;
+
+  for (usize cluster_idx = 0; cluster_idx < clusters.size(); ++cluster_idx) {
+    auto& cluster = cluster_info.emplace_back();
+    cluster.begin = clusters[cluster_idx];
+    cluster.end = (cluster_idx + 1 < clusters.size()) ? clusters[cluster_idx + 1]  //
+                                                      : triangle_count;
+
+    for (auto triangle = cluster.begin; triangle < cluster.end; ++triangle) {
+      const auto& p0 = vertices[indices[triangle * 3 + 0]].position;
+      const auto& p1 = vertices[indices[triangle * 3 + 1]].position;
+      const auto& p2 = vertices[indices[triangle * 3 + 2]].position;
+
+      const auto normal = glm::cross(p1 - p0, p2 - p0);
+      const auto area = glm::length(normal);
+
+      cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+      cluster.normal += normal;
+      cluster.area += area;
+    }
+
+    mesh_centroid += cluster.centroid;
+    mesh_area += cluster.area;
+  }
+
+  if (mesh_area > 0.0f) {
+    mesh_centroid /= mesh_area;
+  }
+
+  for (auto& cluster : cluster_info) {
+    const auto normal_length = glm::length(cluster.normal);
+    if (cluster.area > 0.0f && normal_length > 0.0f) {
+      const auto centroid = cluster.centroid / cluster.area;
+      const auto normal = cluster.normal / normal_length;
+      cluster.sort_key = glm::dot(centroid - mesh_centroid, normal);
+    }
+  }
+
+  // Clusters that face away from the center are likely to occlude other clusters.
+  std::stable_sort(cluster_info.begin(),
+                   cluster_info.end(),
+                   [](const Cluster& a, const Cluster& b) {
+                     return a.sort_key > b.sort_key;
+                   });
+
+  Vector<uint32> result;
+  result.reserve(indices.size());
+
+  for (const auto& cluster : cluster_info) {
+    result.insert(result.end(),
+                  indices.begin() + static_cast<ssize>(cluster.begin * 3),
+                  indices.begin() + static_cast<ssize>(cluster.end * 3));
+  }
+
+  indices = std::move(result);
+}
+
+void optimize_vertex_fetch(Vector<Vertex>& vertices, Vector<uint32>& indices)
+{
+  Vector<uint32> remap(vertices.size(), kInvalidIndex);
+
+  Vector<Vertex> ordered_vertices;
+  ordered_vertices.reserve(vertices.size());
+
+  for (auto& index : indices) {
+    auto& new_index = remap[index];
+
+    if (new_index == kInvalidIndex) {
+      new_index = static_cast<uint32>(ordered_vertices.size());
+      ordered_vertices.push_back(vertices[index]);
+    }
+
+    index = new_index;
+  }
+
+  vertices = std::move(ordered_vertices);
+}
+
+auto simplify_mesh(const Vector<Vertex>& vertices,
+                   const Vector<uint32>& indices,
+                   const usize target_index_count,
+                   float& error) -> Vector<uint32>
+{
+  Vector<uint32> result = indices;
+  error = 0.0f;
+
+  if (result.size() <= target_index_count) {
+    return result;
+  }
+
+  const auto position_remap = _build_position_remap(vertices);
+  const auto initial_border_edges = _find_border_edges(result, position_remap);
+  const auto kinds = _classify_vertices(result, position_remap, initial_border_edges);
+  auto quadrics = _build_quadrics(vertices, result, position_remap, initial_border_edges);
+
+  const auto target_triangle_count = target_index_count / 3;
+  double max_cost = 0.0;
+
+  Vector<Collapse> collapses;
+  Vector<uint32> collapse_remap(vertices.size());
+  Vector<bool> collapse_locked(vertices.size());
+
+  // Each pass performs the cheapest collapses that don't affect each other, which is
+  // much faster than updating a priority queue after every single collapse.
+  while (result.size() / 3 > target_triangle_count) {
+    const auto border_edges = _find_border_edges(result, position_remap);
+    const auto adjacency = _build_vertex_adjacency(result, vertices.size());
+
+    collapses.clear();
+
+    for (usize index_idx = 0; index_idx < result.size(); ++index_idx) {
+      const auto next_idx = (index_idx % 3 == 2) ? index_idx - 2 : index_idx + 1;
+      const auto a = result[index_idx];
+      const auto b = result[next_idx];
+
+      if (_can_collapse(kinds, position_remap, border_edges, a, b)) {
+        const auto cost = _get_collapse_cost(vertices, quadrics, position_remap, a, b);
+        collapses.push_back(Collapse {a, b, cost});
+      }
+
+      if (_can_collapse(kinds, position_remap, border_edges, b, a)) {
+        const auto cost = _get_collapse_cost(vertices, quadrics, position_remap, b, a);
+        collapses.push_back(Collapse {b, a, cost});
+      }
+    }
+
+    std::stable_sort(collapses.begin(),
+                     collapses.end(),
+                     [](const Collapse& a, const Collapse& b) {
+                       return a.cost < b.cost;
+                     });
+
+    for (usize vertex = 0; vertex < vertices.size(); ++vertex) {
+      collapse_remap[vertex] = static_cast<uint32>(vertex);
+    }
+
+    std::fill(collapse_locked.begin(), collapse_locked.end(), false);
+
+    auto triangle_count = result.size() / 3;
+    usize collapse_count = 0;
+
+    for (const auto& collapse : collapses) {
+      if (triangle_count <= target_triangle_count) {
+        break;
+      }
+
+      if (collapse_locked[collapse.from] || collapse_locked[collapse.to] ||
+          _has_flipped_triangles(vertices,
+                                 result,
+                                 position_remap,
+                                 adjacency,
+                                 collapse.from,
+                                 collapse.to)) {
+        continue;
+      }
+
+      // All triangles around the removed vertex change, so their vertices must not be
+      // involved in any other collapses during this pass.
+      const auto begin = adjacency.offsets[collapse.from];
+      const auto end = begin + adjacency.counts[collapse.from];
+      for (auto slot = begin; slot < end; ++slot) {
+        const auto triangle = static_cast<usize>(adjacency.triangles[slot]);
+        collapse_locked[result[triangle * 3 + 0]] = true;
+        collapse_locked[result[triangle * 3 + 1]] = true;
+        collapse_locked[result[triangle * 3 + 2]] = true;
+      }
+
+      collapse_locked[collapse.to] = true;
+      collapse_remap[collapse.from] = collapse.to;
+
+      _add_quadric(quadrics[position_remap[collapse.to]], quadrics[collapse.from]);
+      max_cost = std::max(max_cost, collapse.cost);
+
+      triangle_count -= _count_edge_triangles(result,
+                                              position_remap,
+                                              adjacency,
+                                              collapse.from,
+                                              collapse.to);
+      ++collapse_count;
+    }
+
+    if (collapse_count == 0) {
+      break;
+    }
+
+    for (auto& index : result) {
+      index = collapse_remap[index];
+    }
+
+    _remove_degenerate_triangles(result, position_remap);
+  }
+
+  error = static_cast<float>(std::sqrt(max_cost));
+  return result;
+}
+
+auto build_meshlets(const Vector<Vertex>& vertices, const Vector<uint32>& indices)
+    -> Vector<Meshlet>
+{
+  Vector<Meshlet> meshlets;
+
+  // Keeps track of the last meshlet that used each vertex.
+  Vector<usize> vertex_meshlets(vertices.size(), std::numeric_limits<usize>::max());
+
+  Meshlet meshlet;
+  usize meshlet_vertex_count = 0;
+
+  const auto finish_meshlet = [&] {
+    _compute_meshlet_bounds(vertices, indices, meshlet);
+    meshlets.push_back(meshlet);
+
+    meshlet = Meshlet {};
+    meshlet.index_offset = static_cast<uint32>(meshlets.back().index_offset +
+                                               meshlets.back().index_count);
+    meshlet_vertex_count = 0;
+  };
+
+  for (usize index_idx = 0; index_idx + 2 < indices.size(); index_idx += 3) {
+    const auto meshlet_idx = meshlets.size();
+
+    usize new_vertex_count = 0;
+    for (usize corner = 0; corner < 3; ++corner) {
+      if (vertex_meshlets[indices[index_idx + corner]] != meshlet_idx) {
+        ++new_vertex_count;
+      }
+    }
+
+    const auto triangle_count = static_cast<usize>(meshlet.index_count / 3);
+    if (meshlet_vertex_count + new_vertex_count > kMaxMeshletVertices ||
+        triangle_count + 1 > kMaxMeshletTriangles) {
+      finish_meshlet();
+    }
+
+    for (usize corner = 0; corner < 3; ++corner) {
+      auto& vertex_meshlet = vertex_meshlets[indices[index_idx + corner]];
+      if (vertex_meshlet != meshlets.size()) {
+        vertex_meshlet = meshlets.size();
+        ++meshlet_vertex_count;
+      }
+    }
+
+    meshlet.index_count += 3;
+  }
+
+  if (meshlet.index_count > 0) {
+    finish_meshlet();
+  }
+
+  return meshlets;
+}
+
+void pack_vertices(const Vector<Vertex>& vertices,
+                   const VertexFormat format,
+                   MeshData& mesh)
+{
+  mesh.vertex_format = format;
+  mesh.vertex_count = vertices.size();
+  mesh.position_offset = Vec3 {0};
+  mesh.position_scale = Vec3 {1};
+
+  switch (format) {
+    case VertexFormat::Packed:
+      _store_vertices(_encode_packed_vertices(vertices), mesh);
+      break;
+
+    case VertexFormat::Quantized:
+      _store_vertices(_encode_quantized_vertices(vertices, mesh), mesh);
+      break;
+
+    default:
+      _store_vertices(vertices, mesh);
+      break;
+  }
+}
+
+void pack_indices(const Vector<uint32>& indices, MeshData& mesh)
+{
+  mesh.index_count = indices.size();
+
+  if (mesh.vertex_count <= kMaxUInt16VertexCount) {
+    mesh.index_type = IndexType::UInt16;
+    mesh.indices.resize(indices.size() * sizeof(uint16));
+
+    for (usize i = 0; i < indices.size(); ++i) {
+      const auto index = static_cast<uint16>(indices[i]);
+      std::memcpy(mesh.indices.data() + i * sizeof(uint16), &index, sizeof index);
+    }
+  }
+  else {
+    mesh.index_type = IndexType::UInt32;
+    mesh.indices.resize(indices.size() * sizeof(uint32));
+    std::memcpy(mesh.indices.data(), indices.data(), mesh.indices.size());
+  }
+}
+
+}  // namespace glow
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "common/primitives.hpp"
+#include "common/type/vector.hpp"
+#include "graphics/vertex.hpp"
+#include "io/model_loader.hpp"
+
+namespace glow {
+
+/// Statistics of a triangle list with respect to a simulated post-transform vertex cache.
+///
+/// \details
+/// The simulated cache is a FIFO cache with 16 entries, which approximates the behavior
+/// of most current GPUs reasonably well.
+struct VertexCacheStats final {
+  usize triangle_count {};
+  usize vertex_count {};     ///< The number of unique vertices.
+  usize transform_count {};  ///< The number of vertex shader invocations.
+
+  /// Returns the average cache miss ratio, 0.5 is optimal and 3 is the worst case.
+  [[nodiscard]] auto acmr() const noexcept -> float;
+
+  /// Returns the average transformed vertex ratio, 1 is optimal.
+  [[nodiscard]] auto atvr() const noexcept -> float;
+
+  auto operator+=(const VertexCacheStats& other) noexcept -> VertexCacheStats&;
+};
+
+/// Simulates rendering a triangle list and returns the resulting vertex cache statistics.
+///
+/// \param indices the triangle list indices.
+/// \param vertex_count the number of vertices in the mesh.
+[[nodiscard]] auto analyze_vertex_cache(const Vector<uint32>& indices, usize vertex_count)
+    -> VertexCacheStats;
+
+/// Merges identical vertices and removes vertices that aren't referenced by any index.
+///
+/// \details
+/// The vertices are reordered by first use in the index buffer, which improves the
+/// locality of vertex fetches.
+///
+/// \param vertices the mesh vertices, updated in place.
+/// \param indices the triangle list indices, updated in place.
+///
+/// \return the number of vertices that were removed.
+auto weld_vertices(Vector<Vertex>& vertices, Vector<uint32>& indices) -> usize;
+
+/// Reorders triangles to improve post-transform vertex cache utilization.
+///
+/// \details
+/// This is an implementation of the "Tipsify" algorithm, described in "Fast Triangle
+/// Reordering for Vertex Locality and Reduced Overdraw" by Sander et al.
+///
+/// \param indices the triangle list indices, updated in place.
+/// \param vertex_count the number of vertices in the mesh.
+void optimize_vertex_cache(Vector<uint32>& indices, usize vertex_count);
+
+/// Reorders clusters of triangles to reduce overdraw, mostly preserving cache efficiency.
+///
+/// \details
+/// The triangles are split into clusters, which are then sorted so that clusters facing
+/// away from the center of the mesh are rendered first, since those are more likely to
+/// occlude other parts of the mesh. This should be used after `optimize_vertex_cache()`.
+///
+/// \param vertices the mesh vertices.
+/// \param indices the triangle list indices, updated in place.
+/// \param threshold the allowed ACMR increase factor, e.g. 1.05 allows a 5% increase.
+void optimize_overdraw(const Vector<Vertex>& vertices,
+                       Vector<uint32>& indices,
+                       float threshold = 1.05f);
+
+/// Reorders vertices by first use in the index buffer, to improve vertex fetch locality.
+///
+/// \details
+/// Vertices that aren't referenced by any index are removed.
+///
+/// \param vertices the mesh vertices, updated in place.
+/// \param indices the triangle list indices, updated in place.
+void optimize_vertex_fetch(Vector<Vertex>& vertices, Vector<uint32>& indices);
+
+/// Simplifies a triangle list by collapsing edges, guided by quadric error metrics.
+///
+/// \details
+/// This is based on "Surface Simplification Using Quadric Error Metrics" by Garland and
+/// Heckbert. Vertices are only merged into other existing vertices, so the simplified
+/// indices can share the vertex buffer with the original triangle list. Vertices that
+/// share their position with other vertices, i.e. vertices on texture coordinate or
+/// normal seams, are never removed, and vertices on open borders may only be moved
+/// along the border, which preserves seams and silhouettes.
+///
+/// \param vertices the mesh vertices.
+/// \param indices the triangle list indices.
+/// \param target_index_count the desired number of indices, which may not be reached.
+/// \param error the output for the resulting geometric error, in mesh space units.
+///
+/// \return the simplified triangle list indices.
+[[nodiscard]] auto simplify_mesh(const Vector<Vertex>& vertices,
+                                 const Vector<uint32>& indices,
+                                 usize target_index_count,
+                                 float& error) -> Vector<uint32>;
+
+/// Splits a triangle list into meshlets with bounded vertex and triangle counts.
+///
+/// \details
+/// Meshlets are built from consecutive triangles, so the triangle order is preserved.
+/// This should therefore be used after the other optimization passes, which tend to
+/// produce spatially coherent triangle sequences.
+///
+/// \param vertices the mesh vertices.
+/// \param indices the triangle list indices.
+///
+/// \return the meshlets, which cover all of the indices.
+[[nodiscard]] auto build_meshlets(const Vector<Vertex>& vertices,
+                                  const Vector<uint32>& indices) -> Vector<Meshlet>;
+
+/// Stores vertices in a mesh, encoded using the specified vertex format.
+///
+/// \details
+/// Compact formats encode normals using octahedral mapping and texture coordinates as
+/// half-precision floats. The quantized format also stores positions as normalized
+/// 16-bit integers relative to the bounding box of the mesh, which is stored in the
+/// mesh so that the positions can be decoded by shaders.
+///
+/// \param vertices the mesh vertices.
+/// \param format the vertex format to use.
+/// \param mesh the mesh that will store the vertices.
+void pack_vertices(const Vector<Vertex>& vertices, VertexFormat format, MeshData& mesh);
+
+/// Stores indices in a mesh, using the smallest index type that fits the mesh.
+///
+/// \pre `mesh.vertex_count` must have been set, see `pack_vertices()`.
+///
+/// \param indices the triangle list indices.
+/// \param mesh the mesh that will store the indices.
+void pack_indices(const Vector<uint32>& indices, MeshData& mesh);
+
+}  // namespace glow
@@ -0,0 +1,313 @@
+#include "mip_chain.hpp"
+
+#include <algorithm>  // min, max, clamp
+#include <bit>        // bit_width
+#include <cmath>      // pow, lround, sin, sqrt
+#include <span>       // span
+
+#include "common/type/array.hpp"
+#include "util/thread_pool.hpp"
+
+namespace glow {
+namespace {
+
+inline constexpr usize kMaxFilterTaps = 6;
+inline constexpr usize kLinearToSrgbTableSize = 16384;
+inline constexpr float kKaiserBeta = 4.0f;
+inline constexpr float kPi = 3.14159265358979f;
+
+/// Weights of a separable filter that downsamples by a factor of two.
+struct DownsampleKernel final {
+  Array<float, kMaxFilterTaps> weights {};
+  usize tap_count {};
+};
+
+struct LookupTables final {
+  Array<float, 256> srgb_to_linear {};
+  Array<uint8, kLinearToSrgbTableSize> linear_to_srgb {};
+};
+
+[[nodiscard]] auto _srgb_to_linear(const float value) -> float
+{
+  return (value <= 0.04045f) ? value / 12.92f
+                             : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+[[nodiscard]] auto _linear_to_srgb(const float value) -> float
+{
+  return (value <= 0.0031308f) ? value * 12.92f
+                               : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+[[nodiscard]] auto _get_lookup_tables() -> const LookupTables&
+{
+  static const auto tables = [] {
+    LookupTables result;
+
+    for (usize index = 0; index < result.srgb_to_linear.size(); ++index) {
+      result.srgb_to_linear[index] = _srgb_to_linear(static_cast<float>(index) / 255.0f);
+    }
+
+    for (usize index = 0; index < result.linear_to_srgb.size(); ++index) {
+      const auto linear =
+          static_cast<float>(index) / static_cast<float>(kLinearToSrgbTableSize - 1);
+      const auto srgb = std::lround(_linear_to_srgb(linear) * 255.0f);
+      result.linear_to_srgb[index] = static_cast<uint8>(std::clamp(srgb, 0L, 255L));
+    }
+
+    return result;
+  }();
+
+  return tables;
+}
+
+/// Evaluates the zeroth order modified Bessel function of the first kind.
+[[nodiscard]] auto _bessel_i0(const float x) -> float
+{
+  float sum = 1.0f;
+  float term = 1.0f;
+
+  for (int k = 1; k < 16; ++k) {
+    const auto factor = x / (2.0f * static_cast<float>(k));
+    term *= factor * factor;
+    sum += term;
+  }
+
+  return sum;
+}
+
+[[nodiscard]] auto _make_kernel(const MipFilter filter) -> DownsampleKernel
+{
+  DownsampleKernel kernel;
+
+  if (filter == MipFilter::Box) {
+    kernel.tap_count = 2;
+    kernel.weights[0] = 0.5f;
+    kernel.weights[1] = 0.5f;
+    return kernel;
+  }
+
+  kernel.tap_count = kMaxFilterTaps;
+
+  // The taps are located at half pixel offsets from the center of the output pixel,
+  // and the sinc is stretched by a factor of two to match the new sampling rate.
+  const auto half_width = static_cast<float>(kMaxFilterTaps) * 0.5f;
+
+  float weight_sum = 0;
+  for (usize tap = 0; tap < kMaxFilterTaps; ++tap) {
+    const auto offset = static_cast<float>(tap) + 0.5f - half_width;
+    const auto x = offset * 0.5f;
+
+    const auto sinc = std::sin(kPi * x) / (kPi * x);
+    const auto ratio = offset / half_width;
+    const auto window = _bessel_i0(kKaiserBeta * std::sqrt(1.0f - ratio * ratio)) /
+                        _bessel_i0(kKaiserBeta);
+
+    kernel.weights[tap] = sinc * window;
+    weight_sum += kernel.weights[tap];
+  }
+
+  for (auto& weight : kernel.weights) {
+    weight /= weight_sum;
+  }
+
+  return kernel;
+}
+
+[[nodiscard]] auto _get_source_index(const int dst_index,
+                                     const usize tap,
+                                     const DownsampleKernel& kernel,
+                                     const int src_size) noexcept -> usize
+{
+  const auto index = dst_index * 2 + static_cast<int>(tap) -
+                     static_cast<int>(kernel.tap_count / 2) + 1;
+  return static_cast<usize>(std::clamp(index, 0, src_size - 1));
+}
+
+/// Downsamples a single row of an RGBA8 image.
+///
+/// \details
+/// The source rows are first filtered vertically into a buffer of linear values, which
+/// is then filtered horizontally. The inner loops process four channels at a time,
+/// which compilers are able to vectorize.
+void _downsample_row(const uint8* src,
+                     const Vec2i& src_size,
+                     uint8* dst,
+                     const Vec2i& dst_size,
+                     const int dst_y,
+                     const DownsampleKernel& kernel,
+                     const bool srgb,
+                     const Array<float, 256>& color_table,
+                     Vector<float>& row_buffer)
+{
+  const auto& tables = _get_lookup_tables();
+  const auto src_width = static_cast<usize>(src_size.x);
+
+  row_buffer.assign(src_width * 4, 0.0f);
+
+  for (usize tap = 0; tap < kernel.tap_count; ++tap) {
+    const auto src_y = _get_source_index(dst_y, tap, kernel, src_size.y);
+    const auto* src_row = src + src_y * src_width * 4;
+    const auto weight = kernel.weights[tap];
+
+    for (usize x = 0; x < src_width; ++x) {
+      const auto* pixel = src_row + x * 4;
+      auto* sum = row_buffer.data() + x * 4;
+
+      sum[0] += weight * color_table[pixel[0]];
+      sum[1] += weight * color_table[pixel[1]];
+      sum[2] += weight * color_table[pixel[2]];
+      sum[3] += weight * static_cast<float>(pixel[3]) * (1.0f / 255.0f);
+    }
+  }
+
+  auto* dst_row = dst + static_cast<usize>(dst_y) * static_cast<usize>(dst_size.x) * 4;
+  constexpr auto kTableScale = static_cast<float>(kLinearToSrgbTableSize - 1);
+
+  for (int dst_x = 0; dst_x < dst_size.x; ++dst_x) {
+    Array<float, 4> value {};
+
+    for (usize tap = 0; tap < kernel.tap_count; ++tap) {
+      const auto src_x = _get_source_index(dst_x, tap, kernel, src_size.x);
+      const auto* sum = row_buffer.data() + src_x * 4;
+
+      for (usize channel = 0; channel < 4; ++channel) {
+        value[channel] += kernel.weights[tap] * sum[channel];
+      }
+    }
+
+    auto* pixel = dst_row + static_cast<usize>(dst_x) * 4;
+
+    for (usize channel = 0; channel < 4; ++channel) {
+      const auto clamped = std::clamp(value[channel], 0.0f, 1.0f);
+
+      if (srgb && channel < 3) {
+        const auto index = static_cast<usize>(std::lround(clamped * kTableScale));
+        pixel[channel] = tables.linear_to_srgb[index];
+      }
+      else {
+        pixel[channel] = static_cast<uint8>(std::lround(clamped * 255.0f));
+      }
+    }
+  }
+}
+
+/// Returns the fraction of pixels that pass an alpha test after scaling the alpha.
+[[nodiscard]] auto _compute_alpha_coverage(const std::span<const uint8> pixels,
+                                           const float cutoff,
+                                           const float scale) -> float
+{
+  const auto pixel_count = pixels.size() / 4;
+  const auto threshold = cutoff * 255.0f;
+
+  usize covered = 0;
+  for (usize index = 0; index < pixel_count; ++index) {
+    if (static_cast<float>(pixels[index * 4 + 3]) * scale > threshold) {
+      ++covered;
+    }
+  }
+
+  return static_cast<float>(covered) / static_cast<float>(pixel_count);
+}
+
+/// Scales the alpha channel of a mip level to approximate the specified coverage.
+void _preserve_alpha_coverage(Vector<uint8>& pixels,
+                              const float cutoff,
+                              const float target_coverage)
+{
+  float min_scale = 0.0f;
+  float max_scale = 4.0f;
+  float scale = 1.0f;
+
+  for (int iteration = 0; iteration < 10; ++iteration) {
+    const auto coverage = _compute_alpha_coverage(pixels, cutoff, scale);
+
+    if (coverage < target_coverage) {
+      min_scale = scale;
+    }
+    else if (coverage > target_coverage) {
+      max_scale = scale;
+    }
+    else {
+      break;
+    }
+
+    scale = 0.5f * (min_scale + max_scale);
+  }
+
+  for (usize index = 3; index < pixels.size(); index += 4) {
+    const auto alpha = static_cast<float>(pixels[index]) * scale;
+    pixels[index] = static_cast<uint8>(std::min(std::lround(alpha), 255L));
+  }
+}
+
+}  // namespace
+
+auto generate_mip_chain(const uint8* pixels,
+                        const Vec2i& size,
+                        const MipChainOptions& options) -> Vector<Vector<uint8>>
+{
+  const auto level_count = get_mip_level_count(size);
+  const auto kernel = _make_kernel(options.filter);
+  const auto& tables = _get_lookup_tables();
+
+  // Used to convert the color channels to linear values in [0, 1].
+  Array<float, 256> color_table;
+  for (usize index = 0; index < color_table.size(); ++index) {
+    color_table[index] = options.srgb ? tables.srgb_to_linear[index]  //
+                                      : static_cast<float>(index) / 255.0f;
+  }
+
+  Vector<Vector<uint8>> levels(level_count - 1);
+
+  for (usize level = 1; level < level_count; ++level) {
+    const auto* src = (level == 1) ? pixels : levels[level - 2].data();
+    const auto src_size = get_mip_level_size(size, level - 1);
+    const auto dst_size = get_mip_level_size(size, level);
+
+    auto& dst = levels[level - 1];
+    dst.resize(static_cast<usize>(dst_size.x) * static_cast<usize>(dst_size.y) * 4);
+
+    get_thread_pool().parallel_for(static_cast<usize>(dst_size.y), [&](const usize y) {
+      Vector<float> row_buffer;
+      _downsample_row(src,
+                      src_size,
+                      dst.data(),
+                      dst_size,
+                      static_cast<int>(y),
+                      kernel,
+                      options.srgb,
+                      color_table,
+                      row_buffer);
+    });
+  }
+
+  // Coverage is adjusted after all levels have been generated, since the levels are
+  // downsampled from the unscaled alpha values of the previous level.
+  if (options.alpha_cutoff.has_value() && !levels.empty()) {
+    const auto cutoff = *options.alpha_cutoff;
+    const auto pixel_count = static_cast<usize>(size.x) * static_cast<usize>(size.y);
+
+    const std::span<const uint8> base_level {pixels, pixel_count * 4};
+    const auto target_coverage = _compute_alpha_coverage(base_level, cutoff, 1.0f);
+
+    get_thread_pool().parallel_for(levels.size(), [&](const usize level) {
+      _preserve_alpha_coverage(levels[level], cutoff, target_coverage);
+    });
+  }
+
+  return levels;
+}
+
+auto get_mip_level_count(const Vec2i& size) noexcept -> usize
+{
+  const auto max_size = static_cast<uint32>(std::max(size.x, size.y));
+  return static_cast<usize>(std::bit_width(max_size));
+}
+
+auto get_mip_level_size(const Vec2i& size, const usize level) noexcept -> Vec2i
+{
+  return Vec2i {std::max(size.x >> level, 1), std::max(size.y >> level, 1)};
+}
+
+}  // namespace glow
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common/primitives.hpp"
+#include "common/type/math.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/vector.hpp"
+
+namespace glow {
+
+/// The filters that can be used to downsample mip levels.
+enum class MipFilter : uint8 {
+  Box,    ///< Averages 2x2 pixels, which is fast but somewhat blurry.
+  Kaiser  ///< Kaiser windowed sinc filter with 6 taps, which keeps more detail.
+};
+
+/// Options that control how mip chains are generated.
+struct MipChainOptions final {
+  MipFilter filter {MipFilter::Kaiser};  ///< The downsampling filter.
+
+  /// Whether color channels are sRGB encoded, the alpha channel is always linear.
+  bool srgb {true};
+
+  /// Optional alpha test threshold, the coverage of which is preserved in all levels.
+  Maybe<float> alpha_cutoff;
+};
+
+/// Generates the mip levels below the base level of an RGBA8 image.
+///
+/// \details
+/// Each level is downsampled from the previous level using a separable filter, where
+/// sRGB encoded color channels are filtered in linear space. Rows are distributed across
+/// the shared thread pool. If an alpha cutoff is specified, the alpha channel of each
+/// level is scaled so that the fraction of pixels that pass the alpha test matches that
+/// of the base level, which prevents alpha tested geometry from fading out at a distance.
+///
+/// \param pixels the pixel data of the base level.
+/// \param size the size of the base level.
+/// \param options the mip generation options.
+///
+/// \return the pixel data of each generated level, starting with the second level.
+[[nodiscard]] auto generate_mip_chain(const uint8* pixels,
+                                      const Vec2i& size,
+                                      const MipChainOptions& options)
+    -> Vector<Vector<uint8>>;
+
+/// Returns the number of levels in a complete mip chain for an image.
+[[nodiscard]] auto get_mip_level_count(const Vec2i& size) noexcept -> usize;
+
+/// Returns the size of a mip level, where the base level has index zero.
+[[nodiscard]] auto get_mip_level_size(const Vec2i& size, usize level) noexcept -> Vec2i;
+
+}  // namespace glow
@@ -0,0 +1,682 @@
+#include "model_cache.hpp"
+
+#include <algorithm>     // any_of
+#include <cstddef>       // offsetof
+#include <cstring>       // memcpy
+#include <ios>           // streamsize
+#include <span>          // span
+#include <string>        // u8string
+#include <system_error>  // error_code
+#include <type_traits>   // is_trivially_copyable_v
+#include <utility>       // move
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "common/hash.hpp"
+#include "common/type/chrono.hpp"
+#include "common/type/fstream.hpp"
+#include "common/type/pair.hpp"
+#include "common/type/string.hpp"
+#include "graphics/vertex_layout.hpp"
+#include "io/files.hpp"
+#include "io/mapped_file.hpp"
+
+namespace glow {
+namespace {
+
+inline constexpr uint32 kModelCacheMagic = 0x4D574C47;  // "GLWM"
+inline constexpr uint32 kModelCacheVersion = 8;
+inline constexpr usize kModelCacheAlignment = 16;
+
+struct ModelCacheHeader final {
+  uint32 magic {};
+  uint32 version {};
+  uint32 api {};
+  uint32 profile {};
+  uint32 vertex_format {};
+  uint32 reserved {};
+  uint64 source_size {};
+  int64 source_time {};
+  uint64 source_hash {};
+  uint64 dependency_count {};
+  uint64 mesh_count {};
+  uint64 material_count {};
+  uint64 payload_hash {};  ///< The hash of everything after the header.
+};
+
+/// Identifies the state of a file that the model was imported from.
+struct FileVersion final {
+  uint64 size {};
+  int64 time {};
+  uint64 hash {};
+};
+
+struct MeshCacheHeader final {
+  Mat4 transform {1.0f};
+  uint64 material_id {};
+  uint64 vertex_count {};
+  uint64 index_count {};
+  uint32 index_type {};
+  uint32 vertex_format {};
+  Vec3 position_offset {0};
+  Vec3 position_scale {1};
+  uint64 meshlet_count {};
+  Vec3 bounds_center {};
+  float bounds_radius {};
+  uint64 lod_count {};
+  float uv_density {};
+  uint32 reserved {};
+};
+
+static_assert(std::is_trivially_copyable_v<ModelCacheHeader>);
+static_assert(std::is_trivially_copyable_v<FileVersion>);
+static_assert(std::is_trivially_copyable_v<MeshCacheHeader>);
+static_assert(std::is_trivially_copyable_v<Meshlet>);
+static_assert(std::is_trivially_copyable_v<MeshLod>);
+
+[[nodiscard]] constexpr auto _get_padding(const usize offset) noexcept -> usize
+{
+  return (kModelCacheAlignment - (offset % kModelCacheAlignment)) % kModelCacheAlignment;
+}
+
+/// Simple bounds-checked cursor used to read cache entries.
+class CacheReader final {
+ public:
+  explicit CacheReader(const std::span<const Byte> bytes) noexcept
+      : mData {bytes.data()},
+        mSize {bytes.size()}
+  {
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  [[nodiscard]] auto read(T& value) noexcept -> bool
+  {
+    return read_bytes(&value, sizeof(T));
+  }
+
+  [[nodiscard]] auto read_bytes(void* dst, const usize size) noexcept -> bool
+  {
+    if (size > mSize - mOffset) {
+      return false;
+    }
+
+    if (size != 0) {
+      std::memcpy(dst, mData + mOffset, size);
+    }
+
+    mOffset += size;
+    return true;
+  }
+
+  /// Provides a view of the next bytes, without copying them.
+  [[nodiscard]] auto view_bytes(std::span<const Byte>& view, const usize size) noexcept
+      -> bool
+  {
+    if (size > mSize - mOffset) {
+      return false;
+    }
+
+    view = {mData + mOffset, size};
+    mOffset += size;
+    return true;
+  }
+
+  [[nodiscard]] auto read_string(std::u8string& str) -> bool
+  {
+    uint32 length {};
+    if (!read(length)) {
+      return false;
+    }
+
+    str.resize(length);
+    return read_bytes(str.data(), length);
+  }
+
+  [[nodiscard]] auto align() noexcept -> bool
+  {
+    const auto padding = _get_padding(mOffset);
+    if (padding > mSize - mOffset) {
+      return false;
+    }
+
+    mOffset += padding;
+    return true;
+  }
+
+  [[nodiscard]] auto remaining() const noexcept -> usize { return mSize - mOffset; }
+
+ private:
+  const Byte* mData {};
+  usize mSize {};
+  usize mOffset {};
+};
+
+/// Simple cursor used to write cache entries, keeps track of the written size.
+class CacheWriter final {
+ public:
+  explicit CacheWriter(OfStream& stream) noexcept
+      : mStream {stream}
+  {
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void write(const T& value)
+  {
+    write_bytes(&value, sizeof(T));
+  }
+
+  void write_bytes(const void* data, const usize size)
+  {
+    mStream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    mOffset += size;
+  }
+
+  void write_string(const std::u8string& str)
+  {
+    write(static_cast<uint32>(str.size()));
+    write_bytes(str.data(), str.size());
+  }
+
+  void align()
+  {
+    constexpr char zeros[kModelCacheAlignment] {};
+    write_bytes(zeros, _get_padding(mOffset));
+  }
+
+ private:
+  OfStream& mStream;
+  usize mOffset {};
+};
+
+[[nodiscard]] auto _get_model_cache_dir() -> Path
+{
+  return get_persistent_file_dir() / "cache" / "models";
+}
+
+[[nodiscard]] auto _get_cache_entry_path(const FileInfo& source,
+                                         const GraphicsAPI api,
+                                         const ImportOptions& options) -> Path
+{
+  const auto source_path = source.path.generic_u8string();
+  const auto seed = (static_cast<uint64>(options.vertex_format) << 40u) |
+                    (static_cast<uint64>(options.profile) << 32u) |
+                    static_cast<uint64>(api);
+  const auto key = hash_bytes(source_path.data(), source_path.size(), seed);
+  return _get_model_cache_dir() / fmt::format("{:016x}.glowmodel", key);
+}
+
+[[nodiscard]] auto _is_file_up_to_date(const FileVersion& version, const FileInfo& file)
+    -> bool
+{
+  if (version.size != file.size) {
+    return false;
+  }
+
+  if (version.time == file.time) {
+    return true;
+  }
+
+  // The file was touched, but might still have the same content.
+  const auto hash = hash_file(file.path);
+  return hash.has_value() && hash->hash == version.hash;
+}
+
+/// Checks that the files read along with the model, e.g. OBJ material libraries, are
+/// unchanged.
+[[nodiscard]] auto _are_dependencies_up_to_date(CacheReader& reader,
+                                                const uint64 dependency_count) -> bool
+{
+  for (uint64 index = 0; index < dependency_count; ++index) {
+    std::u8string path;
+    FileVersion version;
+
+    if (!reader.read_string(path) || !reader.read(version)) {
+      return false;
+    }
+
+    const auto file = get_file_info(Path {path});
+    if (!file.has_value() || !_is_file_up_to_date(version, *file)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/// Returns the files the model was imported from, excluding the model file itself.
+[[nodiscard]] auto _get_dependencies(const FileInfo& source,
+                                     const Vector<Path>& opened_files)
+    -> Maybe<Vector<Pair<FileInfo, FileVersion>>>
+{
+  Vector<Pair<FileInfo, FileVersion>> dependencies;
+
+  for (const auto& opened_file : opened_files) {
+    auto file = get_file_info(opened_file);
+    if (!file.has_value()) {
+      return kNothing;
+    }
+
+    const auto is_known = [&](const Pair<FileInfo, FileVersion>& dependency) {
+      return dependency.first.path == file->path;
+    };
+
+    if (file->path == source.path || std::ranges::any_of(dependencies, is_known)) {
+      continue;
+    }
+
+    const auto hash = hash_file(file->path);
+    if (!hash.has_value()) {
+      return kNothing;
+    }
+
+    const FileVersion version {file->size, file->time, hash->hash};
+    dependencies.emplace_back(std::move(*file), version);
+  }
+
+  return dependencies;
+}
+
+[[nodiscard]] auto _read_texture_path(CacheReader& reader, Maybe<Path>& path) -> bool
+{
+  uint8 has_path {};
+  if (!reader.read(has_path)) {
+    return false;
+  }
+
+  if (has_path) {
+    std::u8string str;
+    if (!reader.read_string(str)) {
+      return false;
+    }
+
+    path = Path {str};
+  }
+
+  return true;
+}
+
+void _write_texture_path(CacheWriter& writer, const Maybe<Path>& path)
+{
+  writer.write(static_cast<uint8>(path.has_value()));
+
+  if (path.has_value()) {
+    writer.write_string(path->generic_u8string());
+  }
+}
+
+[[nodiscard]] auto _read_material(CacheReader& reader, usize& id, MaterialData& material)
+    -> bool
+{
+  uint64 material_id {};
+  std::u8string name;
+
+  const auto ok = reader.read(material_id) &&                            //
+                  reader.read_string(name) &&                            //
+                  _read_texture_path(reader, material.diffuse_tex) &&    //
+                  _read_texture_path(reader, material.specular_tex) &&   //
+                  _read_texture_path(reader, material.ao_tex) &&         //
+                  _read_texture_path(reader, material.metalness_tex) &&  //
+                  _read_texture_path(reader, material.roughness_tex) &&  //
+                  _read_texture_path(reader, material.normal_tex) &&     //
+                  reader.read(material.ambient) &&                       //
+                  reader.read(material.diffuse) &&                       //
+                  reader.read(material.specular) &&                      //
+                  reader.read(material.emission) &&                      //
+                  reader.read(material.roughness) &&                     //
+                  reader.read(material.metalness) &&                     //
+                  reader.read(material.sheen) &&                         //
+                  reader.read(material.shininess) &&                     //
+                  reader.read(material.refraction_index);
+  if (!ok) {
+    return false;
+  }
+
+  id = static_cast<usize>(material_id);
+  material.name.assign(name.begin(), name.end());
+
+  return true;
+}
+
+void _write_material(CacheWriter& writer, const usize id, const MaterialData& material)
+{
+  writer.write(static_cast<uint64>(id));
+  writer.write_string(std::u8string {material.name.begin(), material.name.end()});
+
+  _write_texture_path(writer, material.diffuse_tex);
+  _write_texture_path(writer, material.specular_tex);
+  _write_texture_path(writer, material.ao_tex);
+  _write_texture_path(writer, material.metalness_tex);
+  _write_texture_path(writer, material.roughness_tex);
+  _write_texture_path(writer, material.normal_tex);
+
+  writer.write(material.ambient);
+  writer.write(material.diffuse);
+  writer.write(material.specular);
+  writer.write(material.emission);
+
+  writer.write(material.roughness);
+  writer.write(material.metalness);
+  writer.write(material.sheen);
+  writer.write(material.shininess);
+  writer.write(material.refraction_index);
+}
+
+[[nodiscard]] auto _read_mesh(CacheReader& reader,
+                              const Shared<const MappedFile>& file,
+                              MeshData& mesh) -> bool
+{
+  MeshCacheHeader header;
+  if (!reader.read(header)) {
+    return false;
+  }
+
+  if (header.index_type != static_cast<uint32>(IndexType::UInt16) &&
+      header.index_type != static_cast<uint32>(IndexType::UInt32)) {
+    return false;
+  }
+
+  if (header.vertex_format > static_cast<uint32>(VertexFormat::Quantized)) {
+    return false;
+  }
+
+  const auto index_type = static_cast<IndexType>(header.index_type);
+  const auto index_size = get_index_size(index_type);
+
+  const auto vertex_format = static_cast<VertexFormat>(header.vertex_format);
+  const auto vertex_size = get_vertex_size(vertex_format);
+
+  // Guard against corrupt entries claiming more data than there is in the file.
+  const auto vertex_bytes = header.vertex_count * vertex_size;
+  const auto index_bytes = header.index_count * index_size;
+  const auto meshlet_bytes = header.meshlet_count * sizeof(Meshlet);
+  const auto lod_bytes = header.lod_count * sizeof(MeshLod);
+  if (header.vertex_count > reader.remaining() / vertex_size ||
+      header.index_count > reader.remaining() / index_size ||
+      header.meshlet_count > reader.remaining() / sizeof(Meshlet) ||
+      header.lod_count > reader.remaining() / sizeof(MeshLod)) {
+    return false;
+  }
+
+  mesh.transform = header.transform;
+  mesh.material_id = static_cast<usize>(header.material_id);
+  mesh.vertex_format = vertex_format;
+  mesh.vertex_count = static_cast<usize>(header.vertex_count);
+  mesh.position_offset = header.position_offset;
+  mesh.position_scale = header.position_scale;
+  mesh.index_type = index_type;
+  mesh.index_count = static_cast<usize>(header.index_count);
+  mesh.bounds_center = header.bounds_center;
+  mesh.bounds_radius = header.bounds_radius;
+  mesh.uv_density = header.uv_density;
+
+  // The vertex and index arrays are stored exactly as they are laid out in memory, at
+  // aligned offsets, so they are used in place. The mesh keeps the file alive. Meshlets
+  // and levels of detail are small and end up in the mesh components, so they are
+  // copied instead.
+  mesh.mapped_file = file;
+  mesh.meshlets.resize(static_cast<usize>(header.meshlet_count));
+  mesh.lods.resize(static_cast<usize>(header.lod_count));
+
+  const auto valid = reader.align() &&                                          //
+                     reader.view_bytes(mesh.mapped_vertices, vertex_bytes) &&   //
+                     reader.align() &&                                          //
+                     reader.view_bytes(mesh.mapped_indices, index_bytes) &&     //
+                     reader.align() &&                                          //
+                     reader.read_bytes(mesh.meshlets.data(), meshlet_bytes) &&  //
+                     reader.align() &&                                          //
+                     reader.read_bytes(mesh.lods.data(), lod_bytes);
+  if (!valid) {
+    return false;
+  }
+
+  // The levels of detail are used as draw ranges, so they must be within the indices
+  for (const auto& lod : mesh.lods) {
+    if (static_cast<uint64>(lod.index_offset) + lod.index_count > header.index_count) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void _write_mesh(CacheWriter& writer, const MeshData& mesh)
+{
+  MeshCacheHeader header;
+  header.transform = mesh.transform;
+  header.material_id = static_cast<uint64>(mesh.material_id);
+  header.vertex_count = static_cast<uint64>(mesh.vertex_count);
+  header.index_count = static_cast<uint64>(mesh.index_count);
+  header.index_type = static_cast<uint32>(mesh.index_type);
+  header.vertex_format = static_cast<uint32>(mesh.vertex_format);
+  header.position_offset = mesh.position_offset;
+  header.position_scale = mesh.position_scale;
+  header.meshlet_count = static_cast<uint64>(mesh.meshlets.size());
+  header.bounds_center = mesh.bounds_center;
+  header.bounds_radius = mesh.bounds_radius;
+  header.lod_count = static_cast<uint64>(mesh.lods.size());
+  header.uv_density = mesh.uv_density;
+
+  writer.write(header);
+
+  const auto vertices = mesh.get_vertices();
+  const auto indices = mesh.get_indices();
+
+  writer.align();
+  writer.write_bytes(vertices.data(), vertices.size());
+
+  writer.align();
+  writer.write_bytes(indices.data(), indices.size());
+
+  writer.align();
+  writer.write_bytes(mesh.meshlets.data(), byte_size(mesh.meshlets));
+
+  writer.align();
+  writer.write_bytes(mesh.lods.data(), byte_size(mesh.lods));
+}
+
+}  // namespace
+
+auto load_cached_model_data(const Path& path,
+                            const GraphicsAPI api,
+                            const ImportOptions& options) -> Maybe<ModelData>
+{
+  const auto start_time = Clock::now();
+
+  const auto source = get_file_info(path);
+  if (!source.has_value()) {
+    return kNothing;
+  }
+
+  const auto entry_path = _get_cache_entry_path(*source, api, options);
+
+  auto mapped_file = MappedFile::open(entry_path);
+  if (!mapped_file.has_value()) {
+    return kNothing;
+  }
+
+  // Shared with the loaded meshes, which view their vertex and index data in the file
+  const auto file = std::make_shared<const MappedFile>(std::move(*mapped_file));
+
+  CacheReader reader {file->bytes()};
+
+  ModelCacheHeader header;
+  if (!reader.read(header) ||                                    //
+      header.magic != kModelCacheMagic ||                        //
+      header.version != kModelCacheVersion ||                    //
+      header.api != static_cast<uint32>(api) ||                  //
+      header.profile != static_cast<uint32>(options.profile) ||  //
+      header.vertex_format != static_cast<uint32>(options.vertex_format)) {
+    spdlog::debug("[IO] Ignoring incompatible model cache entry {}", entry_path.string());
+    return kNothing;
+  }
+
+  // The source path is stored to detect the (unlikely) case of a key collision.
+  std::u8string source_path;
+  if (!reader.read_string(source_path) ||
+      source_path != source->path.generic_u8string()) {
+    return kNothing;
+  }
+
+  const FileVersion source_version {header.source_size,
+                                    header.source_time,
+                                    header.source_hash};
+
+  if (!_is_file_up_to_date(source_version, *source) ||
+      !_are_dependencies_up_to_date(reader, header.dependency_count)) {
+    spdlog::debug("[IO] Model cache entry for {} is out of date", path.string());
+    return kNothing;
+  }
+
+  // Catches entries that were truncated or corrupted after they were written
+  const auto payload = file->bytes().subspan(sizeof header);
+  if (hash_bytes(payload.data(), payload.size()) != header.payload_hash) {
+    spdlog::warn("[IO] Corrupt model cache entry {}", entry_path.string());
+    return kNothing;
+  }
+
+  ModelData model;
+  model.dir = path.parent_path();
+  model.materials.reserve(static_cast<usize>(header.material_count));
+  model.meshes.resize(static_cast<usize>(header.mesh_count));
+
+  for (uint64 material_idx = 0; material_idx < header.material_count; ++material_idx) {
+    usize material_id {};
+    MaterialData material;
+
+    if (!_read_material(reader, material_id, material)) {
+      spdlog::warn("[IO] Corrupt model cache entry {}", entry_path.string());
+      return kNothing;
+    }
+
+    model.materials.try_emplace(material_id, std::move(material));
+  }
+
+  for (auto& mesh : model.meshes) {
+    if (!_read_mesh(reader, file, mesh)) {
+      spdlog::warn("[IO] Corrupt model cache entry {}", entry_path.string());
+      return kNothing;
+    }
+  }
+
+  const auto end_time = Clock::now();
+  const auto total_duration = chrono::duration_cast<Milliseconds>(end_time - start_time);
+  spdlog::debug("[IO] Loaded cached 3D model in {} (meshes: {}, materials: {})",
+                total_duration,
+                model.meshes.size(),
+                model.materials.size());
+
+  return model;
+}
+
+auto save_cached_model_data(const Path& path,
+                            const GraphicsAPI api,
+                            const ImportOptions& options,
+                            const ModelData& model,
+                            const Vector<Path>& opened_files) -> Result
+{
+  const auto source = get_file_info(path);
+  if (!source.has_value()) {
+    return kFailure;
+  }
+
+  const auto source_hash = hash_file(source->path);
+  if (!source_hash.has_value()) {
+    return kFailure;
+  }
+
+  const auto dependencies = _get_dependencies(*source, opened_files);
+  if (!dependencies.has_value()) {
+    return kFailure;
+  }
+
+  std::error_code error;
+  fs::create_directories(_get_model_cache_dir(), error);
+  if (error) {
+    spdlog::warn("[IO] Could not create model cache directory: {}", error.message());
+    return kFailure;
+  }
+
+  // Entries are written to a temporary file first, to avoid leaving partially written
+  // entries behind if something goes wrong.
+  const auto entry_path = _get_cache_entry_path(*source, api, options);
+  const auto temp_path = make_temp_path(entry_path);
+
+  {
+    auto stream = create_file(temp_path, FileType::Binary);
+    if (!stream.has_value()) {
+      spdlog::warn("[IO] Could not create model cache entry {}", temp_path.string());
+      return kFailure;
+    }
+
+    ModelCacheHeader header;
+    header.magic = kModelCacheMagic;
+    header.version = kModelCacheVersion;
+    header.api = static_cast<uint32>(api);
+    header.profile = static_cast<uint32>(options.profile);
+    header.vertex_format = static_cast<uint32>(options.vertex_format);
+    header.source_size = source->size;
+    header.source_time = source->time;
+    header.source_hash = source_hash->hash;
+    header.dependency_count = static_cast<uint64>(dependencies->size());
+    header.mesh_count = static_cast<uint64>(model.meshes.size());
+    header.material_count = static_cast<uint64>(model.materials.size());
+
+    CacheWriter writer {*stream};
+    writer.write(header);
+    writer.write_string(source->path.generic_u8string());
+
+    for (const auto& [file, version] : *dependencies) {
+      writer.write_string(file.path.generic_u8string());
+      writer.write(version);
+    }
+
+    for (const auto& [material_id, material] : model.materials) {
+      _write_material(writer, material_id, material);
+    }
+
+    for (const auto& mesh : model.meshes) {
+      _write_mesh(writer, mesh);
+    }
+
+    stream->flush();
+
+    // The payload is hashed from the written file, and the header is patched afterwards
+    if (stream->good()) {
+      if (const auto temp_file = MappedFile::open(temp_path)) {
+        const auto payload = temp_file->bytes().subspan(sizeof header);
+        header.payload_hash = hash_bytes(payload.data(), payload.size());
+      }
+      else {
+        stream->setstate(std::ios::failbit);
+      }
+
+      constexpr auto hash_offset = offsetof(ModelCacheHeader, payload_hash);
+      stream->seekp(static_cast<std::streamoff>(hash_offset));
+      stream->write(reinterpret_cast<const char*>(&header.payload_hash),  // NOLINT
+                    static_cast<std::streamsize>(sizeof header.payload_hash));
+    }
+
+    if (!stream->good()) {
+      spdlog::warn("[IO] Could not write model cache entry {}", temp_path.string());
+      stream->close();
+      fs::remove(temp_path, error);
+      return kFailure;
+    }
+  }
+
+  fs::rename(temp_path, entry_path, error);
+  if (error) {
+    spdlog::warn("[IO] Could not store model cache entry: {}", error.message());
+    fs::remove(temp_path, error);
+    return kFailure;
+  }
+
+  spdlog::debug("[IO] Stored model cache entry {}", entry_path.string());
+  return kSuccess;
+}
+
+}  // namespace glow
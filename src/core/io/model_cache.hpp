@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common/result.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/path.hpp"
+#include "common/type/vector.hpp"
+#include "graphics/graphics_api.hpp"
+#include "io/import_options.hpp"
+#include "io/model_loader.hpp"
+
+namespace glow {
+
+/// Attempts to load model data from the persistent model cache.
+///
+/// \details
+/// Cache entries are keyed by the canonical path of the source file, the graphics API
+/// and the import options, since the imported data depends on the target coordinate
+/// system and on the processing that was performed. An entry is only used if it was
+/// created by a compatible version of the cache format, and if the source file, along
+/// with any other files read during the import such as OBJ material libraries, hasn't
+/// changed since the entry was written. The modification time and size of each file
+/// are checked first, the (more expensive) content hash is only computed if the
+/// modification time differs. Entries also store a hash of their contents, which is
+/// verified before the entry is used.
+///
+/// Entries are memory mapped, and the vertex and index data of the returned meshes is
+/// not copied out of the mapping, see `MeshData::mapped_file`. The entry stays mapped
+/// for as long as any of the meshes exists.
+///
+/// \param path the path to the source model file.
+/// \param api the graphics API that will be used to render the model.
+/// \param options the import options used to process the model.
+///
+/// \return the cached model data, or nothing if there is no valid cache entry.
+[[nodiscard]] auto load_cached_model_data(const Path& path,
+                                          GraphicsAPI api,
+                                          const ImportOptions& options)
+    -> Maybe<ModelData>;
+
+/// Writes model data to the persistent model cache.
+///
+/// \param path the path to the source model file.
+/// \param api the graphics API that the model data was imported for.
+/// \param options the import options used to process the model.
+/// \param model the imported model data.
+/// \param opened_files the files read while importing the model, which are validated
+///                     along with the source file when the entry is loaded.
+///
+/// \return success if the cache entry was written; failure otherwise.
+auto save_cached_model_data(const Path& path,
+                            GraphicsAPI api,
+                            const ImportOptions& options,
+                            const ModelData& model,
+                            const Vector<Path>& opened_files) -> Result;
+
+}  // namespace glow
@@ -1,16 +1,36 @@
 #include "model_loader.hpp"
 
+#include <algorithm>  // max, find
+#include <cmath>      // abs, sqrt
+#include <utility>    // move
+
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <fmt/chrono.h>
 #include <spdlog/spdlog.h>
 
+#include "common/hash.hpp"
 #include "common/type/chrono.hpp"
+#include "common/type/set.hpp"
+#include "graphics/vertex_layout.hpp"
+#include "io/asset_io_system.hpp"
+#include "io/mesh_optimizer.hpp"
+#include "io/model_cache.hpp"
+#include "util/thread_pool.hpp"
 
 namespace glow {
 namespace {
 
+// Meshlets are only generated for meshes that are large enough to benefit from culling.
+inline constexpr usize kMinMeshletMeshTriangles = 1'024;
+
+// Levels of detail are only generated for meshes that are large enough to benefit.
+inline constexpr usize kMinLodMeshTriangles = 1'024;
+
+// Each level of detail targets half of the triangles of the previous level.
+inline constexpr usize kMaxLodCount = 4;
+
 [[nodiscard]] auto _convert_color(const aiColor4D& color) -> Vec3
 {
   return Vec3 {color.r, color.g, color.b};
@@ -124,55 +144,318 @@ namespace {
   return vertex;
 }
 
-[[nodiscard]] auto _load_mesh_data(const aiNode* node, const aiMesh* mesh) -> MeshData
+struct MeshJob final {
+  const aiNode* node {};
+  const aiMesh* mesh {};
+};
+
+[[nodiscard]] auto _count_mesh_indices(const aiMesh* mesh) -> usize
+{
+  usize index_count = 0;
+
+  for (uint face_idx = 0; face_idx < mesh->mNumFaces; ++face_idx) {
+    index_count += mesh->mFaces[face_idx].mNumIndices;
+  }
+
+  return index_count;
+}
+
+/// Computes a bounding sphere of a mesh, centered in its bounding box.
+void _compute_mesh_bounds(const Vector<Vertex>& vertices, MeshData& mesh_data)
+{
+  if (vertices.empty()) {
+    return;
+  }
+
+  auto min_position = vertices.front().position;
+  auto max_position = vertices.front().position;
+
+  for (const auto& vertex : vertices) {
+    min_position = glm::min(min_position, vertex.position);
+    max_position = glm::max(max_position, vertex.position);
+  }
+
+  mesh_data.bounds_center = (min_position + max_position) * 0.5f;
+  mesh_data.bounds_radius = 0.0f;
+
+  for (const auto& vertex : vertices) {
+    const auto distance = glm::distance(mesh_data.bounds_center, vertex.position);
+    mesh_data.bounds_radius = std::max(mesh_data.bounds_radius, distance);
+  }
+}
+
+/// Estimates how densely the texture coordinates of a mesh are distributed.
+///
+/// \details
+/// The density is the square root of the ratio between the total texture coordinate
+/// area and the total surface area of the triangles, which is used to determine the
+/// mip levels that are needed to texture the mesh at a given distance.
+void _compute_uv_density(const Vector<Vertex>& vertices,
+                         const Vector<uint32>& indices,
+                         MeshData& mesh_data)
+{
+  // Only the full detail level is considered, which is stored first
+  const auto index_count = mesh_data.lods.empty()
+                               ? indices.size()
+                               : static_cast<usize>(mesh_data.lods.front().index_count);
+
+  float surface_area = 0.0f;
+  float uv_area = 0.0f;
+
+  for (usize index = 0; index + 2 < index_count; index += 3) {
+    const auto& v0 = vertices[indices[index]];
+    const auto& v1 = vertices[indices[index + 1]];
+    const auto& v2 = vertices[indices[index + 2]];
+
+    const auto edge1 = v1.position - v0.position;
+    const auto edge2 = v2.position - v0.position;
+    surface_area += glm::length(glm::cross(edge1, edge2));
+
+    const auto uv_edge1 = v1.tex_coords - v0.tex_coords;
+    const auto uv_edge2 = v2.tex_coords - v0.tex_coords;
+    uv_area += std::abs(uv_edge1.x * uv_edge2.y - uv_edge1.y * uv_edge2.x);
+  }
+
+  // Meshes without proper texture coordinates use a density of one
+  if (surface_area > 0.0f && uv_area > 0.0f) {
+    mesh_data.uv_density = std::sqrt(uv_area / surface_area);
+  }
+}
+
+/// Generates simplified levels of detail, and appends their indices to the mesh indices.
+void _generate_lods(const Vector<Vertex>& vertices,
+                    Vector<uint32>& indices,
+                    MeshData& mesh_data)
+{
+  // Every level is simplified from the full mesh, which keeps the errors accurate.
+  const auto full_indices = indices;
+  mesh_data.lods.push_back(MeshLod {0, static_cast<uint32>(full_indices.size()), 0});
+
+  float error = 0.0f;
+
+  for (usize level = 1; level < kMaxLodCount; ++level) {
+    const auto target_index_count = (full_indices.size() >> level) / 3 * 3;
+
+    float level_error = 0.0f;
+    auto lod_indices =
+        simplify_mesh(vertices, full_indices, target_index_count, level_error);
+
+    // Stop when seams and borders prevent any meaningful simplification
+    const auto& previous_lod = mesh_data.lods.back();
+    if (lod_indices.size() > static_cast<usize>(previous_lod.index_count) * 3 / 4) {
+      break;
+    }
+
+    optimize_vertex_cache(lod_indices, vertices.size());
+
+    // The errors should never decrease, since the levels are selected by error
+    error = std::max(error, level_error);
+
+    mesh_data.lods.push_back(MeshLod {static_cast<uint32>(indices.size()),
+                                      static_cast<uint32>(lod_indices.size()),
+                                      error});
+    indices.insert(indices.end(), lod_indices.begin(), lod_indices.end());
+  }
+
+  if (mesh_data.lods.size() == 1) {
+    mesh_data.lods.clear();
+  }
+}
+
+struct MeshStats final {
+  VertexCacheStats before;  ///< Vertex cache statistics before optimization.
+  VertexCacheStats after;   ///< Vertex cache statistics after optimization.
+};
+
+auto _load_mesh_data(const MeshJob& job,
+                     const ImportOptions& options,
+                     MeshData& mesh_data) -> MeshStats
 {
-  MeshData mesh_data;
+  const auto* mesh = job.mesh;
+
   mesh_data.material_id = mesh->mMaterialIndex;
-  mesh_data.transform = _convert_matrix(node->mTransformation);
+  mesh_data.transform = _convert_matrix(job.node->mTransformation);
 
+  Vector<Vertex> vertices(mesh->mNumVertices);
   for (uint vertex_idx = 0; vertex_idx < mesh->mNumVertices; ++vertex_idx) {
-    mesh_data.vertices.push_back(_create_mesh_vertex(mesh, vertex_idx));
+    vertices[vertex_idx] = _create_mesh_vertex(mesh, vertex_idx);
   }
 
+  Vector<uint32> indices(_count_mesh_indices(mesh));
+  usize next_index = 0;
+
   for (uint face_idx = 0; face_idx < mesh->mNumFaces; ++face_idx) {
     const auto& face = mesh->mFaces[face_idx];
 
     for (uint index_idx = 0; index_idx < face.mNumIndices; ++index_idx) {
-      mesh_data.indices.push_back(static_cast<uint32>(face.mIndices[index_idx]));
+      indices[next_index] = static_cast<uint32>(face.mIndices[index_idx]);
+      ++next_index;
+    }
+  }
+
+  weld_vertices(vertices, indices);
+
+  MeshStats stats;
+
+  if (options.profile == ImportProfile::Optimized) {
+    stats.before = analyze_vertex_cache(indices, vertices.size());
+
+    optimize_vertex_cache(indices, vertices.size());
+    optimize_overdraw(vertices, indices);
+    optimize_vertex_fetch(vertices, indices);
+
+    stats.after = analyze_vertex_cache(indices, vertices.size());
+
+    if (indices.size() / 3 >= kMinMeshletMeshTriangles) {
+      mesh_data.meshlets = build_meshlets(vertices, indices);
+    }
+
+    // Meshlets only cover the full mesh, which is stored first
+    if (indices.size() / 3 >= kMinLodMeshTriangles) {
+      _generate_lods(vertices, indices, mesh_data);
     }
   }
 
-  return mesh_data;
+  _compute_mesh_bounds(vertices, mesh_data);
+  _compute_uv_density(vertices, indices, mesh_data);
+
+  pack_vertices(vertices, options.vertex_format, mesh_data);
+  pack_indices(indices, mesh_data);
+
+  return stats;
 }
 
-void _process_node(ModelData& model, const aiScene* scene, const aiNode* node)
+/// Logs statistics about the vertex and index data of a freshly imported model.
+void _log_mesh_statistics(const ModelData& model,
+                          const Vector<MeshJob>& mesh_jobs,
+                          const Vector<MeshStats>& mesh_stats)
 {
-  for (uint mesh_idx = 0; mesh_idx < node->mNumMeshes; ++mesh_idx) {
-    const auto* mesh = scene->mMeshes[node->mMeshes[mesh_idx]];
+  usize imported_vertex_count = 0;
+  for (const auto& job : mesh_jobs) {
+    imported_vertex_count += job.mesh->mNumVertices;
+  }
 
-    auto [iter, did_insert] = model.materials.try_emplace(mesh->mMaterialIndex);
-    if (did_insert) {
-      iter->second = _load_material_data(scene, mesh);
+  usize vertex_count = 0;
+  usize vertex_bytes = 0;
+  usize index_bytes = 0;
+  usize uint16_mesh_count = 0;
+  usize meshlet_count = 0;
+  usize lod_count = 0;
+
+  for (const auto& mesh : model.meshes) {
+    vertex_count += mesh.vertex_count;
+    vertex_bytes += mesh.get_vertices().size();
+    index_bytes += mesh.get_indices().size();
+    meshlet_count += mesh.meshlets.size();
+    lod_count += mesh.lods.empty() ? 0 : mesh.lods.size() - 1;
+
+    if (mesh.index_type == IndexType::UInt16) {
+      ++uint16_mesh_count;
     }
+  }
+
+  spdlog::debug("[IO] Welded {} vertices into {}, {}/{} meshes use 16-bit indices",
+                imported_vertex_count,
+                vertex_count,
+                uint16_mesh_count,
+                model.meshes.size());
+  spdlog::debug("[IO] Total vertex data size is {} KiB, index data size is {} KiB",
+                vertex_bytes / 1'024,
+                index_bytes / 1'024);
+  spdlog::debug("[IO] Generated {} meshlets and {} simplified levels of detail",
+                meshlet_count,
+                lod_count);
+
+  MeshStats total_stats;
+  for (const auto& stats : mesh_stats) {
+    total_stats.before += stats.before;
+    total_stats.after += stats.after;
+  }
+
+  if (total_stats.after.triangle_count > 0) {
+    spdlog::debug("[IO] Vertex cache ACMR: {:.3f} -> {:.3f}, ATVR: {:.3f} -> {:.3f}",
+                  total_stats.before.acmr(),
+                  total_stats.after.acmr(),
+                  total_stats.before.atvr(),
+                  total_stats.after.atvr());
+  }
+}
 
-    model.meshes.push_back(_load_mesh_data(node, mesh));
+/// Flattens the node hierarchy into a list of meshes, in depth-first order.
+void _collect_mesh_jobs(Vector<MeshJob>& jobs, const aiScene* scene, const aiNode* node)
+{
+  for (uint mesh_idx = 0; mesh_idx < node->mNumMeshes; ++mesh_idx) {
+    jobs.push_back(MeshJob {node, scene->mMeshes[node->mMeshes[mesh_idx]]});
   }
 
   for (uint child_idx = 0; child_idx < node->mNumChildren; ++child_idx) {
-    const auto* child_node = node->mChildren[child_idx];
-    _process_node(model, scene, child_node);
+    _collect_mesh_jobs(jobs, scene, node->mChildren[child_idx]);
   }
 }
 
-}  // namespace
+/// Loads the materials that are used by the meshes, other materials are ignored.
+void _load_materials(ModelData& model,
+                     const aiScene* scene,
+                     const Vector<MeshJob>& mesh_jobs)
+{
+  Vector<const aiMesh*> material_meshes;
+  Vector<bool> material_used(scene->mNumMaterials, false);
+  for (const auto& job : mesh_jobs) {
+    const auto material_idx = job.mesh->mMaterialIndex;
+    if (!material_used[material_idx]) {
+      material_used[material_idx] = true;
+      material_meshes.push_back(job.mesh);
+    }
+  }
+
+  Vector<MaterialData> materials(material_meshes.size());
 
-auto load_model_data(const Path& path, const GraphicsAPI api) -> Maybe<ModelData>
+  get_thread_pool().parallel_for(materials.size(), [&](const usize index) {
+    materials[index] = _load_material_data(scene, material_meshes[index]);
+  });
+
+  model.materials.reserve(materials.size());
+  for (usize index = 0; index < materials.size(); ++index) {
+    model.materials.try_emplace(material_meshes[index]->mMaterialIndex,
+                                std::move(materials[index]));
+  }
+}
+
+void _process_scene(ModelData& model, const aiScene* scene, const ImportOptions& options)
 {
-  const auto start_time = Clock::now();
+  Vector<MeshJob> mesh_jobs;
+  mesh_jobs.reserve(scene->mNumMeshes);
+  _collect_mesh_jobs(mesh_jobs, scene, scene->mRootNode);
 
-  Assimp::Importer importer;
+  _load_materials(model, scene, mesh_jobs);
 
-  auto flags = aiProcessPreset_TargetRealtime_Quality;
+  // Each job writes to its own preallocated slot, so the output order is identical to
+  // that of a sequential traversal, regardless of the number of threads.
+  Vector<MeshStats> mesh_stats(mesh_jobs.size());
+  model.meshes.resize(mesh_jobs.size());
+
+  get_thread_pool().parallel_for(mesh_jobs.size(), [&](const usize index) {
+    mesh_stats[index] = _load_mesh_data(mesh_jobs[index], options, model.meshes[index]);
+  });
+
+  _log_mesh_statistics(model, mesh_jobs, mesh_stats);
+}
+
+/// Reads a model file, the returned scene is owned by the importer.
+///
+/// \param opened_files optional list that receives the paths of all files read by the
+///                     importer, including the model file itself.
+[[nodiscard]] auto _read_scene(Assimp::Importer& importer,
+                               const Path& path,
+                               const GraphicsAPI api,
+                               Vector<Path>* opened_files = nullptr) -> const aiScene*
+{
+  // Files are read through our own file system, which supports asset archives. The
+  // importer takes ownership of the file system.
+  importer.SetIOHandler(new AssetIOSystem {opened_files});  // NOLINT
+
+  // Triangle order is handled by our own optimization passes, see the import profiles.
+  auto flags = aiProcessPreset_TargetRealtime_Quality & ~aiProcess_ImproveCacheLocality;
   if (api == GraphicsAPI::Vulkan) {
     flags |= aiProcess_MakeLeftHanded;
   }
@@ -181,22 +464,192 @@ auto load_model_data(const Path& path, const GraphicsAPI api) -> Maybe<ModelData
 
   if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
     spdlog::error("[IO] Could not read 3D object file: {}", importer.GetErrorString());
+    return nullptr;
+  }
+
+  return scene;
+}
+
+/// Returns the approximate amount of memory needed to convert an imported mesh.
+[[nodiscard]] auto _get_conversion_size(const aiMesh* mesh) -> usize
+{
+  return usize {mesh->mNumVertices} * sizeof(Vertex) +
+         usize {mesh->mNumFaces} * 3 * sizeof(uint32);
+}
+
+}  // namespace
+
+auto load_model_data(const Path& path,
+                     const GraphicsAPI api,
+                     const ImportOptions& options) -> Maybe<ModelData>
+{
+  if (auto cached_model = load_cached_model_data(path, api, options)) {
+    return cached_model;
+  }
+
+  const auto start_time = Clock::now();
+
+  Assimp::Importer importer;
+  Vector<Path> opened_files;
+
+  const auto* scene = _read_scene(importer, path, api, &opened_files);
+  if (!scene) {
     return kNothing;
   }
 
   ModelData model;
   model.dir = path.parent_path();
 
-  _process_node(model, scene, scene->mRootNode);
+  const auto process_start_time = Clock::now();
+  _process_scene(model, scene, options);
 
   const auto end_time = Clock::now();
+  const auto process_duration =
+      chrono::duration_cast<Microseconds>(end_time - process_start_time);
+  spdlog::debug("[IO] Extracted model data in {} using {} threads ({}, {} vertices)",
+                process_duration,
+                get_thread_pool().thread_count() + 1,
+                get_short_name(options.profile),
+                get_short_name(options.vertex_format));
+
   const auto total_duration = chrono::duration_cast<Milliseconds>(end_time - start_time);
   spdlog::debug("[IO] Loaded 3D model in {} (meshes: {}, materials: {})",
                 total_duration,
                 model.meshes.size(),
                 model.materials.size());
 
+  if (save_cached_model_data(path, api, options, model, opened_files).failed()) {
+    spdlog::warn("[IO] Could not cache model data for {}", path.string());
+  }
+
   return model;
 }
 
+ModelImporter::ModelImporter() noexcept = default;
+
+ModelImporter::~ModelImporter() noexcept = default;
+
+ModelImporter::ModelImporter(ModelImporter&& other) noexcept = default;
+
+auto ModelImporter::operator=(ModelImporter&& other) noexcept
+    -> ModelImporter& = default;
+
+auto ModelImporter::open(const Path& path,
+                         const GraphicsAPI api,
+                         const ImportOptions& options) -> Maybe<ModelImporter>
+{
+  const auto start_time = Clock::now();
+
+  Assimp::Importer assimp_importer;
+
+  if (!_read_scene(assimp_importer, path, api)) {
+    return kNothing;
+  }
+
+  ModelImporter importer;
+  importer.mScene.reset(assimp_importer.GetOrphanedScene());
+  importer.mOptions = options;
+  importer.mModel.dir = path.parent_path();
+
+  const auto* scene = importer.mScene.get();
+
+  Vector<MeshJob> mesh_jobs;
+  mesh_jobs.reserve(scene->mNumMeshes);
+  _collect_mesh_jobs(mesh_jobs, scene, scene->mRootNode);
+
+  _load_materials(importer.mModel, scene, mesh_jobs);
+
+  // Meshes may be used by several nodes, so they are only released after the last one
+  importer.mMeshUses.resize(scene->mNumMeshes, 0);
+  importer.mMeshRefs.reserve(mesh_jobs.size());
+
+  for (const auto& job : mesh_jobs) {
+    const auto* mesh_begin = scene->mMeshes;
+    const auto* mesh_end = scene->mMeshes + scene->mNumMeshes;
+    const auto mesh_index = std::find(mesh_begin, mesh_end, job.mesh) - mesh_begin;
+
+    importer.mMeshRefs.push_back(MeshRef {job.node, static_cast<uint>(mesh_index)});
+    ++importer.mMeshUses[static_cast<usize>(mesh_index)];
+  }
+
+  const auto duration = chrono::duration_cast<Milliseconds>(Clock::now() - start_time);
+  spdlog::debug("[IO] Read 3D model in {} (meshes: {}, materials: {})",
+                duration,
+                importer.mMeshRefs.size(),
+                importer.mModel.materials.size());
+
+  return importer;
+}
+
+auto ModelImporter::import_meshes(const usize byte_budget) -> Vector<MeshData>
+{
+  const auto first_ref = mNextMesh;
+  usize batch_size = 0;
+
+  Vector<MeshJob> mesh_jobs;
+
+  while (has_next_mesh()) {
+    const auto& ref = mMeshRefs[mNextMesh];
+    const auto* mesh = mScene->mMeshes[ref.mesh_index];
+    const auto mesh_size = _get_conversion_size(mesh);
+
+    if (!mesh_jobs.empty() && batch_size + mesh_size > byte_budget) {
+      break;
+    }
+
+    mesh_jobs.push_back(MeshJob {ref.node, mesh});
+    batch_size += mesh_size;
+    ++mNextMesh;
+  }
+
+  Vector<MeshData> meshes(mesh_jobs.size());
+
+  get_thread_pool().parallel_for(mesh_jobs.size(), [&](const usize index) {
+    _load_mesh_data(mesh_jobs[index], mOptions, meshes[index]);
+  });
+
+  // The imported meshes are no longer needed once all of their nodes have been converted
+  for (auto ref_index = first_ref; ref_index < mNextMesh; ++ref_index) {
+    const auto mesh_index = mMeshRefs[ref_index].mesh_index;
+
+    if (--mMeshUses[mesh_index] == 0) {
+      delete mScene->mMeshes[mesh_index];  // NOLINT
+      mScene->mMeshes[mesh_index] = nullptr;
+    }
+  }
+
+  return meshes;
+}
+
+auto collect_texture_paths(const ModelData& model) -> Vector<Path>
+{
+  Set<Path> paths;
+
+  for (const auto& [material_id, material] : model.materials) {
+    if (material.diffuse_tex.has_value()) {
+      paths.insert((model.dir / *material.diffuse_tex).lexically_normal());
+    }
+
+    if (material.specular_tex.has_value()) {
+      paths.insert((model.dir / *material.specular_tex).lexically_normal());
+    }
+  }
+
+  return Vector<Path> {paths.begin(), paths.end()};
+}
+
+auto hash_mesh_data(const MeshData& mesh, const uint64 seed) -> ContentHash
+{
+  // The formats are part of the hash, since they determine how the bytes are interpreted
+  const auto format_seed = hash_combine(seed, mesh.vertex_format, mesh.index_type);
+
+  const auto vertices = mesh.get_vertices();
+  const auto indices = mesh.get_indices();
+
+  const auto vertex_hash = hash_bytes(vertices.data(), vertices.size(), format_seed);
+  const auto index_hash = hash_bytes(indices.data(), indices.size(), vertex_hash);
+
+  return ContentHash {index_hash, vertices.size() + indices.size()};
+}
+
 }  // namespace glow
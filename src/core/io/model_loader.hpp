@@ -1,16 +1,27 @@
 #pragma once
 
+#include <span>  // span
+
+#include "common/hash.hpp"
+#include "common/predef.hpp"
 #include "common/primitives.hpp"
 #include "common/type/map.hpp"
 #include "common/type/maybe.hpp"
+#include "common/type/memory.hpp"
 #include "common/type/path.hpp"
 #include "common/type/string.hpp"
 #include "common/type/vector.hpp"
 #include "graphics/graphics_api.hpp"
 #include "graphics/vertex.hpp"
+#include "io/import_options.hpp"
+
+struct aiScene;
+struct aiNode;
 
 namespace glow {
 
+GLOW_FORWARD_DECLARE_C(MappedFile);
+
 struct MaterialData final {
   String name;
 
@@ -37,11 +48,76 @@ struct MaterialData final {
   float refraction_index {};
 };
 
+enum class IndexType : uint8 {
+  UInt16,
+  UInt32
+};
+
+/// Returns the size of a single index of the specified type, in bytes.
+[[nodiscard]] constexpr auto get_index_size(const IndexType type) noexcept -> usize
+{
+  return (type == IndexType::UInt16) ? sizeof(uint16) : sizeof(uint32);
+}
+
+/// A cluster of triangles, stored as a contiguous range in the index buffer of a mesh.
+///
+/// \details
+/// Meshlets have bounding volumes in mesh space that are used to cull clusters of
+/// triangles that are outside the view frustum or that are facing away from the camera.
+struct Meshlet final {
+  uint32 index_offset {};  ///< Offset to the first index of the meshlet.
+  uint32 index_count {};   ///< The number of indices in the meshlet.
+  Vec3 center {};          ///< Center of the bounding sphere.
+  float radius {};         ///< Radius of the bounding sphere.
+  Vec3 cone_axis {};       ///< Average direction of the triangle normals.
+  float cone_cutoff {1};   ///< Sine of the normal cone spread angle, 1 disables culling.
+};
+
+/// A level of detail of a mesh, stored as a contiguous range in its index buffer.
+///
+/// \details
+/// All levels of detail of a mesh share the same vertices. The first level is always the
+/// full resolution mesh, and each subsequent level uses fewer triangles.
+struct MeshLod final {
+  uint32 index_offset {};  ///< Offset to the first index of the level.
+  uint32 index_count {};   ///< The number of indices in the level.
+  float error {};          ///< The geometric error of the level, in mesh space units.
+};
+
 struct MeshData final {
   Mat4 transform {1.0f};
-  Vector<Vertex> vertices;
-  Vector<uint32> indices;
+  Vector<Byte> vertices;  ///< Raw vertex data, see `vertex_format`.
+  VertexFormat vertex_format {VertexFormat::Float};
+  usize vertex_count {};
+  Vec3 position_offset {0};  ///< Offset used to decode quantized positions.
+  Vec3 position_scale {1};   ///< Scale used to decode quantized positions.
+  Vector<Byte> indices;      ///< Raw index data, see `index_type`.
+  IndexType index_type {IndexType::UInt32};
+  usize index_count {};
   usize material_id {};
+  Vector<Meshlet> meshlets;  ///< Optional triangle clusters, covering the first level.
+  Vector<MeshLod> lods;      ///< Optional levels of detail, ordered by decreasing detail.
+  Vec3 bounds_center {};     ///< Center of the bounding sphere.
+  float bounds_radius {};    ///< Radius of the bounding sphere.
+  float uv_density {1};      ///< Texture coordinate units per mesh space unit.
+
+  /// The model cache entry of meshes loaded from the model cache. The vertex and index
+  /// data of such meshes is viewed in place, rather than copied into the vectors.
+  Shared<const MappedFile> mapped_file;
+  std::span<const Byte> mapped_vertices;  ///< Vertex data in `mapped_file`.
+  std::span<const Byte> mapped_indices;   ///< Index data in `mapped_file`.
+
+  /// Returns the raw vertex data, regardless of whether it's owned or mapped.
+  [[nodiscard]] auto get_vertices() const noexcept -> std::span<const Byte>
+  {
+    return mapped_file ? mapped_vertices : std::span<const Byte> {vertices};
+  }
+
+  /// Returns the raw index data, regardless of whether it's owned or mapped.
+  [[nodiscard]] auto get_indices() const noexcept -> std::span<const Byte>
+  {
+    return mapped_file ? mapped_indices : std::span<const Byte> {indices};
+  }
 };
 
 struct ModelData final {
@@ -57,8 +133,100 @@ struct ModelData final {
 /// e.g. OpenGL and Vulkan uses different coordinate systems and texture coordinates,
 /// which this function will take care of.
 ///
+/// The model may be stored in an asset archive, in which case the files it refers to,
+/// e.g. textures, are expected to be stored in the same archive.
+///
 /// \param path file path to the model file.
 /// \param api the graphics API that will be used to render the model.
-[[nodiscard]] auto load_model_data(const Path& path, GraphicsAPI api) -> Maybe<ModelData>;
+/// \param options the import options, determines which optional processing is done and
+///                the vertex format of the meshes.
+[[nodiscard]] auto load_model_data(const Path& path,
+                                   GraphicsAPI api,
+                                   const ImportOptions& options) -> Maybe<ModelData>;
+
+/// Imports the meshes of a model file in batches, to reduce the peak memory usage.
+///
+/// \details
+/// The model file is read up front, but its meshes are only converted on request. The
+/// imported data of each mesh is released as soon as it has been converted, so the
+/// importer holds at most the remaining imported meshes and a single converted batch.
+/// This bypasses the model cache, since cached models are always loaded all at once.
+class ModelImporter final {
+ public:
+  /// The default amount of memory used to convert a batch of meshes, in bytes.
+  static constexpr usize kDefaultBatchSize = 32 * 1'024 * 1'024;
+
+  GLOW_DELETE_COPY(ModelImporter);
+
+  ~ModelImporter() noexcept;
+
+  ModelImporter(ModelImporter&& other) noexcept;
+
+  auto operator=(ModelImporter&& other) noexcept -> ModelImporter&;
+
+  /// Reads a model file, and loads its materials.
+  ///
+  /// \param path file path to the model file.
+  /// \param api the graphics API that will be used to render the model.
+  /// \param options the import options, see `load_model_data`.
+  ///
+  /// \return the importer, or nothing if the file could not be read.
+  [[nodiscard]] static auto open(const Path& path,
+                                 GraphicsAPI api,
+                                 const ImportOptions& options) -> Maybe<ModelImporter>;
+
+  /// Converts the next batch of meshes, in the same order as `load_model_data`.
+  ///
+  /// \param byte_budget the approximate amount of memory used to convert the batch,
+  ///                    at least one mesh is always converted.
+  ///
+  /// \return the converted meshes, which is empty if all meshes have been converted.
+  [[nodiscard]] auto import_meshes(usize byte_budget = kDefaultBatchSize)
+      -> Vector<MeshData>;
+
+  [[nodiscard]] auto has_next_mesh() const noexcept -> bool
+  {
+    return mNextMesh < mMeshRefs.size();
+  }
+
+  /// Returns the model directory and materials, the meshes are never stored here.
+  [[nodiscard]] auto get_model() const noexcept -> const ModelData& { return mModel; }
+
+  [[nodiscard]] auto get_mesh_count() const noexcept -> usize { return mMeshRefs.size(); }
+
+ private:
+  struct MeshRef final {
+    const aiNode* node {};
+    uint mesh_index {};
+  };
+
+  Unique<aiScene> mScene;
+  ModelData mModel;
+  ImportOptions mOptions;
+  Vector<MeshRef> mMeshRefs;  ///< The meshes of each node, in conversion order.
+  Vector<uint> mMeshUses;     ///< The number of unconverted references to each mesh.
+  usize mNextMesh {};         ///< Index of the next mesh reference to convert.
+
+  ModelImporter() noexcept;
+};
+
+/// Returns the resolved paths of the textures used by the renderers, without duplicates.
+///
+/// \details
+/// The paths are lexically normalized, so that textures referenced through different
+/// relative paths are only listed once.
+///
+/// \param model the model data to collect the texture paths from.
+[[nodiscard]] auto collect_texture_paths(const ModelData& model) -> Vector<Path>;
+
+/// Computes the content hash of the vertex and index data of a mesh.
+///
+/// \details
+/// Meshes with equal hashes have identical GPU buffers, so the buffers can be shared
+/// by meshes that are duplicated within or across model files.
+///
+/// \param mesh the mesh data to hash.
+/// \param seed an optional seed value, used to distinguish different buffer layouts.
+[[nodiscard]] auto hash_mesh_data(const MeshData& mesh, uint64 seed = 0) -> ContentHash;
 
 }  // namespace glow
@@ -0,0 +1,203 @@
+#include "texture_cache.hpp"
+
+#include <cstring>       // memcpy
+#include <string>        // u8string
+#include <system_error>  // error_code
+#include <type_traits>   // is_trivially_copyable_v
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "common/hash.hpp"
+#include "common/type/array.hpp"
+#include "io/files.hpp"
+#include "io/ktx2.hpp"
+
+namespace glow {
+namespace {
+
+/// Should be incremented whenever the encoded output changes.
+inline constexpr uint64 kTextureCacheVersion = 4;
+
+/// The KTX2 key of the source file version, "GLOW" prefixed as a vendor key.
+inline constexpr const char* kSourceVersionKey = "GLOWsourceVersion";
+
+[[nodiscard]] auto _get_texture_cache_dir() -> Path
+{
+  return get_persistent_file_dir() / "cache" / "textures";
+}
+
+/// Distinguishes entries of model textures from entries of HDR textures.
+enum class CacheEntryKind : uint64 {
+  Model,
+  Hdr
+};
+
+/// Identifies the state of the source file that an entry was created from.
+struct SourceVersion final {
+  uint64 size {};
+  int64 time {};
+  uint64 hash {};
+};
+
+static_assert(std::is_trivially_copyable_v<SourceVersion>);
+
+/// Entries are keyed by the source path, so modified textures replace their old entries.
+[[nodiscard]] auto _get_cache_entry_path(const FileInfo& source,
+                                         const CacheEntryKind kind,
+                                         const uint64 variant) -> Path
+{
+  const Array<uint64, 3> seed_values = {kTextureCacheVersion,
+                                        static_cast<uint64>(kind),
+                                        variant};
+  const auto seed = hash_bytes(seed_values.data(), sizeof seed_values);
+
+  const auto source_path = source.path.generic_u8string();
+  const auto key = hash_bytes(source_path.data(), source_path.size(), seed);
+
+  return _get_texture_cache_dir() / fmt::format("{:016x}.ktx2", key);
+}
+
+[[nodiscard]] auto _is_cache_entry_up_to_date(const Ktx2KeyValues& key_values,
+                                              const FileInfo& source) -> bool
+{
+  const auto iter = key_values.find(kSourceVersionKey);
+  if (iter == key_values.end() || iter->second.size() != sizeof(SourceVersion)) {
+    return false;
+  }
+
+  SourceVersion version;
+  std::memcpy(&version, iter->second.data(), sizeof version);
+
+  if (version.size != source.size) {
+    return false;
+  }
+
+  if (version.time == source.time) {
+    return true;
+  }
+
+  // The file was touched, but might still have the same content.
+  const auto source_hash = hash_file(source.path);
+  return source_hash.has_value() && source_hash->hash == version.hash;
+}
+
+[[nodiscard]] auto _load_cache_entry(const Path& path,
+                                     const CacheEntryKind kind,
+                                     const uint64 variant) -> Maybe<EncodedTexture>
+{
+  const auto source = get_file_info(path);
+  if (!source.has_value()) {
+    return kNothing;
+  }
+
+  const auto entry_path = _get_cache_entry_path(*source, kind, variant);
+
+  std::error_code error;
+  if (!fs::exists(entry_path, error)) {
+    return kNothing;
+  }
+
+  Ktx2KeyValues key_values;
+  auto texture = load_ktx2(entry_path, &key_values);
+
+  if (texture.has_value() && !_is_cache_entry_up_to_date(key_values, *source)) {
+    spdlog::debug("[IO] Texture cache entry for {} is out of date", path.string());
+    return kNothing;
+  }
+
+  if (texture.has_value()) {
+    spdlog::debug("[IO] Loaded cached {} texture {}",
+                  get_short_name(texture->format),
+                  path.string());
+  }
+
+  return texture;
+}
+
+auto _save_cache_entry(const Path& path,
+                       const CacheEntryKind kind,
+                       const uint64 variant,
+                       const EncodedTexture& texture) -> Result
+{
+  const auto source = get_file_info(path);
+  if (!source.has_value()) {
+    return kFailure;
+  }
+
+  const auto source_hash = hash_file(source->path);
+  if (!source_hash.has_value()) {
+    return kFailure;
+  }
+
+  const SourceVersion version {source->size, source->time, source_hash->hash};
+
+  Ktx2KeyValues key_values;
+  key_values.try_emplace(kSourceVersionKey,
+                         reinterpret_cast<const char*>(&version),  // NOLINT
+                         sizeof version);
+
+  std::error_code error;
+  fs::create_directories(_get_texture_cache_dir(), error);
+  if (error) {
+    spdlog::warn("[IO] Could not create texture cache directory: {}", error.message());
+    return kFailure;
+  }
+
+  // Entries are written to a temporary file first, to avoid leaving partially written
+  // entries behind if something goes wrong.
+  const auto entry_path = _get_cache_entry_path(*source, kind, variant);
+  const auto temp_path = make_temp_path(entry_path);
+
+  if (save_ktx2(temp_path, texture, key_values).failed()) {
+    spdlog::warn("[IO] Could not write texture cache entry {}", temp_path.string());
+    fs::remove(temp_path, error);
+    return kFailure;
+  }
+
+  fs::rename(temp_path, entry_path, error);
+  if (error) {
+    spdlog::warn("[IO] Could not store texture cache entry: {}", error.message());
+    fs::remove(temp_path, error);
+    return kFailure;
+  }
+
+  spdlog::debug("[IO] Stored texture cache entry {}", entry_path.string());
+  return kSuccess;
+}
+
+}  // namespace
+
+auto load_cached_texture(const Path& path, const TextureCompression compression)
+    -> Maybe<EncodedTexture>
+{
+  return _load_cache_entry(path, CacheEntryKind::Model, static_cast<uint64>(compression));
+}
+
+auto load_cached_texture(const Path& path, const PixelFormat format)
+    -> Maybe<EncodedTexture>
+{
+  return _load_cache_entry(path, CacheEntryKind::Hdr, static_cast<uint64>(format));
+}
+
+auto save_cached_texture(const Path& path,
+                         const TextureCompression compression,
+                         const EncodedTexture& texture) -> Result
+{
+  return _save_cache_entry(path,
+                           CacheEntryKind::Model,
+                           static_cast<uint64>(compression),
+                           texture);
+}
+
+auto save_cached_texture(const Path& path,
+                         const PixelFormat format,
+                         const EncodedTexture& texture) -> Result
+{
+  return _save_cache_entry(path,
+                           CacheEntryKind::Hdr,
+                           static_cast<uint64>(format),
+                           texture);
+}
+
+}  // namespace glow
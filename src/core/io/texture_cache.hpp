@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common/result.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/path.hpp"
+#include "io/texture_compression.hpp"
+
+namespace glow {
+
+/// Attempts to load an encoded texture from the persistent texture cache.
+///
+/// \details
+/// Cache entries are stored as KTX2 files, keyed by the canonical path of the source
+/// file and the compression mode. The size, modification time and content hash of the
+/// source file are stored in each entry, and entries for modified textures are ignored
+/// until they are replaced by the next save.
+///
+/// \param path the path to the source texture file.
+/// \param compression the compression mode used to encode the texture.
+///
+/// \return the cached texture, or nothing if there is no valid cache entry.
+[[nodiscard]] auto load_cached_texture(const Path& path, TextureCompression compression)
+    -> Maybe<EncodedTexture>;
+
+/// Attempts to load an HDR texture from the persistent texture cache.
+///
+/// \param path the path to the source texture file.
+/// \param format the pixel format that the texture was converted to.
+///
+/// \return the cached texture, or nothing if there is no valid cache entry.
+[[nodiscard]] auto load_cached_texture(const Path& path, PixelFormat format)
+    -> Maybe<EncodedTexture>;
+
+/// Writes an encoded texture to the persistent texture cache.
+///
+/// \param path the path to the source texture file.
+/// \param compression the compression mode used to encode the texture.
+/// \param texture the encoded texture.
+///
+/// \return success if the cache entry was written; failure otherwise.
+auto save_cached_texture(const Path& path,
+                         TextureCompression compression,
+                         const EncodedTexture& texture) -> Result;
+
+/// Writes a converted HDR texture to the persistent texture cache.
+///
+/// \param path the path to the source texture file.
+/// \param format the pixel format that the texture was converted to.
+/// \param texture the converted texture.
+///
+/// \return success if the cache entry was written; failure otherwise.
+auto save_cached_texture(const Path& path,
+                         PixelFormat format,
+                         const EncodedTexture& texture) -> Result;
+
+}  // namespace glow
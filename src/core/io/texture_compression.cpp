@@ -0,0 +1,713 @@
+#include "texture_compression.hpp"
+
+#include <algorithm>  // min, max, clamp, copy_n, fill_n
+#include <cmath>      // abs, lround, sqrt
+#include <limits>     // numeric_limits
+#include <utility>    // swap
+
+#include "common/debug/error.hpp"
+#include "common/type/array.hpp"
+#include "util/thread_pool.hpp"
+
+namespace glow {
+namespace {
+
+inline constexpr int kBlockSize = 4;
+inline constexpr usize kBlockPixelCount = 16;
+
+/// The interpolation weights used by 4-bit BC7 indices, out of 64.
+inline constexpr Array<int, 16> kBC7Weights = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64,
+};
+
+using Rgba = Array<uint8, 4>;
+using PixelBlock = Array<Rgba, kBlockPixelCount>;
+
+template <usize N>
+using Color = Array<float, N>;
+
+template <usize N>
+using ColorBlock = Array<Color<N>, kBlockPixelCount>;
+
+/// Writes values to a zero-initialized block, starting at the least significant bit.
+class BitWriter final {
+ public:
+  explicit BitWriter(Byte* data) noexcept
+      : mData {data}
+  {
+  }
+
+  void write(const uint32 value, const uint32 bit_count) noexcept
+  {
+    for (uint32 bit = 0; bit < bit_count; ++bit, ++mOffset) {
+      if ((value >> bit) & 1u) {
+        mData[mOffset / 8] |= static_cast<Byte>(1u << (mOffset % 8));
+      }
+    }
+  }
+
+ private:
+  Byte* mData {};
+  usize mOffset {};
+};
+
+void _write_uint16(Byte* data, const uint16 value) noexcept
+{
+  data[0] = static_cast<Byte>(value & 0xFFu);
+  data[1] = static_cast<Byte>(value >> 8u);
+}
+
+/// Copies the pixels of a 4x4 block, repeating edge pixels outside of the image.
+void _fetch_block(const uint8* pixels,
+                  const Vec2i& size,
+                  const int block_x,
+                  const int block_y,
+                  PixelBlock& block) noexcept
+{
+  for (int y = 0; y < kBlockSize; ++y) {
+    const auto row = std::min(block_y * kBlockSize + y, size.y - 1);
+
+    for (int x = 0; x < kBlockSize; ++x) {
+      const auto col = std::min(block_x * kBlockSize + x, size.x - 1);
+      const auto src = (static_cast<usize>(row) * static_cast<usize>(size.x) +
+                        static_cast<usize>(col)) *
+                       4;
+
+      std::copy_n(pixels + src, 4, block[static_cast<usize>(y * kBlockSize + x)].data());
+    }
+  }
+}
+
+/// Finds the endpoints of the line segment that best fits a set of colors.
+///
+/// \details
+/// The line is aligned with the principal axis of the colors, which is approximated
+/// using power iteration on the covariance matrix.
+template <usize N>
+void _find_endpoints(const ColorBlock<N>& colors, Color<N>& low, Color<N>& high) noexcept
+{
+  Color<N> mean {};
+  Color<N> min = colors[0];
+  Color<N> max = colors[0];
+
+  for (const auto& color : colors) {
+    for (usize c = 0; c < N; ++c) {
+      mean[c] += color[c] / static_cast<float>(kBlockPixelCount);
+      min[c] = std::min(min[c], color[c]);
+      max[c] = std::max(max[c], color[c]);
+    }
+  }
+
+  Array<Color<N>, N> covariance {};
+  for (const auto& color : colors) {
+    for (usize row = 0; row < N; ++row) {
+      for (usize col = 0; col < N; ++col) {
+        covariance[row][col] += (color[row] - mean[row]) * (color[col] - mean[col]);
+      }
+    }
+  }
+
+  // The diagonal of the bounding box is a good initial guess of the principal axis.
+  Color<N> axis {};
+  for (usize c = 0; c < N; ++c) {
+    axis[c] = max[c] - min[c];
+  }
+
+  for (int iteration = 0; iteration < 8; ++iteration) {
+    Color<N> next {};
+    float length_sq = 0;
+
+    for (usize row = 0; row < N; ++row) {
+      for (usize col = 0; col < N; ++col) {
+        next[row] += covariance[row][col] * axis[col];
+      }
+
+      length_sq += next[row] * next[row];
+    }
+
+    if (length_sq < 1e-6f) {
+      break;
+    }
+
+    const auto inv_length = 1.0f / std::sqrt(length_sq);
+    for (usize c = 0; c < N; ++c) {
+      axis[c] = next[c] * inv_length;
+    }
+  }
+
+  float axis_length_sq = 0;
+  for (usize c = 0; c < N; ++c) {
+    axis_length_sq += axis[c] * axis[c];
+  }
+
+  // Uniform blocks (or blocks with a degenerate axis) are represented by their mean.
+  if (axis_length_sq < 1e-6f) {
+    low = mean;
+    high = mean;
+    return;
+  }
+
+  float min_t = 0;
+  float max_t = 0;
+  for (const auto& color : colors) {
+    float t = 0;
+    for (usize c = 0; c < N; ++c) {
+      t += (color[c] - mean[c]) * axis[c];
+    }
+
+    min_t = std::min(min_t, t);
+    max_t = std::max(max_t, t);
+  }
+
+  min_t /= axis_length_sq;
+  max_t /= axis_length_sq;
+
+  for (usize c = 0; c < N; ++c) {
+    low[c] = std::clamp(mean[c] + axis[c] * min_t, 0.0f, 255.0f);
+    high[c] = std::clamp(mean[c] + axis[c] * max_t, 0.0f, 255.0f);
+  }
+}
+
+/// Computes the endpoints that minimize the squared error for a fixed set of weights.
+///
+/// \param colors the block colors.
+/// \param weights the interpolation weight of the second endpoint for each color.
+/// \param first the output first endpoint.
+/// \param second the output second endpoint.
+///
+/// \return true if the endpoints were updated; false if the system is singular.
+template <usize N>
+[[nodiscard]] auto _fit_endpoints(const ColorBlock<N>& colors,
+                                  const Array<float, kBlockPixelCount>& weights,
+                                  Color<N>& first,
+                                  Color<N>& second) noexcept -> bool
+{
+  float aa = 0;
+  float bb = 0;
+  float ab = 0;
+  Color<N> ax {};
+  Color<N> bx {};
+
+  for (usize index = 0; index < kBlockPixelCount; ++index) {
+    const auto b = weights[index];
+    const auto a = 1.0f - b;
+
+    aa += a * a;
+    bb += b * b;
+    ab += a * b;
+
+    for (usize c = 0; c < N; ++c) {
+      ax[c] += a * colors[index][c];
+      bx[c] += b * colors[index][c];
+    }
+  }
+
+  const auto det = aa * bb - ab * ab;
+  if (std::abs(det) < 1e-6f) {
+    return false;
+  }
+
+  const auto inv_det = 1.0f / det;
+  for (usize c = 0; c < N; ++c) {
+    first[c] = std::clamp((ax[c] * bb - bx[c] * ab) * inv_det, 0.0f, 255.0f);
+    second[c] = std::clamp((bx[c] * aa - ax[c] * ab) * inv_det, 0.0f, 255.0f);
+  }
+
+  return true;
+}
+
+/// Selects the closest palette entry for each color, and returns the total error.
+template <usize N, usize PaletteSize>
+[[nodiscard]] auto _select_indices(const ColorBlock<N>& colors,
+                                   const Array<Color<N>, PaletteSize>& palette,
+                                   Array<uint8, kBlockPixelCount>& indices) noexcept
+    -> float
+{
+  float total_error = 0;
+
+  for (usize index = 0; index < kBlockPixelCount; ++index) {
+    auto best_error = std::numeric_limits<float>::max();
+
+    for (usize entry = 0; entry < PaletteSize; ++entry) {
+      float error = 0;
+      for (usize c = 0; c < N; ++c) {
+        const auto diff = colors[index][c] - palette[entry][c];
+        error += diff * diff;
+      }
+
+      if (error < best_error) {
+        best_error = error;
+        indices[index] = static_cast<uint8>(entry);
+      }
+    }
+
+    total_error += best_error;
+  }
+
+  return total_error;
+}
+
+[[nodiscard]] auto _to_rgb565(const Color<3>& color) noexcept -> uint16
+{
+  const auto r = static_cast<uint32>(std::lround(color[0] * (31.0f / 255.0f)));
+  const auto g = static_cast<uint32>(std::lround(color[1] * (63.0f / 255.0f)));
+  const auto b = static_cast<uint32>(std::lround(color[2] * (31.0f / 255.0f)));
+  return static_cast<uint16>((r << 11u) | (g << 5u) | b);
+}
+
+[[nodiscard]] auto _from_rgb565(const uint16 value) noexcept -> Color<3>
+{
+  const auto r = (value >> 11u) & 0x1Fu;
+  const auto g = (value >> 5u) & 0x3Fu;
+  const auto b = value & 0x1Fu;
+  return {static_cast<float>((r << 3u) | (r >> 2u)),
+          static_cast<float>((g << 2u) | (g >> 4u)),
+          static_cast<float>((b << 3u) | (b >> 2u))};
+}
+
+/// Encodes the color of a block as a BC1 block, always using the four color mode.
+void _encode_bc1_block(const PixelBlock& block, Byte* output) noexcept
+{
+  // The weights of the second endpoint for each (four color mode) index.
+  constexpr Array<float, 4> kWeights = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+  ColorBlock<3> colors;
+  for (usize index = 0; index < kBlockPixelCount; ++index) {
+    for (usize c = 0; c < 3; ++c) {
+      colors[index][c] = static_cast<float>(block[index][c]);
+    }
+  }
+
+  Color<3> low;
+  Color<3> high;
+  _find_endpoints(colors, low, high);
+
+  auto best_error = std::numeric_limits<float>::max();
+  uint16 best_color0 = 0;
+  uint16 best_color1 = 0;
+  Array<uint8, kBlockPixelCount> best_indices {};
+
+  // The initial endpoints are refined once using the selected indices.
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    auto color0 = _to_rgb565(high);
+    auto color1 = _to_rgb565(low);
+
+    // The four color mode is only used if the first endpoint is the larger value.
+    if (color0 < color1) {
+      std::swap(color0, color1);
+    }
+
+    Array<uint8, kBlockPixelCount> indices {};
+    float error = 0;
+
+    if (color0 == color1) {
+      const auto color = _from_rgb565(color0);
+      for (const auto& pixel : colors) {
+        for (usize c = 0; c < 3; ++c) {
+          error += (pixel[c] - color[c]) * (pixel[c] - color[c]);
+        }
+      }
+    }
+    else {
+      const auto c0 = _from_rgb565(color0);
+      const auto c1 = _from_rgb565(color1);
+
+      Array<Color<3>, 4> palette;
+      for (usize entry = 0; entry < 4; ++entry) {
+        for (usize c = 0; c < 3; ++c) {
+          palette[entry][c] = c0[c] + (c1[c] - c0[c]) * kWeights[entry];
+        }
+      }
+
+      error = _select_indices(colors, palette, indices);
+    }
+
+    if (error < best_error) {
+      best_error = error;
+      best_color0 = color0;
+      best_color1 = color1;
+      best_indices = indices;
+    }
+
+    if (color0 == color1) {
+      break;
+    }
+
+    Array<float, kBlockPixelCount> weights;
+    for (usize index = 0; index < kBlockPixelCount; ++index) {
+      weights[index] = kWeights[indices[index]];
+    }
+
+    if (!_fit_endpoints(colors, weights, high, low)) {
+      break;
+    }
+  }
+
+  uint32 index_bits = 0;
+  for (usize index = 0; index < kBlockPixelCount; ++index) {
+    index_bits |= static_cast<uint32>(best_indices[index]) << (index * 2);
+  }
+
+  _write_uint16(output, best_color0);
+  _write_uint16(output + 2, best_color1);
+  _write_uint16(output + 4, static_cast<uint16>(index_bits & 0xFFFFu));
+  _write_uint16(output + 6, static_cast<uint16>(index_bits >> 16u));
+}
+
+/// Encodes a single channel of a block as a BC4 block, using the eight value mode.
+void _encode_bc4_block(const PixelBlock& block,
+                       const usize channel,
+                       Byte* output) noexcept
+{
+  uint8 min = 255;
+  uint8 max = 0;
+  for (const auto& pixel : block) {
+    min = std::min(min, pixel[channel]);
+    max = std::max(max, pixel[channel]);
+  }
+
+  output[0] = static_cast<Byte>(max);
+  output[1] = static_cast<Byte>(min);
+
+  uint64 index_bits = 0;
+
+  if (max != min) {
+    const auto range = static_cast<float>(max - min);
+
+    for (usize index = 0; index < kBlockPixelCount; ++index) {
+      // The position of the value between the endpoints, where 7 is the first endpoint.
+      const auto t = static_cast<float>(block[index][channel] - min) * 7.0f / range;
+      const auto position = static_cast<uint64>(std::lround(t));
+
+      uint64 value_index = 8 - position;
+      if (position == 7) {
+        value_index = 0;
+      }
+      else if (position == 0) {
+        value_index = 1;
+      }
+
+      index_bits |= value_index << (index * 3);
+    }
+  }
+
+  for (usize byte = 0; byte < 6; ++byte) {
+    output[2 + byte] = static_cast<Byte>((index_bits >> (byte * 8)) & 0xFFu);
+  }
+}
+
+/// Quantizes a BC7 mode 6 endpoint, selecting the shared bit with the smallest error.
+void _quantize_bc7_endpoint(const Color<4>& endpoint,
+                            Array<uint32, 4>& quantized,
+                            uint32& p_bit) noexcept
+{
+  auto best_error = std::numeric_limits<float>::max();
+
+  for (uint32 p = 0; p < 2; ++p) {
+    Array<uint32, 4> candidate;
+    float error = 0;
+
+    for (usize c = 0; c < 4; ++c) {
+      const auto q = std::clamp(std::lround((endpoint[c] - static_cast<float>(p)) * 0.5f),
+                                0L,
+                                127L);
+      candidate[c] = static_cast<uint32>(q);
+
+      const auto diff = endpoint[c] - static_cast<float>((candidate[c] << 1u) | p);
+      error += diff * diff;
+    }
+
+    if (error < best_error) {
+      best_error = error;
+      quantized = candidate;
+      p_bit = p;
+    }
+  }
+}
+
+/// Encodes a block as a BC7 block, using mode 6 (a single RGBA subset).
+void _encode_bc7_block(const PixelBlock& block, Byte* output) noexcept
+{
+  ColorBlock<4> colors;
+  for (usize index = 0; index < kBlockPixelCount; ++index) {
+    for (usize c = 0; c < 4; ++c) {
+      colors[index][c] = static_cast<float>(block[index][c]);
+    }
+  }
+
+  Color<4> first;
+  Color<4> second;
+  _find_endpoints(colors, first, second);
+
+  auto best_error = std::numeric_limits<float>::max();
+  Array<Array<uint32, 4>, 2> best_endpoints {};
+  Array<uint32, 2> best_p_bits {};
+  Array<uint8, kBlockPixelCount> best_indices {};
+
+  for (int iteration = 0; iteration < 2; ++iteration) {
+    Array<Array<uint32, 4>, 2> endpoints;
+    Array<uint32, 2> p_bits;
+    _quantize_bc7_endpoint(first, endpoints[0], p_bits[0]);
+    _quantize_bc7_endpoint(second, endpoints[1], p_bits[1]);
+
+    Array<Color<4>, 16> palette;
+    for (usize entry = 0; entry < 16; ++entry) {
+      for (usize c = 0; c < 4; ++c) {
+        const auto e0 = static_cast<int>((endpoints[0][c] << 1u) | p_bits[0]);
+        const auto e1 = static_cast<int>((endpoints[1][c] << 1u) | p_bits[1]);
+        const auto weight = kBC7Weights[entry];
+        const auto value = ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+        palette[entry][c] = static_cast<float>(value);
+      }
+    }
+
+    Array<uint8, kBlockPixelCount> indices {};
+    const auto error = _select_indices(colors, palette, indices);
+
+    if (error < best_error) {
+      best_error = error;
+      best_endpoints = endpoints;
+      best_p_bits = p_bits;
+      best_indices = indices;
+    }
+
+    Array<float, kBlockPixelCount> weights;
+    for (usize index = 0; index < kBlockPixelCount; ++index) {
+      weights[index] = static_cast<float>(kBC7Weights[indices[index]]) / 64.0f;
+    }
+
+    if (!_fit_endpoints(colors, weights, first, second)) {
+      break;
+    }
+  }
+
+  // The most significant bit of the first index is implicitly zero.
+  if (best_indices[0] >= 8) {
+    std::swap(best_endpoints[0], best_endpoints[1]);
+    std::swap(best_p_bits[0], best_p_bits[1]);
+
+    for (auto& index : best_indices) {
+      index = static_cast<uint8>(15 - index);
+    }
+  }
+
+  std::fill_n(output, 16, Byte {0});
+
+  BitWriter writer {output};
+  writer.write(1u << 6u, 7);
+
+  for (usize c = 0; c < 4; ++c) {
+    writer.write(best_endpoints[0][c], 7);
+    writer.write(best_endpoints[1][c], 7);
+  }
+
+  writer.write(best_p_bits[0], 1);
+  writer.write(best_p_bits[1], 1);
+
+  for (usize index = 0; index < kBlockPixelCount; ++index) {
+    writer.write(best_indices[index], (index == 0) ? 3 : 4);
+  }
+}
+
+void _encode_block(const PixelBlock& block, const PixelFormat format, Byte* output)
+{
+  switch (format) {
+    case PixelFormat::BC1:
+      _encode_bc1_block(block, output);
+      break;
+
+    case PixelFormat::BC3:
+      _encode_bc4_block(block, 3, output);
+      _encode_bc1_block(block, output + 8);
+      break;
+
+    case PixelFormat::BC5:
+      _encode_bc4_block(block, 0, output);
+      _encode_bc4_block(block, 1, output + 8);
+      break;
+
+    case PixelFormat::BC7:
+      _encode_bc7_block(block, output);
+      break;
+
+    default:
+      throw Error {"Invalid block compressed pixel format"};
+  }
+}
+
+}  // namespace
+
+auto get_image_byte_size(const PixelFormat format, const Vec2i& size) noexcept -> usize
+{
+  const auto width = static_cast<usize>(size.x);
+  const auto height = static_cast<usize>(size.y);
+
+  if (is_block_compressed(format)) {
+    const auto block_count_x = (width + 3) / 4;
+    const auto block_count_y = (height + 3) / 4;
+    return block_count_x * block_count_y * get_block_byte_size(format);
+  }
+
+  return width * height * get_block_byte_size(format);
+}
+
+auto select_pixel_format(const TextureCompression compression, const bool has_alpha)
+    -> PixelFormat
+{
+  switch (compression) {
+    case TextureCompression::None:
+      return PixelFormat::RGBA8;
+
+    case TextureCompression::Fast:
+      return has_alpha ? PixelFormat::BC3 : PixelFormat::BC1;
+
+    case TextureCompression::High:
+      return PixelFormat::BC7;
+
+    default:
+      throw Error {"Unknown texture compression enumerator"};
+  }
+}
+
+auto has_transparent_pixels(const TextureData& texture) -> bool
+{
+  const auto pixel_count =
+      static_cast<usize>(texture.size.x) * static_cast<usize>(texture.size.y);
+
+  for (usize index = 0; index < pixel_count; ++index) {
+    if (texture.pixels.get()[index * 4 + 3] != 255) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+auto encode_texture(const TextureData& texture,
+                    const PixelFormat format,
+                    const MipChainOptions& mip_options) -> EncodedTexture
+{
+  EncodedTexture result;
+  result.format = format;
+  result.size = texture.size;
+
+  const auto mips = generate_mip_chain(texture.pixels.get(), texture.size, mip_options);
+  const auto level_count = mips.size() + 1;
+
+  // The base level is read directly from the source pixels.
+  Vector<const uint8*> level_pixels;
+  level_pixels.reserve(level_count);
+  level_pixels.push_back(texture.pixels.get());
+
+  for (const auto& mip : mips) {
+    level_pixels.push_back(mip.data());
+  }
+
+  usize data_size = 0;
+  result.levels.reserve(level_count);
+
+  for (usize level = 0; level < level_count; ++level) {
+    const auto level_size = get_mip_level_size(texture.size, level);
+    const auto byte_size = get_image_byte_size(format, level_size);
+
+    result.levels.push_back(TextureLevel {level_size, data_size, byte_size});
+    data_size += byte_size;
+  }
+
+  result.data.resize(data_size);
+
+  if (!is_block_compressed(format)) {
+    for (usize level = 0; level < level_count; ++level) {
+      const auto& info = result.levels[level];
+      const auto* bytes = reinterpret_cast<const Byte*>(level_pixels[level]);  // NOLINT
+      std::copy_n(bytes, info.byte_size, result.data.data() + info.offset);
+    }
+
+    return result;
+  }
+
+  // Each task encodes a row of blocks, which are written to disjoint output ranges.
+  struct BlockRow final {
+    usize level {};
+    int y {};
+  };
+
+  Vector<BlockRow> block_rows;
+  for (usize level = 0; level < level_count; ++level) {
+    const auto block_count_y = (result.levels[level].size.y + 3) / 4;
+    for (int y = 0; y < block_count_y; ++y) {
+      block_rows.push_back(BlockRow {level, y});
+    }
+  }
+
+  const auto block_byte_size = get_block_byte_size(format);
+
+  get_thread_pool().parallel_for(block_rows.size(), [&](const usize row_index) {
+    const auto& row = block_rows[row_index];
+    const auto& level = result.levels[row.level];
+
+    const auto block_count_x = (level.size.x + 3) / 4;
+    const auto row_offset = level.offset + static_cast<usize>(row.y) *
+                                               static_cast<usize>(block_count_x) *
+                                               block_byte_size;
+
+    PixelBlock block;
+    for (int x = 0; x < block_count_x; ++x) {
+      _fetch_block(level_pixels[row.level], level.size, x, row.y, block);
+      _encode_block(block,
+                    format,
+                    result.data.data() + row_offset +
+                        static_cast<usize>(x) * block_byte_size);
+    }
+  });
+
+  return result;
+}
+
+auto get_short_name(const TextureCompression compression) -> StringView
+{
+  switch (compression) {
+    case TextureCompression::None:
+      return "None";
+
+    case TextureCompression::Fast:
+      return "Fast";
+
+    case TextureCompression::High:
+      return "High";
+
+    default:
+      throw Error {"Unknown texture compression enumerator"};
+  }
+}
+
+auto get_short_name(const PixelFormat format) -> StringView
+{
+  switch (format) {
+    case PixelFormat::RGBA8:
+      return "RGBA8";
+
+    case PixelFormat::BC1:
+      return "BC1";
+
+    case PixelFormat::BC3:
+      return "BC3";
+
+    case PixelFormat::BC5:
+      return "BC5";
+
+    case PixelFormat::BC7:
+      return "BC7";
+
+    case PixelFormat::RGB9E5:
+      return "RGB9E5";
+
+    case PixelFormat::RGBA16F:
+      return "RGBA16F";
+
+    default:
+      throw Error {"Unknown pixel format enumerator"};
+  }
+}
+
+}  // namespace glow
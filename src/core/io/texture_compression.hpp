@@ -0,0 +1,137 @@
+#pragma once
+
+#include "common/primitives.hpp"
+#include "common/type/math.hpp"
+#include "common/type/string.hpp"
+#include "common/type/vector.hpp"
+#include "io/mip_chain.hpp"
+#include "io/texture_loader.hpp"
+
+namespace glow {
+
+/// Determines whether (and how) textures are block compressed when they are imported.
+enum class TextureCompression : uint8 {
+  None,  ///< Textures are uploaded as uncompressed RGBA8 data.
+  Fast,  ///< Textures are encoded as BC1, or BC3 if they have an alpha channel.
+  High   ///< Textures are encoded as BC7, which is slower but looks much better.
+};
+
+/// The pixel formats used by encoded textures.
+enum class PixelFormat : uint8 {
+  RGBA8,   ///< Uncompressed 8-bit RGBA.
+  BC1,     ///< 4 bits per pixel RGB.
+  BC3,     ///< 8 bits per pixel RGBA, i.e. BC1 color with a separate alpha block.
+  BC5,     ///< 8 bits per pixel with two independent channels, for normal maps.
+  BC7,     ///< 8 bits per pixel high quality RGBA.
+  RGB9E5,  ///< 32 bits per pixel HDR RGB, with 9-bit mantissas and a shared exponent.
+  RGBA16F  ///< 64 bits per pixel HDR RGBA, using half precision floats.
+};
+
+/// Describes a single mip level of an encoded texture.
+struct TextureLevel final {
+  Vec2i size {};       ///< The size of the level, in pixels.
+  usize offset {};     ///< The offset of the level data, in bytes.
+  usize byte_size {};  ///< The size of the level data of all faces, in bytes.
+};
+
+/// A texture that is stored in a format that can be uploaded directly to the GPU.
+///
+/// \details
+/// The levels are stored in order, starting with the full resolution image, and always
+/// form a complete mip chain. As a result, textures can be uploaded using a single copy
+/// per level (or face), without generating any mip levels on the GPU. Cubemaps store
+/// the six faces of each level consecutively, in the order +X, -X, +Y, -Y, +Z, -Z.
+struct EncodedTexture final {
+  PixelFormat format {PixelFormat::RGBA8};  ///< The format of the pixel data.
+  Vec2i size {};                            ///< The size of the base level, in pixels.
+  Vector<TextureLevel> levels;              ///< The stored mip levels.
+  Vector<Byte> data;                        ///< The pixel data of all levels.
+  usize face_count {1};                     ///< 1 for 2D textures, 6 for cubemaps.
+
+  [[nodiscard]] auto get_level_data(const usize level) const -> const Byte*
+  {
+    return data.data() + levels.at(level).offset;
+  }
+
+  [[nodiscard]] auto get_face_data(const usize level, const usize face) const
+      -> const Byte*
+  {
+    return get_level_data(level) + face * (levels.at(level).byte_size / face_count);
+  }
+};
+
+/// Indicates whether a pixel format uses 4x4 pixel blocks.
+[[nodiscard]] constexpr auto is_block_compressed(const PixelFormat format) noexcept
+    -> bool
+{
+  switch (format) {
+    case PixelFormat::BC1:
+    case PixelFormat::BC3:
+    case PixelFormat::BC5:
+    case PixelFormat::BC7:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+/// Returns the size of a single 4x4 block (or pixel, for uncompressed formats), in bytes.
+[[nodiscard]] constexpr auto get_block_byte_size(const PixelFormat format) noexcept
+    -> usize
+{
+  switch (format) {
+    case PixelFormat::BC1:
+      return 8;
+
+    case PixelFormat::BC3:
+    case PixelFormat::BC5:
+    case PixelFormat::BC7:
+      return 16;
+
+    case PixelFormat::RGBA16F:
+      return 8;
+
+    default:
+      return 4;
+  }
+}
+
+/// Returns the size of an image with the specified pixel format and size, in bytes.
+[[nodiscard]] auto get_image_byte_size(PixelFormat format, const Vec2i& size) noexcept
+    -> usize;
+
+/// Returns the pixel format used by a compression mode.
+///
+/// \param compression the compression mode.
+/// \param has_alpha whether the texture has non-opaque pixels.
+[[nodiscard]] auto select_pixel_format(TextureCompression compression, bool has_alpha)
+    -> PixelFormat;
+
+/// Indicates whether any pixels of an RGBA8 image are not fully opaque.
+[[nodiscard]] auto has_transparent_pixels(const TextureData& texture) -> bool;
+
+/// Encodes an RGBA8 image and its mip chain using the specified pixel format.
+///
+/// \details
+/// The mip chain is generated on the CPU, see `generate_mip_chain`. Blocks are encoded
+/// in parallel using the shared thread pool. Edge blocks of images with sizes that
+/// aren't multiples of four are padded by repeating the edge pixels. The BC5 format
+/// encodes the red and green channels, which is the usual layout of tangent space
+/// normal maps.
+///
+/// \param texture the source image, which must provide four channels.
+/// \param format the desired pixel format.
+/// \param mip_options the options used to generate the mip chain.
+///
+/// \return the encoded texture.
+[[nodiscard]] auto encode_texture(const TextureData& texture,
+                                  PixelFormat format,
+                                  const MipChainOptions& mip_options = {})
+    -> EncodedTexture;
+
+[[nodiscard]] auto get_short_name(TextureCompression compression) -> StringView;
+
+[[nodiscard]] auto get_short_name(PixelFormat format) -> StringView;
+
+}  // namespace glow
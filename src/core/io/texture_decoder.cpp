@@ -0,0 +1,194 @@
+#include "texture_decoder.hpp"
+
+#include <exception>  // exception
+#include <utility>    // move
+
+#include <fmt/chrono.h>
+#include <spdlog/spdlog.h>
+
+#include "common/type/chrono.hpp"
+#include "io/files.hpp"
+#include "io/texture_cache.hpp"
+#include "io/texture_loader.hpp"
+#include "util/thread_pool.hpp"
+
+namespace glow {
+namespace {
+
+/// The alpha test threshold used when preserving the alpha coverage of mip levels.
+inline constexpr float kAlphaCutoff = 0.5f;
+
+[[nodiscard]] auto _load_texture(const Path& path, const TextureCompression compression)
+    -> Maybe<EncodedTexture>
+{
+  if (auto texture = load_cached_texture(path, compression)) {
+    return texture;
+  }
+
+  const auto data = load_texture_data(path, TextureFormat::Byte, TextureChannels::RGBA);
+  if (!data.has_value()) {
+    return kNothing;
+  }
+
+  const auto start_time = Clock::now();
+
+  const auto has_alpha = has_transparent_pixels(*data);
+  const auto format = select_pixel_format(compression, has_alpha);
+
+  MipChainOptions mip_options;
+  if (has_alpha) {
+    mip_options.alpha_cutoff = kAlphaCutoff;
+  }
+
+  auto texture = encode_texture(*data, format, mip_options);
+
+  usize uncompressed_size = 0;
+  for (const auto& level : texture.levels) {
+    uncompressed_size += get_image_byte_size(PixelFormat::RGBA8, level.size);
+  }
+
+  const auto end_time = Clock::now();
+  spdlog::debug("[IO] Encoded texture as {} with {} mips in {} ({} KiB, {:.1f}x smaller)",
+                get_short_name(format),
+                texture.levels.size(),
+                chrono::duration_cast<Milliseconds>(end_time - start_time),
+                texture.data.size() / 1024,
+                static_cast<double>(uncompressed_size) /
+                    static_cast<double>(texture.data.size()));
+
+  if (save_cached_texture(path, compression, texture).failed()) {
+    spdlog::warn("[IO] Could not cache encoded texture {}", path.string());
+  }
+
+  return texture;
+}
+
+}  // namespace
+
+auto TextureDecoder::decode(const Vector<Path>& paths,
+                            const TextureCompression compression) -> TextureMap
+{
+  const auto start_time = Clock::now();
+
+  // Duplicated files can only be detected by their contents, so all files are hashed
+  Vector<Maybe<ContentHash>> contents(paths.size());
+  get_thread_pool().parallel_for(paths.size(), [&](const usize index) {
+    contents[index] = hash_file(paths[index]);
+  });
+
+  struct OwnedRequest final {
+    RequestKey key;
+    Path path;
+    std::promise<SharedTexture> promise;
+  };
+
+  struct RequestedTexture final {
+    Path path;
+    ContentHash content;
+    SharedTexture texture;  ///< Only set if the texture was already decoded.
+    std::shared_future<SharedTexture> future;
+  };
+
+  Vector<OwnedRequest> owned_requests;
+  Vector<RequestedTexture> requested_textures;
+  requested_textures.reserve(paths.size());
+
+  {
+    const std::lock_guard lock {mMutex};
+
+    for (usize index = 0; index < paths.size(); ++index) {
+      const auto& path = paths[index];
+      const auto& content = contents[index];
+
+      if (!content.has_value()) {
+        spdlog::error("[IO] Could not read texture file {}", path.string());
+        continue;
+      }
+
+      RequestKey key {*content, compression};
+
+      if (const auto iter = mDecodedTextures.find(key); iter != mDecodedTextures.end()) {
+        if (auto texture = iter->second.lock()) {
+          requested_textures.push_back({path, *content, std::move(texture), {}});
+          continue;
+        }
+
+        mDecodedTextures.erase(iter);
+      }
+
+      if (const auto iter = mPendingRequests.find(key); iter != mPendingRequests.end()) {
+        requested_textures.push_back({path, *content, nullptr, iter->second});
+      }
+      else {
+        auto& request = owned_requests.emplace_back(std::move(key), path);
+        auto future = request.promise.get_future().share();
+
+        mPendingRequests.try_emplace(request.key, future);
+        requested_textures.push_back({path, *content, nullptr, std::move(future)});
+      }
+    }
+  }
+
+  // We always decode our own requests before waiting for requests owned by other
+  // threads, which means that two threads can never end up waiting for each other.
+  get_thread_pool().parallel_for(owned_requests.size(), [&](const usize index) {
+    auto& request = owned_requests[index];
+
+    // Failures must still complete the request, or later requests for the same
+    // texture would wait on it forever
+    SharedTexture texture;
+    try {
+      if (auto data = _load_texture(request.path, compression)) {
+        texture = std::make_shared<const EncodedTexture>(std::move(*data));
+      }
+    }
+    catch (const std::exception& e) {
+      spdlog::error("[IO] Could not decode texture {}: {}",
+                    request.path.string(),
+                    e.what());
+    }
+    catch (...) {
+      spdlog::error("[IO] Could not decode texture {}", request.path.string());
+    }
+
+    request.promise.set_value(texture);
+
+    const std::lock_guard lock {mMutex};
+    mPendingRequests.erase(request.key);
+
+    if (texture) {
+      mDecodedTextures.insert_or_assign(request.key, texture);
+    }
+  });
+
+  TextureMap textures;
+  usize texture_memory = 0;
+
+  for (auto& [path, content, texture, future] : requested_textures) {
+    if (!texture) {
+      texture = future.get();
+    }
+
+    if (texture) {
+      texture_memory += texture->data.size();
+      textures.try_emplace(path, DecodedTexture {content, std::move(texture)});
+    }
+  }
+
+  const auto end_time = Clock::now();
+  spdlog::debug("[IO] Decoded {} textures ({} MiB) in {} ({} shared by content)",
+                textures.size(),
+                texture_memory / (1024 * 1024),
+                chrono::duration_cast<Milliseconds>(end_time - start_time),
+                requested_textures.size() - owned_requests.size());
+
+  return textures;
+}
+
+auto get_texture_decoder() -> TextureDecoder&
+{
+  static TextureDecoder decoder;
+  return decoder;
+}
+
+}  // namespace glow
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <future>  // promise, shared_future
+#include <mutex>   // mutex
+
+#include "common/hash.hpp"
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/map.hpp"
+#include "common/type/memory.hpp"
+#include "common/type/pair.hpp"
+#include "common/type/path.hpp"
+#include "common/type/vector.hpp"
+#include "io/texture_compression.hpp"
+
+namespace glow {
+
+using SharedTexture = Shared<const EncodedTexture>;
+
+/// A decoded texture, along with the content hash of its source file.
+struct DecodedTexture final {
+  ContentHash content;    ///< Identifies the texture by the contents of its file.
+  SharedTexture texture;  ///< The decoded texture.
+};
+
+using TextureMap = Map<Path, DecodedTexture>;
+
+/// Decodes textures concurrently using the shared thread pool.
+///
+/// \details
+/// Textures are identified by the contents of their files rather than by their paths,
+/// so that files that are referenced through different paths, or that are copied into
+/// several model directories, are only decoded once. Requests for a texture that is
+/// already being decoded (with the same compression) are coalesced, even if they are
+/// made by several models that are loaded at the same time.
+///
+/// Decoded textures are not retained by the decoder, the texture streamer keeps them
+/// to upload mip levels on demand. However, the decoder keeps track of the textures
+/// that are still alive, so that they can be reused by subsequent requests.
+///
+/// Textures are stored in the persistent texture cache after they have been encoded,
+/// along with their complete mip chains, so that subsequent runs can skip decoding,
+/// mip generation and encoding altogether.
+///
+/// \note This class is thread-safe.
+class TextureDecoder final {
+ public:
+  GLOW_DELETE_COPY(TextureDecoder);
+  GLOW_DELETE_MOVE(TextureDecoder);
+
+  TextureDecoder() = default;
+
+  /// Decodes a batch of textures, and waits until all of them are available.
+  ///
+  /// \details
+  /// The calling thread participates in the decoding, so this function may be called
+  /// from worker threads.
+  ///
+  /// \param paths the paths of the textures to decode.
+  /// \param compression the block compression used for the decoded textures.
+  ///
+  /// \return the decoded textures, textures that couldn't be decoded are omitted.
+  [[nodiscard]] auto decode(const Vector<Path>& paths, TextureCompression compression)
+      -> TextureMap;
+
+ private:
+  struct RequestKey final {
+    ContentHash content;
+    TextureCompression compression {};
+
+    [[nodiscard]] auto operator<=>(const RequestKey&) const = default;
+  };
+
+  std::mutex mMutex;
+  Map<RequestKey, std::shared_future<SharedTexture>> mPendingRequests;
+  Map<RequestKey, Weak<const EncodedTexture>> mDecodedTextures;
+};
+
+/// Returns the shared texture decoder.
+[[nodiscard]] auto get_texture_decoder() -> TextureDecoder&;
+
+}  // namespace glow
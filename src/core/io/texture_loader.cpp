@@ -2,11 +2,14 @@
 
 #define STB_IMAGE_IMPLEMENTATION
 
+#include <limits>  // numeric_limits
+
 #include <fmt/std.h>
 #include <spdlog/spdlog.h>
 #include <stb_image.h>
 
 #include "common/debug/error.hpp"
+#include "io/mapped_file.hpp"
 
 namespace glow {
 namespace {
@@ -42,27 +45,44 @@ auto load_texture_data(const Path& path,
                        const TextureFormat format,
                        const TextureChannels channels) -> Maybe<TextureData>
 {
-  const auto path_str = path.string();
   spdlog::info("[IO] Loading texture {}", path);
 
-  stbi_set_flip_vertically_on_load(true);
+  // The file is read through a mapped file, which also handles files in asset archives
+  const auto file = MappedFile::open(path);
+  if (!file.has_value()) {
+    spdlog::error("[IO] Failed to read texture file {}", path);
+    return kNothing;
+  }
+
+  if (file->size() > static_cast<usize>(std::numeric_limits<int>::max())) {
+    spdlog::error("[IO] Texture file {} is too large", path);
+    return kNothing;
+  }
+
+  const auto* file_data = reinterpret_cast<const stbi_uc*>(file->data());  // NOLINT
+  const auto file_size = static_cast<int>(file->size());
+
+  // The flip flag is thread-local, which makes it safe to load textures concurrently.
+  stbi_set_flip_vertically_on_load_thread(true);
 
   TextureData data;
   void* pixels = nullptr;
 
   if (format == TextureFormat::Float) {
-    pixels = stbi_loadf(path_str.c_str(),
-                        &data.size.x,
-                        &data.size.y,
-                        &data.channels,
-                        _convert_texture_channels(channels));
+    pixels = stbi_loadf_from_memory(file_data,
+                                    file_size,
+                                    &data.size.x,
+                                    &data.size.y,
+                                    &data.channels,
+                                    _convert_texture_channels(channels));
   }
   else {
-    pixels = stbi_load(path_str.c_str(),
-                       &data.size.x,
-                       &data.size.y,
-                       &data.channels,
-                       _convert_texture_channels(channels));
+    pixels = stbi_load_from_memory(file_data,
+                                   file_size,
+                                   &data.size.x,
+                                   &data.size.y,
+                                   &data.channels,
+                                   _convert_texture_channels(channels));
   }
 
   data.pixels.reset(static_cast<uint8*>(pixels));
@@ -76,4 +96,4 @@ auto load_texture_data(const Path& path,
   }
 }
 
-}  // namespace glow
\ No newline at end of file
+}  // namespace glow
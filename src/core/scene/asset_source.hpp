@@ -0,0 +1,32 @@
+#pragma once
+
+#include "common/primitives.hpp"
+#include "common/type/ecs.hpp"
+#include "common/type/map.hpp"
+#include "common/type/maybe.hpp"
+#include "common/type/path.hpp"
+#include "io/import_options.hpp"
+#include "io/texture_compression.hpp"
+
+namespace glow {
+
+/// Component that records the file that a model was loaded from, used to reload it.
+struct ModelSource final {
+  Path path;                         ///< The normalized path of the model file.
+  ImportOptions options;             ///< The options used to import the model file.
+  HashMap<usize, Entity> materials;  ///< The material entities, by material ID.
+};
+
+/// Component that records the texture files used by a material, used to reload them.
+struct MaterialSource final {
+  Maybe<Path> diffuse_tex;            ///< The normalized path of the diffuse texture.
+  Maybe<Path> specular_tex;           ///< The normalized path of the specular texture.
+  TextureCompression compression {};  ///< The compression used for the textures.
+
+  [[nodiscard]] auto uses_texture(const Path& path) const -> bool
+  {
+    return diffuse_tex == path || specular_tex == path;
+  }
+};
+
+}  // namespace glow
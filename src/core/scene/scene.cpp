@@ -6,10 +6,14 @@
 
 #include "common/debug/assert.hpp"
 #include "common/primitives.hpp"
+#include "graphics/asset_stats.hpp"
 #include "graphics/camera.hpp"
 #include "graphics/environment.hpp"
+#include "graphics/render_stats.hpp"
 #include "graphics/renderer_info.hpp"
 #include "graphics/rendering_options.hpp"
+#include "graphics/texture_streaming.hpp"
+#include "io/file_watcher.hpp"
 #include "scene/identifier.hpp"
 #include "scene/node.hpp"
 #include "scene/transform.hpp"
@@ -21,11 +25,15 @@ namespace glow {
 Scene::Scene()
 {
   auto& ctx = mRegistry.ctx();
+  ctx.emplace<AssetStats>();
   ctx.emplace<CameraContext>();
   ctx.emplace<CameraOptions>();
   ctx.emplace<EnvironmentOptions>();
+  ctx.emplace<FileWatcher>();
   ctx.emplace<GizmosOptions>();
   ctx.emplace<RendererInfo>();
+  ctx.emplace<RenderStats>();
+  ctx.emplace<TextureStreamer>();
 
   auto& rendering_options = ctx.emplace<RenderingOptions>();
   rendering_options.options[RenderingOption::VSync];
@@ -33,6 +41,9 @@ Scene::Scene()
   rendering_options.options[RenderingOption::FaceCulling];
   rendering_options.options[RenderingOption::Wireframe];
   rendering_options.options[RenderingOption::Blending];
+  rendering_options.options[RenderingOption::MeshletCulling];
+  rendering_options.options[RenderingOption::LevelOfDetail];
+  rendering_options.options[RenderingOption::LodHysteresis];
 }
 
 auto Scene::make_node(String name, const Entity parent) -> Entity
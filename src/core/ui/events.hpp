@@ -3,6 +3,7 @@
 #include "common/primitives.hpp"
 #include "common/type/ecs.hpp"
 #include "common/type/math.hpp"
+#include "graphics/render_stats.hpp"
 #include "graphics/rendering_options.hpp"
 #include "ui/gizmos.hpp"
 
@@ -94,4 +95,12 @@ struct ToggleRenderingOptionEvent final {
   RenderingOption option {};
 };
 
+struct UpdateRenderStatsEvent final {
+  RenderStats stats;
+};
+
+struct SetTextureBudgetEvent final {
+  usize budget {};  ///< The texture memory budget, in bytes.
+};
+
 }  // namespace glow
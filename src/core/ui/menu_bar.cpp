@@ -3,9 +3,12 @@
 #include <IconsFontAwesome6.h>
 #include <imgui.h>
 
+#include "graphics/asset_stats.hpp"
 #include "graphics/environment.hpp"
+#include "graphics/render_stats.hpp"
 #include "graphics/renderer_info.hpp"
 #include "graphics/rendering_options.hpp"
+#include "graphics/texture_streaming.hpp"
 #include "scene/scene.hpp"
 #include "ui/events.hpp"
 
@@ -66,6 +69,9 @@ void _show_renderer_menu(const Scene& scene, Dispatcher& dispatcher)
 {
   const auto& renderer_info = scene.get<RendererInfo>();
   const auto& rendering_options = scene.get<RenderingOptions>();
+  const auto& render_stats = scene.get<RenderStats>();
+  const auto& texture_streamer = scene.get<TextureStreamer>();
+  const auto& asset_stats = scene.get<AssetStats>();
 
   bool show_renderer_info_popup = false;
 
@@ -100,6 +106,83 @@ void _show_renderer_menu(const Scene& scene, Dispatcher& dispatcher)
       dispatcher.enqueue<ToggleRenderingOptionEvent>(RenderingOption::Blending);
     }
 
+    if (ImGui::MenuItem(ICON_FA_CUBES " Meshlet Culling",
+                        nullptr,
+                        rendering_options.test(RenderingOption::MeshletCulling))) {
+      dispatcher.enqueue<ToggleRenderingOptionEvent>(RenderingOption::MeshletCulling);
+    }
+
+    if (ImGui::MenuItem(ICON_FA_DRAW_POLYGON " Level of Detail",
+                        nullptr,
+                        rendering_options.test(RenderingOption::LevelOfDetail))) {
+      dispatcher.enqueue<ToggleRenderingOptionEvent>(RenderingOption::LevelOfDetail);
+    }
+
+    if (ImGui::MenuItem(ICON_FA_STAIRS " LOD Hysteresis",
+                        nullptr,
+                        rendering_options.test(RenderingOption::LodHysteresis))) {
+      dispatcher.enqueue<ToggleRenderingOptionEvent>(RenderingOption::LodHysteresis);
+    }
+
+    ImGui::Separator();
+
+    const auto submitted_percentage =
+        (render_stats.triangle_count != 0)
+            ? 100.0 * static_cast<double>(render_stats.submitted_triangle_count) /
+                  static_cast<double>(render_stats.triangle_count)
+            : 100.0;
+
+    ImGui::Text("Triangles: %zu / %zu (%.1f%%)",
+                render_stats.submitted_triangle_count,
+                render_stats.triangle_count,
+                submitted_percentage);
+    ImGui::Text("Meshlets: %zu / %zu",
+                render_stats.visible_meshlet_count,
+                render_stats.meshlet_count);
+    ImGui::Text("Simplified meshes: %zu", render_stats.lod_mesh_count);
+    ImGui::Text("Draw calls: %zu", render_stats.draw_count);
+    ImGui::Text("Instanced meshes: %zu", render_stats.instanced_mesh_count);
+
+    if (render_stats.state_change_count != 0) {
+      ImGui::Text("GL state changes: %zu (%zu skipped)",
+                  render_stats.state_change_count,
+                  render_stats.skipped_change_count);
+    }
+
+    ImGui::Separator();
+
+    constexpr float kMebibyte = 1'024.0f * 1'024.0f;
+
+    ImGui::Text("Texture memory: %.1f / %.1f MiB",
+                static_cast<float>(texture_streamer.get_resident_bytes()) / kMebibyte,
+                static_cast<float>(texture_streamer.get_budget()) / kMebibyte);
+    ImGui::Text("Streaming textures: %zu / %zu",
+                texture_streamer.get_pending_count(),
+                texture_streamer.get_texture_count());
+    ImGui::Text("Shared textures: %zu hits, %zu misses",
+                asset_stats.texture_hits,
+                asset_stats.texture_misses);
+    ImGui::Text("Shared meshes: %zu hits, %zu misses",
+                asset_stats.mesh_hits,
+                asset_stats.mesh_misses);
+    ImGui::Text("Memory saved by sharing: %.1f MiB",
+                static_cast<float>(asset_stats.saved_bytes) / kMebibyte);
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::TextUnformatted(ICON_FA_MEMORY " Texture Budget");
+    ImGui::SameLine();
+
+    int budget_mib = static_cast<int>(texture_streamer.get_budget() / (1'024 * 1'024));
+    if (ImGui::SliderInt("##TextureBudget",
+                         &budget_mib,
+                         64,
+                         4'096,
+                         "%d MiB",
+                         ImGuiSliderFlags_Logarithmic)) {
+      dispatcher.enqueue<SetTextureBudgetEvent>(static_cast<usize>(budget_mib) * 1'024 *
+                                                1'024);
+    }
+
     ImGui::Separator();
 
     show_renderer_info_popup = ImGui::MenuItem("Renderer Info...");
@@ -0,0 +1,84 @@
+#include "process_memory.hpp"
+
+#include "common/predef.hpp"
+
+#if GLOW_OS_WINDOWS
+
+#include <windows.h>
+
+#include <psapi.h>
+
+#elif GLOW_OS_LINUX
+
+#include <ios>     // ios
+#include <string>  // getline, stoull
+
+#include "common/type/fstream.hpp"
+#include "common/type/string.hpp"
+
+#endif  // GLOW_OS_WINDOWS
+
+namespace glow {
+
+#if GLOW_OS_WINDOWS
+
+auto query_process_memory() -> Maybe<ProcessMemory>
+{
+  PROCESS_MEMORY_COUNTERS counters {};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof counters)) {
+    return kNothing;
+  }
+
+  return ProcessMemory {
+      .resident = static_cast<usize>(counters.WorkingSetSize),
+      .peak_resident = static_cast<usize>(counters.PeakWorkingSetSize),
+  };
+}
+
+#elif GLOW_OS_LINUX
+
+auto query_process_memory() -> Maybe<ProcessMemory>
+{
+  IfStream stream {"/proc/self/status", std::ios::in};
+  if (!stream.good()) {
+    return kNothing;
+  }
+
+  // The sizes are listed in KiB, e.g. "VmHWM:     123456 kB"
+  const auto parse_size = [](const String& line) -> usize {
+    const auto digits = line.find_first_of("0123456789");
+    return (digits != String::npos) ? std::stoull(line.substr(digits)) * 1'024 : 0;
+  };
+
+  ProcessMemory memory;
+  usize found_count = 0;
+
+  String line;
+  while (found_count < 2 && std::getline(stream, line)) {
+    if (line.starts_with("VmRSS:")) {
+      memory.resident = parse_size(line);
+      ++found_count;
+    }
+    else if (line.starts_with("VmHWM:")) {
+      memory.peak_resident = parse_size(line);
+      ++found_count;
+    }
+  }
+
+  if (found_count != 2) {
+    return kNothing;
+  }
+
+  return memory;
+}
+
+#else
+
+auto query_process_memory() -> Maybe<ProcessMemory>
+{
+  return kNothing;
+}
+
+#endif  // GLOW_OS_WINDOWS
+
+}  // namespace glow
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "common/primitives.hpp"
+#include "common/type/maybe.hpp"
+
+namespace glow {
+
+/// Physical memory usage of the current process.
+struct ProcessMemory final {
+  usize resident {};       ///< The current resident set size, in bytes.
+  usize peak_resident {};  ///< The largest resident set size so far, in bytes.
+};
+
+/// Queries the physical memory usage of the current process.
+///
+/// \return the memory usage, or nothing if it isn't available on the current platform.
+[[nodiscard]] auto query_process_memory() -> Maybe<ProcessMemory>;
+
+}  // namespace glow
@@ -0,0 +1,73 @@
+#include "range_allocator.hpp"
+
+#include <iterator>  // prev
+
+#include "common/debug/assert.hpp"
+
+namespace glow {
+
+auto RangeAllocator::allocate(const usize size) -> Maybe<usize>
+{
+  // Empty ranges don't occupy any elements
+  if (size == 0) {
+    return 0;
+  }
+
+  for (auto iter = mFreeRanges.begin(); iter != mFreeRanges.end(); ++iter) {
+    const auto [offset, free_size] = *iter;
+
+    if (free_size >= size) {
+      mFreeRanges.erase(iter);
+
+      if (free_size > size) {
+        mFreeRanges.emplace(offset + size, free_size - size);
+      }
+
+      return offset;
+    }
+  }
+
+  return kNothing;
+}
+
+void RangeAllocator::release(usize offset, usize size)
+{
+  if (size == 0) {
+    return;
+  }
+
+  GLOW_ASSERT(offset + size <= mCapacity);
+
+  auto next = mFreeRanges.lower_bound(offset);
+
+  // Merge with the following free range
+  if (next != mFreeRanges.end() && offset + size == next->first) {
+    size += next->second;
+    next = mFreeRanges.erase(next);
+  }
+
+  // Merge with the preceding free range
+  if (next != mFreeRanges.begin()) {
+    const auto prev = std::prev(next);
+
+    if (prev->first + prev->second == offset) {
+      offset = prev->first;
+      size += prev->second;
+      mFreeRanges.erase(prev);
+    }
+  }
+
+  mFreeRanges.emplace(offset, size);
+}
+
+void RangeAllocator::grow(const usize capacity)
+{
+  GLOW_ASSERT(capacity >= mCapacity);
+
+  const auto old_capacity = mCapacity;
+  mCapacity = capacity;
+
+  release(old_capacity, capacity - old_capacity);
+}
+
+}  // namespace glow
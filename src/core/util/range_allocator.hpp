@@ -0,0 +1,41 @@
+#pragma once
+
+#include "common/primitives.hpp"
+#include "common/type/map.hpp"
+#include "common/type/maybe.hpp"
+
+namespace glow {
+
+/// Allocates ranges of elements from a growable space, e.g. the vertices of a buffer.
+///
+/// \details
+/// Free ranges are kept sorted by their offsets, and adjacent free ranges are merged
+/// when ranges are released. Allocations use the first free range that is large enough.
+class RangeAllocator final {
+ public:
+  /// Allocates a range of elements.
+  ///
+  /// \param size the number of elements in the range.
+  ///
+  /// \return the offset of the range; or nothing if no free range is large enough.
+  [[nodiscard]] auto allocate(usize size) -> Maybe<usize>;
+
+  /// Releases a previously allocated range, so that it may be reused.
+  ///
+  /// \param offset the offset of the range.
+  /// \param size the number of elements in the range.
+  void release(usize offset, usize size);
+
+  /// Adds free elements at the end of the space.
+  ///
+  /// \param capacity the new total number of elements, which may not be smaller.
+  void grow(usize capacity);
+
+  [[nodiscard]] auto get_capacity() const noexcept -> usize { return mCapacity; }
+
+ private:
+  Map<usize, usize> mFreeRanges;  ///< The size of each free range, by offset.
+  usize mCapacity {};
+};
+
+}  // namespace glow
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <coroutine>    // coroutine_handle, suspend_always, suspend_never, noop_coroutine
+#include <exception>    // exception_ptr, current_exception, rethrow_exception, terminate
+#include <optional>     // optional
+#include <utility>      // move, exchange, forward
+
+#include <spdlog/spdlog.h>
+
+#include "common/debug/error.hpp"
+#include "common/predef.hpp"
+
+namespace glow {
+
+template <typename T>
+class Task;
+
+/// Base class of task promises, handles the continuation and error state.
+class TaskPromiseBase {
+ public:
+  struct FinalAwaiter final {
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+    template <typename Promise>
+    [[nodiscard]] auto await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        -> std::coroutine_handle<>
+    {
+      if (auto continuation = handle.promise().mContinuation) {
+        return continuation;
+      }
+
+      return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  [[nodiscard]] auto initial_suspend() const noexcept -> std::suspend_always
+  {
+    return {};
+  }
+
+  [[nodiscard]] auto final_suspend() const noexcept -> FinalAwaiter { return {}; }
+
+  void unhandled_exception() noexcept { mException = std::current_exception(); }
+
+  void set_continuation(const std::coroutine_handle<> continuation) noexcept
+  {
+    mContinuation = continuation;
+  }
+
+ protected:
+  std::coroutine_handle<> mContinuation;
+  std::exception_ptr mException;
+
+  void rethrow_if_failed() const
+  {
+    if (mException) {
+      std::rethrow_exception(mException);
+    }
+  }
+};
+
+template <typename T>
+class TaskPromise final : public TaskPromiseBase {
+ public:
+  [[nodiscard]] auto get_return_object() noexcept -> Task<T>;
+
+  template <typename U>
+  void return_value(U&& value)
+  {
+    mValue.emplace(std::forward<U>(value));
+  }
+
+  [[nodiscard]] auto take_result() -> T
+  {
+    rethrow_if_failed();
+    return std::move(*mValue);
+  }
+
+ private:
+  std::optional<T> mValue;
+};
+
+template <>
+class TaskPromise<void> final : public TaskPromiseBase {
+ public:
+  [[nodiscard]] auto get_return_object() noexcept -> Task<void>;
+
+  void return_void() noexcept {}
+
+  void take_result() const { rethrow_if_failed(); }
+};
+
+/// A lazily started coroutine that produces a value when awaited.
+///
+/// \details
+/// Tasks don't start executing until they are awaited, at which point the awaiting
+/// coroutine is suspended until the task has finished. Use `spawn()` to start a task
+/// from ordinary code. Tasks may move themselves between threads by awaiting
+/// schedulers, e.g. `co_await get_thread_pool().schedule()`.
+template <typename T = void>
+class [[nodiscard]] Task final {
+ public:
+  using promise_type = TaskPromise<T>;
+  using handle_type = std::coroutine_handle<promise_type>;
+
+  GLOW_DELETE_COPY(Task);
+
+  explicit Task(const handle_type handle) noexcept
+      : mHandle {handle}
+  {
+  }
+
+  ~Task() noexcept
+  {
+    if (mHandle) {
+      mHandle.destroy();
+    }
+  }
+
+  Task(Task&& other) noexcept
+      : mHandle {std::exchange(other.mHandle, nullptr)}
+  {
+  }
+
+  auto operator=(Task&& other) noexcept -> Task&
+  {
+    if (this != &other) {
+      if (mHandle) {
+        mHandle.destroy();
+      }
+
+      mHandle = std::exchange(other.mHandle, nullptr);
+    }
+
+    return *this;
+  }
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+  [[nodiscard]] auto await_suspend(const std::coroutine_handle<> continuation) noexcept
+      -> std::coroutine_handle<>
+  {
+    mHandle.promise().set_continuation(continuation);
+    return mHandle;
+  }
+
+  auto await_resume() -> T { return mHandle.promise().take_result(); }
+
+ private:
+  handle_type mHandle;
+};
+
+template <typename T>
+auto TaskPromise<T>::get_return_object() noexcept -> Task<T>
+{
+  return Task<T> {std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline auto TaskPromise<void>::get_return_object() noexcept -> Task<void>
+{
+  return Task<void> {std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+/// Coroutine type used for "fire-and-forget" tasks, destroys itself when done.
+struct DetachedTask final {
+  struct promise_type final {
+    [[nodiscard]] auto get_return_object() const noexcept -> DetachedTask { return {}; }
+
+    [[nodiscard]] auto initial_suspend() const noexcept -> std::suspend_never
+    {
+      return {};
+    }
+
+    [[nodiscard]] auto final_suspend() const noexcept -> std::suspend_never
+    {
+      return {};
+    }
+
+    void return_void() const noexcept {}
+
+    [[noreturn]] void unhandled_exception() const noexcept { std::terminate(); }
+  };
+};
+
+/// Starts a task without waiting for it to finish.
+///
+/// \details
+/// The task starts executing on the calling thread, and runs until its first
+/// suspension point. Errors that escape the task are logged.
+///
+/// \param task the task to start.
+/// \param on_done function object invoked when the task has finished.
+template <typename OnDone>
+auto spawn(Task<void> task, OnDone on_done) -> DetachedTask
+{
+  try {
+    co_await std::move(task);
+  }
+  catch (const Error& err) {
+    spdlog::error("[Engine] Unhandled error in task: {}\n{}", err.what(), err.trace());
+  }
+  catch (const std::exception& e) {
+    spdlog::error("[Engine] Unhandled exception in task: {}", e.what());
+  }
+  catch (...) {
+    spdlog::error("[Engine] Unhandled exception in task");
+  }
+
+  on_done();
+}
+
+}  // namespace glow
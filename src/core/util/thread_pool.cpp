@@ -0,0 +1,166 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>  // max, min
+#include <atomic>     // atomic
+#include <exception>  // exception_ptr, current_exception, rethrow_exception
+
+#include <spdlog/spdlog.h>
+
+#include "common/debug/assert.hpp"
+#include "common/type/memory.hpp"
+
+namespace glow {
+namespace {
+
+inline usize gThreadPoolSize = 0;
+inline bool gThreadPoolCreated = false;
+
+struct ParallelForState final {
+  usize count {};
+  std::atomic<usize> next_index {0};
+  std::atomic<usize> done_count {0};
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::exception_ptr exception;
+};
+
+void _run_parallel_for_items(ParallelForState& state,
+                             const ThreadPool::IndexedTask& func) noexcept
+{
+  usize processed = 0;
+
+  for (auto index = state.next_index++; index < state.count;
+       index = state.next_index++) {
+    try {
+      func(index);
+    }
+    catch (...) {
+      const std::lock_guard lock {state.mutex};
+      if (!state.exception) {
+        state.exception = std::current_exception();
+      }
+    }
+
+    ++processed;
+  }
+
+  if (processed != 0 && state.done_count.fetch_add(processed) + processed == state.count) {
+    const std::lock_guard lock {state.mutex};
+    state.condition.notify_all();
+  }
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(const usize thread_count)
+{
+  mThreads.reserve(thread_count);
+  for (usize index = 0; index < thread_count; ++index) {
+    mThreads.emplace_back([this] { run_worker(); });
+  }
+
+  spdlog::debug("[Engine] Created thread pool with {} workers", thread_count);
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+  {
+    const std::lock_guard lock {mMutex};
+    mStopping = true;
+  }
+
+  mCondition.notify_all();
+  mThreads.clear();
+}
+
+void ThreadPool::enqueue(Task task)
+{
+  if (mThreads.empty()) {
+    task();
+    return;
+  }
+
+  {
+    const std::lock_guard lock {mMutex};
+    mTasks.push_back(std::move(task));
+  }
+
+  mCondition.notify_one();
+}
+
+void ThreadPool::run_worker()
+{
+  while (true) {
+    Task task;
+
+    {
+      std::unique_lock lock {mMutex};
+      mCondition.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+
+      if (mTasks.empty()) {
+        return;
+      }
+
+      task = std::move(mTasks.front());
+      mTasks.pop_front();
+    }
+
+    task();
+  }
+}
+
+void ThreadPool::parallel_for(const usize count, const IndexedTask& func)
+{
+  if (count == 0) {
+    return;
+  }
+
+  // The state is shared with the helper tasks, since these may be dequeued by the
+  // workers after this function has returned (in which case they don't do anything).
+  auto state = std::make_shared<ParallelForState>();
+  state->count = count;
+
+  const auto helper_count = std::min(count - 1, thread_count());
+  for (usize helper_index = 0; helper_index < helper_count; ++helper_index) {
+    enqueue([state, &func] { _run_parallel_for_items(*state, func); });
+  }
+
+  _run_parallel_for_items(*state, func);
+
+  {
+    std::unique_lock lock {state->mutex};
+    state->condition.wait(lock, [&] { return state->done_count == count; });
+  }
+
+  if (state->exception) {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+void set_thread_pool_size(const usize thread_count)
+{
+  GLOW_ASSERT_MSG(!gThreadPoolCreated, "Thread pool has already been created");
+  GLOW_ASSERT(thread_count > 0);
+
+  gThreadPoolSize = thread_count;
+}
+
+auto get_thread_pool() -> ThreadPool&
+{
+  static ThreadPool pool {[] {
+    gThreadPoolCreated = true;
+
+    const usize hardware_threads = std::thread::hardware_concurrency();
+    const auto thread_count = (gThreadPoolSize != 0) ? gThreadPoolSize  //
+                                                     : std::max(hardware_threads, usize {1});
+
+    // The calling thread accounts for one of the threads. However, there is always at
+    // least one worker, since tasks that move off the main thread would otherwise
+    // resume inline and block the frame.
+    return std::max(thread_count - 1, usize {1});
+  }()};
+
+  return pool;
+}
+
+}  // namespace glow
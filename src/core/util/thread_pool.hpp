@@ -0,0 +1,118 @@
+#pragma once
+
+#include <condition_variable>  // condition_variable
+#include <coroutine>           // coroutine_handle
+#include <deque>               // deque
+#include <functional>          // function, move_only_function
+#include <future>              // future, packaged_task
+#include <mutex>               // mutex
+#include <thread>              // jthread
+#include <type_traits>         // invoke_result_t
+#include <utility>             // move, forward
+
+#include "common/predef.hpp"
+#include "common/primitives.hpp"
+#include "common/type/vector.hpp"
+
+namespace glow {
+
+/// A fixed-size pool of worker threads that execute submitted tasks in FIFO order.
+class ThreadPool final {
+ public:
+  using Task = std::move_only_function<void()>;
+  using IndexedTask = std::function<void(usize)>;
+
+  GLOW_DELETE_COPY(ThreadPool);
+  GLOW_DELETE_MOVE(ThreadPool);
+
+  /// Creates a thread pool.
+  ///
+  /// \details
+  /// A pool without any worker threads is valid, in which case all tasks are executed
+  /// synchronously by the thread that submits them.
+  ///
+  /// \param thread_count the number of worker threads.
+  explicit ThreadPool(usize thread_count);
+
+  /// Finishes all pending tasks and joins the worker threads.
+  ~ThreadPool() noexcept;
+
+  /// Schedules a task for execution on a worker thread.
+  ///
+  /// \param func the function object to invoke.
+  ///
+  /// \return a future that provides the result of the task.
+  template <typename Func>
+  [[nodiscard]] auto submit(Func&& func) -> std::future<std::invoke_result_t<Func>>
+  {
+    std::packaged_task<std::invoke_result_t<Func>()> task {std::forward<Func>(func)};
+    auto future = task.get_future();
+
+    enqueue(Task {std::move(task)});
+
+    return future;
+  }
+
+  /// Returns an awaitable that resumes the awaiting coroutine on a worker thread.
+  [[nodiscard]] auto schedule() noexcept
+  {
+    struct Awaiter final {
+      ThreadPool* pool {};
+
+      [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+      void await_suspend(const std::coroutine_handle<> handle)
+      {
+        pool->enqueue([handle] { handle.resume(); });
+      }
+
+      void await_resume() const noexcept {}
+    };
+
+    return Awaiter {this};
+  }
+
+  /// Invokes a function for each index in [0, count), distributed across the workers.
+  ///
+  /// \details
+  /// The calling thread participates in the work and the function doesn't return
+  /// until all indices have been processed, so it's safe to call this function from
+  /// a worker thread. The first exception thrown by a task, if any, is rethrown
+  /// in the calling thread.
+  ///
+  /// \param count the number of indices to process.
+  /// \param func the function to invoke for each index.
+  void parallel_for(usize count, const IndexedTask& func);
+
+  /// Returns the number of worker threads in the pool.
+  [[nodiscard]] auto thread_count() const noexcept -> usize { return mThreads.size(); }
+
+ private:
+  Vector<std::jthread> mThreads;
+  std::deque<Task> mTasks;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  bool mStopping {false};
+
+  void enqueue(Task task);
+
+  void run_worker();
+};
+
+/// Sets the total number of threads used by the shared thread pool.
+///
+/// \details
+/// The calling thread is included in the thread count, since it participates in
+/// parallel loops. By default, all hardware threads are used. A single worker thread
+/// is created even if the count is one, so that asynchronous loading never runs on
+/// the main thread.
+///
+/// \pre This function must be called before the first call to `get_thread_pool()`.
+///
+/// \param thread_count the total number of threads, must be greater than zero.
+void set_thread_pool_size(usize thread_count);
+
+/// Returns the shared thread pool.
+[[nodiscard]] auto get_thread_pool() -> ThreadPool&;
+
+}  // namespace glow
@@ -0,0 +1,55 @@
+#include <cstdlib>    // EXIT_FAILURE, EXIT_SUCCESS
+#include <exception>  // exception
+
+#include <argparse/argparse.hpp>
+#include <spdlog/spdlog.h>
+
+#include "common/predef.hpp"
+#include "common/type/path.hpp"
+#include "common/type/string.hpp"
+#include "io/asset_archive.hpp"
+
+namespace {
+
+inline constexpr const char* kDirHelp = "directory with the asset files to pack";
+inline constexpr const char* kOutputHelp = "path of the asset archive to create";
+inline constexpr const char* kStoreHelp = "store files without compression";
+inline constexpr const char* kVerboseHelp = "log every packed file";
+
+}  // namespace
+
+auto main(const int argc, char* argv[]) -> int
+{
+  spdlog::set_pattern("%^[%L][%T.%e]%$ %v");
+
+  argparse::ArgumentParser parser {"glowpak",
+                                   GLOW_VERSION_STRING,
+                                   argparse::default_arguments::all};
+
+  // clang-format off
+  parser.add_argument("dir").help(kDirHelp);
+  parser.add_argument("output").help(kOutputHelp);
+  parser.add_argument("--store").default_value(false).implicit_value(true).help(kStoreHelp);
+  parser.add_argument("--verbose", "-v").default_value(false).implicit_value(true).help(kVerboseHelp);
+  // clang-format on
+
+  try {
+    parser.parse_args(argc, argv);
+  }
+  catch (const std::exception& e) {
+    spdlog::error("[Pack] Invalid command line arguments: {}", e.what());
+    return EXIT_FAILURE;
+  }
+
+  if (parser.get<bool>("--verbose")) {
+    spdlog::set_level(spdlog::level::debug);
+  }
+
+  const auto compression = parser.get<bool>("--store") ? glow::ArchiveCompression::None
+                                                       : glow::ArchiveCompression::LZ4;
+
+  const glow::Path dir {parser.get<glow::String>("dir")};
+  const glow::Path output {parser.get<glow::String>("output")};
+
+  return glow::pack_asset_archive(dir, output, compression) ? EXIT_SUCCESS : EXIT_FAILURE;
+}